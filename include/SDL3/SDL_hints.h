@@ -1351,6 +1351,22 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_LINE_METHOD "SDL_RENDER_LINE_METHOD"
 
+/**
+ *  \brief  A variable controlling whether the 2D render API may reorder batched draws.
+ *
+ *  This variable can be set to the following values:
+ *    "0"     - Draw in the order the draws were made (the default)
+ *    "1"     - Group draws using the same texture and blend mode together
+ *
+ *  When enabled, a draw is moved ahead of earlier draws only if none of
+ *  them touch the same pixels, so the rendered result is unchanged while
+ *  the renderer switches textures and blend modes less often. This only
+ *  has an effect when batching is enabled, see SDL_HINT_RENDER_BATCHING.
+ *
+ *  This variable should be set when the renderer is created.
+ */
+#define SDL_HINT_RENDER_REORDERING "SDL_RENDER_REORDERING"
+
 /**
  *  \brief  A variable controlling whether to enable Direct3D 11+'s Debug Layer.
  *
@@ -1414,12 +1430,38 @@ extern "C" {
  *  This variable can be set to the following values:
  *    "0" or "nearest" - Nearest pixel sampling
  *    "1" or "linear"  - Linear filtering (supported by OpenGL and Direct3D)
- *    "2" or "best"    - Currently this is the same as "linear"
+ *    "2" or "best"    - Linear filtering, except that the software renderer
+ *                       averages the covered area when shrinking
  *
  *  By default nearest pixel sampling is used
  */
 #define SDL_HINT_RENDER_SCALE_QUALITY       "SDL_RENDER_SCALE_QUALITY"
 
+/**
+ *  \brief  A variable controlling how many threads the software renderer draws with.
+ *
+ *  With more than one thread, the target is split in tiles that are drawn
+ *  in parallel, each tile keeping the order of the draw calls. Only the
+ *  drawing is parallel: queuing the draw calls and presenting still run on
+ *  the rendering thread, as do scaled and rotated copies and lines crossing
+ *  tiles. Whether more threads are faster depends on how much of the frame
+ *  is spent drawing, so measure before raising it.
+ *
+ *  With more than one thread the draw calls are always batched, see
+ *  SDL_HINT_RENDER_BATCHING: call SDL_RenderFlush() before accessing the
+ *  target surface directly.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use one thread per CPU core
+ *    "1"       - Draw on the rendering thread only
+ *    "N"       - Use N threads, including the rendering thread
+ *
+ *  By default the software renderer draws on the rendering thread only.
+ *
+ *  This hint should be set before creating the renderer.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS    "SDL_RENDER_SOFTWARE_THREADS"
+
 /**
  *  \brief  A variable controlling whether updates to the SDL screen surface should be synchronized with the vertical refresh, to avoid tearing.
  *
@@ -1482,6 +1524,39 @@ extern "C" {
  */
 #define SDL_HINT_SCREENSAVER_INHIBIT_ACTIVITY_NAME "SDL_SCREENSAVER_INHIBIT_ACTIVITY_NAME"
 
+/**
+ * \brief A variable controlling whether blits from true color surfaces to 8-bit palettized surfaces are dithered.
+ *
+ * Each color is matched to the nearest palette color; with dithering, an
+ * ordered 4x4 pattern spreads the rounding error over neighbouring pixels,
+ * which avoids banding in gradients at the cost of a visible texture.
+ *
+ * This variable can be set to the following values:
+ *   "0"       - Colors are matched to the nearest palette color (the default)
+ *   "1"       - Colors are matched after an ordered dither
+ *
+ * This hint is checked when the blit mapping between two surfaces is
+ * created, changing it does not affect surfaces that were already blitted.
+ */
+#define SDL_HINT_SURFACE_PALETTE_DITHER "SDL_SURFACE_PALETTE_DITHER"
+
+/**
+ * \brief A variable controlling how many threads are used to convert YUV images to RGB.
+ *
+ * Large YV12, IYUV, NV12 and NV21 images are split into bands of rows that
+ * are converted at the same time, which helps when decoded video is converted
+ * on the CPU. Each band has at least 64 rows, so small images are always
+ * converted on one thread.
+ *
+ * This variable can be set to the following values:
+ *   "1"       - Convert on the calling thread (the default)
+ *   "0"       - Use one thread per CPU core
+ *   "N"       - Use up to N threads
+ *
+ * This hint is checked on every conversion.
+ */
+#define SDL_HINT_YUV_CONVERSION_THREADS "SDL_YUV_CONVERSION_THREADS"
+
 /**
  *  \brief Specifies whether SDL_THREAD_PRIORITY_TIME_CRITICAL should be treated as realtime.
  *
@@ -1739,6 +1814,23 @@ extern "C" {
 */
 #define SDL_HINT_VIDEO_WINDOW_SHARE_PIXEL_FORMAT    "SDL_VIDEO_WINDOW_SHARE_PIXEL_FORMAT"
 
+/**
+ *  \brief  A variable controlling whether SDL_UpdateWindowSurface() only updates the changed parts of the window surface.
+ *
+ *  When this is enabled, SDL keeps track of the areas of the window surface changed by
+ *  SDL_BlitSurface(), SDL_FillSurfaceRect() and the other surface functions, and by the
+ *  software renderer, and SDL_UpdateWindowSurface() only sends these areas to the display.
+ *  Changes made directly to the pixels of the surface are only tracked if the surface is
+ *  locked with SDL_LockSurface() before making them.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - SDL_UpdateWindowSurface() updates the whole window (the default)
+ *    "1"       - SDL_UpdateWindowSurface() only updates the areas that changed
+ *
+ *  This hint is checked when the window surface is created by SDL_GetWindowSurface().
+ */
+#define SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE    "SDL_VIDEO_WINDOW_SURFACE_DAMAGE"
+
 /**
  *  \brief  When calling SDL_CreateWindowFrom(), make the window compatible with OpenGL.
  *
@@ -84,6 +84,34 @@ typedef struct SDL_RendererInfo
     int max_texture_height;     /**< The maximum texture height */
 } SDL_RendererInfo;
 
+/**
+ * Rendering statistics for one frame, see SDL_GetRenderStats()
+ */
+typedef struct SDL_RenderStats
+{
+    int state_commands;         /**< Viewport, clip rect and draw color commands queued */
+    int clear_commands;         /**< Clear commands queued */
+    int point_commands;         /**< Point commands queued */
+    int line_commands;          /**< Line commands queued */
+    int rect_commands;          /**< Filled rectangle commands queued */
+    int copy_commands;          /**< Texture copy commands queued, including rotated and flipped copies */
+    int geometry_commands;      /**< Geometry commands queued */
+    int dropped_commands;       /**< Commands queued but dropped before reaching the backend */
+    int submitted_commands;     /**< Commands handed to the backend */
+    int flushes;                /**< Number of times the command queue was sent to the backend */
+    int texture_flushes;        /**< Flushes forced by changing a texture the queued commands use */
+    int draw_calls;             /**< Draw calls made by the backend */
+    int texture_changes;        /**< Texture bindings changed by the backend */
+    int blend_changes;          /**< Blend mode changes made by the backend */
+    int shader_changes;         /**< Shader changes made by the backend */
+    int viewport_changes;       /**< Viewport and clip rect changes made by the backend */
+    int reordered_commands;     /**< Draw commands moved ahead of others, see SDL_HINT_RENDER_REORDERING */
+    int saved_state_changes;    /**< Texture and blend mode changes avoided by reordering draw commands */
+    Uint64 vertex_bytes;        /**< Bytes of vertex data sent to the backend */
+    Uint64 texture_bytes;       /**< Bytes of pixel data uploaded with SDL_UpdateTexture() and friends or SDL_UnlockTexture() */
+    Uint64 command_time_ns;     /**< CPU time spent running the command queue, in nanoseconds */
+} SDL_RenderStats;
+
 /**
  *  Vertex structure
  */
@@ -134,6 +162,18 @@ typedef enum
     SDL_FLIP_VERTICAL = 0x00000002     /**< flip vertically */
 } SDL_RendererFlip;
 
+/**
+ * A texture area drawn by SDL_RenderTextures()
+ */
+typedef struct SDL_TextureBatchItem
+{
+    SDL_FRect srcrect;          /**< The source rectangle, within the texture */
+    SDL_FRect dstrect;          /**< The destination rectangle */
+    SDL_Color color;            /**< Modulates the texture color and alpha mod */
+    double angle;               /**< Clockwise rotation in degrees, around the center of dstrect */
+    SDL_RendererFlip flip;      /**< Flipping actions performed on the texture */
+} SDL_TextureBatchItem;
+
 /**
  * How the logical size is mapped to the output
  */
@@ -159,6 +199,22 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ * Pixels being read from a rendering target in the background
+ *
+ * \sa SDL_RenderReadPixelsAsync
+ */
+struct SDL_RenderReadback;
+typedef struct SDL_RenderReadback SDL_RenderReadback;
+
+/**
+ * A list of triangles kept by the renderer, to be drawn many times
+ *
+ * \sa SDL_CreateStaticGeometry
+ */
+struct SDL_StaticGeometry;
+typedef struct SDL_StaticGeometry SDL_StaticGeometry;
+
 /* Function prototypes */
 
 /**
@@ -683,10 +739,11 @@ extern DECLSPEC int SDLCALL SDL_UpdateYUVTexture(SDL_Texture *texture,
                                                  const Uint8 *Vplane, int Vpitch);
 
 /**
- * Update a rectangle within a planar NV12 or NV21 texture with new pixels.
+ * Update a rectangle within a planar NV12, NV21, P010 or P016 texture with
+ * new pixels.
  *
  * You can use SDL_UpdateTexture() as long as your pixel data is a contiguous
- * block of NV12/21 planes in the proper order, but this function is available
+ * block of Y and UV planes in the proper order, but this function is available
  * if your pixel data is not contiguous.
  *
  * \param texture the texture to update
@@ -1311,6 +1368,32 @@ extern DECLSPEC int SDLCALL SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL
                                                      const double angle, const SDL_FPoint *center,
                                                      const SDL_RendererFlip flip);
 
+/**
+ * Copy many portions of a texture to the current rendering target at once.
+ *
+ * This draws the same as calling SDL_RenderTextureRotated() for each item
+ * after setting the texture color and alpha mod to the item color multiplied
+ * by them, but queues a single command for thousands of items. This is much
+ * faster for drawing large amounts of sprites or particles.
+ *
+ * As with SDL_RenderTextureRotated(), the source rects are clipped to the
+ * texture and each clipped area is drawn over the whole destination rect.
+ *
+ * \param renderer The renderer which should copy parts of a texture.
+ * \param texture The source texture.
+ * \param items The texture areas to draw, in drawing order.
+ * \param count The number of items.
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_RenderTexture
+ * \sa SDL_RenderTextureRotated
+ */
+extern DECLSPEC int SDLCALL SDL_RenderTextures(SDL_Renderer *renderer, SDL_Texture *texture,
+                                               const SDL_TextureBatchItem *items, int count);
+
 /**
  * Render a list of triangles, optionally using a texture and indices into the
  * vertex array Color and alpha modulation is done per vertex
@@ -1370,6 +1453,81 @@ extern DECLSPEC int SDLCALL SDL_RenderGeometryRaw(SDL_Renderer *renderer,
                                                int num_vertices,
                                                const void *indices, int num_indices, int size_indices);
 
+/**
+ * Create geometry that is kept by the renderer, to be drawn many times.
+ *
+ * This takes the same triangles as SDL_RenderGeometry(), but copies them
+ * once, so that drawing them again doesn't have to. Renderers that can keep
+ * the vertices on the GPU do so, and the software renderer keeps the work of
+ * setting up the triangles. Use this for geometry that stays the same from
+ * frame to frame, like a tile map, and draw it with
+ * SDL_RenderStaticGeometry().
+ *
+ * The texture and the vertices can't be changed afterwards, but the blend
+ * mode is the one set at the time the geometry is drawn. Color and alpha
+ * modulation is done per vertex, as with SDL_RenderGeometry(). Drawing the
+ * geometry fails once its texture has been destroyed.
+ *
+ * \param renderer the rendering context
+ * \param texture (optional) The SDL texture to use.
+ * \param vertices Vertices.
+ * \param num_vertices Number of vertices.
+ * \param indices (optional) An array of integer indices into the 'vertices'
+ *                array, if NULL all vertices will be rendered in sequential
+ *                order.
+ * \param num_indices Number of indices.
+ * \returns the geometry, which must be freed with
+ *          SDL_DestroyStaticGeometry(), or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_DestroyStaticGeometry
+ * \sa SDL_RenderGeometry
+ * \sa SDL_RenderStaticGeometry
+ */
+extern DECLSPEC SDL_StaticGeometry *SDLCALL SDL_CreateStaticGeometry(SDL_Renderer *renderer,
+                                                                     SDL_Texture *texture,
+                                                                     const SDL_Vertex *vertices, int num_vertices,
+                                                                     const int *indices, int num_indices);
+
+/**
+ * Render static geometry, moved by a transform.
+ *
+ * The transform is a 2x3 affine matrix of six floats `{ a, b, c, d, x, y }`
+ * that moves each vertex position (vx, vy) to (a * vx + c * vy + x,
+ * b * vx + d * vy + y) before it's drawn, like SDL_RenderGeometry() would
+ * draw it. This can scale, rotate and move the geometry without changing
+ * it.
+ *
+ * \param renderer the rendering context
+ * \param geometry the geometry returned by SDL_CreateStaticGeometry()
+ * \param transform a pointer to six floats, or NULL to draw the geometry
+ *                  where it is
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreateStaticGeometry
+ */
+extern DECLSPEC int SDLCALL SDL_RenderStaticGeometry(SDL_Renderer *renderer,
+                                                     SDL_StaticGeometry *geometry,
+                                                     const float *transform);
+
+/**
+ * Free static geometry.
+ *
+ * Geometry that is still around is freed along with its renderer.
+ *
+ * \param geometry the geometry returned by SDL_CreateStaticGeometry()
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreateStaticGeometry
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyStaticGeometry(SDL_StaticGeometry *geometry);
+
 /**
  * Read pixels from the current rendering target to an array of pixels.
  *
@@ -1401,6 +1559,89 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer *renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ * Start reading pixels from the current rendering target without waiting
+ * for them.
+ *
+ * This works like SDL_RenderReadPixels(), but only schedules the read and
+ * returns a handle right away. The rendering target can be drawn to and
+ * presented while the pixels are transferred, and
+ * SDL_GetRenderReadbackPixels() copies them out once they're needed. A
+ * typical use is to start a read every frame and get the pixels of the read
+ * started the frame before.
+ *
+ * Renderers that can't read pixels in the background read them right away
+ * and keep a copy until SDL_GetRenderReadbackPixels() is called.
+ *
+ * \param renderer the rendering context
+ * \param rect an SDL_Rect structure representing the area in pixels relative
+ *             to the to current viewport, or NULL for the entire viewport
+ * \param format an SDL_PixelFormatEnum value of the desired format of the
+ *               pixel data, or 0 to use the format of the rendering target
+ * \returns the readback handle, which must be freed with
+ *          SDL_DestroyRenderReadback(), or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_DestroyRenderReadback
+ * \sa SDL_GetRenderReadbackPixels
+ * \sa SDL_IsRenderReadbackReady
+ * \sa SDL_RenderReadPixels
+ */
+extern DECLSPEC SDL_RenderReadback *SDLCALL SDL_RenderReadPixelsAsync(SDL_Renderer *renderer,
+                                                                      const SDL_Rect *rect,
+                                                                      Uint32 format);
+
+/**
+ * Check whether the pixels of a readback have arrived.
+ *
+ * Once this returns SDL_TRUE, SDL_GetRenderReadbackPixels() won't wait.
+ *
+ * \param readback the readback handle returned by SDL_RenderReadPixelsAsync()
+ * \returns SDL_TRUE if the pixels can be copied out without waiting,
+ *          SDL_FALSE otherwise.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_GetRenderReadbackPixels
+ * \sa SDL_RenderReadPixelsAsync
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_IsRenderReadbackReady(SDL_RenderReadback *readback);
+
+/**
+ * Copy out the pixels of a readback, waiting for them if necessary.
+ *
+ * The pixels are in the format and cover the area passed to
+ * SDL_RenderReadPixelsAsync(). This can be called more than once.
+ *
+ * \param readback the readback handle returned by SDL_RenderReadPixelsAsync()
+ * \param pixels a pointer to the pixel data to copy into
+ * \param pitch the pitch of the `pixels` parameter
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_IsRenderReadbackReady
+ * \sa SDL_RenderReadPixelsAsync
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderReadbackPixels(SDL_RenderReadback *readback,
+                                                        void *pixels, int pitch);
+
+/**
+ * Free a readback handle.
+ *
+ * Readbacks that are still around are freed along with their renderer.
+ *
+ * \param readback the readback handle returned by SDL_RenderReadPixelsAsync()
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_RenderReadPixelsAsync
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyRenderReadback(SDL_RenderReadback *readback);
+
 /**
  * Update the screen with any rendering performed since the previous call.
  *
@@ -1502,6 +1743,28 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer *renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer *renderer);
 
+/**
+ * Get rendering statistics for the last presented frame.
+ *
+ * The statistics cover everything done with the renderer between the last
+ * two calls to SDL_RenderPresent(), and are all zero until the first frame
+ * has been presented. Backends that don't track draw calls or state changes
+ * leave those fields at zero.
+ *
+ * This is meant for catching performance problems like broken batching; the
+ * exact numbers depend on the backend and may change between SDL versions.
+ *
+ * \param renderer the rendering context
+ * \param stats an SDL_RenderStats structure filled in with the statistics
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_RenderPresent
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderStats(SDL_Renderer *renderer, SDL_RenderStats *stats);
+
 
 /**
  * Bind an OpenGL/ES/ES2 texture to the current context.
@@ -54,6 +54,7 @@ extern "C" {
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
 #define SDL_SIMD_ALIGNED    0x00000008  /**< Surface uses aligned memory */
+#define SDL_POOLED          0x00000010  /**< Surface goes back to the surface pool when destroyed */
 /* @} *//* Surface flags */
 
 /**
@@ -102,6 +103,20 @@ typedef struct SDL_Surface
 typedef int (SDLCALL *SDL_blit) (struct SDL_Surface *src, SDL_Rect *srcrect,
                                  struct SDL_Surface *dst, SDL_Rect *dstrect);
 
+/**
+ * \brief Surface allocation counters, see SDL_GetSurfacePoolStats()
+ *
+ * The counters wrap around, compare them by subtracting them.
+ */
+typedef struct SDL_SurfacePoolStats
+{
+    Uint32 allocated;       /**< Number of surfaces allocated, including the ones created by SDL */
+    Uint32 reused;          /**< Number of surfaces taken from the pool instead of being allocated */
+    Uint32 freed;           /**< Number of surfaces freed */
+    int pooled;             /**< Number of surfaces currently kept in the pool */
+    size_t pooled_bytes;    /**< Size of the pixels of the surfaces kept in the pool */
+} SDL_SurfacePoolStats;
+
 /**
  * \brief The formula used for converting between YUV and RGB
  */
@@ -172,6 +187,66 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_CreateSurfaceFrom
  */
 extern DECLSPEC void SDLCALL SDL_DestroySurface(SDL_Surface *surface);
 
+/**
+ * Get a surface from the surface pool, or allocate a new one.
+ *
+ * The pool keeps surfaces that were created by this function and destroyed
+ * with SDL_DestroySurface(), so that surfaces of the same format and size can
+ * be created and destroyed every frame without allocating memory. SDL uses it
+ * for its own temporary surfaces.
+ *
+ * A surface taken from the pool is in the same state as a new surface, except
+ * that the content of its pixels is undefined. Surfaces with an indexed pixel
+ * format are never pooled.
+ *
+ * The pool keeps a couple of surfaces for each size and format, up to a
+ * limited number and size in total. It doesn't lock, so threads can create
+ * and destroy pooled surfaces without waiting on each other.
+ *
+ * \param width the width of the surface
+ * \param height the height of the surface
+ * \param format the SDL_PixelFormatEnum for the surface's pixel format.
+ * \returns the SDL_Surface structure or NULL if it fails; call SDL_GetError()
+ *          for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_ClearSurfacePool
+ * \sa SDL_CreateSurface
+ * \sa SDL_DestroySurface
+ * \sa SDL_GetSurfacePoolStats
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_CreatePooledSurface
+    (int width, int height, Uint32 format);
+
+/**
+ * Free the surfaces kept in the surface pool.
+ *
+ * This is done automatically by SDL_Quit().
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreatePooledSurface
+ */
+extern DECLSPEC void SDLCALL SDL_ClearSurfacePool(void);
+
+/**
+ * Get the surface allocation counters.
+ *
+ * The counters cover all the surfaces, not only the pooled ones, so they can
+ * be compared from one frame to the next to check that a frame doesn't
+ * allocate any surface.
+ *
+ * \param stats a pointer filled in with the counters
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_CreatePooledSurface
+ */
+extern DECLSPEC int SDLCALL SDL_GetSurfacePoolStats(SDL_SurfacePoolStats *stats);
+
 /**
  * Set the palette used by a surface.
  *
@@ -626,7 +701,11 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
  *
  * This is safe to use with src == dst, but not for other overlapping areas.
  *
- * This function is currently only implemented for SDL_PIXELFORMAT_ARGB8888.
+ * This function works with any 32-bit format with 8-bit channels, such as
+ * SDL_PIXELFORMAT_ARGB8888 or SDL_PIXELFORMAT_ABGR8888, and `src_format` may
+ * differ from `dst_format` to convert and premultiply the pixels in a single
+ * pass. If the source format has no alpha channel the pixels are simply
+ * converted, and treated as opaque.
  *
  * \param width the width of the block to convert, in pixels
  * \param height the height of the block to convert, in pixels
@@ -640,6 +719,8 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
  *          SDL_GetError() for more information.
  *
  * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_UnpremultiplyAlpha
  */
 extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
                                                  Uint32 src_format,
@@ -647,6 +728,39 @@ extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
                                                  Uint32 dst_format,
                                                  void *dst, int dst_pitch);
 
+/**
+ * Undo the alpha premultiplication on a block of pixels.
+ *
+ * Each color channel is divided by the pixel alpha, rounding to nearest, and
+ * pixels with an alpha of 0 become fully black. This is the inverse of
+ * SDL_PremultiplyAlpha(), except for the precision lost at low alpha values.
+ *
+ * This is safe to use with src == dst, but not for other overlapping areas.
+ *
+ * This function works with any 32-bit format with 8-bit channels, and
+ * `src_format` may differ from `dst_format`.
+ *
+ * \param width the width of the block to convert, in pixels
+ * \param height the height of the block to convert, in pixels
+ * \param src_format an SDL_PixelFormatEnum value of the `src` pixels format
+ * \param src a pointer to the source premultiplied pixels
+ * \param src_pitch the pitch of the source pixels, in bytes
+ * \param dst_format an SDL_PixelFormatEnum value of the `dst` pixels format
+ * \param dst a pointer to be filled in with straight alpha pixel data
+ * \param dst_pitch the pitch of the destination pixels, in bytes
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_PremultiplyAlpha
+ */
+extern DECLSPEC int SDLCALL SDL_UnpremultiplyAlpha(int width, int height,
+                                                   Uint32 src_format,
+                                                   const void *src, int src_pitch,
+                                                   Uint32 dst_format,
+                                                   void *dst, int dst_pitch);
+
 /**
  * Perform a fast fill of a rectangle with a specific color.
  *
@@ -816,7 +930,12 @@ extern DECLSPEC int SDLCALL SDL_SoftStretch(SDL_Surface *src,
                                             const SDL_Rect *dstrect);
 
 /**
- * Perform bilinear scaling between two surfaces of the same format, 32BPP.
+ * Perform bilinear scaling between two surfaces of the same format, 16, 24
+ * or 32BPP.
+ *
+ * The surfaces may have different formats if both are 32BPP with 8 bits
+ * channels, like SDL_PIXELFORMAT_ABGR8888 and SDL_PIXELFORMAT_XRGB8888; the
+ * conversion is then done while scaling.
  *
  * \param src the SDL_Surface structure to be copied from
  * \param srcrect the SDL_Rect structure representing the rectangle to be
@@ -834,6 +953,33 @@ extern DECLSPEC int SDLCALL SDL_SoftStretchLinear(SDL_Surface *src,
                                             SDL_Surface *dst,
                                             const SDL_Rect *dstrect);
 
+/**
+ * Perform area averaging scaling between two surfaces of the same format.
+ *
+ * Each destination pixel is the average of the source pixels it covers, which
+ * avoids the aliasing of bilinear filtering on large downscales. Any scaling
+ * ratio is handled in a single pass. Works with 16, 24 and 32 bits formats,
+ * except SDL_PIXELFORMAT_ARGB2101010. Like SDL_SoftStretchLinear(), it can
+ * convert between 32 bits formats while scaling.
+ *
+ * \param src the SDL_Surface structure to be copied from
+ * \param srcrect the SDL_Rect structure representing the rectangle to be
+ *                copied
+ * \param dst the SDL_Surface structure that is the blit target
+ * \param dstrect the SDL_Rect structure representing the rectangle that is
+ *                copied into
+ * \returns 0 on success or a negative error code on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \since This function is available since SDL 3.0.0.
+ *
+ * \sa SDL_SoftStretchLinear
+ */
+extern DECLSPEC int SDLCALL SDL_SoftStretchArea(SDL_Surface *src,
+                                            const SDL_Rect *srcrect,
+                                            SDL_Surface *dst,
+                                            const SDL_Rect *dstrect);
+
 
 /**
  * Perform a scaled surface copy to a destination surface.
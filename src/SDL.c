@@ -489,6 +489,8 @@ void SDL_Quit(void)
 #endif
     SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
+    SDL_ClearSurfacePool();
+
 #ifndef SDL_TIMERS_DISABLED
     SDL_QuitTicks();
 #endif
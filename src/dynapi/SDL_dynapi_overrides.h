@@ -882,3 +882,17 @@
 #define SDL_UnlockRWLock SDL_UnlockRWLock_REAL
 #define SDL_DestroyRWLock SDL_DestroyRWLock_REAL
 #define SDL_GetPath SDL_GetPath_REAL
+#define SDL_SoftStretchArea SDL_SoftStretchArea_REAL
+#define SDL_UnpremultiplyAlpha SDL_UnpremultiplyAlpha_REAL
+#define SDL_CreatePooledSurface SDL_CreatePooledSurface_REAL
+#define SDL_ClearSurfacePool SDL_ClearSurfacePool_REAL
+#define SDL_GetSurfacePoolStats SDL_GetSurfacePoolStats_REAL
+#define SDL_RenderTextures SDL_RenderTextures_REAL
+#define SDL_GetRenderStats SDL_GetRenderStats_REAL
+#define SDL_RenderReadPixelsAsync SDL_RenderReadPixelsAsync_REAL
+#define SDL_IsRenderReadbackReady SDL_IsRenderReadbackReady_REAL
+#define SDL_GetRenderReadbackPixels SDL_GetRenderReadbackPixels_REAL
+#define SDL_DestroyRenderReadback SDL_DestroyRenderReadback_REAL
+#define SDL_CreateStaticGeometry SDL_CreateStaticGeometry_REAL
+#define SDL_RenderStaticGeometry SDL_RenderStaticGeometry_REAL
+#define SDL_DestroyStaticGeometry SDL_DestroyStaticGeometry_REAL
@@ -927,3 +927,17 @@ SDL_DYNAPI_PROC(int,SDL_TryLockRWLockForWriting,(SDL_RWLock *a),(a),return)
 SDL_DYNAPI_PROC(int,SDL_UnlockRWLock,(SDL_RWLock *a),(a),return)
 SDL_DYNAPI_PROC(void,SDL_DestroyRWLock,(SDL_RWLock *a),(a),)
 SDL_DYNAPI_PROC(char*,SDL_GetPath,(SDL_Folder a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_SoftStretchArea,(SDL_Surface *a, const SDL_Rect *b, SDL_Surface *c, const SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_UnpremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_CreatePooledSurface,(int a, int b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_ClearSurfacePool,(void),(),)
+SDL_DYNAPI_PROC(int,SDL_GetSurfacePoolStats,(SDL_SurfacePoolStats *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_RenderTextures,(SDL_Renderer *a, SDL_Texture *b, const SDL_TextureBatchItem *c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_GetRenderStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RenderReadback*,SDL_RenderReadPixelsAsync,(SDL_Renderer *a, const SDL_Rect *b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_IsRenderReadbackReady,(SDL_RenderReadback *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetRenderReadbackPixels,(SDL_RenderReadback *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyRenderReadback,(SDL_RenderReadback *a),(a),)
+SDL_DYNAPI_PROC(SDL_StaticGeometry*,SDL_CreateStaticGeometry,(SDL_Renderer *a, SDL_Texture *b, const SDL_Vertex *c, int d, const int *e, int f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_RenderStaticGeometry,(SDL_Renderer *a, SDL_StaticGeometry *b, const float *c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroyStaticGeometry,(SDL_StaticGeometry *a),(a),)
@@ -26,6 +26,7 @@
 #include "software/SDL_render_sw_c.h"
 #include "../video/SDL_pixels_c.h"
 #include "../video/SDL_video_c.h"
+#include "../video/SDL_yuv_c.h"
 
 #ifdef __ANDROID__
 #include "../core/android/SDL_android.h"
@@ -57,6 +58,18 @@ this should probably be removed at some point in the future.  --ryan. */
         return retval;                                          \
     }
 
+#define CHECK_READBACK_MAGIC(readback, retval)                  \
+    if (!(readback) || (readback)->magic != &readback_magic) {  \
+        SDL_InvalidParamError("readback");                      \
+        return retval;                                          \
+    }
+
+#define CHECK_GEOMETRY_MAGIC(geometry, retval)                  \
+    if (!(geometry) || (geometry)->magic != &geometry_magic) {  \
+        SDL_InvalidParamError("geometry");                      \
+        return retval;                                          \
+    }
+
 /* Predefined blend modes */
 #define SDL_COMPOSE_BLENDMODE(srcColorFactor, dstColorFactor, colorOperation, \
                               srcAlphaFactor, dstAlphaFactor, alphaOperation) \
@@ -124,6 +137,8 @@ static const SDL_RenderDriver *render_drivers[] = {
 
 static char renderer_magic;
 static char texture_magic;
+static char readback_magic;
+static char geometry_magic;
 
 static SDL_INLINE void DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 {
@@ -225,8 +240,221 @@ static SDL_INLINE void DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 #endif
 }
 
+static void CountRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+    const SDL_RenderCommand *cmd;
+
+    for (cmd = renderer->render_commands; cmd != NULL; cmd = cmd->next) {
+        switch (cmd->command) {
+        case SDL_RENDERCMD_NO_OP:
+            ++stats->dropped_commands;
+            continue;
+        case SDL_RENDERCMD_SETVIEWPORT:
+        case SDL_RENDERCMD_SETCLIPRECT:
+        case SDL_RENDERCMD_SETDRAWCOLOR:
+            ++stats->state_commands;
+            break;
+        case SDL_RENDERCMD_CLEAR:
+            ++stats->clear_commands;
+            break;
+        case SDL_RENDERCMD_DRAW_POINTS:
+            ++stats->point_commands;
+            break;
+        case SDL_RENDERCMD_DRAW_LINES:
+            ++stats->line_commands;
+            break;
+        case SDL_RENDERCMD_FILL_RECTS:
+            ++stats->rect_commands;
+            break;
+        case SDL_RENDERCMD_COPY:
+        case SDL_RENDERCMD_COPY_EX:
+            ++stats->copy_commands;
+            break;
+        case SDL_RENDERCMD_GEOMETRY:
+            ++stats->geometry_commands;
+            break;
+        }
+        ++stats->submitted_commands;
+    }
+}
+
+static SDL_bool IsReorderableDraw(const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+    case SDL_RENDERCMD_DRAW_POINTS:
+    case SDL_RENDERCMD_DRAW_LINES:
+    case SDL_RENDERCMD_FILL_RECTS:
+    case SDL_RENDERCMD_COPY:
+    case SDL_RENDERCMD_COPY_EX:
+    case SDL_RENDERCMD_GEOMETRY:
+        return cmd->data.draw.size > 0;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static SDL_bool SameDrawState(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    return a->command == b->command &&
+           a->data.draw.texture == b->data.draw.texture &&
+           a->data.draw.blend == b->data.draw.blend;
+}
+
+static SDL_bool DrawBoundsIntersect(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    const SDL_FRect *r1 = &a->data.draw.bounds;
+    const SDL_FRect *r2 = &b->data.draw.bounds;
+
+    /* Written so that NaN bounds count as intersecting */
+    return !(r1->x + r1->w <= r2->x || r2->x + r2->w <= r1->x ||
+             r1->y + r1->h <= r2->y || r2->y + r2->h <= r1->y);
+}
+
+static int CountDrawStateChanges(SDL_RenderCommand **cmds, int count)
+{
+    int i, changes = 0;
+
+    for (i = 1; i < count; ++i) {
+        if (cmds[i]->data.draw.texture != cmds[i - 1]->data.draw.texture) {
+            ++changes;
+        }
+        if (cmds[i]->data.draw.blend != cmds[i - 1]->data.draw.blend) {
+            ++changes;
+        }
+    }
+    return changes;
+}
+
+/* How far ahead to look for a draw that can join the current state */
+#define REORDER_LOOKAHEAD 128
+
+/* Sorts a run of draws into sorted[] so that draws with the same state follow
+   each other, taking them out of cmds[]. A draw is only moved ahead of draws
+   it doesn't overlap. Returns the number of state changes this saves. */
+static int SortDrawCommands(SDL_RenderCommand **cmds, SDL_RenderCommand **sorted, int count, int *moved)
+{
+    const int changes = CountDrawStateChanges(cmds, count);
+    const SDL_RenderCommand *last = NULL;
+    int first = 0;
+    int i, j, n;
+
+    *moved = 0;
+    if (changes == 0) {
+        return 0;
+    }
+
+    for (n = 0; n < count; ++n) {
+        int pick;
+
+        while (cmds[first] == NULL) {
+            ++first;
+        }
+        pick = first;
+
+        if (last != NULL && !SameDrawState(cmds[first], last)) {
+            for (i = first + 1; i < count && i <= first + REORDER_LOOKAHEAD; ++i) {
+                if (cmds[i] != NULL && SameDrawState(cmds[i], last)) {
+                    for (j = first; j < i; ++j) {
+                        if (cmds[j] != NULL && DrawBoundsIntersect(cmds[j], cmds[i])) {
+                            break;
+                        }
+                    }
+                    if (j == i) {
+                        pick = i;
+                        ++*moved;
+                    }
+                    break;
+                }
+            }
+        }
+
+        last = sorted[n] = cmds[pick];
+        cmds[pick] = NULL;
+    }
+    return changes - CountDrawStateChanges(sorted, count);
+}
+
+/* Copies the vertex data of the draws to the end of the buffer in their new
+   order, so that backends merging draws with adjacent vertex data still can. */
+static int MoveDrawVertices(SDL_Renderer *renderer, SDL_RenderCommand **cmds, int count)
+{
+    const size_t alignment = renderer->vertex_data_alignment;
+    const size_t mask = alignment ? (alignment - 1) : 0;
+    size_t total = 0;
+    size_t offset;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        total += (cmds[i]->data.draw.size + mask) & ~mask;
+    }
+    if (SDL_AllocateRenderVertices(renderer, total, alignment, &offset) == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < count; ++i) {
+        Uint8 *vertices = (Uint8 *)renderer->vertex_data;
+        SDL_memcpy(vertices + offset, vertices + cmds[i]->data.draw.first, cmds[i]->data.draw.size);
+        cmds[i]->data.draw.first = offset;
+        offset += (cmds[i]->data.draw.size + mask) & ~mask;
+    }
+    return 0;
+}
+
+/* Reorders each run of draws between state changes to need fewer texture and blend mode changes */
+static void ReorderRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand **link = &renderer->render_commands;
+
+    while (*link != NULL) {
+        SDL_RenderCommand *cmd = *link;
+        SDL_RenderCommand *last = NULL;
+        SDL_RenderCommand **sorted;
+        int count = 0;
+        int moved, saved, i;
+
+        if (!IsReorderableDraw(cmd)) {
+            link = &cmd->next;
+            continue;
+        }
+
+        for (; cmd != NULL && IsReorderableDraw(cmd); cmd = cmd->next) {
+            if (2 * (count + 1) > renderer->reorder_commands_allocated) {
+                const int allocated = SDL_max(2 * renderer->reorder_commands_allocated, 256);
+                SDL_RenderCommand **cmds = (SDL_RenderCommand **)SDL_realloc(renderer->reorder_commands, allocated * sizeof(*cmds));
+                if (cmds == NULL) {
+                    return; /* just draw in the original order */
+                }
+                renderer->reorder_commands = cmds;
+                renderer->reorder_commands_allocated = allocated;
+            }
+            renderer->reorder_commands[count++] = cmd;
+            last = cmd;
+        }
+
+        sorted = renderer->reorder_commands + count;
+        saved = (count > 2) ? SortDrawCommands(renderer->reorder_commands, sorted, count, &moved) : 0;
+        if (saved <= 0 || MoveDrawVertices(renderer, sorted, count) < 0) {
+            link = &last->next;
+            continue;
+        }
+
+        for (i = 0; i < count; ++i) {
+            *link = sorted[i];
+            link = &sorted[i]->next;
+        }
+        *link = cmd;
+        if (cmd == NULL) {
+            renderer->render_commands_tail = sorted[count - 1];
+        }
+        renderer->stats.reordered_commands += moved;
+        renderer->stats.saved_state_changes += saved;
+    }
+}
+
 static int FlushRenderCommands(SDL_Renderer *renderer)
 {
+    Uint64 start;
     int retval;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
@@ -236,9 +464,18 @@ static int FlushRenderCommands(SDL_Renderer *renderer)
         return 0;
     }
 
+    if (renderer->reordering) {
+        ReorderRenderCommands(renderer);
+    }
+
     DebugLogRenderCommands(renderer->render_commands);
+    CountRenderCommands(renderer);
 
+    start = SDL_GetTicksNS();
     retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    renderer->stats.command_time_ns += SDL_GetTicksNS() - start;
+    renderer->stats.vertex_bytes += renderer->vertex_data_used;
+    ++renderer->stats.flushes;
 
     /* Move the whole render command queue to the unused pool so we can reuse them next time. */
     if (renderer->render_commands_tail != NULL) {
@@ -260,6 +497,7 @@ static int FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
     SDL_Renderer *renderer = texture->renderer;
     if (texture->last_command_generation == renderer->render_command_generation) {
         /* the current command queue depends on this texture, flush the queue now before it changes */
+        ++renderer->stats.texture_flushes;
         return FlushRenderCommands(renderer);
     }
     return 0;
@@ -306,6 +544,9 @@ void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes,
     }
 
     renderer->vertex_data_used += aligner + numbytes;
+    if (alignment > renderer->vertex_data_alignment) {
+        renderer->vertex_data_alignment = alignment;
+    }
 
     return ((Uint8 *)renderer->vertex_data) + aligned;
 }
@@ -494,19 +735,91 @@ static SDL_RenderCommand *PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_Ren
             cmd->data.draw.a = color->a;
             cmd->data.draw.blend = blendMode;
             cmd->data.draw.texture = texture;
+            cmd->data.draw.geometry = NULL;
+            cmd->data.draw.size = 0; /* set by SetDrawCommandBounds() when reordering */
         }
     }
     return cmd;
 }
 
+/* Records the pixels a draw may touch, grown by one to allow for rasterization
+   rules and line widths, and the vertex data that has to move along with it. */
+static void SetDrawCommandBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, size_t vertex_start,
+                                 float minx, float miny, float maxx, float maxy)
+{
+    cmd->data.draw.bounds.x = minx - 1.0f;
+    cmd->data.draw.bounds.y = miny - 1.0f;
+    cmd->data.draw.bounds.w = (maxx - minx) + 2.0f;
+    cmd->data.draw.bounds.h = (maxy - miny) + 2.0f;
+
+    /* Backends that keep their vertices somewhere else can't be reordered */
+    if (cmd->data.draw.first >= vertex_start && cmd->data.draw.first < renderer->vertex_data_used) {
+        cmd->data.draw.size = renderer->vertex_data_used - cmd->data.draw.first;
+    }
+}
+
+static void SetDrawCommandVertexBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, size_t vertex_start,
+                                       const float *xy, int xy_stride, int num_vertices,
+                                       float scale_x, float scale_y)
+{
+    float minx, miny, maxx, maxy;
+    int i;
+
+    if (num_vertices <= 0) {
+        return;
+    }
+
+    minx = maxx = xy[0] * scale_x;
+    miny = maxy = xy[1] * scale_y;
+    for (i = 1; i < num_vertices; ++i) {
+        float x, y;
+
+        xy = (const float *)((const Uint8 *)xy + xy_stride);
+        x = xy[0] * scale_x;
+        y = xy[1] * scale_y;
+        minx = SDL_min(minx, x);
+        miny = SDL_min(miny, y);
+        maxx = SDL_max(maxx, x);
+        maxy = SDL_max(maxy, y);
+    }
+    SetDrawCommandBounds(renderer, cmd, vertex_start, minx, miny, maxx, maxy);
+}
+
+static void SetDrawCommandRectBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, size_t vertex_start,
+                                     const SDL_FRect *rects, int count)
+{
+    float minx, miny, maxx, maxy;
+    int i;
+
+    if (count <= 0) {
+        return;
+    }
+
+    minx = maxx = rects[0].x;
+    miny = maxy = rects[0].y;
+    for (i = 0; i < count; ++i) {
+        const float x1 = rects[i].x, x2 = rects[i].x + rects[i].w;
+        const float y1 = rects[i].y, y2 = rects[i].y + rects[i].h;
+
+        minx = SDL_min(minx, SDL_min(x1, x2));
+        miny = SDL_min(miny, SDL_min(y1, y2));
+        maxx = SDL_max(maxx, SDL_max(x1, x2));
+        maxy = SDL_max(maxy, SDL_max(y1, y2));
+    }
+    SetDrawCommandBounds(renderer, cmd, vertex_start, minx, miny, maxx, maxy);
+}
+
 static int QueueCmdDrawPoints(SDL_Renderer *renderer, const SDL_FPoint *points, const int count)
 {
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_POINTS, NULL);
     int retval = -1;
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
         retval = renderer->QueueDrawPoints(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reordering) {
+            SetDrawCommandVertexBounds(renderer, cmd, vertex_start, &points->x, sizeof(*points), count, 1.0f, 1.0f);
         }
     }
     return retval;
@@ -517,9 +830,12 @@ static int QueueCmdDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points, c
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_LINES, NULL);
     int retval = -1;
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
         retval = renderer->QueueDrawLines(renderer, cmd, points, count);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reordering) {
+            SetDrawCommandVertexBounds(renderer, cmd, vertex_start, &points->x, sizeof(*points), count, 1.0f, 1.0f);
         }
     }
     return retval;
@@ -534,6 +850,8 @@ static int QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, con
     cmd = PrepQueueCmdDraw(renderer, (use_rendergeometry ? SDL_RENDERCMD_GEOMETRY : SDL_RENDERCMD_FILL_RECTS), NULL);
 
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
+
         if (use_rendergeometry) {
             SDL_bool isstack1;
             SDL_bool isstack2;
@@ -595,6 +913,9 @@ static int QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, con
                 cmd->command = SDL_RENDERCMD_NO_OP;
             }
         }
+        if (retval == 0 && renderer->reordering) {
+            SetDrawCommandRectBounds(renderer, cmd, vertex_start, rects, count);
+        }
     }
     return retval;
 }
@@ -604,9 +925,12 @@ static int QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY, texture);
     int retval = -1;
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
         retval = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reordering) {
+            SetDrawCommandRectBounds(renderer, cmd, vertex_start, dstrect, 1);
         }
     }
     return retval;
@@ -619,9 +943,22 @@ static int QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture *texture,
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY_EX, texture);
     int retval = -1;
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
         retval = renderer->QueueCopyEx(renderer, cmd, texture, srcquad, dstrect, angle, center, flip, scale_x, scale_y);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reordering) {
+            /* Any rotation stays within the circle around the center through the farthest corner */
+            const float dx = SDL_max(SDL_fabsf(center->x), SDL_fabsf(dstrect->w - center->x));
+            const float dy = SDL_max(SDL_fabsf(center->y), SDL_fabsf(dstrect->h - center->y));
+            const float radius = SDL_sqrtf(dx * dx + dy * dy);
+            float xy[4];
+
+            xy[0] = dstrect->x + center->x - radius;
+            xy[1] = dstrect->y + center->y - radius;
+            xy[2] = dstrect->x + center->x + radius;
+            xy[3] = dstrect->y + center->y + radius;
+            SetDrawCommandVertexBounds(renderer, cmd, vertex_start, xy, 2 * sizeof(float), 2, scale_x, scale_y);
         }
     }
     return retval;
@@ -639,6 +976,7 @@ static int QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
     int retval = -1;
     cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
     if (cmd != NULL) {
+        const size_t vertex_start = renderer->vertex_data_used;
         retval = renderer->QueueGeometry(renderer, cmd, texture,
                                          xy, xy_stride,
                                          color, color_stride, uv, uv_stride,
@@ -646,6 +984,8 @@ static int QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
                                          scale_x, scale_y);
         if (retval < 0) {
             cmd->command = SDL_RENDERCMD_NO_OP;
+        } else if (renderer->reordering) {
+            SetDrawCommandVertexBounds(renderer, cmd, vertex_start, xy, xy_stride, num_vertices, scale_x, scale_y);
         }
     }
     return retval;
@@ -886,6 +1226,7 @@ SDL_Renderer *SDL_CreateRenderer(SDL_Window *window, const char *name, Uint32 fl
     }
 
     renderer->batching = batching;
+    renderer->reordering = batching && SDL_GetHintBoolean(SDL_HINT_RENDER_REORDERING, SDL_FALSE);
     renderer->magic = &renderer_magic;
     renderer->window = window;
     renderer->target_mutex = SDL_CreateMutex();
@@ -955,6 +1296,7 @@ SDL_Renderer *SDL_CreateSoftwareRenderer(SDL_Surface *surface)
 
     if (renderer) {
         VerifyDrawQueueFunctions(renderer);
+        renderer->batching = renderer->always_batch;
         renderer->magic = &renderer_magic;
         renderer->target_mutex = SDL_CreateMutex();
         renderer->main_view.pixel_w = surface->w;
@@ -1001,6 +1343,18 @@ int SDL_GetRendererInfo(SDL_Renderer *renderer, SDL_RendererInfo *info)
     return 0;
 }
 
+int SDL_GetRenderStats(SDL_Renderer *renderer, SDL_RenderStats *stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (stats == NULL) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_copyp(stats, &renderer->last_stats);
+    return 0;
+}
+
 int SDL_GetRenderWindowSize(SDL_Renderer *renderer, int *w, int *h)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
@@ -1083,6 +1437,15 @@ static Uint32 GetClosestSupportedFormat(SDL_Renderer *renderer, Uint32 format)
                 return renderer->info.texture_formats[i];
             }
         }
+
+        /* Keep the extra precision of 10-bit YUV formats if we can */
+        if (format == SDL_PIXELFORMAT_P010 || format == SDL_PIXELFORMAT_P016) {
+            for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+                if (renderer->info.texture_formats[i] == SDL_PIXELFORMAT_ARGB2101010) {
+                    return renderer->info.texture_formats[i];
+                }
+            }
+        }
     } else {
         SDL_bool hasAlpha = SDL_ISPIXELFORMAT_ALPHA(format);
 
@@ -1518,6 +1881,20 @@ void *SDL_GetTextureUserData(SDL_Texture *texture)
     return texture->userdata;
 }
 
+static void AddTextureUploadStats(SDL_Texture *texture, const SDL_Rect *rect)
+{
+    size_t size;
+
+    if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+        if (SDL_CalculateYUVSize(texture->format, rect->w, rect->h, &size, NULL) < 0) {
+            return;
+        }
+    } else {
+        size = (size_t)rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
+    }
+    texture->renderer->stats.texture_bytes += size;
+}
+
 #if SDL_HAVE_YUV
 static int SDL_UpdateTextureYUV(SDL_Texture *texture, const SDL_Rect *rect,
                                 const void *pixels, int pitch)
@@ -1641,6 +2018,7 @@ int SDL_UpdateTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *pi
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        AddTextureUploadStats(texture, &real_rect);
         return renderer->UpdateTexture(renderer, texture, &real_rect, pixels, pitch);
     }
 }
@@ -1806,6 +2184,7 @@ int SDL_UpdateYUVTexture(SDL_Texture *texture, const SDL_Rect *rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            AddTextureUploadStats(texture, &real_rect);
             return renderer->UpdateTextureYUV(renderer, texture, &real_rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1840,8 +2219,10 @@ int SDL_UpdateNVTexture(SDL_Texture *texture, const SDL_Rect *rect,
     }
 
     if (texture->format != SDL_PIXELFORMAT_NV12 &&
-        texture->format != SDL_PIXELFORMAT_NV21) {
-        return SDL_SetError("Texture format must by NV12 or NV21");
+        texture->format != SDL_PIXELFORMAT_NV21 &&
+        texture->format != SDL_PIXELFORMAT_P010 &&
+        texture->format != SDL_PIXELFORMAT_P016) {
+        return SDL_SetError("Texture format must by NV12, NV21, P010 or P016");
     }
 
     real_rect.x = 0;
@@ -1866,6 +2247,7 @@ int SDL_UpdateNVTexture(SDL_Texture *texture, const SDL_Rect *rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            AddTextureUploadStats(texture, &real_rect);
             return renderer->UpdateTextureNV(renderer, texture, &real_rect, Yplane, Ypitch, UVplane, UVpitch);
         } else {
             return SDL_Unsupported();
@@ -1929,6 +2311,7 @@ int SDL_LockTexture(SDL_Texture *texture, const SDL_Rect *rect, void **pixels, i
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        texture->locked_rect = *rect;
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -2025,6 +2408,7 @@ void SDL_UnlockTexture(SDL_Texture *texture)
         SDL_UnlockTextureNative(texture);
     } else {
         SDL_Renderer *renderer = texture->renderer;
+        AddTextureUploadStats(texture, &texture->locked_rect);
         renderer->UnlockTexture(renderer, texture);
     }
 
@@ -2712,13 +3096,14 @@ int SDL_RenderLine(SDL_Renderer *renderer, float x1, float y1, float x2, float y
 static int RenderLineBresenham(SDL_Renderer *renderer, int x1, int y1, int x2, int y2, SDL_bool draw_last)
 {
     const int MAX_PIXELS = SDL_max(renderer->view->pixel_w, renderer->view->pixel_h) * 4;
-    int i, deltax, deltay, numpixels;
+    int i, deltax, deltay, numpixels, numpoints;
     int d, dinc1, dinc2;
     int x, xinc1, xinc2;
     int y, yinc1, yinc2;
     int retval;
     SDL_bool isstack;
     SDL_FPoint *points;
+    SDL_FRect viewport;
 
     deltax = SDL_abs(x2 - x1);
     deltay = SDL_abs(y2 - y1);
@@ -2767,9 +3152,16 @@ static int RenderLineBresenham(SDL_Renderer *renderer, int x1, int y1, int x2, i
     if (points == NULL) {
         return SDL_OutOfMemory();
     }
+    /* Pixels outside of the viewport are never drawn, so leave them out of
+       the queue instead of having the backend clip them. */
+    GetRenderViewportSize(renderer, &viewport);
+    numpoints = 0;
     for (i = 0; i < numpixels; ++i) {
-        points[i].x = (float)x;
-        points[i].y = (float)y;
+        if (x >= 0 && y >= 0 && x < viewport.w && y < viewport.h) {
+            points[numpoints].x = (float)x;
+            points[numpoints].y = (float)y;
+            ++numpoints;
+        }
 
         if (d < 0) {
             d += dinc1;
@@ -2782,10 +3174,12 @@ static int RenderLineBresenham(SDL_Renderer *renderer, int x1, int y1, int x2, i
         }
     }
 
-    if (renderer->view->scale.x != 1.0f || renderer->view->scale.y != 1.0f) {
-        retval = RenderPointsWithRects(renderer, points, numpixels);
+    if (numpoints == 0) {
+        retval = 0;
+    } else if (renderer->view->scale.x != 1.0f || renderer->view->scale.y != 1.0f) {
+        retval = RenderPointsWithRects(renderer, points, numpoints);
     } else {
-        retval = QueueCmdDrawPoints(renderer, points, numpixels);
+        retval = QueueCmdDrawPoints(renderer, points, numpoints);
     }
 
     SDL_small_free(points, isstack);
@@ -3387,6 +3781,265 @@ int SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+void SDL_GetTextureBatchItemCorners(const SDL_TextureBatchItem *item, float scale_x, float scale_y, float *xy)
+{
+    const SDL_FRect *dstrect = &item->dstrect;
+    float minx, miny, maxx, maxy;
+    int i;
+
+    if (item->flip & SDL_FLIP_HORIZONTAL) {
+        minx = dstrect->x + dstrect->w;
+        maxx = dstrect->x;
+    } else {
+        minx = dstrect->x;
+        maxx = dstrect->x + dstrect->w;
+    }
+
+    if (item->flip & SDL_FLIP_VERTICAL) {
+        miny = dstrect->y + dstrect->h;
+        maxy = dstrect->y;
+    } else {
+        miny = dstrect->y;
+        maxy = dstrect->y + dstrect->h;
+    }
+
+    xy[0] = minx;
+    xy[1] = miny;
+    xy[2] = maxx;
+    xy[3] = miny;
+    xy[4] = maxx;
+    xy[5] = maxy;
+    xy[6] = minx;
+    xy[7] = maxy;
+
+    if (item->angle != 0.0) {
+        /* apply rotation with 2x2 matrix ( c -s ) around the center of dstrect
+         *                                ( s  c ) */
+        const float radian_angle = (float)((SDL_PI_D * item->angle) / 180.0);
+        const float s = SDL_sinf(radian_angle);
+        const float c = SDL_cosf(radian_angle);
+        const float centerx = dstrect->x + dstrect->w / 2.0f;
+        const float centery = dstrect->y + dstrect->h / 2.0f;
+
+        for (i = 0; i < 8; i += 2) {
+            const float x = xy[i] - centerx;
+            const float y = xy[i + 1] - centery;
+            xy[i] = (c * x - s * y) + centerx;
+            xy[i + 1] = (s * x + c * y) + centery;
+        }
+    }
+
+    for (i = 0; i < 8; i += 2) {
+        xy[i] *= scale_x;
+        xy[i + 1] *= scale_y;
+    }
+}
+
+void SDL_GetTextureBatchItemColor(const SDL_TextureBatchItem *item, const SDL_Color *texture_color, SDL_Color *color)
+{
+    color->r = (Uint8)(((int)item->color.r * texture_color->r) / 255);
+    color->g = (Uint8)(((int)item->color.g * texture_color->g) / 255);
+    color->b = (Uint8)(((int)item->color.b * texture_color->b) / 255);
+    color->a = (Uint8)(((int)item->color.a * texture_color->a) / 255);
+}
+
+static void SetDrawCommandBatchBounds(SDL_Renderer *renderer, SDL_RenderCommand *cmd, size_t vertex_start,
+                                      const SDL_TextureBatchItem *items, int count)
+{
+    float minx = 0.0f, miny = 0.0f, maxx = 0.0f, maxy = 0.0f;
+    int i, j;
+
+    for (i = 0; i < count; ++i) {
+        float xy[8];
+
+        SDL_GetTextureBatchItemCorners(&items[i], renderer->view->scale.x, renderer->view->scale.y, xy);
+        if (i == 0) {
+            minx = maxx = xy[0];
+            miny = maxy = xy[1];
+        }
+        for (j = 0; j < 8; j += 2) {
+            minx = SDL_min(minx, xy[j]);
+            miny = SDL_min(miny, xy[j + 1]);
+            maxx = SDL_max(maxx, xy[j]);
+            maxy = SDL_max(maxy, xy[j + 1]);
+        }
+    }
+    SetDrawCommandBounds(renderer, cmd, vertex_start, minx, miny, maxx, maxy);
+}
+
+/* How many items of SDL_RenderTextures() go in one command */
+#define TEXTURE_BATCH_CHUNK 4096
+
+/* Draws the batch as a single list of triangles, for the renderers without QueueCopies() */
+static int QueueCmdGeometryBatch(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_TextureBatchItem *items, int count)
+{
+    const int xy_stride = 2 * sizeof(float);
+    const int uv_stride = 2 * sizeof(float);
+    const int size_indices = 4;
+    const int *rect_index_order = renderer->rect_index_order;
+    float *xy, *uv;
+    SDL_Color *colors;
+    int *indices;
+    int i, retval;
+
+    xy = (float *)SDL_malloc(count * (8 * sizeof(*xy) + 8 * sizeof(*uv) + 4 * sizeof(*colors) + 6 * sizeof(*indices)));
+    if (xy == NULL) {
+        return SDL_OutOfMemory();
+    }
+    uv = xy + 8 * count;
+    colors = (SDL_Color *)(uv + 8 * count);
+    indices = (int *)(colors + 4 * count);
+
+    for (i = 0; i < count; i++) {
+        const SDL_TextureBatchItem *item = &items[i];
+        const float minu = item->srcrect.x / texture->w;
+        const float minv = item->srcrect.y / texture->h;
+        const float maxu = (item->srcrect.x + item->srcrect.w) / texture->w;
+        const float maxv = (item->srcrect.y + item->srcrect.h) / texture->h;
+        float *uv_ = &uv[8 * i];
+        int *indices_ = &indices[6 * i];
+        SDL_Color *colors_ = &colors[4 * i];
+
+        SDL_GetTextureBatchItemCorners(item, 1.0f, 1.0f, &xy[8 * i]);
+
+        uv_[0] = minu;
+        uv_[1] = minv;
+        uv_[2] = maxu;
+        uv_[3] = minv;
+        uv_[4] = maxu;
+        uv_[5] = maxv;
+        uv_[6] = minu;
+        uv_[7] = maxv;
+
+        SDL_GetTextureBatchItemColor(item, &texture->color, &colors_[0]);
+        colors_[1] = colors_[2] = colors_[3] = colors_[0];
+
+        indices_[0] = 4 * i + rect_index_order[0];
+        indices_[1] = 4 * i + rect_index_order[1];
+        indices_[2] = 4 * i + rect_index_order[2];
+        indices_[3] = 4 * i + rect_index_order[3];
+        indices_[4] = 4 * i + rect_index_order[4];
+        indices_[5] = 4 * i + rect_index_order[5];
+    }
+
+    retval = QueueCmdGeometry(renderer, texture,
+                              xy, xy_stride, colors, sizeof(*colors), uv, uv_stride,
+                              4 * count,
+                              indices, 6 * count, size_indices,
+                              renderer->view->scale.x,
+                              renderer->view->scale.y);
+    SDL_free(xy);
+    return retval;
+}
+
+static int QueueCmdTextureBatch(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_TextureBatchItem *items, int count)
+{
+    SDL_RenderCommand *cmd;
+    int retval;
+
+    if (renderer->QueueCopies) {
+        /* The renderer turns this into whichever draw command it runs the batch with */
+        cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
+        retval = -1;
+        if (cmd != NULL) {
+            const size_t vertex_start = renderer->vertex_data_used;
+            retval = renderer->QueueCopies(renderer, cmd, texture, items, count,
+                                           renderer->view->scale.x,
+                                           renderer->view->scale.y);
+            if (retval < 0) {
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            } else if (renderer->reordering) {
+                SetDrawCommandBatchBounds(renderer, cmd, vertex_start, items, count);
+            }
+        }
+    } else {
+        retval = QueueCmdGeometryBatch(renderer, texture, items, count);
+    }
+    return retval;
+}
+
+int SDL_RenderTextures(SDL_Renderer *renderer, SDL_Texture *texture,
+                       const SDL_TextureBatchItem *items, int count)
+{
+    SDL_TextureBatchItem *clipped = NULL;
+    SDL_FRect bounds;
+    int retval = 0;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (renderer != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+    if (items == NULL) {
+        return SDL_InvalidParamError("items");
+    }
+    if (count <= 0) {
+        return 0;
+    }
+    if (!renderer->QueueCopies && !renderer->QueueGeometry) {
+        return SDL_SetError("Renderer does not support RenderTextures");
+    }
+
+#if DONT_DRAW_WHILE_HIDDEN
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+#endif
+
+    bounds.x = 0.0f;
+    bounds.y = 0.0f;
+    bounds.w = (float)texture->w;
+    bounds.h = (float)texture->h;
+
+    if (texture->native) {
+        texture = texture->native;
+    }
+
+    texture->last_command_generation = renderer->render_command_generation;
+
+    /* Queue a command for each chunk of items, so the vertex sizes the renderers compute can't overflow */
+    while (count > 0 && retval == 0) {
+        const int chunk = SDL_min(count, TEXTURE_BATCH_CHUNK);
+        int i, n;
+
+        for (i = 0; i < chunk; ++i) {
+            const SDL_FRect *srcrect = &items[i].srcrect;
+            if (srcrect->x < 0.0f || srcrect->y < 0.0f || srcrect->w <= 0.0f || srcrect->h <= 0.0f ||
+                srcrect->x + srcrect->w > bounds.w || srcrect->y + srcrect->h > bounds.h) {
+                break;
+            }
+        }
+        if (i == chunk) {
+            retval = QueueCmdTextureBatch(renderer, texture, items, chunk);
+        } else {
+            /* Clip the source rects to the texture as SDL_RenderTextureRotated() does, dropping the empty ones */
+            if (clipped == NULL) {
+                clipped = (SDL_TextureBatchItem *)SDL_malloc(TEXTURE_BATCH_CHUNK * sizeof(*clipped));
+                if (clipped == NULL) {
+                    return SDL_OutOfMemory();
+                }
+            }
+            SDL_memcpy(clipped, items, i * sizeof(*clipped));
+            for (n = i; i < chunk; ++i) {
+                clipped[n] = items[i];
+                if (SDL_GetRectIntersectionFloat(&items[i].srcrect, &bounds, &clipped[n].srcrect)) {
+                    ++n;
+                }
+            }
+            if (n > 0) {
+                retval = QueueCmdTextureBatch(renderer, texture, clipped, n);
+            }
+        }
+        items += chunk;
+        count -= chunk;
+    }
+    SDL_free(clipped);
+
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int SDL_RenderGeometry(SDL_Renderer *renderer,
                        SDL_Texture *texture,
                        const SDL_Vertex *vertices, int num_vertices,
@@ -3467,31 +4120,235 @@ static int remap_indices(
 }
 
 #define DEBUG_SW_RENDER_GEOMETRY 0
-/* For the software renderer, try to reinterpret triangles as SDL_Rect */
-static int SDLCALL SDL_SW_RenderGeometryRaw(SDL_Renderer *renderer,
-                                            SDL_Texture *texture,
-                                            const float *xy, int xy_stride,
-                                            const SDL_Color *color, int color_stride,
-                                            const float *uv, int uv_stride,
-                                            int num_vertices,
-                                            const void *indices, int num_indices, int size_indices)
-{
-    int i;
-    int retval = 0;
-    int count = indices ? num_indices : num_vertices;
-    int prev[3]; /* Previous triangle vertex indices */
-    int texw = 0, texh = 0;
-    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
-    Uint8 r = 0, g = 0, b = 0, a = 0;
+/* Checks if the triangle k0, k1, k2 and the triangle before it form an axis
+   aligned, uniformly colored rectangle, and finds its top left and bottom
+   right vertices. */
+static SDL_bool SDL_SW_IsGeometryRect(const int prev[3], int k0, int k1, int k2,
+                                      const float *xy, int xy_stride,
+                                      const SDL_Color *color, int color_stride,
+                                      int *top_left, int *bottom_right)
+{
+    int A = -1;  /* Top left vertex */
+    int B = -1;  /* Bottom right vertex */
+    int C = -1;  /* Third vertex of current triangle */
+    int C2 = -1; /* Last, vertex of previous triangle */
+    const float *xy0_, *xy1_, *xy2_;
+    float x0, x1, x2;
+    float y0, y1, y2;
+
+    /* Two triangles forming a quadialateral,
+     * prev and current triangles must have exactly 2 common vertices */
+    {
+        int cnt = 0, j = 3;
+        while (j--) {
+            int p = prev[j];
+            if (p == k0 || p == k1 || p == k2) {
+                cnt++;
+            }
+        }
+        if (cnt != 2) {
+            return SDL_FALSE;
+        }
+    }
 
-    /* Save */
-    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
-    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    /* Identify vertices */
+    xy0_ = (const float *)((const char *)xy + k0 * xy_stride);
+    xy1_ = (const float *)((const char *)xy + k1 * xy_stride);
+    xy2_ = (const float *)((const char *)xy + k2 * xy_stride);
+    x0 = xy0_[0];
+    y0 = xy0_[1];
+    x1 = xy1_[0];
+    y1 = xy1_[1];
+    x2 = xy2_[0];
+    y2 = xy2_[1];
+
+    /* Find top-left */
+    if (x0 <= x1 && y0 <= y1) {
+        if (x0 <= x2 && y0 <= y2) {
+            A = k0;
+        } else {
+            A = k2;
+        }
+    } else {
+        if (x1 <= x2 && y1 <= y2) {
+            A = k1;
+        } else {
+            A = k2;
+        }
+    }
+
+    /* Find bottom-right */
+    if (x0 >= x1 && y0 >= y1) {
+        if (x0 >= x2 && y0 >= y2) {
+            B = k0;
+        } else {
+            B = k2;
+        }
+    } else {
+        if (x1 >= x2 && y1 >= y2) {
+            B = k1;
+        } else {
+            B = k2;
+        }
+    }
+
+    /* Find C */
+    if (k0 != A && k0 != B) {
+        C = k0;
+    } else if (k1 != A && k1 != B) {
+        C = k1;
+    } else {
+        C = k2;
+    }
+
+    /* Find C2 */
+    if (prev[0] != A && prev[0] != B) {
+        C2 = prev[0];
+    } else if (prev[1] != A && prev[1] != B) {
+        C2 = prev[1];
+    } else {
+        C2 = prev[2];
+    }
+
+    xy0_ = (const float *)((const char *)xy + A * xy_stride);
+    xy1_ = (const float *)((const char *)xy + B * xy_stride);
+    xy2_ = (const float *)((const char *)xy + C * xy_stride);
+    x0 = xy0_[0];
+    y0 = xy0_[1];
+    x1 = xy1_[0];
+    y1 = xy1_[1];
+    x2 = xy2_[0];
+    y2 = xy2_[1];
+
+    /* Check if triangle A B C is rectangle */
+    if ((x0 == x2 && y1 == y2) || (y0 == y2 && x1 == x2)) {
+        /* ok */
+    } else {
+#if DEBUG_SW_RENDER_GEOMETRY
+        SDL_Log("Triangle %d %d %d is not a rectangle", k0, k1, k2);
+#endif
+        return SDL_FALSE;
+    }
+
+    xy2_ = (const float *)((const char *)xy + C2 * xy_stride);
+    x2 = xy2_[0];
+    y2 = xy2_[1];
+
+    /* Check if triangle A B C2 is rectangle */
+    if ((x0 == x2 && y1 == y2) || (y0 == y2 && x1 == x2)) {
+        /* ok */
+    } else {
+#if DEBUG_SW_RENDER_GEOMETRY
+        SDL_Log("Triangle %d %d %d is not a rectangle", prev[0], prev[1], prev[2]);
+#endif
+        return SDL_FALSE;
+    }
+
+    /* Check if uniformly colored */
+    {
+        const int col0_ = *(const int *)((const char *)color + A * color_stride);
+        const int col1_ = *(const int *)((const char *)color + B * color_stride);
+        const int col2_ = *(const int *)((const char *)color + C * color_stride);
+        const int col3_ = *(const int *)((const char *)color + C2 * color_stride);
+        if (col0_ == col1_ && col0_ == col2_ && col0_ == col3_) {
+            /* ok */
+        } else {
+#if DEBUG_SW_RENDER_GEOMETRY
+            SDL_Log("Quad %d %d %d %d is not uniformly colored", A, B, C, C2);
+#endif
+            return SDL_FALSE;
+        }
+    }
+
+    *top_left = A;
+    *bottom_right = B;
+    return SDL_TRUE;
+}
+
+/* Draws a rect found by SDL_SW_IsGeometryRect(), from its top left and bottom
+   right vertex positions and texture coordinates. This changes the draw color
+   and blend mode of the renderer, and the color and alpha mod of the texture. */
+static void SDL_SW_RenderGeometryRect(SDL_Renderer *renderer, SDL_Texture *texture,
+                                      const float *xy0_, const float *xy1_,
+                                      const float *uv0_, const float *uv1_,
+                                      SDL_Color col0_)
+{
+    SDL_FRect s;
+    SDL_FRect d;
 
     if (texture) {
-        SDL_QueryTexture(texture, NULL, NULL, &texw, &texh);
+        s.x = uv0_[0] * texture->w;
+        s.y = uv0_[1] * texture->h;
+        s.w = uv1_[0] * texture->w - s.x;
+        s.h = uv1_[1] * texture->h - s.y;
+    } else {
+        s.x = s.y = s.w = s.h = 0;
     }
 
+    d.x = xy0_[0];
+    d.y = xy0_[1];
+    d.w = xy1_[0] - d.x;
+    d.h = xy1_[1] - d.y;
+
+    /* Rect + texture */
+    if (texture && s.w != 0 && s.h != 0) {
+        SDL_SetTextureAlphaMod(texture, col0_.a);
+        SDL_SetTextureColorMod(texture, col0_.r, col0_.g, col0_.b);
+        if (s.w > 0 && s.h > 0) {
+            SDL_RenderTexture(renderer, texture, &s, &d);
+        } else {
+            int flags = 0;
+            if (s.w < 0) {
+                flags |= SDL_FLIP_HORIZONTAL;
+                s.w *= -1;
+                s.x -= s.w;
+            }
+            if (s.h < 0) {
+                flags |= SDL_FLIP_VERTICAL;
+                s.h *= -1;
+                s.y -= s.h;
+            }
+            SDL_RenderTextureRotated(renderer, texture, &s, &d, 0, NULL, flags);
+        }
+
+#if DEBUG_SW_RENDER_GEOMETRY
+        SDL_Log("Rect-COPY: RGB %d %d %d - Alpha:%d - texture=%p: src=(%f,%f, %f x %f) dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
+                (void *)texture, s.x, s.y, s.w, s.h, d.x, d.y, d.w, d.h);
+#endif
+    } else if (d.w != 0.0f && d.h != 0.0f) { /* Rect, no texture */
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, col0_.r, col0_.g, col0_.b, col0_.a);
+        SDL_RenderFillRect(renderer, &d);
+#if DEBUG_SW_RENDER_GEOMETRY
+        SDL_Log("Rect-FILL: RGB %d %d %d - Alpha:%d - texture=%p: dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
+                (void *)texture, d.x, d.y, d.w, d.h);
+    } else {
+        SDL_Log("Rect-DISMISS: RGB %d %d %d - Alpha:%d - texture=%p: src=(%f,%f, %f x %f) dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
+                (void *)texture, s.x, s.y, s.w, s.h, d.x, d.y, d.w, d.h);
+#endif
+    }
+}
+
+/* For the software renderer, try to reinterpret triangles as SDL_Rect */
+static int SDLCALL SDL_SW_RenderGeometryRaw(SDL_Renderer *renderer,
+                                            SDL_Texture *texture,
+                                            const float *xy, int xy_stride,
+                                            const SDL_Color *color, int color_stride,
+                                            const float *uv, int uv_stride,
+                                            int num_vertices,
+                                            const void *indices, int num_indices, int size_indices)
+{
+    int i;
+    int retval = 0;
+    int count = indices ? num_indices : num_vertices;
+    int prev[3]; /* Previous triangle vertex indices */
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+
+    /* Save */
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+
     prev[0] = -1;
     prev[1] = -1;
     prev[2] = -1;
@@ -3499,15 +4356,8 @@ static int SDLCALL SDL_SW_RenderGeometryRaw(SDL_Renderer *renderer,
 
     for (i = 0; i < count; i += 3) {
         int k0, k1, k2; /* Current triangle indices */
-        int is_quad = 1;
-#if DEBUG_SW_RENDER_GEOMETRY
-        int is_uniform = 1;
-        int is_rectangle = 1;
-#endif
-        int A = -1;  /* Top left vertex */
-        int B = -1;  /* Bottom right vertex */
-        int C = -1;  /* Third vertex of current triangle */
-        int C2 = -1; /* Last, vertex of previous triangle */
+        int A = -1;     /* Top left vertex */
+        int B = -1;     /* Bottom right vertex */
 
         if (size_indices == 4) {
             k0 = ((const Uint32 *)indices)[i];
@@ -3536,203 +4386,25 @@ static int SDLCALL SDL_SW_RenderGeometryRaw(SDL_Renderer *renderer,
             continue;
         }
 
-        /* Two triangles forming a quadialateral,
-         * prev and current triangles must have exactly 2 common vertices */
-        {
-            int cnt = 0, j = 3;
-            while (j--) {
-                int p = prev[j];
-                if (p == k0 || p == k1 || p == k2) {
-                    cnt++;
-                }
-            }
-            is_quad = (cnt == 2);
-        }
-
-        /* Identify vertices */
-        if (is_quad) {
-            const float *xy0_, *xy1_, *xy2_;
-            float x0, x1, x2;
-            float y0, y1, y2;
-            xy0_ = (const float *)((const char *)xy + k0 * xy_stride);
-            xy1_ = (const float *)((const char *)xy + k1 * xy_stride);
-            xy2_ = (const float *)((const char *)xy + k2 * xy_stride);
-            x0 = xy0_[0];
-            y0 = xy0_[1];
-            x1 = xy1_[0];
-            y1 = xy1_[1];
-            x2 = xy2_[0];
-            y2 = xy2_[1];
-
-            /* Find top-left */
-            if (x0 <= x1 && y0 <= y1) {
-                if (x0 <= x2 && y0 <= y2) {
-                    A = k0;
-                } else {
-                    A = k2;
-                }
-            } else {
-                if (x1 <= x2 && y1 <= y2) {
-                    A = k1;
-                } else {
-                    A = k2;
-                }
-            }
-
-            /* Find bottom-right */
-            if (x0 >= x1 && y0 >= y1) {
-                if (x0 >= x2 && y0 >= y2) {
-                    B = k0;
-                } else {
-                    B = k2;
-                }
-            } else {
-                if (x1 >= x2 && y1 >= y2) {
-                    B = k1;
-                } else {
-                    B = k2;
-                }
-            }
-
-            /* Find C */
-            if (k0 != A && k0 != B) {
-                C = k0;
-            } else if (k1 != A && k1 != B) {
-                C = k1;
-            } else {
-                C = k2;
-            }
-
-            /* Find C2 */
-            if (prev[0] != A && prev[0] != B) {
-                C2 = prev[0];
-            } else if (prev[1] != A && prev[1] != B) {
-                C2 = prev[1];
-            } else {
-                C2 = prev[2];
-            }
-
-            xy0_ = (const float *)((const char *)xy + A * xy_stride);
-            xy1_ = (const float *)((const char *)xy + B * xy_stride);
-            xy2_ = (const float *)((const char *)xy + C * xy_stride);
-            x0 = xy0_[0];
-            y0 = xy0_[1];
-            x1 = xy1_[0];
-            y1 = xy1_[1];
-            x2 = xy2_[0];
-            y2 = xy2_[1];
-
-            /* Check if triangle A B C is rectangle */
-            if ((x0 == x2 && y1 == y2) || (y0 == y2 && x1 == x2)) {
-                /* ok */
-            } else {
-                is_quad = 0;
-#if DEBUG_SW_RENDER_GEOMETRY
-                is_rectangle = 0;
-#endif
-            }
-
-            xy2_ = (const float *)((const char *)xy + C2 * xy_stride);
-            x2 = xy2_[0];
-            y2 = xy2_[1];
-
-            /* Check if triangle A B C2 is rectangle */
-            if ((x0 == x2 && y1 == y2) || (y0 == y2 && x1 == x2)) {
-                /* ok */
-            } else {
-                is_quad = 0;
-#if DEBUG_SW_RENDER_GEOMETRY
-                is_rectangle = 0;
-#endif
-            }
-        }
-
-        /* Check if uniformly colored */
-        if (is_quad) {
-            const int col0_ = *(const int *)((const char *)color + A * color_stride);
-            const int col1_ = *(const int *)((const char *)color + B * color_stride);
-            const int col2_ = *(const int *)((const char *)color + C * color_stride);
-            const int col3_ = *(const int *)((const char *)color + C2 * color_stride);
-            if (col0_ == col1_ && col0_ == col2_ && col0_ == col3_) {
-                /* ok */
-            } else {
-                is_quad = 0;
-#if DEBUG_SW_RENDER_GEOMETRY
-                is_uniform = 0;
-#endif
-            }
-        }
-
         /* Start rendering rect */
-        if (is_quad) {
-            SDL_FRect s;
-            SDL_FRect d;
-            const float *xy0_, *xy1_, *uv0_, *uv1_;
-            SDL_Color col0_ = *(const SDL_Color *)((const char *)color + k0 * color_stride);
-
-            xy0_ = (const float *)((const char *)xy + A * xy_stride);
-            xy1_ = (const float *)((const char *)xy + B * xy_stride);
+        if (SDL_SW_IsGeometryRect(prev, k0, k1, k2, xy, xy_stride, color, color_stride, &A, &B)) {
+            const float *uv0_ = NULL, *uv1_ = NULL;
 
             if (texture) {
                 uv0_ = (const float *)((const char *)uv + A * uv_stride);
                 uv1_ = (const float *)((const char *)uv + B * uv_stride);
-                s.x = uv0_[0] * texw;
-                s.y = uv0_[1] * texh;
-                s.w = uv1_[0] * texw - s.x;
-                s.h = uv1_[1] * texh - s.y;
-            } else {
-                s.x = s.y = s.w = s.h = 0;
-            }
-
-            d.x = xy0_[0];
-            d.y = xy0_[1];
-            d.w = xy1_[0] - d.x;
-            d.h = xy1_[1] - d.y;
-
-            /* Rect + texture */
-            if (texture && s.w != 0 && s.h != 0) {
-                SDL_SetTextureAlphaMod(texture, col0_.a);
-                SDL_SetTextureColorMod(texture, col0_.r, col0_.g, col0_.b);
-                if (s.w > 0 && s.h > 0) {
-                    SDL_RenderTexture(renderer, texture, &s, &d);
-                } else {
-                    int flags = 0;
-                    if (s.w < 0) {
-                        flags |= SDL_FLIP_HORIZONTAL;
-                        s.w *= -1;
-                        s.x -= s.w;
-                    }
-                    if (s.h < 0) {
-                        flags |= SDL_FLIP_VERTICAL;
-                        s.h *= -1;
-                        s.y -= s.h;
-                    }
-                    SDL_RenderTextureRotated(renderer, texture, &s, &d, 0, NULL, flags);
-                }
-
-#if DEBUG_SW_RENDER_GEOMETRY
-                SDL_Log("Rect-COPY: RGB %d %d %d - Alpha:%d - texture=%p: src=(%d,%d, %d x %d) dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
-                        (void *)texture, s.x, s.y, s.w, s.h, d.x, d.y, d.w, d.h);
-#endif
-            } else if (d.w != 0.0f && d.h != 0.0f) { /* Rect, no texture */
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-                SDL_SetRenderDrawColor(renderer, col0_.r, col0_.g, col0_.b, col0_.a);
-                SDL_RenderFillRect(renderer, &d);
-#if DEBUG_SW_RENDER_GEOMETRY
-                SDL_Log("Rect-FILL: RGB %d %d %d - Alpha:%d - texture=%p: dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
-                        (void *)texture, d.x, d.y, d.w, d.h);
-            } else {
-                SDL_Log("Rect-DISMISS: RGB %d %d %d - Alpha:%d - texture=%p: src=(%d,%d, %d x %d) dst (%f, %f, %f x %f)", col0_.r, col0_.g, col0_.b, col0_.a,
-                        (void *)texture, s.x, s.y, s.w, s.h, d.x, d.y, d.w, d.h);
-#endif
             }
-
+            SDL_SW_RenderGeometryRect(renderer, texture,
+                                      (const float *)((const char *)xy + A * xy_stride),
+                                      (const float *)((const char *)xy + B * xy_stride),
+                                      uv0_, uv1_,
+                                      *(const SDL_Color *)((const char *)color + k0 * color_stride));
             prev[0] = -1;
         } else {
             /* Render triangles */
             if (prev[0] != -1) {
 #if DEBUG_SW_RENDER_GEOMETRY
-                SDL_Log("Triangle %d %d %d - is_uniform:%d is_rectangle:%d", prev[0], prev[1], prev[2], is_uniform, is_rectangle);
+                SDL_Log("Triangle %d %d %d", prev[0], prev[1], prev[2]);
 #endif
                 retval = QueueCmdGeometry(renderer, texture,
                                           xy, xy_stride, color, color_stride, uv, uv_stride,
@@ -3890,6 +4562,384 @@ int SDL_RenderGeometryRaw(SDL_Renderer *renderer,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+static void SDL_FreeStaticGeometry(SDL_StaticGeometry *geometry)
+{
+    SDL_free(geometry->xy);
+    SDL_free(geometry->color);
+    SDL_free(geometry->uv);
+    SDL_free(geometry->runs);
+    SDL_free(geometry->transformed_xy);
+    SDL_free(geometry);
+}
+
+/* Adds vertices to the runs of the geometry, joining them to the run before
+   if both are triangles */
+static void SDL_SW_AddGeometryRun(SDL_StaticGeometry *geometry, int first, int count, int top_left, int bottom_right)
+{
+    SDL_StaticGeometryRun *run;
+
+    if (top_left < 0 && geometry->num_runs > 0) {
+        run = &geometry->runs[geometry->num_runs - 1];
+        if (run->top_left < 0 && run->first + run->count == first) {
+            run->count += count;
+            return;
+        }
+    }
+
+    run = &geometry->runs[geometry->num_runs++];
+    run->first = first;
+    run->count = count;
+    run->top_left = top_left;
+    run->bottom_right = bottom_right;
+}
+
+/* Finds the quads SDL_SW_RenderGeometryRaw() would draw as rects, once */
+static int SDL_SW_FindGeometryRects(SDL_StaticGeometry *geometry)
+{
+    const float *xy = geometry->xy;
+    const SDL_Color *color = geometry->color;
+    const float *uv = geometry->uv;
+    const int xy_stride = 2 * sizeof(float);
+    const int color_stride = sizeof(SDL_Color);
+    const int uv_stride = 2 * sizeof(float);
+    SDL_Texture *texture = geometry->textured ? geometry->texture : NULL;
+    int prev[3]; /* Previous triangle vertex indices */
+    int i;
+
+    /* At most one run per triangle */
+    geometry->runs = (SDL_StaticGeometryRun *)SDL_malloc((geometry->num_vertices / 3) * sizeof(*geometry->runs));
+    if (geometry->runs == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    prev[0] = -1;
+    for (i = 0; i < geometry->num_vertices; i += 3) {
+        const int k0 = remap_indices(prev, i, texture, xy, xy_stride, color, color_stride, uv, uv_stride);
+        const int k1 = remap_indices(prev, i + 1, texture, xy, xy_stride, color, color_stride, uv, uv_stride);
+        const int k2 = remap_indices(prev, i + 2, texture, xy, xy_stride, color, color_stride, uv, uv_stride);
+        int A, B;
+
+        if (prev[0] == -1) {
+            prev[0] = k0;
+            prev[1] = k1;
+            prev[2] = k2;
+        } else if (SDL_SW_IsGeometryRect(prev, k0, k1, k2, xy, xy_stride, color, color_stride, &A, &B)) {
+            SDL_SW_AddGeometryRun(geometry, i - 3, 6, A, B);
+            prev[0] = -1;
+        } else {
+            SDL_SW_AddGeometryRun(geometry, i - 3, 3, -1, -1);
+            prev[0] = k0;
+            prev[1] = k1;
+            prev[2] = k2;
+        }
+    }
+    if (prev[0] != -1) {
+        SDL_SW_AddGeometryRun(geometry, i - 3, 3, -1, -1);
+    }
+    return 0;
+}
+
+SDL_StaticGeometry *SDL_CreateStaticGeometry(SDL_Renderer *renderer,
+                                             SDL_Texture *texture,
+                                             const SDL_Vertex *vertices, int num_vertices,
+                                             const int *indices, int num_indices)
+{
+    SDL_StaticGeometry *geometry;
+    int count = indices ? num_indices : num_vertices;
+    int i;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->QueueGeometry) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    if (texture) {
+        CHECK_TEXTURE_MAGIC(texture, NULL);
+
+        if (renderer != texture->renderer) {
+            SDL_SetError("Texture was not created with this renderer");
+            return NULL;
+        }
+    }
+
+    if (vertices == NULL) {
+        SDL_InvalidParamError("vertices");
+        return NULL;
+    }
+
+    if (num_vertices < 0 || count < 0 || count % 3 != 0) {
+        SDL_InvalidParamError(indices ? "num_indices" : "num_vertices");
+        return NULL;
+    }
+
+    if (texture) {
+        for (i = 0; i < num_vertices; ++i) {
+            float u = vertices[i].tex_coord.x;
+            float v = vertices[i].tex_coord.y;
+            if (u < 0.0f || v < 0.0f || u > 1.0f || v > 1.0f) {
+                SDL_SetError("Values of 'uv' out of bounds %f %f at %d/%d", u, v, i, num_vertices);
+                return NULL;
+            }
+        }
+    }
+
+    if (indices) {
+        for (i = 0; i < num_indices; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_vertices) {
+                SDL_SetError("Values of 'indices' out of bounds");
+                return NULL;
+            }
+        }
+    }
+
+    if (texture && texture->native) {
+        texture = texture->native;
+    }
+
+    geometry = (SDL_StaticGeometry *)SDL_calloc(1, sizeof(*geometry));
+    if (geometry == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    geometry->magic = &geometry_magic;
+    geometry->renderer = renderer;
+    geometry->texture = texture;
+    geometry->textured = texture ? SDL_TRUE : SDL_FALSE;
+    geometry->num_vertices = count;
+
+    if (count > 0) {
+        geometry->xy = (float *)SDL_malloc(count * 2 * sizeof(float));
+        geometry->color = (SDL_Color *)SDL_malloc(count * sizeof(SDL_Color));
+        if (texture) {
+            geometry->uv = (float *)SDL_malloc(count * 2 * sizeof(float));
+        }
+        if (!renderer->QueueStaticGeometry) {
+            geometry->transformed_xy = (float *)SDL_malloc(count * 2 * sizeof(float));
+        }
+        if (geometry->xy == NULL || geometry->color == NULL ||
+            (texture && geometry->uv == NULL) ||
+            (!renderer->QueueStaticGeometry && geometry->transformed_xy == NULL)) {
+            SDL_FreeStaticGeometry(geometry);
+            SDL_OutOfMemory();
+            return NULL;
+        }
+    }
+
+    /* Expand the indices, so that drawing doesn't have to */
+    for (i = 0; i < count; ++i) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+
+        geometry->xy[i * 2] = vertex->position.x;
+        geometry->xy[i * 2 + 1] = vertex->position.y;
+        geometry->color[i] = vertex->color;
+        if (texture) {
+            geometry->uv[i * 2] = vertex->tex_coord.x;
+            geometry->uv[i * 2 + 1] = vertex->tex_coord.y;
+        }
+    }
+
+    if (count > 0 && (renderer->info.flags & SDL_RENDERER_SOFTWARE)) {
+        if (SDL_SW_FindGeometryRects(geometry) < 0) {
+            SDL_FreeStaticGeometry(geometry);
+            return NULL;
+        }
+    }
+
+    if (count > 0 && renderer->CreateStaticGeometry) {
+        if (renderer->CreateStaticGeometry(renderer, geometry) < 0) {
+            SDL_FreeStaticGeometry(geometry);
+            return NULL;
+        }
+    }
+
+    geometry->next = renderer->geometries;
+    if (renderer->geometries) {
+        renderer->geometries->prev = geometry;
+    }
+    renderer->geometries = geometry;
+
+    return geometry;
+}
+
+/* Queues the vertices first to first + count of the geometry, moved by the transform */
+static int QueueCmdStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry,
+                                  int first, int count, const float *transform)
+{
+    SDL_RenderCommand *cmd;
+    int retval = -1;
+    int i;
+
+    if (renderer->QueueStaticGeometry) {
+        cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, geometry->texture);
+        if (cmd != NULL) {
+            cmd->data.draw.geometry = geometry;
+            retval = renderer->QueueStaticGeometry(renderer, cmd, geometry, first, count, transform);
+            if (retval < 0) {
+                cmd->command = SDL_RENDERCMD_NO_OP;
+            }
+        }
+        return retval;
+    }
+
+    /* Move the vertices here and draw them as regular geometry */
+    for (i = first; i < first + count; ++i) {
+        const float x = geometry->xy[i * 2];
+        const float y = geometry->xy[i * 2 + 1];
+        geometry->transformed_xy[i * 2] = transform[0] * x + transform[2] * y + transform[4];
+        geometry->transformed_xy[i * 2 + 1] = transform[1] * x + transform[3] * y + transform[5];
+    }
+    return QueueCmdGeometry(renderer, geometry->texture,
+                            geometry->transformed_xy + first * 2, 2 * sizeof(float),
+                            geometry->color + first, sizeof(SDL_Color),
+                            geometry->uv ? geometry->uv + first * 2 : NULL, 2 * sizeof(float),
+                            count, NULL, 0, 0, 1.0f, 1.0f);
+}
+
+/* For the software renderer, draws the quads found by SDL_SW_FindGeometryRects() as rects */
+static int SDL_SW_RenderStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry,
+                                       const float *transform, const float *view_transform)
+{
+    SDL_Texture *texture = geometry->texture;
+    SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+    SDL_Color texture_color = { 0, 0, 0, 0 };
+    int retval = 0;
+    int i;
+
+    /* Save */
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    if (texture) {
+        texture_color = texture->color;
+    }
+
+    for (i = 0; i < geometry->num_runs; ++i) {
+        const SDL_StaticGeometryRun *run = &geometry->runs[i];
+
+        if (run->top_left >= 0) {
+            const float *xy0_ = &geometry->xy[run->top_left * 2];
+            const float *xy1_ = &geometry->xy[run->bottom_right * 2];
+            float xy[4];
+
+            xy[0] = transform[0] * xy0_[0] + transform[4];
+            xy[1] = transform[3] * xy0_[1] + transform[5];
+            xy[2] = transform[0] * xy1_[0] + transform[4];
+            xy[3] = transform[3] * xy1_[1] + transform[5];
+            SDL_SW_RenderGeometryRect(renderer, texture, &xy[0], &xy[2],
+                                      texture ? &geometry->uv[run->top_left * 2] : NULL,
+                                      texture ? &geometry->uv[run->bottom_right * 2] : NULL,
+                                      geometry->color[run->top_left]);
+        } else {
+            retval = QueueCmdStaticGeometry(renderer, geometry, run->first, run->count, view_transform);
+            if (retval < 0) {
+                break;
+            }
+        }
+    }
+
+    /* Restore */
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    if (texture) {
+        SDL_SetTextureColorMod(texture, texture_color.r, texture_color.g, texture_color.b);
+        SDL_SetTextureAlphaMod(texture, texture_color.a);
+    }
+
+    return retval;
+}
+
+int SDL_RenderStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry, const float *transform)
+{
+    static const float identity[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    float view_transform[6];
+    int retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+    CHECK_GEOMETRY_MAGIC(geometry, -1);
+
+    if (renderer != geometry->renderer) {
+        return SDL_SetError("Geometry was not created with this renderer");
+    }
+
+    if (geometry->textured && geometry->texture == NULL) {
+        return SDL_SetError("The texture of the geometry was destroyed");
+    }
+
+    if (transform == NULL) {
+        transform = identity;
+    }
+
+#if DONT_DRAW_WHILE_HIDDEN
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+#endif
+
+    if (geometry->num_vertices == 0) {
+        return 0;
+    }
+
+    if (geometry->texture) {
+        geometry->texture->last_command_generation = renderer->render_command_generation;
+    }
+    geometry->last_command_generation = renderer->render_command_generation;
+
+    /* The transform followed by the scale of the view */
+    view_transform[0] = transform[0] * renderer->view->scale.x;
+    view_transform[1] = transform[1] * renderer->view->scale.y;
+    view_transform[2] = transform[2] * renderer->view->scale.x;
+    view_transform[3] = transform[3] * renderer->view->scale.y;
+    view_transform[4] = transform[4] * renderer->view->scale.x;
+    view_transform[5] = transform[5] * renderer->view->scale.y;
+
+    /* Rects only stay rects if the geometry isn't rotated or flipped */
+    if (geometry->runs && transform[1] == 0.0f && transform[2] == 0.0f && transform[0] > 0.0f && transform[3] > 0.0f) {
+        retval = SDL_SW_RenderStaticGeometry(renderer, geometry, transform, view_transform);
+    } else {
+        retval = QueueCmdStaticGeometry(renderer, geometry, 0, geometry->num_vertices, view_transform);
+    }
+
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
+static void SDL_DestroyStaticGeometryInternal(SDL_StaticGeometry *geometry, SDL_bool is_destroying)
+{
+    SDL_Renderer *renderer = geometry->renderer;
+
+    if (is_destroying) {
+        /* Renderer get destroyed, avoid to queue more commands */
+    } else if (geometry->last_command_generation == renderer->render_command_generation) {
+        /* the current command queue depends on this geometry, flush the queue now before it goes */
+        FlushRenderCommands(renderer);
+    }
+
+    if (geometry->next) {
+        geometry->next->prev = geometry->prev;
+    }
+    if (geometry->prev) {
+        geometry->prev->next = geometry->next;
+    } else {
+        renderer->geometries = geometry->next;
+    }
+
+    if (geometry->driverdata) {
+        renderer->DestroyStaticGeometry(renderer, geometry);
+    }
+
+    geometry->magic = NULL;
+    SDL_FreeStaticGeometry(geometry);
+}
+
+void SDL_DestroyStaticGeometry(SDL_StaticGeometry *geometry)
+{
+    CHECK_GEOMETRY_MAGIC(geometry,);
+
+    SDL_DestroyStaticGeometryInternal(geometry, SDL_FALSE /* is_destroying */);
+}
+
 int SDL_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *rect, Uint32 format, void *pixels, int pitch)
 {
     SDL_Rect real_rect;
@@ -3929,6 +4979,143 @@ int SDL_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *rect, Uint32 fo
                                       format, pixels, pitch);
 }
 
+SDL_RenderReadback *SDL_RenderReadPixelsAsync(SDL_Renderer *renderer, const SDL_Rect *rect, Uint32 format)
+{
+    SDL_RenderReadback *readback;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->RenderReadPixels && !renderer->RenderReadPixelsAsync) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    FlushRenderCommands(renderer); /* we need to render before we read the results. */
+
+    if (!format) {
+        if (renderer->target == NULL) {
+            format = SDL_GetWindowPixelFormat(renderer->window);
+        } else {
+            format = renderer->target->format;
+        }
+    }
+
+    readback = (SDL_RenderReadback *)SDL_calloc(1, sizeof(*readback));
+    if (readback == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->magic = &readback_magic;
+    readback->renderer = renderer;
+    readback->format = format;
+
+    GetRenderViewportInPixels(renderer, &readback->rect);
+
+    if (rect) {
+        if (!SDL_GetRectIntersection(rect, &readback->rect, &readback->rect)) {
+            /* Nothing to read, the pixels are left alone like SDL_RenderReadPixels() does */
+            SDL_zero(readback->rect);
+        } else {
+            readback->offset_x = readback->rect.x - rect->x;
+            readback->offset_y = readback->rect.y - rect->y;
+        }
+    }
+
+    if (readback->rect.w > 0 && readback->rect.h > 0) {
+        int status;
+
+        if (renderer->RenderReadPixelsAsync) {
+            status = renderer->RenderReadPixelsAsync(renderer, readback);
+        } else {
+            readback->pitch = readback->rect.w * SDL_BYTESPERPIXEL(format);
+            readback->pixels = SDL_malloc((size_t)readback->rect.h * readback->pitch);
+            if (readback->pixels == NULL) {
+                status = SDL_OutOfMemory();
+            } else {
+                status = renderer->RenderReadPixels(renderer, &readback->rect, format,
+                                                    readback->pixels, readback->pitch);
+            }
+        }
+        if (status < 0) {
+            SDL_free(readback->pixels);
+            SDL_free(readback);
+            return NULL;
+        }
+    }
+
+    readback->next = renderer->readbacks;
+    if (renderer->readbacks) {
+        renderer->readbacks->prev = readback;
+    }
+    renderer->readbacks = readback;
+
+    return readback;
+}
+
+SDL_bool SDL_IsRenderReadbackReady(SDL_RenderReadback *readback)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_READBACK_MAGIC(readback, SDL_FALSE);
+
+    renderer = readback->renderer;
+    if (readback->driverdata && renderer->IsReadbackReady) {
+        return renderer->IsReadbackReady(renderer, readback);
+    }
+    return SDL_TRUE;
+}
+
+int SDL_GetRenderReadbackPixels(SDL_RenderReadback *readback, void *pixels, int pitch)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_READBACK_MAGIC(readback, -1);
+
+    if (pixels == NULL) {
+        return SDL_InvalidParamError("pixels");
+    }
+
+    if (readback->rect.w == 0 || readback->rect.h == 0) {
+        return 0; /* nothing to do. */
+    }
+
+    pixels = (Uint8 *)pixels + pitch * readback->offset_y;
+    pixels = (Uint8 *)pixels + SDL_BYTESPERPIXEL(readback->format) * readback->offset_x;
+
+    renderer = readback->renderer;
+    if (readback->driverdata) {
+        return renderer->GetReadbackPixels(renderer, readback, pixels, pitch);
+    }
+    return SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                             readback->format, readback->pixels, readback->pitch,
+                             readback->format, pixels, pitch);
+}
+
+void SDL_DestroyRenderReadback(SDL_RenderReadback *readback)
+{
+    SDL_Renderer *renderer;
+
+    CHECK_READBACK_MAGIC(readback,);
+
+    renderer = readback->renderer;
+    if (readback->next) {
+        readback->next->prev = readback->prev;
+    }
+    if (readback->prev) {
+        readback->prev->next = readback->next;
+    } else {
+        renderer->readbacks = readback->next;
+    }
+
+    if (readback->driverdata) {
+        renderer->DestroyReadback(renderer, readback);
+    }
+
+    readback->magic = NULL;
+    SDL_free(readback->pixels);
+    SDL_free(readback);
+}
+
 static void SDL_SimulateRenderVSync(SDL_Renderer *renderer)
 {
     Uint64 now, elapsed;
@@ -4027,6 +5214,9 @@ int SDL_RenderPresent(SDL_Renderer *renderer)
         presented = SDL_FALSE;
     }
 
+    SDL_copyp(&renderer->last_stats, &renderer->stats);
+    SDL_zero(renderer->stats);
+
     if (renderer->logical_target) {
         SDL_SetRenderTargetInternal(renderer, renderer->logical_target);
     }
@@ -4041,6 +5231,7 @@ int SDL_RenderPresent(SDL_Renderer *renderer)
 static int SDL_DestroyTextureInternal(SDL_Texture *texture, SDL_bool is_destroying)
 {
     SDL_Renderer *renderer;
+    SDL_StaticGeometry *geometry;
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
@@ -4070,6 +5261,13 @@ static int SDL_DestroyTextureInternal(SDL_Texture *texture, SDL_bool is_destroyi
         renderer->textures = texture->next;
     }
 
+    /* Geometry drawn with this texture can't be drawn anymore */
+    for (geometry = renderer->geometries; geometry != NULL; geometry = geometry->next) {
+        if (geometry->texture == texture) {
+            geometry->texture = NULL;
+        }
+    }
+
     if (texture->native) {
         SDL_DestroyTextureInternal(texture->native, is_destroying);
     }
@@ -4124,6 +5322,14 @@ void SDL_DestroyRenderer(SDL_Renderer *renderer)
 
     SDL_DiscardAllCommands(renderer);
 
+    while (renderer->readbacks) {
+        SDL_DestroyRenderReadback(renderer->readbacks);
+    }
+
+    while (renderer->geometries) {
+        SDL_DestroyStaticGeometryInternal(renderer->geometries, SDL_TRUE /* is_destroying */);
+    }
+
     /* Free existing textures for this renderer */
     while (renderer->textures) {
         SDL_Texture *tex = renderer->textures;
@@ -4133,6 +5339,7 @@ void SDL_DestroyRenderer(SDL_Renderer *renderer)
     }
 
     SDL_free(renderer->vertex_data);
+    SDL_free(renderer->reorder_commands);
 
     if (renderer->window) {
         SDL_SetWindowData(renderer->window, SDL_WINDOWRENDERDATA, NULL);
@@ -90,6 +90,63 @@ struct SDL_Texture
     SDL_Texture *next;
 };
 
+/* Define the SDL readback structure */
+struct SDL_RenderReadback
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+    SDL_Rect rect;  /**< The area being read, clipped to the viewport, in pixels */
+    int offset_x;   /**< Where rect starts in the area that was asked for */
+    int offset_y;
+    Uint32 format;  /**< The format the pixels are returned in */
+
+    /* Pixels read right away, for renderers that can't read them in the background */
+    void *pixels;
+    int pitch;
+
+    void *driverdata; /**< Driver specific readback representation */
+
+    SDL_RenderReadback *prev;
+    SDL_RenderReadback *next;
+};
+
+/* A part of static geometry the software renderer draws in one go */
+typedef struct SDL_StaticGeometryRun
+{
+    int first;        /**< The first vertex of the run */
+    int count;        /**< The number of vertices, a multiple of 3 */
+    int top_left;     /**< For a quad drawn as a rect, its top left vertex, -1 for triangles */
+    int bottom_right; /**< For a quad drawn as a rect, its bottom right vertex */
+} SDL_StaticGeometryRun;
+
+/* Define the SDL static geometry structure */
+struct SDL_StaticGeometry
+{
+    const void *magic;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture; /**< The texture to draw with, NULL once it's destroyed */
+    SDL_bool textured;    /**< Whether the geometry was created with a texture */
+
+    /* The triangles, with the indices already expanded */
+    int num_vertices;
+    float *xy;
+    SDL_Color *color;
+    float *uv;
+
+    /* Quads the software renderer can draw as rects when the geometry isn't rotated */
+    SDL_StaticGeometryRun *runs;
+    int num_runs;
+
+    float *transformed_xy; /**< Scratch space, for renderers drawing the vertices as regular geometry */
+
+    Uint32 last_command_generation; /* last command queue generation this geometry was in. */
+
+    void *driverdata; /**< Driver specific geometry representation */
+
+    SDL_StaticGeometry *prev;
+    SDL_StaticGeometry *next;
+};
+
 typedef enum
 {
     SDL_RENDERCMD_NO_OP,
@@ -127,6 +184,9 @@ typedef struct SDL_RenderCommand
             Uint8 r, g, b, a;
             SDL_BlendMode blend;
             SDL_Texture *texture;
+            SDL_StaticGeometry *geometry; /* drawn with the transform at first, if not NULL */
+            SDL_FRect bounds; /* pixels this may touch, only set when reordering */
+            size_t size;      /* bytes of vertex data at first, 0 if it can't be moved */
         } draw;
         struct
         {
@@ -172,10 +232,16 @@ struct SDL_Renderer
     int (*QueueCopyEx)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
                        const SDL_FRect *srcquad, const SDL_FRect *dstrect,
                        const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip, float scale_x, float scale_y);
+    int (*QueueCopies)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
+                       const SDL_TextureBatchItem *items, int count, float scale_x, float scale_y);
     int (*QueueGeometry)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
                          const float *xy, int xy_stride, const SDL_Color *color, int color_stride, const float *uv, int uv_stride,
                          int num_vertices, const void *indices, int num_indices, int size_indices,
                          float scale_x, float scale_y);
+    int (*CreateStaticGeometry)(SDL_Renderer *renderer, SDL_StaticGeometry *geometry);
+    int (*QueueStaticGeometry)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_StaticGeometry *geometry,
+                               int first, int count, const float *transform);
+    void (*DestroyStaticGeometry)(SDL_Renderer *renderer, SDL_StaticGeometry *geometry);
 
     int (*RunCommandQueue)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
     int (*UpdateTexture)(SDL_Renderer *renderer, SDL_Texture *texture,
@@ -199,6 +265,11 @@ struct SDL_Renderer
     int (*SetRenderTarget)(SDL_Renderer *renderer, SDL_Texture *texture);
     int (*RenderReadPixels)(SDL_Renderer *renderer, const SDL_Rect *rect,
                             Uint32 format, void *pixels, int pitch);
+    int (*RenderReadPixelsAsync)(SDL_Renderer *renderer, SDL_RenderReadback *readback);
+    SDL_bool (*IsReadbackReady)(SDL_Renderer *renderer, SDL_RenderReadback *readback);
+    int (*GetReadbackPixels)(SDL_Renderer *renderer, SDL_RenderReadback *readback,
+                             void *pixels, int pitch);
+    void (*DestroyReadback)(SDL_Renderer *renderer, SDL_RenderReadback *readback);
     int (*RenderPresent)(SDL_Renderer *renderer);
     void (*DestroyTexture)(SDL_Renderer *renderer, SDL_Texture *texture);
 
@@ -249,11 +320,18 @@ struct SDL_Renderer
     SDL_Texture *target;
     SDL_Mutex *target_mutex;
 
+    /* The list of readbacks */
+    SDL_RenderReadback *readbacks;
+
+    /* The list of static geometry */
+    SDL_StaticGeometry *geometries;
+
     SDL_Color color;         /**< Color for drawing operations values */
     SDL_BlendMode blendMode; /**< The drawing blend mode */
 
     SDL_bool always_batch;
     SDL_bool batching;
+    SDL_bool reordering;
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -269,6 +347,15 @@ struct SDL_Renderer
     void *vertex_data;
     size_t vertex_data_used;
     size_t vertex_data_allocation;
+    size_t vertex_data_alignment;
+
+    /* Scratch space to reorder draw commands */
+    SDL_RenderCommand **reorder_commands;
+    int reorder_commands_allocated;
+
+    /* Statistics for the frame being drawn and the last presented one */
+    SDL_RenderStats stats;
+    SDL_RenderStats last_stats;
 
     void *driverdata;
 };
@@ -307,6 +394,12 @@ extern SDL_BlendOperation SDL_GetBlendModeAlphaOperation(SDL_BlendMode blendMode
    the next call, because it might be in an array that gets realloc()'d. */
 extern void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, const size_t numbytes, const size_t alignment, size_t *offset);
 
+/* drivers call these during their QueueCopies() method. The corners of an item are given in the
+   same order as the ones SDL_RenderTexture() passes to QueueGeometry(), and its color is modulated
+   by the texture color. */
+extern void SDL_GetTextureBatchItemCorners(const SDL_TextureBatchItem *item, float scale_x, float scale_y, float *xy);
+extern void SDL_GetTextureBatchItemColor(const SDL_TextureBatchItem *item, const SDL_Color *texture_color, SDL_Color *color);
+
 extern int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
 extern int SDL_PrivateBlitSurfaceScaled(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
 
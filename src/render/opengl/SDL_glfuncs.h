@@ -234,7 +234,7 @@ SDL_PROC(void, glLineWidth, (GLfloat width))
 SDL_PROC_UNUSED(void, glListBase, (GLuint base))
 SDL_PROC(void, glLoadIdentity, (void))
 SDL_PROC_UNUSED(void, glLoadMatrixd, (const GLdouble *m))
-SDL_PROC_UNUSED(void, glLoadMatrixf, (const GLfloat *m))
+SDL_PROC(void, glLoadMatrixf, (const GLfloat *m))
 SDL_PROC_UNUSED(void, glLoadName, (GLuint name))
 SDL_PROC_UNUSED(void, glLogicOp, (GLenum opcode))
 SDL_PROC_UNUSED(void, glMap1d,
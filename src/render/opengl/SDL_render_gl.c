@@ -43,6 +43,15 @@
 #define RENDERER_CONTEXT_MAJOR 2
 #define RENDERER_CONTEXT_MINOR 1
 
+/* The vertex buffer starts out this big and grows to twice the largest batch */
+#define GL_VERTEX_BUFFER_SIZE (1024 * 1024)
+
+/* The most batches whose vertices can still be in use by the GPU */
+#define GL_MAX_VERTEX_FENCES 8
+
+/* Readback buffers kept around for reuse, so reading every frame doesn't reallocate */
+#define GL_MAX_READBACK_BUFFERS 2
+
 /* OpenGL renderer implementation */
 
 /* Details on optimizing the texture path on macOS:
@@ -78,10 +87,17 @@ typedef struct
     SDL_bool vertex_array;
     SDL_bool color_array;
     SDL_bool texture_array;
-    Uint32 color;
     Uint32 clear_color;
 } GL_DrawStateCache;
 
+/* Marks the part of the vertex buffer a batch used, until the GPU is done with it */
+typedef struct
+{
+    GLsync sync;
+    size_t start;
+    size_t end;
+} GL_VertexFence;
+
 typedef struct
 {
     SDL_GLContext context;
@@ -116,6 +132,34 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Buffer objects that can be mapped, with fences if GL_ARB_sync is supported */
+    SDL_bool GL_ARB_map_buffer_range_supported;
+    SDL_bool GL_ARB_sync_supported;
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
+
+    /* Batches are streamed through this buffer, used as a ring, if it isn't 0 */
+    GLuint vertex_buffer;
+    size_t vertex_buffer_size;
+    size_t vertex_buffer_offset;
+    GL_VertexFence vertex_fences[GL_MAX_VERTEX_FENCES];
+    int first_vertex_fence;
+    int num_vertex_fences;
+
+    GLuint readback_buffers[GL_MAX_READBACK_BUFFERS];
+    GLsizeiptr readback_buffer_sizes[GL_MAX_READBACK_BUFFERS];
+    int num_readback_buffers;
+
+    PFNGLGENBUFFERSPROC glGenBuffers;
+    PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+    PFNGLBINDBUFFERPROC glBindBuffer;
+    PFNGLBUFFERDATAPROC glBufferData;
+    PFNGLBUFFERSUBDATAPROC glBufferSubData;
+    PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+    PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
@@ -134,6 +178,10 @@ typedef struct
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Streaming textures are locked into these in turn, if pixels is NULL */
+    GLuint pixel_buffers[2];
+    int pixel_buffer;
+
 #if SDL_HAVE_YUV
     /* YUV texture support */
     SDL_bool yuv;
@@ -145,6 +193,30 @@ typedef struct
     GL_FBOList *fbo;
 } GL_TextureData;
 
+/* Static geometry lives in a buffer, or in client memory without buffer objects */
+typedef struct
+{
+    GLuint buffer;
+    GLfloat *vertices;
+} GL_StaticGeometryData;
+
+/* The vertex data of a static geometry draw command */
+typedef struct
+{
+    GLfloat modelview[16];
+    GLint first;
+} GL_StaticGeometryDraw;
+
+typedef struct
+{
+    GLuint buffer;
+    GLsizeiptr size;
+    GLsync sync;
+    Uint32 format; /* the format of the pixels in the buffer */
+    int pitch;
+    SDL_bool flipped; /* the rows are bottom-up, as read from the window */
+} GL_ReadbackData;
+
 SDL_FORCE_INLINE const char *
 GL_TranslateError(GLenum error)
 {
@@ -447,6 +519,7 @@ static int GL_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     GLenum format, type;
     int texture_w, texture_h;
     GLenum scaleMode;
+    SDL_bool use_pixel_buffers;
 
     GL_ActivateRenderer(renderer);
 
@@ -468,7 +541,27 @@ static int GL_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         return SDL_OutOfMemory();
     }
 
-    if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
+    /* Streaming textures are locked straight into pixel buffers when they can be */
+    use_pixel_buffers = (texture->access == SDL_TEXTUREACCESS_STREAMING &&
+                         renderdata->GL_ARB_pixel_buffer_object_supported &&
+                         !SDL_ISPIXELFORMAT_FOURCC(texture->format));
+#ifdef __MACOS__
+    if (texture->format == SDL_PIXELFORMAT_ARGB8888 && (texture->w % 8) == 0) {
+        use_pixel_buffers = SDL_FALSE; /* the pixels are used as client storage below */
+    }
+#endif
+
+    if (use_pixel_buffers) {
+        const GLsizeiptr size = (GLsizeiptr)texture->h * texture->w * SDL_BYTESPERPIXEL(texture->format);
+        int i;
+
+        renderdata->glGenBuffers(SDL_arraysize(data->pixel_buffers), data->pixel_buffers);
+        for (i = 0; i < SDL_arraysize(data->pixel_buffers); ++i) {
+            renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, data->pixel_buffers[i]);
+            renderdata->glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        }
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         size_t size;
         data->pitch = texture->w * SDL_BYTESPERPIXEL(texture->format);
         size = (size_t)texture->h * data->pitch;
@@ -498,6 +591,9 @@ static int GL_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     GL_CheckError("", renderer);
     renderdata->glGenTextures(1, &data->texture);
     if (GL_CheckError("glGenTextures()", renderer) < 0) {
+        if (data->pixel_buffers[0]) {
+            renderdata->glDeleteBuffers(SDL_arraysize(data->pixel_buffers), data->pixel_buffers);
+        }
         if (data->pixels) {
             SDL_free(data->pixels);
         }
@@ -815,6 +911,27 @@ static int GL_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture,
     GL_TextureData *data = (GL_TextureData *)texture->driverdata;
 
     data->locked_rect = *rect;
+
+    if (data->pixel_buffers[0]) {
+        GL_RenderData *renderdata = (GL_RenderData *)renderer->driverdata;
+        const int length = rect->w * SDL_BYTESPERPIXEL(texture->format);
+
+        GL_ActivateRenderer(renderer);
+
+        /* Invalidating the buffer lets the driver hand out fresh memory while
+           the GPU may still be copying the last upload out of it. */
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, data->pixel_buffers[data->pixel_buffer]);
+        *pixels = renderdata->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)rect->h * length,
+                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (*pixels == NULL) {
+            GL_CheckError("", renderer);
+            return SDL_SetError("Couldn't map pixel buffer");
+        }
+        *pitch = length;
+        return 0;
+    }
+
     *pixels =
         (void *)((Uint8 *)data->pixels + rect->y * data->pitch +
                  rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -829,6 +946,30 @@ static void GL_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     void *pixels;
 
     rect = &data->locked_rect;
+
+    if (data->pixel_buffers[0]) {
+        GL_RenderData *renderdata = (GL_RenderData *)renderer->driverdata;
+        const GLenum textype = renderdata->textype;
+
+        GL_ActivateRenderer(renderer);
+
+        renderdata->drawstate.texture = NULL; /* we trash this state. */
+
+        /* The pixels are copied from the buffer by the GPU, after we return */
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, data->pixel_buffers[data->pixel_buffer]);
+        renderdata->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        renderdata->glBindTexture(textype, data->texture);
+        renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, rect->w);
+        renderdata->glTexSubImage2D(textype, 0, rect->x, rect->y, rect->w,
+                                    rect->h, data->format, data->formattype, NULL);
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        GL_CheckError("glTexSubImage2D()", renderer);
+
+        data->pixel_buffer = (data->pixel_buffer + 1) % SDL_arraysize(data->pixel_buffers);
+        return;
+    }
+
     pixels =
         (void *)((Uint8 *)data->pixels + rect->y * data->pitch +
                  rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -908,17 +1049,24 @@ static int GL_QueueSetViewport(SDL_Renderer *renderer, SDL_RenderCommand *cmd)
 
 static int GL_QueueDrawPoints(SDL_Renderer *renderer, SDL_RenderCommand *cmd, const SDL_FPoint *points, int count)
 {
-    GLfloat *verts = (GLfloat *)SDL_AllocateRenderVertices(renderer, count * 2 * sizeof(GLfloat), 0, &cmd->data.draw.first);
+    GLfloat *verts = (GLfloat *)SDL_AllocateRenderVertices(renderer, count * 3 * sizeof(GLfloat), 0, &cmd->data.draw.first);
+    SDL_Color color;
     int i;
 
     if (verts == NULL) {
         return -1;
     }
 
+    color.r = cmd->data.draw.r;
+    color.g = cmd->data.draw.g;
+    color.b = cmd->data.draw.b;
+    color.a = cmd->data.draw.a;
+
     cmd->data.draw.count = count;
     for (i = 0; i < count; i++) {
         *(verts++) = 0.5f + points[i].x;
         *(verts++) = 0.5f + points[i].y;
+        SDL_memcpy(verts++, &color, sizeof(color));
     }
 
     return 0;
@@ -928,7 +1076,8 @@ static int GL_QueueDrawLines(SDL_Renderer *renderer, SDL_RenderCommand *cmd, con
 {
     int i;
     GLfloat prevx, prevy;
-    const size_t vertlen = (sizeof(GLfloat) * 2) * count;
+    SDL_Color color;
+    const size_t vertlen = (sizeof(GLfloat) * 3) * count;
     GLfloat *verts = (GLfloat *)SDL_AllocateRenderVertices(renderer, vertlen, 0, &cmd->data.draw.first);
 
     if (verts == NULL) {
@@ -936,11 +1085,17 @@ static int GL_QueueDrawLines(SDL_Renderer *renderer, SDL_RenderCommand *cmd, con
     }
     cmd->data.draw.count = count;
 
+    color.r = cmd->data.draw.r;
+    color.g = cmd->data.draw.g;
+    color.b = cmd->data.draw.b;
+    color.a = cmd->data.draw.a;
+
     /* 0.5f offset to hit the center of the pixel. */
     prevx = 0.5f + points->x;
     prevy = 0.5f + points->y;
     *(verts++) = prevx;
     *(verts++) = prevy;
+    SDL_memcpy(verts++, &color, sizeof(color));
 
     /* bump the end of each line segment out a quarter of a pixel, to provoke
        the diamond-exit rule. Without this, you won't just drop the last
@@ -959,6 +1114,7 @@ static int GL_QueueDrawLines(SDL_Renderer *renderer, SDL_RenderCommand *cmd, con
         prevy = yend + (SDL_sinf(angle) * 0.25f);
         *(verts++) = prevx;
         *(verts++) = prevy;
+        SDL_memcpy(verts++, &color, sizeof(color));
     }
 
     return 0;
@@ -1019,8 +1175,146 @@ static int GL_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_
     return 0;
 }
 
-static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const GL_Shader shader)
+static int GL_CreateStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    const GL_TextureData *texturedata = geometry->texture ? (GL_TextureData *)geometry->texture->driverdata : NULL;
+    const size_t sz = 2 * sizeof(GLfloat) + 4 * sizeof(Uint8) + (texturedata ? 2 : 0) * sizeof(GLfloat);
+    const size_t size = geometry->num_vertices * sz;
+    GL_StaticGeometryData *geometrydata;
+    GLfloat *vertices, *verts;
+    int i;
+
+    geometrydata = (GL_StaticGeometryData *)SDL_calloc(1, sizeof(*geometrydata));
+    if (geometrydata == NULL) {
+        return SDL_OutOfMemory();
+    }
+    vertices = (GLfloat *)SDL_malloc(size);
+    if (vertices == NULL) {
+        SDL_free(geometrydata);
+        return SDL_OutOfMemory();
+    }
+
+    verts = vertices;
+    for (i = 0; i < geometry->num_vertices; i++) {
+        *(verts++) = geometry->xy[i * 2];
+        *(verts++) = geometry->xy[i * 2 + 1];
+
+        /* Not really a float, but it is still 4 bytes and will be cast to the
+           right type in the graphics driver. */
+        SDL_memcpy(verts, &geometry->color[i], sizeof(*geometry->color));
+        ++verts;
+
+        if (texturedata) {
+            *(verts++) = geometry->uv[i * 2] * texturedata->texw;
+            *(verts++) = geometry->uv[i * 2 + 1] * texturedata->texh;
+        }
+    }
+
+    /* The buffer functions come with mapped buffers */
+    if (data->GL_ARB_map_buffer_range_supported) {
+        GL_ActivateRenderer(renderer);
+
+        data->glGenBuffers(1, &geometrydata->buffer);
+        data->glBindBuffer(GL_ARRAY_BUFFER, geometrydata->buffer);
+        data->glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+        data->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        SDL_free(vertices);
+
+        if (GL_CheckError("glBufferData()", renderer) < 0) {
+            data->glDeleteBuffers(1, &geometrydata->buffer);
+            SDL_free(geometrydata);
+            return -1;
+        }
+    } else {
+        geometrydata->vertices = vertices;
+    }
+
+    geometry->driverdata = geometrydata;
+    return 0;
+}
+
+static int GL_QueueStaticGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_StaticGeometry *geometry,
+                                  int first, int count, const float *transform)
+{
+    GL_StaticGeometryDraw *draw = (GL_StaticGeometryDraw *)SDL_AllocateRenderVertices(renderer, sizeof(*draw), 0, &cmd->data.draw.first);
+
+    if (draw == NULL) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+    draw->first = first;
+
+    /* The affine transform as a column-major 4x4 matrix */
+    SDL_zeroa(draw->modelview);
+    draw->modelview[0] = transform[0];
+    draw->modelview[1] = transform[1];
+    draw->modelview[4] = transform[2];
+    draw->modelview[5] = transform[3];
+    draw->modelview[10] = 1.0f;
+    draw->modelview[12] = transform[4];
+    draw->modelview[13] = transform[5];
+    draw->modelview[15] = 1.0f;
+    return 0;
+}
+
+static int GL_QueueCopies(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
+                          const SDL_TextureBatchItem *items, int count, float scale_x, float scale_y)
+{
+    GL_TextureData *texturedata = (GL_TextureData *)texture->driverdata;
+    const int *rect_index_order = renderer->rect_index_order;
+    const size_t sz = 2 * sizeof(GLfloat) + 4 * sizeof(Uint8) + 2 * sizeof(GLfloat);
+    GLfloat *verts;
+    int i, j;
+
+    /* The batch is drawn as triangles, like SDL_RenderTexture() */
+    verts = (GLfloat *)SDL_AllocateRenderVertices(renderer, count * 6 * sz, 0, &cmd->data.draw.first);
+    if (verts == NULL) {
+        return -1;
+    }
+
+    cmd->command = SDL_RENDERCMD_GEOMETRY;
+    cmd->data.draw.count = count * 6;
+
+    for (i = 0; i < count; i++) {
+        const SDL_TextureBatchItem *item = &items[i];
+        const GLfloat minu = (item->srcrect.x / texture->w) * texturedata->texw;
+        const GLfloat minv = (item->srcrect.y / texture->h) * texturedata->texh;
+        const GLfloat maxu = ((item->srcrect.x + item->srcrect.w) / texture->w) * texturedata->texw;
+        const GLfloat maxv = ((item->srcrect.y + item->srcrect.h) / texture->h) * texturedata->texh;
+        float xy[8];
+        GLfloat uv[8];
+        SDL_Color color;
+
+        SDL_GetTextureBatchItemCorners(item, scale_x, scale_y, xy);
+        SDL_GetTextureBatchItemColor(item, &texture->color, &color);
+
+        uv[0] = minu;
+        uv[1] = minv;
+        uv[2] = maxu;
+        uv[3] = minv;
+        uv[4] = maxu;
+        uv[5] = maxv;
+        uv[6] = minu;
+        uv[7] = maxv;
+
+        for (j = 0; j < 6; j++) {
+            const int k = rect_index_order[j];
+            *(verts++) = xy[2 * k];
+            *(verts++) = xy[2 * k + 1];
+            SDL_memcpy(verts, &color, sizeof(color));
+            ++verts;
+            *(verts++) = uv[2 * k];
+            *(verts++) = uv[2 * k + 1];
+        }
+    }
+    return 0;
+}
+
+static int SetDrawState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, const GL_Shader shader)
 {
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
     const SDL_BlendMode blend = cmd->data.draw.blend;
     SDL_bool vertex_array;
     SDL_bool color_array;
@@ -1042,6 +1336,7 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
         }
         data->glMatrixMode(GL_MODELVIEW);
         data->drawstate.viewport_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if (data->drawstate.cliprect_enabled_dirty) {
@@ -1051,6 +1346,7 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
             data->glEnable(GL_SCISSOR_TEST);
         }
         data->drawstate.cliprect_enabled_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if (data->drawstate.cliprect_enabled && data->drawstate.cliprect_dirty) {
@@ -1060,6 +1356,7 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
                         data->drawstate.target ? viewport->y + rect->y : data->drawstate.drawableh - viewport->y - rect->y - rect->h,
                         rect->w, rect->h);
         data->drawstate.cliprect_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if (blend != data->drawstate.blend) {
@@ -1074,11 +1371,13 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
             data->glBlendEquation(GetBlendEquation(SDL_GetBlendModeColorOperation(blend)));
         }
         data->drawstate.blend = blend;
+        ++renderer->stats.blend_changes;
     }
 
     if (data->shaders && (shader != data->drawstate.shader)) {
         GL_SelectShader(data->shaders, shader);
         data->drawstate.shader = shader;
+        ++renderer->stats.shader_changes;
     }
 
     if ((cmd->data.draw.texture != NULL) != data->drawstate.texturing) {
@@ -1092,7 +1391,7 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
     }
 
     vertex_array = cmd->command == SDL_RENDERCMD_DRAW_POINTS || cmd->command == SDL_RENDERCMD_DRAW_LINES || cmd->command == SDL_RENDERCMD_GEOMETRY;
-    color_array = cmd->command == SDL_RENDERCMD_GEOMETRY;
+    color_array = vertex_array;
     texture_array = cmd->data.draw.texture != NULL;
 
     if (vertex_array != data->drawstate.vertex_array) {
@@ -1127,12 +1426,13 @@ static int SetDrawState(GL_RenderData *data, const SDL_RenderCommand *cmd, const
     return 0;
 }
 
-static int SetCopyState(GL_RenderData *data, const SDL_RenderCommand *cmd)
+static int SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
 {
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
     SDL_Texture *texture = cmd->data.draw.texture;
     const GL_TextureData *texturedata = (GL_TextureData *)texture->driverdata;
 
-    SetDrawState(data, cmd, texturedata->shader);
+    SetDrawState(renderer, cmd, texturedata->shader);
 
     if (texture != data->drawstate.texture) {
         const GLenum textype = data->textype;
@@ -1161,15 +1461,187 @@ static int SetCopyState(GL_RenderData *data, const SDL_RenderCommand *cmd)
         data->glBindTexture(textype, texturedata->texture);
 
         data->drawstate.texture = texture;
+        ++renderer->stats.texture_changes;
     }
 
     return 0;
 }
 
+/* State commands that don't change anything for the next draw call, so
+   draw commands on either side of them can still be combined. */
+static SDL_bool GL_IsRedundantStateCommand(const GL_RenderData *data, const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+    case SDL_RENDERCMD_NO_OP:
+    case SDL_RENDERCMD_SETDRAWCOLOR:
+        return SDL_TRUE;
+    case SDL_RENDERCMD_SETVIEWPORT:
+        return SDL_memcmp(&data->drawstate.viewport, &cmd->data.viewport.rect, sizeof(cmd->data.viewport.rect)) == 0;
+    case SDL_RENDERCMD_SETCLIPRECT:
+        return data->drawstate.cliprect_enabled == cmd->data.cliprect.enabled &&
+               SDL_memcmp(&data->drawstate.cliprect, &cmd->data.cliprect.rect, sizeof(cmd->data.cliprect.rect)) == 0;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* Finds the last draw command that can go into the same draw call as cmd:
+   same command, texture and blend mode, vertices directly following the ones
+   before it, and nothing but redundant state commands in between. */
+static SDL_RenderCommand *GL_MergeDrawCommands(const GL_RenderData *data, SDL_RenderCommand *cmd, size_t stride, size_t *count)
+{
+    SDL_RenderCommand *finalcmd = cmd;
+    SDL_RenderCommand *nextcmd;
+    size_t next_first = cmd->data.draw.first + cmd->data.draw.count * stride;
+
+    *count = cmd->data.draw.count;
+    if (cmd->data.draw.geometry) {
+        return finalcmd; /* static geometry has its own vertices. */
+    }
+    for (nextcmd = cmd->next; nextcmd != NULL; nextcmd = nextcmd->next) {
+        if (nextcmd->command != cmd->command) {
+            if (GL_IsRedundantStateCommand(data, nextcmd)) {
+                continue;
+            }
+            break; /* can't go any further on this draw call, different render command up next. */
+        } else if (nextcmd->data.draw.geometry) {
+            break; /* can't go any further on this draw call, static geometry has its own vertices. */
+        } else if (nextcmd->data.draw.texture != cmd->data.draw.texture || nextcmd->data.draw.blend != cmd->data.draw.blend) {
+            break; /* can't go any further on this draw call, different texture/blendmode copy up next. */
+        } else if (cmd->command == SDL_RENDERCMD_DRAW_LINES && nextcmd->data.draw.count != 2) {
+            break; /* can't go any further on this draw call, those are joined lines */
+        } else if (nextcmd->data.draw.first != next_first) {
+            break; /* can't go any further on this draw call, the vertices aren't contiguous. */
+        }
+        finalcmd = nextcmd; /* we can combine these operations here. Mark this one as the furthest okay command. */
+        *count += nextcmd->data.draw.count;
+        next_first += nextcmd->data.draw.count * stride;
+    }
+    return finalcmd;
+}
+
+/* Waits until the GPU is done with the oldest fenced vertices */
+static void GL_WaitVertexFence(GL_RenderData *data)
+{
+    GL_VertexFence *fence = &data->vertex_fences[data->first_vertex_fence];
+
+    while (data->glClientWaitSync(fence->sync, GL_SYNC_FLUSH_COMMANDS_BIT, SDL_NS_PER_SECOND) == GL_TIMEOUT_EXPIRED) {
+        /* keep waiting */
+    }
+    data->glDeleteSync(fence->sync);
+    data->first_vertex_fence = (data->first_vertex_fence + 1) % GL_MAX_VERTEX_FENCES;
+    --data->num_vertex_fences;
+}
+
+/* Copies the vertices of a batch after the ones of the batch before, wrapping
+   around to the start of the buffer once they don't fit at the end anymore.
+   Returns where the vertices went in the buffer. */
+static size_t GL_UploadVertices(GL_RenderData *data, const void *vertices, size_t vertsize)
+{
+    size_t offset = data->vertex_buffer_offset;
+    void *mapped;
+    int i;
+
+    data->glBindBuffer(GL_ARRAY_BUFFER, data->vertex_buffer);
+
+    if (vertsize > data->vertex_buffer_size / 2) {
+        size_t size = SDL_max(data->vertex_buffer_size, GL_VERTEX_BUFFER_SIZE);
+        while (size < vertsize * 2) {
+            size *= 2;
+        }
+
+        /* The GPU keeps the old storage for as long as it needs it */
+        while (data->num_vertex_fences > 0) {
+            data->glDeleteSync(data->vertex_fences[data->first_vertex_fence].sync);
+            data->first_vertex_fence = (data->first_vertex_fence + 1) % GL_MAX_VERTEX_FENCES;
+            --data->num_vertex_fences;
+        }
+        data->glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        data->vertex_buffer_size = size;
+        offset = 0;
+    } else if (offset + vertsize > data->vertex_buffer_size) {
+        offset = 0;
+    }
+
+    /* Fences complete in order, so wait up to the last one using this space */
+    for (i = data->num_vertex_fences - 1; i >= 0; --i) {
+        const GL_VertexFence *fence = &data->vertex_fences[(data->first_vertex_fence + i) % GL_MAX_VERTEX_FENCES];
+        if (fence->start < offset + vertsize && offset < fence->end) {
+            break;
+        }
+    }
+    for (; i >= 0; --i) {
+        GL_WaitVertexFence(data);
+    }
+
+    mapped = data->glMapBufferRange(GL_ARRAY_BUFFER, offset, vertsize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        SDL_memcpy(mapped, vertices, vertsize);
+        data->glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        data->glBufferSubData(GL_ARRAY_BUFFER, offset, vertsize, vertices);
+    }
+
+    data->vertex_buffer_offset = offset + vertsize;
+    return offset;
+}
+
+/* Remembers that the commands just run use these vertices */
+static void GL_FenceVertices(GL_RenderData *data, size_t offset, size_t vertsize)
+{
+    GL_VertexFence *fence;
+
+    if (data->num_vertex_fences == GL_MAX_VERTEX_FENCES) {
+        GL_WaitVertexFence(data);
+    }
+    fence = &data->vertex_fences[(data->first_vertex_fence + data->num_vertex_fences) % GL_MAX_VERTEX_FENCES];
+    fence->sync = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fence->start = offset;
+    fence->end = offset + vertsize;
+    if (fence->sync) {
+        ++data->num_vertex_fences;
+    }
+}
+
+/* Draws static geometry from its own buffer, moved by the modelview matrix */
+static void GL_DrawStaticGeometry(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, const void *vertices, SDL_bool use_vertex_buffer)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    const GL_StaticGeometryData *geometrydata = (const GL_StaticGeometryData *)cmd->data.draw.geometry->driverdata;
+    const GL_StaticGeometryDraw *draw = (const GL_StaticGeometryDraw *)(((const Uint8 *)vertices) + cmd->data.draw.first);
+    const size_t stride = sizeof(float) * (cmd->data.draw.texture ? 5 : 3);
+    const GLfloat *verts;
+
+    if (geometrydata->buffer) {
+        data->glBindBuffer(GL_ARRAY_BUFFER, geometrydata->buffer);
+    } else if (use_vertex_buffer) {
+        data->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    verts = (const GLfloat *)(((const Uint8 *)geometrydata->vertices) + draw->first * stride); /* offset into the buffer if there is one */
+
+    data->glVertexPointer(2, GL_FLOAT, (GLsizei)stride, verts + 0);
+    data->glColorPointer(4, GL_UNSIGNED_BYTE, (GLsizei)stride, verts + 2);
+    if (cmd->data.draw.texture) {
+        data->glTexCoordPointer(2, GL_FLOAT, (GLsizei)stride, verts + 3);
+    }
+
+    data->glLoadMatrixf(draw->modelview);
+    data->glDrawArrays(GL_TRIANGLES, 0, (GLsizei)cmd->data.draw.count);
+    data->glLoadIdentity();
+    ++renderer->stats.draw_calls;
+
+    if (geometrydata->buffer || use_vertex_buffer) {
+        data->glBindBuffer(GL_ARRAY_BUFFER, use_vertex_buffer ? data->vertex_buffer : 0);
+    }
+}
+
 static int GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
 {
-    /* !!! FIXME: it'd be nice to use a vertex buffer instead of immediate mode... */
     GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    /* Client-side arrays are faster for the small batches drawn without batching */
+    const SDL_bool use_vertex_buffer = (data->vertex_buffer && vertsize > 0 && renderer->batching);
+    size_t vertex_offset = 0;
+    const void *client_vertices = vertices;
 
     if (GL_ActivateRenderer(renderer) < 0) {
         return -1;
@@ -1194,21 +1666,15 @@ static int GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, vo
     data->drawstate.viewport_dirty = SDL_TRUE;
 #endif
 
+    if (use_vertex_buffer) {
+        vertex_offset = GL_UploadVertices(data, vertices, vertsize);
+        vertices = (void *)(uintptr_t)vertex_offset; /* array pointers will be offsets into the VBO. */
+    }
+
     while (cmd) {
         switch (cmd->command) {
-        case SDL_RENDERCMD_SETDRAWCOLOR:
-        {
-            const Uint8 r = cmd->data.color.r;
-            const Uint8 g = cmd->data.color.g;
-            const Uint8 b = cmd->data.color.b;
-            const Uint8 a = cmd->data.color.a;
-            const Uint32 color = (((Uint32)a << 24) | (r << 16) | (g << 8) | b);
-            if (color != data->drawstate.color) {
-                data->glColor4ub((GLubyte)r, (GLubyte)g, (GLubyte)b, (GLubyte)a);
-                data->drawstate.color = color;
-            }
+        case SDL_RENDERCMD_SETDRAWCOLOR: /* draw colors are stored in the vertices */
             break;
-        }
 
         case SDL_RENDERCMD_SETVIEWPORT:
         {
@@ -1271,39 +1737,24 @@ static int GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, vo
 
         case SDL_RENDERCMD_DRAW_LINES:
         {
-            if (SetDrawState(data, cmd, SHADER_SOLID) == 0) {
+            if (SetDrawState(renderer, cmd, SHADER_SOLID) == 0) {
                 size_t count = cmd->data.draw.count;
                 const GLfloat *verts = (GLfloat *)(((Uint8 *)vertices) + cmd->data.draw.first);
 
                 /* SetDrawState handles glEnableClientState. */
-                data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 2, verts);
+                data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 3, verts + 0);
+                data->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(float) * 3, verts + 2);
 
                 if (count > 2) {
                     /* joined lines cannot be grouped */
                     data->glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)count);
+                    ++renderer->stats.draw_calls;
                 } else {
                     /* let's group non joined lines */
-                    SDL_RenderCommand *finalcmd = cmd;
-                    SDL_RenderCommand *nextcmd = cmd->next;
-                    SDL_BlendMode thisblend = cmd->data.draw.blend;
-
-                    while (nextcmd != NULL) {
-                        const SDL_RenderCommandType nextcmdtype = nextcmd->command;
-                        if (nextcmdtype != SDL_RENDERCMD_DRAW_LINES) {
-                            break; /* can't go any further on this draw call, different render command up next. */
-                        } else if (nextcmd->data.draw.count != 2) {
-                            break; /* can't go any further on this draw call, those are joined lines */
-                        } else if (nextcmd->data.draw.blend != thisblend) {
-                            break; /* can't go any further on this draw call, different blendmode copy up next. */
-                        } else {
-                            finalcmd = nextcmd; /* we can combine copy operations here. Mark this one as the furthest okay command. */
-                            count += nextcmd->data.draw.count;
-                        }
-                        nextcmd = nextcmd->next;
-                    }
-
+                    SDL_RenderCommand *finalcmd = GL_MergeDrawCommands(data, cmd, sizeof(float) * 3, &count);
                     data->glDrawArrays(GL_LINES, 0, (GLsizei)count);
-                    cmd = finalcmd; /* skip any copy commands we just combined in here. */
+                    ++renderer->stats.draw_calls;
+                    cmd = finalcmd; /* skip any line commands we just combined in here. */
                 }
             }
             break;
@@ -1315,64 +1766,35 @@ static int GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, vo
             /* as long as we have the same copy command in a row, with the
                same texture, we can combine them all into a single draw call. */
             SDL_Texture *thistexture = cmd->data.draw.texture;
-            SDL_BlendMode thisblend = cmd->data.draw.blend;
-            const SDL_RenderCommandType thiscmdtype = cmd->command;
-            SDL_RenderCommand *finalcmd = cmd;
-            SDL_RenderCommand *nextcmd = cmd->next;
-            size_t count = cmd->data.draw.count;
+            const size_t stride = sizeof(float) * (thistexture ? 5 : 3);
+            size_t count;
+            SDL_RenderCommand *finalcmd = GL_MergeDrawCommands(data, cmd, stride, &count);
             int ret;
-            while (nextcmd != NULL) {
-                const SDL_RenderCommandType nextcmdtype = nextcmd->command;
-                if (nextcmdtype != thiscmdtype) {
-                    break; /* can't go any further on this draw call, different render command up next. */
-                } else if (nextcmd->data.draw.texture != thistexture || nextcmd->data.draw.blend != thisblend) {
-                    break; /* can't go any further on this draw call, different texture/blendmode copy up next. */
-                } else {
-                    finalcmd = nextcmd; /* we can combine copy operations here. Mark this one as the furthest okay command. */
-                    count += nextcmd->data.draw.count;
-                }
-                nextcmd = nextcmd->next;
-            }
 
             if (thistexture) {
-                ret = SetCopyState(data, cmd);
+                ret = SetCopyState(renderer, cmd);
             } else {
-                ret = SetDrawState(data, cmd, SHADER_SOLID);
+                ret = SetDrawState(renderer, cmd, SHADER_SOLID);
             }
 
-            if (ret == 0) {
+            if (ret == 0 && cmd->data.draw.geometry) {
+                GL_DrawStaticGeometry(renderer, cmd, client_vertices, use_vertex_buffer);
+            } else if (ret == 0) {
                 const GLfloat *verts = (GLfloat *)(((Uint8 *)vertices) + cmd->data.draw.first);
                 int op = GL_TRIANGLES; /* SDL_RENDERCMD_GEOMETRY */
-                if (thiscmdtype == SDL_RENDERCMD_DRAW_POINTS) {
+                if (cmd->command == SDL_RENDERCMD_DRAW_POINTS) {
                     op = GL_POINTS;
                 }
 
-                if (thiscmdtype == SDL_RENDERCMD_DRAW_POINTS) {
-                    /* SetDrawState handles glEnableClientState. */
-                    data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 2, verts);
-                } else {
-                    /* SetDrawState handles glEnableClientState. */
-                    if (thistexture) {
-                        data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 5, verts + 0);
-                        data->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(float) * 5, verts + 2);
-                        data->glTexCoordPointer(2, GL_FLOAT, sizeof(float) * 5, verts + 3);
-                    } else {
-                        data->glVertexPointer(2, GL_FLOAT, sizeof(float) * 3, verts + 0);
-                        data->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(float) * 3, verts + 2);
-                    }
+                /* SetDrawState handles glEnableClientState. */
+                data->glVertexPointer(2, GL_FLOAT, (GLsizei)stride, verts + 0);
+                data->glColorPointer(4, GL_UNSIGNED_BYTE, (GLsizei)stride, verts + 2);
+                if (thistexture) {
+                    data->glTexCoordPointer(2, GL_FLOAT, (GLsizei)stride, verts + 3);
                 }
 
                 data->glDrawArrays(op, 0, (GLsizei)count);
-
-                /* Restore previously set color when we're done. */
-                if (thiscmdtype != SDL_RENDERCMD_DRAW_POINTS) {
-                    Uint32 color = data->drawstate.color;
-                    GLubyte a = (GLubyte)((color >> 24) & 0xFF);
-                    GLubyte r = (GLubyte)((color >> 16) & 0xFF);
-                    GLubyte g = (GLubyte)((color >> 8) & 0xFF);
-                    GLubyte b = (GLubyte)((color >> 0) & 0xFF);
-                    data->glColor4ub(r, g, b, a);
-                }
+                ++renderer->stats.draw_calls;
             }
 
             cmd = finalcmd; /* skip any copy commands we just combined in here. */
@@ -1386,6 +1808,12 @@ static int GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, vo
         cmd = cmd->next;
     }
 
+    if (use_vertex_buffer) {
+        GL_FenceVertices(data, vertex_offset, vertsize);
+        /* Leave client-side arrays working for code drawing after us */
+        data->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     /* Turn off vertex array state when we're done, in case external code
        relies on it being off. */
     if (data->drawstate.vertex_array) {
@@ -1474,6 +1902,150 @@ static int GL_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *rect,
     return status;
 }
 
+static void GL_DestroyReadback(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *)readback->driverdata;
+
+    GL_ActivateRenderer(renderer);
+
+    if (readbackdata->sync) {
+        data->glDeleteSync(readbackdata->sync);
+    }
+    if (data->num_readback_buffers < GL_MAX_READBACK_BUFFERS) {
+        data->readback_buffers[data->num_readback_buffers] = readbackdata->buffer;
+        data->readback_buffer_sizes[data->num_readback_buffers] = readbackdata->size;
+        ++data->num_readback_buffers;
+    } else {
+        data->glDeleteBuffers(1, &readbackdata->buffer);
+    }
+    SDL_free(readbackdata);
+    readback->driverdata = NULL;
+}
+
+static int GL_RenderReadPixelsAsync(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    GL_ReadbackData *readbackdata;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h;
+
+    GL_ActivateRenderer(renderer);
+
+    readbackdata = (GL_ReadbackData *)SDL_calloc(1, sizeof(*readbackdata));
+    if (readbackdata == NULL) {
+        return SDL_OutOfMemory();
+    }
+    readbackdata->format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ARGB8888;
+    readbackdata->pitch = rect->w * SDL_BYTESPERPIXEL(readbackdata->format);
+    readbackdata->flipped = renderer->target ? SDL_FALSE : SDL_TRUE;
+
+    if (!convert_format(data, readbackdata->format, &internalFormat, &format, &type)) {
+        SDL_free(readbackdata);
+        return SDL_SetError("Texture format %s not supported by OpenGL",
+                            SDL_GetPixelFormatName(readbackdata->format));
+    }
+
+    if (data->num_readback_buffers > 0) {
+        --data->num_readback_buffers;
+        readbackdata->buffer = data->readback_buffers[data->num_readback_buffers];
+        readbackdata->size = data->readback_buffer_sizes[data->num_readback_buffers];
+    } else {
+        data->glGenBuffers(1, &readbackdata->buffer);
+    }
+
+    SDL_GetCurrentRenderOutputSize(renderer, &w, &h);
+
+    /* The pixels are copied into the buffer by the GPU, we only wait for them when they're mapped */
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackdata->buffer);
+    if (readbackdata->size < (GLsizeiptr)rect->h * readbackdata->pitch) {
+        readbackdata->size = (GLsizeiptr)rect->h * readbackdata->pitch;
+        data->glBufferData(GL_PIXEL_PACK_BUFFER, readbackdata->size, NULL, GL_STREAM_READ);
+    }
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h - rect->y) - rect->h,
+                       rect->w, rect->h, format, type, NULL);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (data->GL_ARB_sync_supported) {
+        readbackdata->sync = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    readback->driverdata = readbackdata;
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        GL_DestroyReadback(renderer, readback);
+        return -1;
+    }
+    return 0;
+}
+
+static SDL_bool GL_IsReadbackReady(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *)readback->driverdata;
+
+    if (readbackdata->sync) {
+        GL_ActivateRenderer(renderer);
+
+        if (data->glClientWaitSync(readbackdata->sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+            return SDL_FALSE;
+        }
+        data->glDeleteSync(readbackdata->sync);
+        readbackdata->sync = NULL;
+    }
+    return SDL_TRUE;
+}
+
+static int GL_GetReadbackPixels(SDL_Renderer *renderer, SDL_RenderReadback *readback,
+                                void *pixels, int pitch)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *)readback->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    void *mapped;
+    int status;
+
+    GL_ActivateRenderer(renderer);
+
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackdata->buffer);
+    mapped = data->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)rect->h * readbackdata->pitch, GL_MAP_READ_BIT);
+    if (mapped == NULL) {
+        data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        GL_CheckError("", renderer);
+        return SDL_SetError("Couldn't map pixel buffer");
+    }
+
+    status = SDL_ConvertPixels(rect->w, rect->h,
+                               readbackdata->format, mapped, readbackdata->pitch,
+                               readback->format, pixels, pitch);
+
+    data->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    /* Flip the rows to be top-down if necessary */
+    if (status == 0 && readbackdata->flipped) {
+        SDL_bool isstack;
+        const int length = rect->w * SDL_BYTESPERPIXEL(readback->format);
+        Uint8 *src = (Uint8 *)pixels + (rect->h - 1) * pitch;
+        Uint8 *dst = (Uint8 *)pixels;
+        Uint8 *tmp = SDL_small_alloc(Uint8, length, &isstack);
+        int rows = rect->h / 2;
+        while (rows--) {
+            SDL_memcpy(tmp, dst, length);
+            SDL_memcpy(dst, src, length);
+            SDL_memcpy(src, tmp, length);
+            dst += pitch;
+            src -= pitch;
+        }
+        SDL_small_free(tmp, isstack);
+    }
+
+    return status;
+}
+
 static int GL_RenderPresent(SDL_Renderer *renderer)
 {
     GL_ActivateRenderer(renderer);
@@ -1507,11 +2079,28 @@ static void GL_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         renderdata->glDeleteTextures(1, &data->vtexture);
     }
 #endif
+    if (data->pixel_buffers[0]) {
+        renderdata->glDeleteBuffers(SDL_arraysize(data->pixel_buffers), data->pixel_buffers);
+    }
     SDL_free(data->pixels);
     SDL_free(data);
     texture->driverdata = NULL;
 }
 
+static void GL_DestroyStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
+    GL_StaticGeometryData *geometrydata = (GL_StaticGeometryData *)geometry->driverdata;
+
+    if (geometrydata->buffer) {
+        GL_ActivateRenderer(renderer);
+        data->glDeleteBuffers(1, &geometrydata->buffer);
+    }
+    SDL_free(geometrydata->vertices);
+    SDL_free(geometrydata);
+    geometry->driverdata = NULL;
+}
+
 static void GL_DestroyRenderer(SDL_Renderer *renderer)
 {
     GL_RenderData *data = (GL_RenderData *)renderer->driverdata;
@@ -1534,6 +2123,19 @@ static void GL_DestroyRenderer(SDL_Renderer *renderer)
             GL_DestroyShaderContext(data->shaders);
         }
         if (data->context) {
+            if (data->vertex_buffer) {
+                while (data->num_vertex_fences > 0) {
+                    data->glDeleteSync(data->vertex_fences[data->first_vertex_fence].sync);
+                    data->first_vertex_fence = (data->first_vertex_fence + 1) % GL_MAX_VERTEX_FENCES;
+                    --data->num_vertex_fences;
+                }
+                data->glDeleteBuffers(1, &data->vertex_buffer);
+                GL_CheckError("", renderer);
+            }
+            if (data->num_readback_buffers > 0) {
+                data->glDeleteBuffers(data->num_readback_buffers, data->readback_buffers);
+                GL_CheckError("", renderer);
+            }
             while (data->framebuffers) {
                 GL_FBOList *nextnode = data->framebuffers->next;
                 /* delete the framebuffer object */
@@ -1761,6 +2363,10 @@ static SDL_Renderer *GL_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueDrawPoints = GL_QueueDrawPoints;
     renderer->QueueDrawLines = GL_QueueDrawLines;
     renderer->QueueGeometry = GL_QueueGeometry;
+    renderer->CreateStaticGeometry = GL_CreateStaticGeometry;
+    renderer->QueueStaticGeometry = GL_QueueStaticGeometry;
+    renderer->DestroyStaticGeometry = GL_DestroyStaticGeometry;
+    renderer->QueueCopies = GL_QueueCopies;
     renderer->RunCommandQueue = GL_RunCommandQueue;
     renderer->RenderReadPixels = GL_RenderReadPixels;
     renderer->RenderPresent = GL_RenderPresent;
@@ -1888,6 +2494,54 @@ static SDL_Renderer *GL_CreateRenderer(SDL_Window *window, Uint32 flags)
         }
     }
 
+    /* Check for mapped buffers, which need OpenGL 3.0 or the same extensions (fences need 3.2) */
+    {
+        const char *verstr = (const char *)data->glGetString(GL_VERSION);
+        const char *dot = verstr ? SDL_strchr(verstr, '.') : NULL;
+        const int gl_major = verstr ? SDL_atoi(verstr) : 0;
+
+        if (gl_major >= 3 || SDL_GL_ExtensionSupported("GL_ARB_map_buffer_range")) {
+            data->glGenBuffers = (PFNGLGENBUFFERSPROC)SDL_GL_GetProcAddress("glGenBuffers");
+            data->glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)SDL_GL_GetProcAddress("glDeleteBuffers");
+            data->glBindBuffer = (PFNGLBINDBUFFERPROC)SDL_GL_GetProcAddress("glBindBuffer");
+            data->glBufferData = (PFNGLBUFFERDATAPROC)SDL_GL_GetProcAddress("glBufferData");
+            data->glBufferSubData = (PFNGLBUFFERSUBDATAPROC)SDL_GL_GetProcAddress("glBufferSubData");
+            data->glMapBufferRange = (PFNGLMAPBUFFERRANGEPROC)SDL_GL_GetProcAddress("glMapBufferRange");
+            data->glUnmapBuffer = (PFNGLUNMAPBUFFERPROC)SDL_GL_GetProcAddress("glUnmapBuffer");
+            if (data->glGenBuffers && data->glDeleteBuffers && data->glBindBuffer &&
+                data->glBufferData && data->glBufferSubData && data->glMapBufferRange &&
+                data->glUnmapBuffer) {
+                data->GL_ARB_map_buffer_range_supported = SDL_TRUE;
+            }
+        }
+        if (gl_major > 3 || (gl_major == 3 && dot && SDL_atoi(dot + 1) >= 2) ||
+            SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+            data->glFenceSync = (PFNGLFENCESYNCPROC)SDL_GL_GetProcAddress("glFenceSync");
+            data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)SDL_GL_GetProcAddress("glClientWaitSync");
+            data->glDeleteSync = (PFNGLDELETESYNCPROC)SDL_GL_GetProcAddress("glDeleteSync");
+            if (data->glFenceSync && data->glClientWaitSync && data->glDeleteSync) {
+                data->GL_ARB_sync_supported = SDL_TRUE;
+            }
+        }
+        if (data->GL_ARB_map_buffer_range_supported &&
+            (gl_major >= 3 || SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object"))) {
+            data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+        }
+    }
+
+    /* Stream vertices through a ring buffer, fenced for reuse */
+    if (data->GL_ARB_map_buffer_range_supported && data->GL_ARB_sync_supported) {
+        data->glGenBuffers(1, &data->vertex_buffer);
+    }
+
+    /* Read pixels into buffers, copied out once they're asked for */
+    if (data->GL_ARB_pixel_buffer_object_supported) {
+        renderer->RenderReadPixelsAsync = GL_RenderReadPixelsAsync;
+        renderer->IsReadbackReady = GL_IsReadbackReady;
+        renderer->GetReadbackPixels = GL_GetReadbackPixels;
+        renderer->DestroyReadback = GL_DestroyReadback;
+    }
+
     /* Check for shader support */
     if (SDL_GetHintBoolean(SDL_HINT_RENDER_OPENGL_SHADERS, SDL_TRUE)) {
         data->shaders = GL_CreateShaderContext();
@@ -1952,7 +2606,6 @@ static SDL_Renderer *GL_CreateRenderer(SDL_Window *window, Uint32 flags)
 
     data->drawstate.blend = SDL_BLENDMODE_INVALID;
     data->drawstate.shader = SHADER_INVALID;
-    data->drawstate.color = 0xFFFFFFFF;
     data->drawstate.clear_color = 0xFFFFFFFF;
 
     return renderer;
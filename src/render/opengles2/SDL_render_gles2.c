@@ -32,13 +32,57 @@
    on Emscripten, which converts GLES2 into WebGL calls.
    In all other cases, attempt to use client-side arrays, as they tend to
    be dramatically faster when not batching, and about the same when
-   we are. */
+   we are. Batches are streamed through a mapped buffer instead when the
+   context has OpenGL ES 3.0, which saves the driver a copy of them. */
 #ifdef __EMSCRIPTEN__
 #define USE_VERTEX_BUFFER_OBJECTS 1
 #else
 #define USE_VERTEX_BUFFER_OBJECTS 0
 #endif
 
+/* The vertex buffer starts out this big and grows to twice the largest batch */
+#define GLES2_VERTEX_BUFFER_SIZE (1024 * 1024)
+
+/* The most batches whose vertices can still be in use by the GPU */
+#define GLES2_MAX_VERTEX_FENCES 8
+
+/* Readback buffers kept around for reuse, so reading every frame doesn't reallocate */
+#define GLES2_MAX_READBACK_BUFFERS 2
+
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
 /* To prevent unnecessary window recreation,
  * these should match the defaults selected in SDL_GL_ResetAttributes
  */
@@ -66,6 +110,10 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     int pitch;
+    SDL_Rect locked_rect;
+    /* Streaming textures are locked into these in turn, if pixel_data is NULL */
+    GLuint pixel_buffers[2];
+    int pixel_buffer;
 #if SDL_HAVE_YUV
     /* YUV texture support */
     SDL_bool yuv;
@@ -76,6 +124,30 @@ typedef struct GLES2_TextureData
     GLES2_FBOList *fbo;
 } GLES2_TextureData;
 
+typedef struct GLES2_ReadbackData
+{
+    GLuint buffer;
+    GLsizeiptr size;
+    GLsync sync;
+    Uint32 format; /* the format of the pixels in the buffer */
+    int pitch;
+    SDL_bool flipped; /* the rows are bottom-up, as read from the window */
+} GLES2_ReadbackData;
+
+/* Static geometry lives in a buffer, with the colors as given and, once
+   it's drawn to a target that needs it, with red and blue swapped */
+typedef struct GLES2_StaticGeometryData
+{
+    GLuint buffers[2];
+} GLES2_StaticGeometryData;
+
+/* The vertex data of a static geometry draw command */
+typedef struct GLES2_StaticGeometryDraw
+{
+    float transform[6];
+    GLint first;
+} GLES2_StaticGeometryDraw;
+
 typedef struct GLES2_ProgramCacheEntry
 {
     GLuint id;
@@ -140,8 +212,17 @@ typedef struct
     int drawableh;
     GLES2_ProgramCacheEntry *program;
     GLfloat projection[4][4];
+    const float *transform; /* the transform of the static geometry being drawn, if not NULL */
 } GLES2_DrawStateCache;
 
+/* Marks the part of the vertex buffer a batch used, until the GPU is done with it */
+typedef struct GLES2_VertexFence
+{
+    GLsync sync;
+    size_t start;
+    size_t end;
+} GLES2_VertexFence;
+
 typedef struct GLES2_RenderData
 {
     SDL_GLContext *context;
@@ -161,11 +242,27 @@ typedef struct GLES2_RenderData
     GLES2_ProgramCache program_cache;
     Uint8 clear_r, clear_g, clear_b, clear_a;
 
-#if USE_VERTEX_BUFFER_OBJECTS
-    GLuint vertex_buffers[8];
-    size_t vertex_buffer_size[8];
-    int current_vertex_buffer;
-#endif
+    /* Vertices are streamed through this buffer, used as a ring, if it isn't 0 */
+    GLuint vertex_buffer;
+    size_t vertex_buffer_size;
+    size_t vertex_buffer_offset;
+    SDL_bool vertex_buffer_mapped;
+    GLES2_VertexFence vertex_fences[GLES2_MAX_VERTEX_FENCES];
+    int first_vertex_fence;
+    int num_vertex_fences;
+
+    /* Streaming textures and readbacks go through pixel buffers if this is set */
+    SDL_bool pixel_buffers_supported;
+    GLuint readback_buffers[GLES2_MAX_READBACK_BUFFERS];
+    GLsizeiptr readback_buffer_sizes[GLES2_MAX_READBACK_BUFFERS];
+    int num_readback_buffers;
+
+    /* OpenGL ES 3.0 functions used to map buffers */
+    void *(APIENTRY *glMapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield);
+    GLboolean(APIENTRY *glUnmapBuffer)(GLenum);
+    GLsync(APIENTRY *glFenceSync)(GLenum, GLbitfield);
+    GLenum(APIENTRY *glClientWaitSync)(GLsync, GLbitfield, GLuint64);
+    void(APIENTRY *glDeleteSync)(GLsync);
 
     GLES2_DrawStateCache drawstate;
     GLES2_ShaderIncludeType texcoord_precision_hint;
@@ -909,11 +1006,181 @@ static int GLES2_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, S
     return 0;
 }
 
-static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_ImageSource imgsrc, void *vertices)
+/* Copies the vertices of static geometry into a new buffer */
+static GLuint GLES2_CreateStaticGeometryBuffer(SDL_Renderer *renderer, SDL_StaticGeometry *geometry, SDL_bool colorswap)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    const int count = geometry->num_vertices;
+    const size_t sz = geometry->textured ? sizeof(SDL_Vertex) : sizeof(SDL_VertexSolid);
+    Uint8 *vertices;
+    GLuint buffer = 0;
+    int i;
+
+    vertices = (Uint8 *)SDL_malloc(count * sz);
+    if (vertices == NULL) {
+        SDL_OutOfMemory();
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        SDL_VertexSolid *verts = (SDL_VertexSolid *)(vertices + i * sz);
+        SDL_Color col_ = geometry->color[i];
+
+        verts->position.x = geometry->xy[i * 2];
+        verts->position.y = geometry->xy[i * 2 + 1];
+
+        if (colorswap) {
+            Uint8 r = col_.r;
+            col_.r = col_.b;
+            col_.b = r;
+        }
+
+        verts->color = col_;
+
+        if (geometry->textured) {
+            ((SDL_Vertex *)verts)->tex_coord.x = geometry->uv[i * 2];
+            ((SDL_Vertex *)verts)->tex_coord.y = geometry->uv[i * 2 + 1];
+        }
+    }
+
+    data->glGenBuffers(1, &buffer);
+    data->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    data->glBufferData(GL_ARRAY_BUFFER, count * sz, vertices, GL_STATIC_DRAW);
+    SDL_free(vertices);
+
+    if (GL_CheckError("glBufferData()", renderer) < 0) {
+        data->glDeleteBuffers(1, &buffer);
+        return 0;
+    }
+    return buffer;
+}
+
+static int GLES2_CreateStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_StaticGeometryData *geometrydata;
+
+    geometrydata = (GLES2_StaticGeometryData *)SDL_calloc(1, sizeof(*geometrydata));
+    if (geometrydata == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    GLES2_ActivateRenderer(renderer);
+
+    geometrydata->buffers[0] = GLES2_CreateStaticGeometryBuffer(renderer, geometry, SDL_FALSE);
+    data->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!geometrydata->buffers[0]) {
+        SDL_free(geometrydata);
+        return -1;
+    }
+
+    geometry->driverdata = geometrydata;
+    return 0;
+}
+
+static int GLES2_QueueStaticGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_StaticGeometry *geometry,
+                                     int first, int count, const float *transform)
+{
+    GLES2_StaticGeometryDraw *draw = (GLES2_StaticGeometryDraw *)SDL_AllocateRenderVertices(renderer, sizeof(*draw), 0, &cmd->data.draw.first);
+
+    if (draw == NULL) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+    SDL_memcpy(draw->transform, transform, sizeof(draw->transform));
+    draw->first = first;
+    return 0;
+}
+
+static int GLES2_QueueCopies(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
+                             const SDL_TextureBatchItem *items, int count, float scale_x, float scale_y)
+{
+    const SDL_bool colorswap = (renderer->target && (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 || renderer->target->format == SDL_PIXELFORMAT_RGB888));
+    const int *rect_index_order = renderer->rect_index_order;
+    SDL_Vertex *verts;
+    int i, j;
+
+    /* The batch is drawn as triangles, like SDL_RenderTexture() */
+    verts = (SDL_Vertex *)SDL_AllocateRenderVertices(renderer, count * 6 * sizeof(*verts), 0, &cmd->data.draw.first);
+    if (verts == NULL) {
+        return -1;
+    }
+
+    cmd->command = SDL_RENDERCMD_GEOMETRY;
+    cmd->data.draw.count = count * 6;
+
+    for (i = 0; i < count; i++) {
+        const SDL_TextureBatchItem *item = &items[i];
+        const float minu = item->srcrect.x / texture->w;
+        const float minv = item->srcrect.y / texture->h;
+        const float maxu = (item->srcrect.x + item->srcrect.w) / texture->w;
+        const float maxv = (item->srcrect.y + item->srcrect.h) / texture->h;
+        float xy[8];
+        float uv[8];
+        SDL_Color color;
+
+        SDL_GetTextureBatchItemCorners(item, scale_x, scale_y, xy);
+        SDL_GetTextureBatchItemColor(item, &texture->color, &color);
+        if (colorswap) {
+            Uint8 r = color.r;
+            color.r = color.b;
+            color.b = r;
+        }
+
+        uv[0] = minu;
+        uv[1] = minv;
+        uv[2] = maxu;
+        uv[3] = minv;
+        uv[4] = maxu;
+        uv[5] = maxv;
+        uv[6] = minu;
+        uv[7] = maxv;
+
+        for (j = 0; j < 6; j++, verts++) {
+            const int k = rect_index_order[j];
+            verts->position.x = xy[2 * k];
+            verts->position.y = xy[2 * k + 1];
+            verts->color = color;
+            verts->tex_coord.x = uv[2 * k];
+            verts->tex_coord.y = uv[2 * k + 1];
+        }
+    }
+    return 0;
+}
+
+/* Multiplies the projection by the affine transform of static geometry */
+static void GLES2_TransformProjection(GLfloat result[4][4], const GLfloat projection[4][4], const float *transform)
 {
+    GLfloat modelview[4][4];
+    int i, j, k;
+
+    SDL_zeroa(modelview);
+    modelview[0][0] = transform[0];
+    modelview[0][1] = transform[1];
+    modelview[1][0] = transform[2];
+    modelview[1][1] = transform[3];
+    modelview[2][2] = 1.0f;
+    modelview[3][0] = transform[4];
+    modelview[3][1] = transform[5];
+    modelview[3][3] = 1.0f;
+
+    for (i = 0; i < 4; i++) {
+        for (j = 0; j < 4; j++) {
+            result[i][j] = 0.0f;
+            for (k = 0; k < 4; k++) {
+                result[i][j] += projection[k][j] * modelview[i][k];
+            }
+        }
+    }
+}
+
+static int SetDrawState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, const GLES2_ImageSource imgsrc, void *vertices)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
     SDL_Texture *texture = cmd->data.draw.texture;
     const SDL_BlendMode blend = cmd->data.draw.blend;
-    GLES2_ProgramCacheEntry *program;
+    GLES2_ProgramCacheEntry *program = data->drawstate.program;
     int stride;
 
     SDL_assert((texture != NULL) == (imgsrc != GLES2_IMAGESOURCE_SOLID));
@@ -929,6 +1196,7 @@ static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, co
             data->drawstate.projection[3][1] = data->drawstate.target ? -1.0f : 1.0f;
         }
         data->drawstate.viewport_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if (data->drawstate.cliprect_enabled_dirty) {
@@ -938,6 +1206,7 @@ static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, co
             data->glEnable(GL_SCISSOR_TEST);
         }
         data->drawstate.cliprect_enabled_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if (data->drawstate.cliprect_enabled && data->drawstate.cliprect_dirty) {
@@ -947,6 +1216,7 @@ static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, co
                         data->drawstate.target ? viewport->y + rect->y : data->drawstate.drawableh - viewport->y - rect->y - rect->h,
                         rect->w, rect->h);
         data->drawstate.cliprect_dirty = SDL_FALSE;
+        ++renderer->stats.viewport_changes;
     }
 
     if ((texture != NULL) != data->drawstate.texturing) {
@@ -974,12 +1244,22 @@ static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, co
         return -1;
     }
 
-    program = data->drawstate.program;
+    if (data->drawstate.program != program) {
+        program = data->drawstate.program;
+        ++renderer->stats.shader_changes;
+    }
 
     if (program->uniform_locations[GLES2_UNIFORM_PROJECTION] != -1) {
-        if (SDL_memcmp(program->projection, data->drawstate.projection, sizeof(data->drawstate.projection)) != 0) {
-            data->glUniformMatrix4fv(program->uniform_locations[GLES2_UNIFORM_PROJECTION], 1, GL_FALSE, (GLfloat *)data->drawstate.projection);
-            SDL_memcpy(program->projection, data->drawstate.projection, sizeof(data->drawstate.projection));
+        GLfloat transformed[4][4];
+        GLfloat(*projection)[4] = data->drawstate.projection;
+
+        if (data->drawstate.transform) {
+            GLES2_TransformProjection(transformed, data->drawstate.projection, data->drawstate.transform);
+            projection = transformed;
+        }
+        if (SDL_memcmp(program->projection, projection, sizeof(transformed)) != 0) {
+            data->glUniformMatrix4fv(program->uniform_locations[GLES2_UNIFORM_PROJECTION], 1, GL_FALSE, (GLfloat *)projection);
+            SDL_memcpy(program->projection, projection, sizeof(transformed));
         }
     }
 
@@ -996,6 +1276,7 @@ static int SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, co
                                           GetBlendEquation(SDL_GetBlendModeAlphaOperation(blend)));
         }
         data->drawstate.blend = blend;
+        ++renderer->stats.blend_changes;
     }
 
     /* all drawing commands use this */
@@ -1123,7 +1404,7 @@ static int SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, vo
         }
     }
 
-    ret = SetDrawState(data, cmd, sourceType, vertices);
+    ret = SetDrawState(renderer, cmd, sourceType, vertices);
 
     if (texture != data->drawstate.texture) {
         GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
@@ -1145,8 +1426,187 @@ static int SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, vo
 #endif
         data->glBindTexture(tdata->texture_type, tdata->texture);
         data->drawstate.texture = texture;
+        ++renderer->stats.texture_changes;
+    }
+
+    return ret;
+}
+
+/* State commands that don't change anything for the next draw call, so
+   draw commands on either side of them can still be combined. */
+static SDL_bool GLES2_IsRedundantStateCommand(const GLES2_RenderData *data, const SDL_RenderCommand *cmd)
+{
+    switch (cmd->command) {
+    case SDL_RENDERCMD_NO_OP:
+    case SDL_RENDERCMD_SETDRAWCOLOR:
+        return SDL_TRUE;
+    case SDL_RENDERCMD_SETVIEWPORT:
+        return SDL_memcmp(&data->drawstate.viewport, &cmd->data.viewport.rect, sizeof(cmd->data.viewport.rect)) == 0;
+    case SDL_RENDERCMD_SETCLIPRECT:
+        return data->drawstate.cliprect_enabled == cmd->data.cliprect.enabled &&
+               SDL_memcmp(&data->drawstate.cliprect, &cmd->data.cliprect.rect, sizeof(cmd->data.cliprect.rect)) == 0;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+/* Finds the last draw command that can go into the same draw call as cmd:
+   same command, texture and blend mode, vertices directly following the ones
+   before it, and nothing but redundant state commands in between. */
+static SDL_RenderCommand *GLES2_MergeDrawCommands(const GLES2_RenderData *data, SDL_RenderCommand *cmd, size_t stride, size_t *count)
+{
+    SDL_RenderCommand *finalcmd = cmd;
+    SDL_RenderCommand *nextcmd;
+    size_t next_first = cmd->data.draw.first + cmd->data.draw.count * stride;
+
+    *count = cmd->data.draw.count;
+    if (cmd->data.draw.geometry) {
+        return finalcmd; /* static geometry has its own vertices. */
+    }
+    for (nextcmd = cmd->next; nextcmd != NULL; nextcmd = nextcmd->next) {
+        if (nextcmd->command != cmd->command) {
+            if (GLES2_IsRedundantStateCommand(data, nextcmd)) {
+                continue;
+            }
+            break; /* can't go any further on this draw call, different render command up next. */
+        } else if (nextcmd->data.draw.geometry) {
+            break; /* can't go any further on this draw call, static geometry has its own vertices. */
+        } else if (nextcmd->data.draw.texture != cmd->data.draw.texture || nextcmd->data.draw.blend != cmd->data.draw.blend) {
+            break; /* can't go any further on this draw call, different texture/blendmode copy up next. */
+        } else if (cmd->command == SDL_RENDERCMD_DRAW_LINES && nextcmd->data.draw.count != 2) {
+            break; /* can't go any further on this draw call, those are joined lines */
+        } else if (nextcmd->data.draw.first != next_first) {
+            break; /* can't go any further on this draw call, the vertices aren't contiguous. */
+        }
+        finalcmd = nextcmd; /* we can combine these operations here. Mark this one as the furthest okay command. */
+        *count += nextcmd->data.draw.count;
+        next_first += nextcmd->data.draw.count * stride;
+    }
+    return finalcmd;
+}
+
+/* Waits until the GPU is done with the oldest fenced vertices */
+static void GLES2_WaitVertexFence(GLES2_RenderData *data)
+{
+    GLES2_VertexFence *fence = &data->vertex_fences[data->first_vertex_fence];
+
+    while (data->glClientWaitSync(fence->sync, GL_SYNC_FLUSH_COMMANDS_BIT, SDL_NS_PER_SECOND) == GL_TIMEOUT_EXPIRED) {
+        /* keep waiting */
+    }
+    data->glDeleteSync(fence->sync);
+    data->first_vertex_fence = (data->first_vertex_fence + 1) % GLES2_MAX_VERTEX_FENCES;
+    --data->num_vertex_fences;
+}
+
+/* Copies the vertices of a batch after the ones of the batch before, wrapping
+   around to the start of the buffer once they don't fit at the end anymore.
+   Returns where the vertices went in the buffer. */
+static size_t GLES2_UploadVertices(GLES2_RenderData *data, const void *vertices, size_t vertsize)
+{
+    size_t offset = data->vertex_buffer_offset;
+    void *mapped = NULL;
+
+    data->glBindBuffer(GL_ARRAY_BUFFER, data->vertex_buffer);
+
+    if (vertsize > data->vertex_buffer_size / 2) {
+        size_t size = SDL_max(data->vertex_buffer_size, GLES2_VERTEX_BUFFER_SIZE);
+        while (size < vertsize * 2) {
+            size *= 2;
+        }
+
+        /* The GPU keeps the old storage for as long as it needs it */
+        while (data->num_vertex_fences > 0) {
+            data->glDeleteSync(data->vertex_fences[data->first_vertex_fence].sync);
+            data->first_vertex_fence = (data->first_vertex_fence + 1) % GLES2_MAX_VERTEX_FENCES;
+            --data->num_vertex_fences;
+        }
+        data->glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        data->vertex_buffer_size = size;
+        offset = 0;
+    } else if (offset + vertsize > data->vertex_buffer_size) {
+        offset = 0;
+        if (!data->vertex_buffer_mapped) {
+            /* Orphan the storage, instead of waiting for the GPU to be done with it */
+            data->glBufferData(GL_ARRAY_BUFFER, data->vertex_buffer_size, NULL, GL_STREAM_DRAW);
+        }
+    }
+
+    if (data->vertex_buffer_mapped) {
+        int i;
+
+        /* Fences complete in order, so wait up to the last one using this space */
+        for (i = data->num_vertex_fences - 1; i >= 0; --i) {
+            const GLES2_VertexFence *fence = &data->vertex_fences[(data->first_vertex_fence + i) % GLES2_MAX_VERTEX_FENCES];
+            if (fence->start < offset + vertsize && offset < fence->end) {
+                break;
+            }
+        }
+        for (; i >= 0; --i) {
+            GLES2_WaitVertexFence(data);
+        }
+        mapped = data->glMapBufferRange(GL_ARRAY_BUFFER, offset, vertsize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+    if (mapped) {
+        SDL_memcpy(mapped, vertices, vertsize);
+        data->glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        data->glBufferSubData(GL_ARRAY_BUFFER, offset, vertsize, vertices);
+    }
+
+    data->vertex_buffer_offset = offset + vertsize;
+    return offset;
+}
+
+/* Remembers that the commands just queued use these vertices */
+static void GLES2_FenceVertices(GLES2_RenderData *data, size_t offset, size_t vertsize)
+{
+    GLES2_VertexFence *fence;
+
+    if (data->num_vertex_fences == GLES2_MAX_VERTEX_FENCES) {
+        GLES2_WaitVertexFence(data);
+    }
+    fence = &data->vertex_fences[(data->first_vertex_fence + data->num_vertex_fences) % GLES2_MAX_VERTEX_FENCES];
+    fence->sync = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fence->start = offset;
+    fence->end = offset + vertsize;
+    if (fence->sync) {
+        ++data->num_vertex_fences;
+    }
+}
+
+/* Sets the state to draw static geometry from its own buffer, with the
+   transform applied to the projection. The attribute pointers keep the
+   buffer, so the vertex buffer is bound again right away. */
+static int SetStaticGeometryState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd, const void *vertices,
+                                  SDL_bool colorswap, SDL_bool use_vertex_buffer)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    SDL_StaticGeometry *geometry = cmd->data.draw.geometry;
+    GLES2_StaticGeometryData *geometrydata = (GLES2_StaticGeometryData *)geometry->driverdata;
+    const GLES2_StaticGeometryDraw *draw = (const GLES2_StaticGeometryDraw *)(((const Uint8 *)vertices) + cmd->data.draw.first);
+    SDL_RenderCommand staticcmd = *cmd;
+    int ret;
+
+    if (!geometrydata->buffers[colorswap]) {
+        geometrydata->buffers[colorswap] = GLES2_CreateStaticGeometryBuffer(renderer, geometry, colorswap);
+        if (!geometrydata->buffers[colorswap]) {
+            data->glBindBuffer(GL_ARRAY_BUFFER, use_vertex_buffer ? data->vertex_buffer : 0);
+            return -1;
+        }
+    } else {
+        data->glBindBuffer(GL_ARRAY_BUFFER, geometrydata->buffers[colorswap]);
     }
 
+    staticcmd.data.draw.first = draw->first * (cmd->data.draw.texture ? sizeof(SDL_Vertex) : sizeof(SDL_VertexSolid));
+    data->drawstate.transform = draw->transform;
+    if (cmd->data.draw.texture) {
+        ret = SetCopyState(renderer, &staticcmd, NULL);
+    } else {
+        ret = SetDrawState(renderer, &staticcmd, GLES2_IMAGESOURCE_SOLID, NULL);
+    }
+    data->drawstate.transform = NULL;
+
+    data->glBindBuffer(GL_ARRAY_BUFFER, use_vertex_buffer ? data->vertex_buffer : 0);
     return ret;
 }
 
@@ -1154,11 +1614,9 @@ static int GLES2_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
 {
     GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
     const SDL_bool colorswap = (renderer->target && (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 || renderer->target->format == SDL_PIXELFORMAT_RGB888));
-
-#if USE_VERTEX_BUFFER_OBJECTS
-    const int vboidx = data->current_vertex_buffer;
-    const GLuint vbo = data->vertex_buffers[vboidx];
-#endif
+    const SDL_bool use_vertex_buffer = (data->vertex_buffer && vertsize > 0 && (USE_VERTEX_BUFFER_OBJECTS || renderer->batching));
+    size_t vertex_offset = 0;
+    const void *client_vertices = vertices;
 
     if (GLES2_ActivateRenderer(renderer) < 0) {
         return -1;
@@ -1176,30 +1634,15 @@ static int GLES2_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
         }
     }
 
-#if USE_VERTEX_BUFFER_OBJECTS
-    /* upload the new VBO data for this set of commands. */
-    data->glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    if (data->vertex_buffer_size[vboidx] < vertsize) {
-        data->glBufferData(GL_ARRAY_BUFFER, vertsize, vertices, GL_STREAM_DRAW);
-        data->vertex_buffer_size[vboidx] = vertsize;
-    } else {
-        data->glBufferSubData(GL_ARRAY_BUFFER, 0, vertsize, vertices);
+    if (use_vertex_buffer) {
+        vertex_offset = GLES2_UploadVertices(data, vertices, vertsize);
+        vertices = (void *)(uintptr_t)vertex_offset; /* attrib pointers will be offsets into the VBO. */
     }
 
-    /* cycle through a few VBOs so the GL has some time with the data before we replace it. */
-    data->current_vertex_buffer++;
-    if (data->current_vertex_buffer >= SDL_arraysize(data->vertex_buffers)) {
-        data->current_vertex_buffer = 0;
-    }
-    vertices = NULL; /* attrib pointers will be offsets into the VBO. */
-#endif
-
     while (cmd) {
         switch (cmd->command) {
-        case SDL_RENDERCMD_SETDRAWCOLOR:
-        {
+        case SDL_RENDERCMD_SETDRAWCOLOR: /* draw colors are stored in the vertices */
             break;
-        }
 
         case SDL_RENDERCMD_SETVIEWPORT:
         {
@@ -1262,34 +1705,18 @@ static int GLES2_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
 
         case SDL_RENDERCMD_DRAW_LINES:
         {
-            if (SetDrawState(data, cmd, GLES2_IMAGESOURCE_SOLID, vertices) == 0) {
+            if (SetDrawState(renderer, cmd, GLES2_IMAGESOURCE_SOLID, vertices) == 0) {
                 size_t count = cmd->data.draw.count;
                 if (count > 2) {
                     /* joined lines cannot be grouped */
                     data->glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)count);
+                    ++renderer->stats.draw_calls;
                 } else {
                     /* let's group non joined lines */
-                    SDL_RenderCommand *finalcmd = cmd;
-                    SDL_RenderCommand *nextcmd = cmd->next;
-                    SDL_BlendMode thisblend = cmd->data.draw.blend;
-
-                    while (nextcmd != NULL) {
-                        const SDL_RenderCommandType nextcmdtype = nextcmd->command;
-                        if (nextcmdtype != SDL_RENDERCMD_DRAW_LINES) {
-                            break; /* can't go any further on this draw call, different render command up next. */
-                        } else if (nextcmd->data.draw.count != 2) {
-                            break; /* can't go any further on this draw call, those are joined lines */
-                        } else if (nextcmd->data.draw.blend != thisblend) {
-                            break; /* can't go any further on this draw call, different blendmode copy up next. */
-                        } else {
-                            finalcmd = nextcmd; /* we can combine copy operations here. Mark this one as the furthest okay command. */
-                            count += nextcmd->data.draw.count;
-                        }
-                        nextcmd = nextcmd->next;
-                    }
-
+                    SDL_RenderCommand *finalcmd = GLES2_MergeDrawCommands(data, cmd, sizeof(SDL_VertexSolid), &count);
                     data->glDrawArrays(GL_LINES, 0, (GLsizei)count);
-                    cmd = finalcmd; /* skip any copy commands we just combined in here. */
+                    ++renderer->stats.draw_calls;
+                    cmd = finalcmd; /* skip any line commands we just combined in here. */
                 }
             }
             break;
@@ -1301,37 +1728,26 @@ static int GLES2_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
             /* as long as we have the same copy command in a row, with the
                same texture, we can combine them all into a single draw call. */
             SDL_Texture *thistexture = cmd->data.draw.texture;
-            SDL_BlendMode thisblend = cmd->data.draw.blend;
-            const SDL_RenderCommandType thiscmdtype = cmd->command;
-            SDL_RenderCommand *finalcmd = cmd;
-            SDL_RenderCommand *nextcmd = cmd->next;
-            size_t count = cmd->data.draw.count;
+            const size_t stride = thistexture ? sizeof(SDL_Vertex) : sizeof(SDL_VertexSolid);
+            size_t count;
+            SDL_RenderCommand *finalcmd = GLES2_MergeDrawCommands(data, cmd, stride, &count);
             int ret;
-            while (nextcmd != NULL) {
-                const SDL_RenderCommandType nextcmdtype = nextcmd->command;
-                if (nextcmdtype != thiscmdtype) {
-                    break; /* can't go any further on this draw call, different render command up next. */
-                } else if (nextcmd->data.draw.texture != thistexture || nextcmd->data.draw.blend != thisblend) {
-                    break; /* can't go any further on this draw call, different texture/blendmode copy up next. */
-                } else {
-                    finalcmd = nextcmd; /* we can combine copy operations here. Mark this one as the furthest okay command. */
-                    count += nextcmd->data.draw.count;
-                }
-                nextcmd = nextcmd->next;
-            }
 
-            if (thistexture) {
+            if (cmd->data.draw.geometry) {
+                ret = SetStaticGeometryState(renderer, cmd, client_vertices, colorswap, use_vertex_buffer);
+            } else if (thistexture) {
                 ret = SetCopyState(renderer, cmd, vertices);
             } else {
-                ret = SetDrawState(data, cmd, GLES2_IMAGESOURCE_SOLID, vertices);
+                ret = SetDrawState(renderer, cmd, GLES2_IMAGESOURCE_SOLID, vertices);
             }
 
             if (ret == 0) {
                 int op = GL_TRIANGLES; /* SDL_RENDERCMD_GEOMETRY */
-                if (thiscmdtype == SDL_RENDERCMD_DRAW_POINTS) {
+                if (cmd->command == SDL_RENDERCMD_DRAW_POINTS) {
                     op = GL_POINTS;
                 }
                 data->glDrawArrays(op, 0, (GLsizei)count);
+                ++renderer->stats.draw_calls;
             }
 
             cmd = finalcmd; /* skip any copy commands we just combined in here. */
@@ -1345,9 +1761,31 @@ static int GLES2_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd,
         cmd = cmd->next;
     }
 
+    if (use_vertex_buffer) {
+        if (data->vertex_buffer_mapped) {
+            GLES2_FenceVertices(data, vertex_offset, vertsize);
+        }
+#if !USE_VERTEX_BUFFER_OBJECTS
+        /* Leave client-side arrays working for code drawing after us */
+        data->glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+    }
+
     return GL_CheckError("", renderer);
 }
 
+static void GLES2_DestroyStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_StaticGeometryData *geometrydata = (GLES2_StaticGeometryData *)geometry->driverdata;
+
+    GLES2_ActivateRenderer(renderer);
+
+    data->glDeleteBuffers(SDL_arraysize(geometrydata->buffers), geometrydata->buffers);
+    SDL_free(geometrydata);
+    geometry->driverdata = NULL;
+}
+
 static void GLES2_DestroyRenderer(SDL_Renderer *renderer)
 {
     GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
@@ -1386,10 +1824,19 @@ static void GLES2_DestroyRenderer(SDL_Renderer *renderer)
                 data->framebuffers = nextnode;
             }
 
-#if USE_VERTEX_BUFFER_OBJECTS
-            data->glDeleteBuffers(SDL_arraysize(data->vertex_buffers), data->vertex_buffers);
-            GL_CheckError("", renderer);
-#endif
+            if (data->vertex_buffer) {
+                while (data->num_vertex_fences > 0) {
+                    data->glDeleteSync(data->vertex_fences[data->first_vertex_fence].sync);
+                    data->first_vertex_fence = (data->first_vertex_fence + 1) % GLES2_MAX_VERTEX_FENCES;
+                    --data->num_vertex_fences;
+                }
+                data->glDeleteBuffers(1, &data->vertex_buffer);
+                GL_CheckError("", renderer);
+            }
+            if (data->num_readback_buffers > 0) {
+                data->glDeleteBuffers(data->num_readback_buffers, data->readback_buffers);
+                GL_CheckError("", renderer);
+            }
 
             SDL_GL_DeleteContext(data->context);
         }
@@ -1465,8 +1912,21 @@ static int GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 #endif
     scaleMode = (texture->scaleMode == SDL_SCALEMODE_NEAREST) ? GL_NEAREST : GL_LINEAR;
 
-    /* Allocate a blob for image renderdata */
-    if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
+    /* Streaming textures are locked straight into pixel buffers when they can be,
+       the pixels are uploaded as they are so that only works on little endian. */
+    if (texture->access == SDL_TEXTUREACCESS_STREAMING && renderdata->pixel_buffers_supported &&
+        SDL_BYTEORDER == SDL_LIL_ENDIAN && !SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+        const GLsizeiptr size = (GLsizeiptr)texture->h * texture->w * SDL_BYTESPERPIXEL(texture->format);
+        int i;
+
+        renderdata->glGenBuffers(SDL_arraysize(data->pixel_buffers), data->pixel_buffers);
+        for (i = 0; i < SDL_arraysize(data->pixel_buffers); ++i) {
+            renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, data->pixel_buffers[i]);
+            renderdata->glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        }
+        renderdata->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
+        /* Allocate a blob for image renderdata */
         size_t size;
         data->pitch = texture->w * SDL_BYTESPERPIXEL(texture->format);
         size = (size_t)texture->h * data->pitch;
@@ -1798,6 +2258,27 @@ static int GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const
 {
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
 
+    if (tdata->pixel_buffers[0]) {
+        GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+        const int length = rect->w * SDL_BYTESPERPIXEL(texture->format);
+
+        GLES2_ActivateRenderer(renderer);
+
+        /* Invalidating the buffer lets the driver hand out fresh memory while
+           the GPU may still be copying the last upload out of it. */
+        tdata->locked_rect = *rect;
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tdata->pixel_buffers[tdata->pixel_buffer]);
+        *pixels = data->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)rect->h * length,
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (*pixels == NULL) {
+            GL_CheckError("", renderer);
+            return SDL_SetError("Couldn't map pixel buffer");
+        }
+        *pitch = length;
+        return 0;
+    }
+
     /* Retrieve the buffer/pitch for the specified region */
     *pixels = (Uint8 *)tdata->pixel_data +
               (tdata->pitch * rect->y) +
@@ -1812,6 +2293,27 @@ static void GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
     SDL_Rect rect;
 
+    if (tdata->pixel_buffers[0]) {
+        GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+
+        GLES2_ActivateRenderer(renderer);
+
+        data->drawstate.texture = NULL; /* we trash this state. */
+
+        /* The pixels are copied from the buffer by the GPU, after we return */
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, tdata->pixel_buffers[tdata->pixel_buffer]);
+        data->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        data->glBindTexture(tdata->texture_type, tdata->texture);
+        data->glTexSubImage2D(tdata->texture_type, 0, tdata->locked_rect.x, tdata->locked_rect.y,
+                              tdata->locked_rect.w, tdata->locked_rect.h,
+                              tdata->pixel_format, tdata->pixel_type, NULL);
+        data->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        GL_CheckError("glTexSubImage2D()", renderer);
+
+        tdata->pixel_buffer = (tdata->pixel_buffer + 1) % SDL_arraysize(tdata->pixel_buffers);
+        return;
+    }
+
     /* We do whole texture updates, at least for now */
     rect.x = 0;
     rect.y = 0;
@@ -1900,6 +2402,9 @@ static void GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
             data->glDeleteTextures(1, &tdata->texture_u);
         }
 #endif
+        if (tdata->pixel_buffers[0]) {
+            data->glDeleteBuffers(SDL_arraysize(tdata->pixel_buffers), tdata->pixel_buffers);
+        }
         SDL_free(tdata->pixel_data);
         SDL_free(tdata);
         texture->driverdata = NULL;
@@ -1963,6 +2468,138 @@ static int GLES2_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *rect,
     return status;
 }
 
+static void GLES2_DestroyReadback(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_ReadbackData *readbackdata = (GLES2_ReadbackData *)readback->driverdata;
+
+    GLES2_ActivateRenderer(renderer);
+
+    if (readbackdata->sync) {
+        data->glDeleteSync(readbackdata->sync);
+    }
+    if (data->num_readback_buffers < GLES2_MAX_READBACK_BUFFERS) {
+        data->readback_buffers[data->num_readback_buffers] = readbackdata->buffer;
+        data->readback_buffer_sizes[data->num_readback_buffers] = readbackdata->size;
+        ++data->num_readback_buffers;
+    } else {
+        data->glDeleteBuffers(1, &readbackdata->buffer);
+    }
+    SDL_free(readbackdata);
+    readback->driverdata = NULL;
+}
+
+static int GLES2_RenderReadPixelsAsync(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    GLES2_ReadbackData *readbackdata;
+    int w, h;
+
+    GLES2_ActivateRenderer(renderer);
+
+    readbackdata = (GLES2_ReadbackData *)SDL_calloc(1, sizeof(*readbackdata));
+    if (readbackdata == NULL) {
+        return SDL_OutOfMemory();
+    }
+    readbackdata->format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ABGR8888;
+    readbackdata->pitch = rect->w * SDL_BYTESPERPIXEL(readbackdata->format);
+    readbackdata->flipped = renderer->target ? SDL_FALSE : SDL_TRUE;
+
+    if (data->num_readback_buffers > 0) {
+        --data->num_readback_buffers;
+        readbackdata->buffer = data->readback_buffers[data->num_readback_buffers];
+        readbackdata->size = data->readback_buffer_sizes[data->num_readback_buffers];
+    } else {
+        data->glGenBuffers(1, &readbackdata->buffer);
+    }
+
+    SDL_GetCurrentRenderOutputSize(renderer, &w, &h);
+
+    /* The pixels are copied into the buffer by the GPU, we only wait for them when they're mapped */
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackdata->buffer);
+    if (readbackdata->size < (GLsizeiptr)rect->h * readbackdata->pitch) {
+        readbackdata->size = (GLsizeiptr)rect->h * readbackdata->pitch;
+        data->glBufferData(GL_PIXEL_PACK_BUFFER, readbackdata->size, NULL, GL_STREAM_READ);
+    }
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h - rect->y) - rect->h,
+                       rect->w, rect->h, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackdata->sync = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    readback->driverdata = readbackdata;
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        GLES2_DestroyReadback(renderer, readback);
+        return -1;
+    }
+    return 0;
+}
+
+static SDL_bool GLES2_IsReadbackReady(SDL_Renderer *renderer, SDL_RenderReadback *readback)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_ReadbackData *readbackdata = (GLES2_ReadbackData *)readback->driverdata;
+
+    if (readbackdata->sync) {
+        GLES2_ActivateRenderer(renderer);
+
+        if (data->glClientWaitSync(readbackdata->sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+            return SDL_FALSE;
+        }
+        data->glDeleteSync(readbackdata->sync);
+        readbackdata->sync = NULL;
+    }
+    return SDL_TRUE;
+}
+
+static int GLES2_GetReadbackPixels(SDL_Renderer *renderer, SDL_RenderReadback *readback,
+                                   void *pixels, int pitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_ReadbackData *readbackdata = (GLES2_ReadbackData *)readback->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    void *mapped;
+    int status;
+
+    GLES2_ActivateRenderer(renderer);
+
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackdata->buffer);
+    mapped = data->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)rect->h * readbackdata->pitch, GL_MAP_READ_BIT);
+    if (mapped == NULL) {
+        data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        GL_CheckError("", renderer);
+        return SDL_SetError("Couldn't map pixel buffer");
+    }
+
+    status = SDL_ConvertPixels(rect->w, rect->h,
+                               readbackdata->format, mapped, readbackdata->pitch,
+                               readback->format, pixels, pitch);
+
+    data->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    data->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    /* Flip the rows to be top-down if necessary */
+    if (status == 0 && readbackdata->flipped) {
+        SDL_bool isstack;
+        const int length = rect->w * SDL_BYTESPERPIXEL(readback->format);
+        Uint8 *src = (Uint8 *)pixels + (rect->h - 1) * pitch;
+        Uint8 *dst = (Uint8 *)pixels;
+        Uint8 *tmp = SDL_small_alloc(Uint8, length, &isstack);
+        int rows = rect->h / 2;
+        while (rows--) {
+            SDL_memcpy(tmp, dst, length);
+            SDL_memcpy(dst, src, length);
+            SDL_memcpy(src, tmp, length);
+            dst += pitch;
+            src -= pitch;
+        }
+        SDL_small_free(tmp, isstack);
+    }
+
+    return status;
+}
+
 static int GLES2_RenderPresent(SDL_Renderer *renderer)
 {
     /* Tell the video driver to swap buffers */
@@ -2173,10 +2810,23 @@ static SDL_Renderer *GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     data->glGetIntegerv(GL_MAX_TEXTURE_SIZE, &value);
     renderer->info.max_texture_height = value;
 
-#if USE_VERTEX_BUFFER_OBJECTS
-    /* we keep a few of these and cycle through them, so data can live for a few frames. */
-    data->glGenBuffers(SDL_arraysize(data->vertex_buffers), data->vertex_buffers);
-#endif
+    /* Stream vertices through a mapped buffer if the context can do it without stalls */
+    {
+        const char *version = (const char *)data->glGetString(GL_VERSION);
+        if (version && SDL_strncmp(version, "OpenGL ES ", 10) == 0 && SDL_atoi(version + 10) >= 3) {
+            data->glMapBufferRange = (void *(APIENTRY *)(GLenum, GLintptr, GLsizeiptr, GLbitfield))SDL_GL_GetProcAddress("glMapBufferRange");
+            data->glUnmapBuffer = (GLboolean(APIENTRY *)(GLenum))SDL_GL_GetProcAddress("glUnmapBuffer");
+            data->glFenceSync = (GLsync(APIENTRY *)(GLenum, GLbitfield))SDL_GL_GetProcAddress("glFenceSync");
+            data->glClientWaitSync = (GLenum(APIENTRY *)(GLsync, GLbitfield, GLuint64))SDL_GL_GetProcAddress("glClientWaitSync");
+            data->glDeleteSync = (void(APIENTRY *)(GLsync))SDL_GL_GetProcAddress("glDeleteSync");
+            data->vertex_buffer_mapped = (data->glMapBufferRange && data->glUnmapBuffer &&
+                                          data->glFenceSync && data->glClientWaitSync && data->glDeleteSync);
+            data->pixel_buffers_supported = data->vertex_buffer_mapped;
+        }
+    }
+    if (USE_VERTEX_BUFFER_OBJECTS || data->vertex_buffer_mapped) {
+        data->glGenBuffers(1, &data->vertex_buffer);
+    }
 
     data->framebuffers = NULL;
     data->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &window_framebuffer);
@@ -2200,8 +2850,18 @@ static SDL_Renderer *GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueDrawPoints = GLES2_QueueDrawPoints;
     renderer->QueueDrawLines = GLES2_QueueDrawLines;
     renderer->QueueGeometry = GLES2_QueueGeometry;
+    renderer->CreateStaticGeometry = GLES2_CreateStaticGeometry;
+    renderer->QueueStaticGeometry = GLES2_QueueStaticGeometry;
+    renderer->DestroyStaticGeometry = GLES2_DestroyStaticGeometry;
+    renderer->QueueCopies = GLES2_QueueCopies;
     renderer->RunCommandQueue = GLES2_RunCommandQueue;
     renderer->RenderReadPixels = GLES2_RenderReadPixels;
+    if (data->pixel_buffers_supported) {
+        renderer->RenderReadPixelsAsync = GLES2_RenderReadPixelsAsync;
+        renderer->IsReadbackReady = GLES2_IsReadbackReady;
+        renderer->GetReadbackPixels = GLES2_GetReadbackPixels;
+        renderer->DestroyReadback = GLES2_DestroyReadback;
+    }
     renderer->RenderPresent = GLES2_RenderPresent;
     renderer->DestroyTexture = GLES2_DestroyTexture;
     renderer->DestroyRenderer = GLES2_DestroyRenderer;
@@ -230,6 +230,7 @@ int SDL_BlendFillRect(SDL_Surface *dst, const SDL_Rect *rect,
     } else {
         rect = &dst->clip_rect;
     }
+    SDL_AddSurfaceDamage(dst, rect);
 
     if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
         r = DRAW_MUL(r, a);
@@ -338,6 +339,7 @@ int SDL_BlendFillRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
         if (!SDL_GetRectIntersection(&rects[i], &dst->clip_rect, &rect)) {
             continue;
         }
+        SDL_AddSurfaceDamage(dst, &rect);
         status = func(dst, &rect, blendMode, r, g, b, a);
     }
     return status;
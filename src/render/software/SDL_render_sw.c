@@ -23,6 +23,8 @@
 #if SDL_VIDEO_RENDER_SW && !defined(SDL_RENDER_DISABLED)
 
 #include "../SDL_sysrender.h"
+#include "../../thread/SDL_systhread.h"
+#include "../../video/SDL_pixels_c.h"
 #include "SDL_render_sw_c.h"
 
 #include "SDL_draw.h"
@@ -43,10 +45,127 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+/* A surface kept between rotated copies, with its allocated size */
+typedef struct
+{
+    SDL_Surface *surface;
+    int w, h;
+} SW_ScratchSurface;
+
+/* How many blit maps a texture keeps besides its current one, see SW_SelectBlitMap() */
+#define SW_BLIT_MAP_CACHE_SIZE 4
+
+/* Blit maps of a texture surface for the copy states it was drawn with recently,
+   so that going back to a color mod or blend mode doesn't remap the blit */
+typedef struct
+{
+    SDL_BlitMap *maps[SW_BLIT_MAP_CACHE_SIZE]; /* most recently used first */
+} SW_BlitMapCache;
+
+typedef struct
+{
+    SDL_Surface *surface;
+    SW_BlitMapCache maps;
+} SW_TextureData;
+
+/* With more than one thread, draws are binned in tiles of this size */
+#define SW_TILE_SIZE 64
+
+typedef struct SW_TileWorker
+{
+    struct SW_TileContext *context;
+    SDL_Thread *thread;
+
+    /* A view of the target, with its own clip rect */
+    SW_ScratchSurface target;
+} SW_TileWorker;
+
+/* A blit of a texture to the target, set up once on the rendering thread
+   and run by the workers on their own copy of the blit info */
+typedef struct
+{
+    SDL_Surface *source;
+    SDL_Color color;
+    SDL_BlendMode blend;
+    SDL_BlitFunc func;
+    SDL_BlitInfo info;
+} SW_TileBlit;
+
+/* A copy clipped to the texture and to the clip rect, still to be clipped to each tile */
+typedef struct
+{
+    SDL_Rect srcrect;
+    SDL_Rect dstrect;
+    int blit;
+} SW_TileCopy;
+
+/* A view of a texture set up for drawing geometry, read by all the workers */
+typedef struct
+{
+    SDL_Surface *source;
+    SDL_Color color;
+    SDL_BlendMode blend;
+    SW_ScratchSurface view;
+} SW_TileTexture;
+
+/* A draw command binned in the tiles it touches */
+typedef struct
+{
+    const SDL_RenderCommand *cmd;
+    SDL_Rect clip;
+    int tile_x0, tile_y0, tile_x1, tile_y1;
+
+    /* The copies of a copy command, or the texture view of textured geometry */
+    int first_copy, num_copies;
+    SDL_Surface *texture;
+} SW_TileJob;
+
+typedef struct SW_TileContext
+{
+    /* workers[0] is the rendering thread, the others have their own thread */
+    int num_workers;
+    SW_TileWorker *workers;
+
+    SDL_Mutex *lock;
+    SDL_Condition *work_ready;
+    SDL_Condition *work_done;
+    Uint32 generation;
+    int busy;
+    SDL_bool quit;
+
+    /* The batch of draws being collected */
+    SDL_Surface *surface;
+    void *vertices;
+    int tiles_x, tiles_y;
+    SW_TileJob *jobs;
+    int num_jobs, max_jobs;
+    SW_TileCopy *copies;
+    int num_copies, max_copies;
+    SW_TileBlit *blits;
+    int num_blits, max_blits;
+    SW_TileTexture *textures;
+    int num_textures, max_textures;
+
+    /* Indices of the jobs of each tile, in draw order */
+    int *bins;
+    int *bin_start;
+    int max_bins, max_tiles;
+    SDL_AtomicInt next_tile;
+} SW_TileContext;
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    SW_TileContext *tiles;
+
+    /* The intermediate surfaces of rotated copies */
+    SW_ScratchSurface source;
+    SW_ScratchSurface scaled;
+    SW_ScratchSurface mask;
+    SW_ScratchSurface rotated;
+    SW_ScratchSurface mask_rotated;
+    SW_ScratchSurface rotated_rgb;
 } SW_RenderData;
 
 static SDL_Surface *SW_ActivateRenderer(SDL_Renderer *renderer)
@@ -99,25 +218,30 @@ static int SW_GetOutputSize(SDL_Renderer *renderer, int *w, int *h)
 
 static int SW_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
-    SDL_Surface *surface = SDL_CreateSurface(texture->w, texture->h, texture->format);
+    SW_TextureData *texturedata;
+    SDL_Surface *surface;
+
+    texturedata = (SW_TextureData *)SDL_calloc(1, sizeof(*texturedata));
+    if (texturedata == NULL) {
+        return SDL_OutOfMemory();
+    }
 
+    surface = SDL_CreateSurface(texture->w, texture->h, texture->format);
     if (surface == NULL) {
+        SDL_free(texturedata);
         return SDL_SetError("Cannot create surface");
     }
-    texture->driverdata = surface;
-    SDL_SetSurfaceColorMod(texture->driverdata, texture->color.r, texture->color.g, texture->color.b);
-    SDL_SetSurfaceAlphaMod(texture->driverdata, texture->color.a);
-    SDL_SetSurfaceBlendMode(texture->driverdata, texture->blendMode);
+    texturedata->surface = surface;
+    texture->driverdata = texturedata;
+    SDL_SetSurfaceColorMod(surface, texture->color.r, texture->color.g, texture->color.b);
+    SDL_SetSurfaceAlphaMod(surface, texture->color.a);
+    SDL_SetSurfaceBlendMode(surface, texture->blendMode);
 
     /* Only RLE encode textures without an alpha channel since the RLE coder
      * discards the color values of pixels with an alpha value of zero.
      */
     if (texture->access == SDL_TEXTUREACCESS_STATIC && !surface->format->Amask) {
-        SDL_SetSurfaceRLE(texture->driverdata, 1);
-    }
-
-    if (!texture->driverdata) {
-        return -1;
+        SDL_SetSurfaceRLE(surface, 1);
     }
     return 0;
 }
@@ -125,7 +249,7 @@ static int SW_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 static int SW_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture,
                             const SDL_Rect *rect, const void *pixels, int pitch)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->driverdata;
+    SDL_Surface *surface = ((SW_TextureData *)texture->driverdata)->surface;
     Uint8 *src, *dst;
     int row;
     size_t length;
@@ -152,7 +276,7 @@ static int SW_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture,
 static int SW_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture,
                           const SDL_Rect *rect, void **pixels, int *pitch)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->driverdata;
+    SDL_Surface *surface = ((SW_TextureData *)texture->driverdata)->surface;
 
     *pixels =
         (void *)((Uint8 *)surface->pixels + rect->y * surface->pitch +
@@ -174,7 +298,7 @@ static int SW_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
     SW_RenderData *data = (SW_RenderData *)renderer->driverdata;
 
     if (texture) {
-        data->surface = (SDL_Surface *)texture->driverdata;
+        data->surface = ((SW_TextureData *)texture->driverdata)->surface;
     } else {
         data->surface = data->window;
     }
@@ -226,10 +350,17 @@ static int SW_QueueFillRects(SDL_Renderer *renderer, SDL_RenderCommand *cmd, con
     return 0;
 }
 
+typedef struct CopyData
+{
+    SDL_Rect srcrect;
+    SDL_Rect dstrect;
+    SDL_Color color;
+} CopyData;
+
 static int SW_QueueCopy(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
                         const SDL_FRect *srcrect, const SDL_FRect *dstrect)
 {
-    SDL_Rect *verts = (SDL_Rect *)SDL_AllocateRenderVertices(renderer, 2 * sizeof(SDL_Rect), 0, &cmd->data.draw.first);
+    CopyData *verts = (CopyData *)SDL_AllocateRenderVertices(renderer, sizeof(CopyData), 0, &cmd->data.draw.first);
 
     if (verts == NULL) {
         return -1;
@@ -237,16 +368,18 @@ static int SW_QueueCopy(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Text
 
     cmd->data.draw.count = 1;
 
-    verts->x = (int)srcrect->x;
-    verts->y = (int)srcrect->y;
-    verts->w = (int)srcrect->w;
-    verts->h = (int)srcrect->h;
-    verts++;
-
-    verts->x = (int)dstrect->x;
-    verts->y = (int)dstrect->y;
-    verts->w = (int)dstrect->w;
-    verts->h = (int)dstrect->h;
+    verts->srcrect.x = (int)srcrect->x;
+    verts->srcrect.y = (int)srcrect->y;
+    verts->srcrect.w = (int)srcrect->w;
+    verts->srcrect.h = (int)srcrect->h;
+    verts->dstrect.x = (int)dstrect->x;
+    verts->dstrect.y = (int)dstrect->y;
+    verts->dstrect.w = (int)dstrect->w;
+    verts->dstrect.h = (int)dstrect->h;
+    verts->color.r = cmd->data.draw.r;
+    verts->color.g = cmd->data.draw.g;
+    verts->color.b = cmd->data.draw.b;
+    verts->color.a = cmd->data.draw.a;
 
     return 0;
 }
@@ -260,6 +393,7 @@ typedef struct CopyExData
     SDL_RendererFlip flip;
     float scale_x;
     float scale_y;
+    SDL_Color color;
 } CopyExData;
 
 static int SW_QueueCopyEx(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
@@ -287,6 +421,90 @@ static int SW_QueueCopyEx(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Te
     verts->flip = flip;
     verts->scale_x = scale_x;
     verts->scale_y = scale_y;
+    verts->color.r = cmd->data.draw.r;
+    verts->color.g = cmd->data.draw.g;
+    verts->color.b = cmd->data.draw.b;
+    verts->color.a = cmd->data.draw.a;
+
+    return 0;
+}
+
+/* Queues the batch as a single copy command, or as a single rotated copy
+   command if any item needs to be rotated or flipped */
+static int SW_QueueCopies(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
+                          const SDL_TextureBatchItem *items, int count, float scale_x, float scale_y)
+{
+    SDL_bool rotated = SDL_FALSE;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        if (items[i].flip != SDL_FLIP_NONE || (int)(items[i].angle / 360) != items[i].angle / 360) {
+            rotated = SDL_TRUE;
+            break;
+        }
+    }
+
+    cmd->data.draw.count = count;
+
+    if (rotated) {
+        CopyExData *verts = (CopyExData *)SDL_AllocateRenderVertices(renderer, count * sizeof(CopyExData), 0, &cmd->data.draw.first);
+
+        if (verts == NULL) {
+            return -1;
+        }
+
+        cmd->command = SDL_RENDERCMD_COPY_EX;
+        for (i = 0; i < count; i++, verts++) {
+            const SDL_TextureBatchItem *item = &items[i];
+            verts->srcrect.x = (int)item->srcrect.x;
+            verts->srcrect.y = (int)item->srcrect.y;
+            verts->srcrect.w = (int)item->srcrect.w;
+            verts->srcrect.h = (int)item->srcrect.h;
+            if (item->flip == SDL_FLIP_NONE && (int)(item->angle / 360) == item->angle / 360) {
+                /* Drawn as a plain copy, see SW_DrawCommand() */
+                verts->dstrect.x = (int)(item->dstrect.x * scale_x);
+                verts->dstrect.y = (int)(item->dstrect.y * scale_y);
+                verts->dstrect.w = (int)(item->dstrect.w * scale_x);
+                verts->dstrect.h = (int)(item->dstrect.h * scale_y);
+                verts->angle = 0.0;
+                verts->flip = SDL_FLIP_NONE;
+                verts->scale_x = 1.0f;
+                verts->scale_y = 1.0f;
+            } else {
+                verts->dstrect.x = (int)item->dstrect.x;
+                verts->dstrect.y = (int)item->dstrect.y;
+                verts->dstrect.w = (int)item->dstrect.w;
+                verts->dstrect.h = (int)item->dstrect.h;
+                verts->angle = item->angle;
+                verts->flip = item->flip;
+                verts->scale_x = scale_x;
+                verts->scale_y = scale_y;
+            }
+            verts->center.x = item->dstrect.w / 2.0f;
+            verts->center.y = item->dstrect.h / 2.0f;
+            SDL_GetTextureBatchItemColor(item, &texture->color, &verts->color);
+        }
+    } else {
+        CopyData *verts = (CopyData *)SDL_AllocateRenderVertices(renderer, count * sizeof(CopyData), 0, &cmd->data.draw.first);
+
+        if (verts == NULL) {
+            return -1;
+        }
+
+        cmd->command = SDL_RENDERCMD_COPY;
+        for (i = 0; i < count; i++, verts++) {
+            const SDL_TextureBatchItem *item = &items[i];
+            verts->srcrect.x = (int)item->srcrect.x;
+            verts->srcrect.y = (int)item->srcrect.y;
+            verts->srcrect.w = (int)item->srcrect.w;
+            verts->srcrect.h = (int)item->srcrect.h;
+            verts->dstrect.x = (int)(item->dstrect.x * scale_x);
+            verts->dstrect.y = (int)(item->dstrect.y * scale_y);
+            verts->dstrect.w = (int)(item->dstrect.w * scale_x);
+            verts->dstrect.h = (int)(item->dstrect.h * scale_y);
+            SDL_GetTextureBatchItemColor(item, &texture->color, &verts->color);
+        }
+    }
 
     return 0;
 }
@@ -309,11 +527,72 @@ static int Blit_to_Screen(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *surf
     return retval;
 }
 
+/* Gives a scratch surface the size and the default state of a new surface */
+static SDL_Surface *SW_ResetScratchSurface(SDL_Surface *surface, int w, int h)
+{
+    surface->w = w;
+    surface->h = h;
+    SDL_SetSurfaceClipRect(surface, NULL);
+    SDL_SetSurfaceColorKey(surface, SDL_FALSE, 0);
+    SDL_SetSurfaceBlendMode(surface, surface->format->Amask ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    SDL_SetSurfaceColorMod(surface, 255, 255, 255);
+    SDL_SetSurfaceAlphaMod(surface, 255);
+    return surface;
+}
+
+/* Returns a surface with undefined content, with extra_rows of pixels past its height.
+   The scratch surface is only reallocated when it's too small or of another format. */
+static SDL_Surface *SW_GetScratchSurface(SW_ScratchSurface *scratch, int w, int h, int extra_rows, Uint32 format)
+{
+    if (scratch->surface != NULL &&
+        (scratch->surface->format->format != format || scratch->w < w || scratch->h < h + extra_rows)) {
+        SDL_DestroySurface(scratch->surface);
+        scratch->surface = NULL;
+    }
+    if (scratch->surface == NULL) {
+        /* Grow to the largest size seen so far, so that sizes going back and forth don't reallocate */
+        scratch->w = SDL_max(w, scratch->w);
+        scratch->h = SDL_max(h + extra_rows, scratch->h);
+        scratch->surface = SDL_CreateSurface(scratch->w, scratch->h, format);
+        if (scratch->surface == NULL) {
+            scratch->w = scratch->h = 0;
+            return NULL;
+        }
+    }
+    return SW_ResetScratchSurface(scratch->surface, w, h);
+}
+
+/* Returns a surface using the given pixels, like SDL_CreateSurfaceFrom() */
+static SDL_Surface *SW_GetScratchView(SW_ScratchSurface *scratch, void *pixels, int w, int h, int pitch, Uint32 format)
+{
+    if (scratch->surface != NULL && scratch->surface->format->format != format) {
+        SDL_DestroySurface(scratch->surface);
+        scratch->surface = NULL;
+    }
+    if (scratch->surface == NULL) {
+        scratch->surface = SDL_CreateSurfaceFrom(pixels, w, h, pitch, format);
+        if (scratch->surface == NULL) {
+            return NULL;
+        }
+    } else {
+        scratch->surface->pixels = pixels;
+        scratch->surface->pitch = pitch;
+    }
+    return SW_ResetScratchSurface(scratch->surface, w, h);
+}
+
+static void SW_DestroyScratchSurface(SW_ScratchSurface *scratch)
+{
+    SDL_DestroySurface(scratch->surface);
+    scratch->surface = NULL;
+}
+
 static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Texture *texture,
                            const SDL_Rect *srcrect, const SDL_Rect *final_rect,
                            const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip, float scale_x, float scale_y)
 {
-    SDL_Surface *src = (SDL_Surface *)texture->driverdata;
+    SW_RenderData *data = (SW_RenderData *)renderer->driverdata;
+    SDL_Surface *src = ((SW_TextureData *)texture->driverdata)->surface;
     SDL_Rect tmp_rect;
     SDL_Surface *src_clone, *src_rotated, *src_scaled;
     SDL_Surface *mask = NULL, *mask_rotated = NULL;
@@ -342,8 +621,9 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
 
     /* Clone the source surface but use its pixel buffer directly.
      * The original source surface must be treated as read-only.
+     * The clone and the other intermediate surfaces are kept for the next rotated copies.
      */
-    src_clone = SDL_CreateSurfaceFrom(src->pixels, src->w, src->h, src->pitch, src->format->format);
+    src_clone = SW_GetScratchView(&data->source, src->pixels, src->w, src->h, src->pitch, src->format->format);
     if (src_clone == NULL) {
         if (SDL_MUSTLOCK(src)) {
             SDL_UnlockSurface(src);
@@ -386,10 +666,11 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
      * to clear the pixels in the destination surface. The other steps are explained below.
      */
     if (blendmode == SDL_BLENDMODE_NONE && !isOpaque) {
-        mask = SDL_CreateSurface(final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888);
+        mask = SW_GetScratchSurface(&data->mask, final_rect->w, final_rect->h, 0, SDL_PIXELFORMAT_ARGB8888);
         if (mask == NULL) {
             retval = -1;
         } else {
+            SDL_FillSurfaceRect(mask, NULL, 0);
             SDL_SetSurfaceBlendMode(mask, SDL_BLENDMODE_MOD);
         }
     }
@@ -399,15 +680,13 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
      */
     if (!retval && (blitRequired || applyModulation)) {
         SDL_Rect scale_rect = tmp_rect;
-        src_scaled = SDL_CreateSurface(final_rect->w, final_rect->h, SDL_PIXELFORMAT_ARGB8888);
+        src_scaled = SW_GetScratchSurface(&data->scaled, final_rect->w, final_rect->h, 0, SDL_PIXELFORMAT_ARGB8888);
         if (src_scaled == NULL) {
             retval = -1;
         } else {
             SDL_SetSurfaceBlendMode(src_clone, SDL_BLENDMODE_NONE);
             retval = SDL_PrivateBlitSurfaceScaled(src_clone, srcrect, src_scaled, &scale_rect, texture->scaleMode);
-            SDL_DestroySurface(src_clone);
             src_clone = src_scaled;
-            src_scaled = NULL;
         }
     }
 
@@ -420,17 +699,23 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
 
         SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, center,
                                        &rect_dest, &cangle, &sangle);
-        src_rotated = SDLgfx_rotateSurface(src_clone, angle,
-                                           (texture->scaleMode == SDL_SCALEMODE_NEAREST) ? 0 : 1, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL,
-                                           &rect_dest, cangle, sangle, center);
+        src_rotated = SW_GetScratchSurface(&data->rotated, rect_dest.w, rect_dest.h, GUARD_ROWS, src_clone->format->format);
+        if (src_rotated != NULL) {
+            src_rotated = SDLgfx_rotateSurface(src_clone, angle,
+                                               (texture->scaleMode == SDL_SCALEMODE_NEAREST) ? 0 : 1, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL,
+                                               &rect_dest, cangle, sangle, center, src_rotated);
+        }
         if (src_rotated == NULL) {
             retval = -1;
         }
         if (!retval && mask != NULL) {
             /* The mask needed for the NONE blend mode gets rotated with the same parameters. */
-            mask_rotated = SDLgfx_rotateSurface(mask, angle,
-                                                SDL_FALSE, 0, 0,
-                                                &rect_dest, cangle, sangle, center);
+            mask_rotated = SW_GetScratchSurface(&data->mask_rotated, rect_dest.w, rect_dest.h, GUARD_ROWS, mask->format->format);
+            if (mask_rotated != NULL) {
+                mask_rotated = SDLgfx_rotateSurface(mask, angle,
+                                                    SDL_FALSE, 0, 0,
+                                                    &rect_dest, cangle, sangle, center, mask_rotated);
+            }
             if (mask_rotated == NULL) {
                 retval = -1;
             }
@@ -485,22 +770,17 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
                                                            src_rotated->format->Bmask,
                                                            0);
 
-                        src_rotated_rgb = SDL_CreateSurfaceFrom(src_rotated->pixels, src_rotated->w, src_rotated->h,
-                                                                   src_rotated->pitch, f);
+                        src_rotated_rgb = SW_GetScratchView(&data->rotated_rgb, src_rotated->pixels, src_rotated->w, src_rotated->h,
+                                                            src_rotated->pitch, f);
                         if (src_rotated_rgb == NULL) {
                             retval = -1;
                         } else {
                             SDL_SetSurfaceBlendMode(src_rotated_rgb, SDL_BLENDMODE_ADD);
                             /* Renderer scaling, if needed */
                             retval = Blit_to_Screen(src_rotated_rgb, NULL, surface, &tmp_rect, scale_x, scale_y, texture->scaleMode);
-                            SDL_DestroySurface(src_rotated_rgb);
                         }
                     }
                 }
-                SDL_DestroySurface(mask_rotated);
-            }
-            if (src_rotated != NULL) {
-                SDL_DestroySurface(src_rotated);
             }
         }
     }
@@ -508,12 +788,6 @@ static int SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Tex
     if (SDL_MUSTLOCK(src)) {
         SDL_UnlockSurface(src);
     }
-    if (mask != NULL) {
-        SDL_DestroySurface(mask);
-    }
-    if (src_clone != NULL) {
-        SDL_DestroySurface(src_clone);
-    }
     return retval;
 }
 
@@ -613,15 +887,185 @@ static int SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_
     return 0;
 }
 
-static void PrepTextureForCopy(const SDL_RenderCommand *cmd)
+/* Sets up the vertices of static geometry once, leaving their positions to be
+   filled in every time the geometry is drawn */
+static int SW_CreateStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    SDL_Texture *texture = geometry->texture;
+    const int count = geometry->num_vertices;
+    int i;
+
+    if (texture) {
+        GeometryCopyData *ptr = (GeometryCopyData *)SDL_calloc(count, sizeof(*ptr));
+        if (ptr == NULL) {
+            return SDL_OutOfMemory();
+        }
+        geometry->driverdata = ptr;
+
+        for (i = 0; i < count; i++) {
+            ptr->src.x = (int)(geometry->uv[i * 2] * texture->w);
+            ptr->src.y = (int)(geometry->uv[i * 2 + 1] * texture->h);
+            ptr->color = geometry->color[i];
+            ptr++;
+        }
+    } else {
+        GeometryFillData *ptr = (GeometryFillData *)SDL_calloc(count, sizeof(*ptr));
+        if (ptr == NULL) {
+            return SDL_OutOfMemory();
+        }
+        geometry->driverdata = ptr;
+
+        for (i = 0; i < count; i++) {
+            ptr->color = geometry->color[i];
+            ptr++;
+        }
+    }
+    return 0;
+}
+
+static int SW_QueueStaticGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_StaticGeometry *geometry,
+                                  int first, int count, const float *transform)
+{
+    const size_t sz = geometry->textured ? sizeof(GeometryCopyData) : sizeof(GeometryFillData);
+    const size_t offset = geometry->textured ? offsetof(GeometryCopyData, dst) : offsetof(GeometryFillData, dst);
+    const float *xy = geometry->xy + first * 2;
+    Uint8 *verts;
+    int i;
+
+    verts = (Uint8 *)SDL_AllocateRenderVertices(renderer, count * sz, 0, &cmd->data.draw.first);
+    if (verts == NULL) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+    SDL_memcpy(verts, (const Uint8 *)geometry->driverdata + first * sz, count * sz);
+
+    for (i = 0; i < count; i++, xy += 2) {
+        SDL_Point *dst = (SDL_Point *)(verts + i * sz + offset);
+        dst->x = (int)(transform[0] * xy[0] + transform[2] * xy[1] + transform[4]);
+        dst->y = (int)(transform[1] * xy[0] + transform[3] * xy[1] + transform[5]);
+        trianglepoint_2_fixedpoint(dst);
+    }
+    return 0;
+}
+
+static void SW_DestroyStaticGeometry(SDL_Renderer *renderer, SDL_StaticGeometry *geometry)
+{
+    SDL_free(geometry->driverdata);
+    geometry->driverdata = NULL;
+}
+
+static void SW_FlushBlitMaps(SW_BlitMapCache *maps)
+{
+    int i;
+
+    for (i = 0; i < SW_BLIT_MAP_CACHE_SIZE; ++i) {
+        SDL_FreeBlitMap(maps->maps[i]);
+        maps->maps[i] = NULL;
+    }
+}
+
+static SDL_bool SW_BlitMapMatches(const SDL_BlitMap *map, int flags, const SDL_Color *color, Uint32 colorkey)
+{
+    const SDL_BlitInfo *info = &map->info;
+
+    return (info->flags == flags &&
+            info->r == color->r && info->g == color->g && info->b == color->b && info->a == color->a &&
+            (!(flags & SDL_COPY_COLORKEY) || info->colorkey == colorkey)) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Gives the surface a blit map for the copy state and the destination, by swapping
+   in one kept from a previous copy with that state. The map being replaced is kept
+   in turn, so that alternating between a few tints or blend modes doesn't invalidate
+   and remap the blit on every copy. */
+static void SW_SelectBlitMap(SW_BlitMapCache *maps, SDL_Surface *surface, SDL_Surface *dst,
+                             const SDL_Color *color, SDL_BlendMode blend, SDL_bool scaled)
+{
+    SDL_BlitMap *map = surface->map;
+    const Uint32 colorkey = map->info.colorkey;
+    int flags;
+    int i;
+
+    /* RLE data is stored in the blit map */
+    if ((surface->flags & SDL_RLEACCEL) || (map->info.flags & SDL_COPY_RLE_MASK)) {
+        return;
+    }
+
+    /* The flags SDL_SetSurfaceColorMod() and friends and the blit functions would set */
+    flags = map->info.flags & ~(SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
+                                SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL | SDL_COPY_NEAREST);
+    if ((color->r & color->g & color->b) != 0xFF) {
+        flags |= SDL_COPY_MODULATE_COLOR;
+    }
+    if (color->a != 0xFF) {
+        flags |= SDL_COPY_MODULATE_ALPHA;
+    }
+    switch (blend) {
+    case SDL_BLENDMODE_BLEND:
+        flags |= SDL_COPY_BLEND;
+        break;
+    case SDL_BLENDMODE_ADD:
+        flags |= SDL_COPY_ADD;
+        break;
+    case SDL_BLENDMODE_MOD:
+        flags |= SDL_COPY_MOD;
+        break;
+    case SDL_BLENDMODE_MUL:
+        flags |= SDL_COPY_MUL;
+        break;
+    default:
+        break;
+    }
+    if (scaled) {
+        flags |= SDL_COPY_NEAREST;
+    }
+
+    if (map->dst == dst && SW_BlitMapMatches(map, flags, color, colorkey)) {
+        return;
+    }
+
+    for (i = 0; i < SW_BLIT_MAP_CACHE_SIZE && maps->maps[i]; ++i) {
+        if (maps->maps[i]->dst == dst && SW_BlitMapMatches(maps->maps[i], flags, color, colorkey)) {
+            break;
+        }
+    }
+    if (i == SW_BLIT_MAP_CACHE_SIZE || !maps->maps[i]) {
+        if (SW_BlitMapMatches(map, flags, color, colorkey)) {
+            /* Only the destination changed, remap the current one */
+            return;
+        }
+
+        /* Keep the current map, and set up the least recently used one for this state */
+        i = SW_BLIT_MAP_CACHE_SIZE - 1;
+        if (maps->maps[i]) {
+            SDL_InvalidateMap(maps->maps[i]);
+        } else {
+            maps->maps[i] = SDL_AllocBlitMap();
+            if (maps->maps[i] == NULL) {
+                return;
+            }
+        }
+        maps->maps[i]->info.flags = flags;
+        maps->maps[i]->info.r = color->r;
+        maps->maps[i]->info.g = color->g;
+        maps->maps[i]->info.b = color->b;
+        maps->maps[i]->info.a = color->a;
+        maps->maps[i]->info.colorkey = colorkey;
+    }
+
+    surface->map = maps->maps[i];
+    SDL_memmove(&maps->maps[1], &maps->maps[0], i * sizeof(*maps->maps));
+    maps->maps[0] = map;
+}
+
+static void PrepTextureForCopy(const SDL_RenderCommand *cmd, const SDL_Color *color, SDL_Surface *surface,
+                               SW_BlitMapCache *maps, SDL_Surface *dst, SDL_bool scaled)
 {
-    const Uint8 r = cmd->data.draw.r;
-    const Uint8 g = cmd->data.draw.g;
-    const Uint8 b = cmd->data.draw.b;
-    const Uint8 a = cmd->data.draw.a;
+    const Uint8 r = color->r;
+    const Uint8 g = color->g;
+    const Uint8 b = color->b;
+    const Uint8 a = color->a;
     const SDL_BlendMode blend = cmd->data.draw.blend;
-    SDL_Texture *texture = cmd->data.draw.texture;
-    SDL_Surface *surface = (SDL_Surface *)texture->driverdata;
     const SDL_bool colormod = ((r & g & b) != 0xFF);
     const SDL_bool alphamod = (a != 0xFF);
     const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL));
@@ -630,314 +1074,1101 @@ static void PrepTextureForCopy(const SDL_RenderCommand *cmd)
         SDL_SetSurfaceRLE(surface, 0);
     }
 
+    if (maps) {
+        SW_SelectBlitMap(maps, surface, dst, color, blend, scaled);
+    }
+
     /* !!! FIXME: we can probably avoid some of these calls. */
     SDL_SetSurfaceColorMod(surface, r, g, b);
     SDL_SetSurfaceAlphaMod(surface, a);
     SDL_SetSurfaceBlendMode(surface, blend);
 }
 
+static void GetDrawClipRect(SDL_Surface *surface, const SW_DrawStateCache *drawstate, SDL_Rect *clip_rect)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const SDL_Rect *cliprect = drawstate->cliprect;
+    SDL_Rect full_rect;
+    SDL_assert_release(viewport != NULL); /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
+
+    if (cliprect != NULL) {
+        clip_rect->x = cliprect->x + viewport->x;
+        clip_rect->y = cliprect->y + viewport->y;
+        clip_rect->w = cliprect->w;
+        clip_rect->h = cliprect->h;
+        SDL_GetRectIntersection(viewport, clip_rect, clip_rect);
+    } else {
+        *clip_rect = *viewport;
+    }
+
+    /* Like SDL_SetSurfaceClipRect() */
+    full_rect.x = 0;
+    full_rect.y = 0;
+    full_rect.w = surface->w;
+    full_rect.h = surface->h;
+    SDL_GetRectIntersection(clip_rect, &full_rect, clip_rect);
+}
+
 static void SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
 {
     if (drawstate->surface_cliprect_dirty) {
-        const SDL_Rect *viewport = drawstate->viewport;
-        const SDL_Rect *cliprect = drawstate->cliprect;
-        SDL_assert_release(viewport != NULL); /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
-
-        if (cliprect != NULL) {
-            SDL_Rect clip_rect;
-            clip_rect.x = cliprect->x + viewport->x;
-            clip_rect.y = cliprect->y + viewport->y;
-            clip_rect.w = cliprect->w;
-            clip_rect.h = cliprect->h;
-            SDL_GetRectIntersection(viewport, &clip_rect, &clip_rect);
-            SDL_SetSurfaceClipRect(surface, &clip_rect);
-        } else {
-            SDL_SetSurfaceClipRect(surface, drawstate->viewport);
-        }
+        SDL_Rect clip_rect;
+        GetDrawClipRect(surface, drawstate, &clip_rect);
+        SDL_SetSurfaceClipRect(surface, &clip_rect);
         drawstate->surface_cliprect_dirty = SDL_FALSE;
     }
 }
 
-static int SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+/* Moves the vertices of a draw command to the viewport */
+static void ApplyViewport(const SDL_RenderCommand *cmd, const SDL_Rect *viewport, void *vertices)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
-    SW_DrawStateCache drawstate;
+    void *verts = ((Uint8 *)vertices) + cmd->data.draw.first;
+    const int count = (int)cmd->data.draw.count;
+    int i;
 
-    if (surface == NULL) {
-        return -1;
+    if (viewport == NULL || (!viewport->x && !viewport->y)) {
+        return;
     }
 
-    drawstate.viewport = NULL;
-    drawstate.cliprect = NULL;
-    drawstate.surface_cliprect_dirty = SDL_TRUE;
-
-    while (cmd) {
-        switch (cmd->command) {
-        case SDL_RENDERCMD_SETDRAWCOLOR:
-        {
-            break; /* Not used in this backend. */
+    switch (cmd->command) {
+    case SDL_RENDERCMD_DRAW_POINTS:
+    case SDL_RENDERCMD_DRAW_LINES:
+    {
+        SDL_Point *points = (SDL_Point *)verts;
+        for (i = 0; i < count; i++) {
+            points[i].x += viewport->x;
+            points[i].y += viewport->y;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_SETVIEWPORT:
-        {
-            drawstate.viewport = &cmd->data.viewport.rect;
-            drawstate.surface_cliprect_dirty = SDL_TRUE;
-            break;
+    case SDL_RENDERCMD_FILL_RECTS:
+    {
+        SDL_Rect *rects = (SDL_Rect *)verts;
+        for (i = 0; i < count; i++) {
+            rects[i].x += viewport->x;
+            rects[i].y += viewport->y;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_SETCLIPRECT:
-        {
-            drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
-            drawstate.surface_cliprect_dirty = SDL_TRUE;
-            break;
+    case SDL_RENDERCMD_COPY:
+    {
+        CopyData *copydata = (CopyData *)verts;
+        for (i = 0; i < count; i++) {
+            copydata[i].dstrect.x += viewport->x;
+            copydata[i].dstrect.y += viewport->y;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_CLEAR:
-        {
-            const Uint8 r = cmd->data.color.r;
-            const Uint8 g = cmd->data.color.g;
-            const Uint8 b = cmd->data.color.b;
-            const Uint8 a = cmd->data.color.a;
-            /* By definition the clear ignores the clip rect */
-            SDL_SetSurfaceClipRect(surface, NULL);
-            SDL_FillSurfaceRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
-            drawstate.surface_cliprect_dirty = SDL_TRUE;
-            break;
+    case SDL_RENDERCMD_COPY_EX:
+    {
+        CopyExData *copydata = (CopyExData *)verts;
+        for (i = 0; i < count; i++) {
+            copydata[i].dstrect.x += viewport->x;
+            copydata[i].dstrect.y += viewport->y;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_DRAW_POINTS:
-        {
-            const Uint8 r = cmd->data.draw.r;
-            const Uint8 g = cmd->data.draw.g;
-            const Uint8 b = cmd->data.draw.b;
-            const Uint8 a = cmd->data.draw.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
-
-            /* Apply viewport */
-            if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
-                for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
-                }
+    case SDL_RENDERCMD_GEOMETRY:
+    {
+        SDL_Point vp;
+        vp.x = viewport->x;
+        vp.y = viewport->y;
+        trianglepoint_2_fixedpoint(&vp);
+        if (cmd->data.draw.texture) {
+            GeometryCopyData *ptr = (GeometryCopyData *)verts;
+            for (i = 0; i < count; i++) {
+                ptr[i].dst.x += vp.x;
+                ptr[i].dst.y += vp.y;
             }
-
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-            } else {
-                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+        } else {
+            GeometryFillData *ptr = (GeometryFillData *)verts;
+            for (i = 0; i < count; i++) {
+                ptr[i].dst.x += vp.x;
+                ptr[i].dst.y += vp.y;
             }
-            break;
         }
+        break;
+    }
 
-        case SDL_RENDERCMD_DRAW_LINES:
-        {
-            const Uint8 r = cmd->data.draw.r;
-            const Uint8 g = cmd->data.draw.g;
-            const Uint8 b = cmd->data.draw.b;
-            const Uint8 a = cmd->data.draw.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
-
-            /* Apply viewport */
-            if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
-                for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
-                }
-            }
+    default:
+        break;
+    }
+}
 
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-            } else {
-                SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
-            }
-            break;
-        }
+static void SW_DrawCopy(SDL_Surface *surface, const SDL_RenderCommand *cmd, const CopyData *copy)
+{
+    const SDL_Rect *srcrect = &copy->srcrect;
+    SDL_Rect dstrect = copy->dstrect;
+    SDL_Texture *texture = cmd->data.draw.texture;
+    SW_TextureData *texturedata = (SW_TextureData *)texture->driverdata;
+    SDL_Surface *src = texturedata->surface;
+    const SDL_bool scaled = (srcrect->w != dstrect.w || srcrect->h != dstrect.h) ? SDL_TRUE : SDL_FALSE;
 
-        case SDL_RENDERCMD_FILL_RECTS:
-        {
-            const Uint8 r = cmd->data.draw.r;
-            const Uint8 g = cmd->data.draw.g;
-            const Uint8 b = cmd->data.draw.b;
-            const Uint8 a = cmd->data.draw.a;
-            const int count = (int)cmd->data.draw.count;
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-            SetDrawState(surface, &drawstate);
-
-            /* Apply viewport */
-            if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
-                for (i = 0; i < count; i++) {
-                    verts[i].x += drawstate.viewport->x;
-                    verts[i].y += drawstate.viewport->y;
-                }
-            }
+    PrepTextureForCopy(cmd, &copy->color, src, &texturedata->maps, surface, scaled);
 
-            if (blend == SDL_BLENDMODE_NONE) {
-                SDL_FillSurfaceRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-            } else {
-                SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+    if (!scaled) {
+        SDL_BlitSurface(src, srcrect, surface, &dstrect);
+    } else {
+        /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+         * to avoid potentially frequent RLE encoding/decoding.
+         */
+        SDL_SetSurfaceRLE(surface, 0);
+
+        /* Prevent to do scaling + clipping on viewport boundaries as it may lose proportion */
+        if (dstrect.x < 0 || dstrect.y < 0 || dstrect.x + dstrect.w > surface->w || dstrect.y + dstrect.h > surface->h) {
+            SDL_Surface *tmp = SDL_CreatePooledSurface(dstrect.w, dstrect.h, src->format->format);
+            /* Scale to an intermediate surface, then blit */
+            if (tmp) {
+                SDL_Rect r;
+                SDL_BlendMode blendmode;
+                Uint8 alphaMod, rMod, gMod, bMod;
+
+                SDL_GetSurfaceBlendMode(src, &blendmode);
+                SDL_GetSurfaceAlphaMod(src, &alphaMod);
+                SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+
+                r.x = 0;
+                r.y = 0;
+                r.w = dstrect.w;
+                r.h = dstrect.h;
+
+                SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+                SDL_SetSurfaceColorMod(src, 255, 255, 255);
+                SDL_SetSurfaceAlphaMod(src, 255);
+
+                SDL_PrivateBlitSurfaceScaled(src, srcrect, tmp, &r, texture->scaleMode);
+
+                SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
+                SDL_SetSurfaceAlphaMod(tmp, alphaMod);
+                SDL_SetSurfaceBlendMode(tmp, blendmode);
+
+                SDL_BlitSurface(tmp, NULL, surface, &dstrect);
+                SDL_DestroySurface(tmp);
+                /* No need to set back r/g/b/a/blendmode to 'src' since it's done in PrepTextureForCopy() */
             }
-            break;
+        } else {
+            SDL_PrivateBlitSurfaceScaled(src, srcrect, surface, &dstrect, texture->scaleMode);
         }
+    }
+}
 
-        case SDL_RENDERCMD_COPY:
-        {
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_Rect *srcrect = verts;
-            SDL_Rect *dstrect = verts + 1;
-            SDL_Texture *texture = cmd->data.draw.texture;
-            SDL_Surface *src = (SDL_Surface *)texture->driverdata;
+/* Draws textured geometry from a texture surface already set up for it.
+   The triangle functions may adjust the points, this works on copies so
+   that the vertices can be drawn again in another tile. */
+static void SW_DrawGeometry(SDL_Surface *surface, const SDL_RenderCommand *cmd, void *vertices, SDL_Surface *src)
+{
+    const GeometryCopyData *ptr = (const GeometryCopyData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+    const int count = (int)cmd->data.draw.count;
+    int i;
+
+    for (i = 0; i < count; i += 3, ptr += 3) {
+        SDL_Point s0 = ptr[0].src, s1 = ptr[1].src, s2 = ptr[2].src;
+        SDL_Point d0 = ptr[0].dst, d1 = ptr[1].dst, d2 = ptr[2].dst;
+        SDL_SW_BlitTriangle(
+            src,
+            &s0, &s1, &s2,
+            surface,
+            &d0, &d1, &d2,
+            ptr[0].color, ptr[1].color, ptr[2].color);
+    }
+}
+
+/* Runs a draw command with the vertices already moved to the viewport,
+   within the clip rect of the surface. */
+static void SW_DrawCommand(SDL_Renderer *renderer, SDL_Surface *surface,
+                           const SDL_RenderCommand *cmd, void *vertices)
+{
+    switch (cmd->command) {
+    case SDL_RENDERCMD_CLEAR:
+    {
+        const Uint8 r = cmd->data.color.r;
+        const Uint8 g = cmd->data.color.g;
+        const Uint8 b = cmd->data.color.b;
+        const Uint8 a = cmd->data.color.a;
+        SDL_FillSurfaceRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
+        break;
+    }
+
+    case SDL_RENDERCMD_DRAW_POINTS:
+    {
+        const Uint8 r = cmd->data.draw.r;
+        const Uint8 g = cmd->data.draw.g;
+        const Uint8 b = cmd->data.draw.b;
+        const Uint8 a = cmd->data.draw.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        /* Points, lines and triangles are not worth computing exact bounds for */
+        SDL_AddSurfaceDamage(surface, &surface->clip_rect);
+
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+        } else {
+            SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_DRAW_LINES:
+    {
+        const Uint8 r = cmd->data.draw.r;
+        const Uint8 g = cmd->data.draw.g;
+        const Uint8 b = cmd->data.draw.b;
+        const Uint8 a = cmd->data.draw.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+        SDL_AddSurfaceDamage(surface, &surface->clip_rect);
+
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+        } else {
+            SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_FILL_RECTS:
+    {
+        const Uint8 r = cmd->data.draw.r;
+        const Uint8 g = cmd->data.draw.g;
+        const Uint8 b = cmd->data.draw.b;
+        const Uint8 a = cmd->data.draw.a;
+        const int count = (int)cmd->data.draw.count;
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+
+        if (blend == SDL_BLENDMODE_NONE) {
+            SDL_FillSurfaceRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+        } else {
+            SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_COPY:
+    {
+        const CopyData *copydata = (const CopyData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        int i;
+
+        for (i = 0; i < count; i++) {
+            SW_DrawCopy(surface, cmd, &copydata[i]);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_COPY_EX:
+    {
+        const CopyExData *copydata = (const CopyExData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        int i;
+
+        for (i = 0; i < count; i++, copydata++) {
+            if (copydata->angle == 0.0 && copydata->flip == SDL_FLIP_NONE) {
+                /* Not rotated items of a batch of copies */
+                CopyData copy;
+                copy.srcrect = copydata->srcrect;
+                copy.dstrect = copydata->dstrect;
+                copy.color = copydata->color;
+                SW_DrawCopy(surface, cmd, &copy);
+                continue;
+            }
+
+            PrepTextureForCopy(cmd, &copydata->color, ((SW_TextureData *)cmd->data.draw.texture->driverdata)->surface, NULL, NULL, SDL_FALSE);
+
+            SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
+                            &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip,
+                            copydata->scale_x, copydata->scale_y);
+        }
+        break;
+    }
+
+    case SDL_RENDERCMD_GEOMETRY:
+    {
+        int i;
+        SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
+        const int count = (int)cmd->data.draw.count;
+        SDL_Texture *texture = cmd->data.draw.texture;
+        const SDL_BlendMode blend = cmd->data.draw.blend;
+
+        SDL_AddSurfaceDamage(surface, &surface->clip_rect);
+
+        if (texture) {
+            SDL_Surface *src = ((SW_TextureData *)texture->driverdata)->surface;
+            SDL_Color color;
+
+            color.r = cmd->data.draw.r;
+            color.g = cmd->data.draw.g;
+            color.b = cmd->data.draw.b;
+            color.a = cmd->data.draw.a;
+            PrepTextureForCopy(cmd, &color, src, NULL, NULL, SDL_FALSE);
+
+            SW_DrawGeometry(surface, cmd, vertices, src);
+        } else {
+            const GeometryFillData *ptr = (const GeometryFillData *)verts;
+
+            for (i = 0; i < count; i += 3, ptr += 3) {
+                SDL_Point d0 = ptr[0].dst, d1 = ptr[1].dst, d2 = ptr[2].dst;
+                SDL_SW_FillTriangle(surface, &d0, &d1, &d2, blend, ptr[0].color, ptr[1].color, ptr[2].color);
+            }
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+/* Can tile workers read the texture directly? RLE encoded surfaces have no pixels */
+static SDL_bool SW_CanTileTexture(SDL_Texture *texture)
+{
+    SDL_Surface *src = ((SW_TextureData *)texture->driverdata)->surface;
+
+    return (src->pixels && !SDL_MUSTLOCK(src) && !SDL_ISPIXELFORMAT_INDEXED(src->format->format)) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Gets the area a draw command can touch. Some commands are only drawn exactly
+   the same when clipped at the edges of their own clip rect, like lines and
+   scaled copies: these have to be within one tile. */
+static SDL_bool SW_GetCommandBounds(const SDL_RenderCommand *cmd, void *vertices, SDL_Rect *bounds, SDL_bool *single_tile)
+{
+    const void *verts = ((Uint8 *)vertices) + cmd->data.draw.first;
+    const int count = (int)cmd->data.draw.count;
+    int i;
+
+    *single_tile = SDL_FALSE;
+
+    switch (cmd->command) {
+    case SDL_RENDERCMD_DRAW_LINES:
+        *single_tile = SDL_TRUE;
+        SDL_FALLTHROUGH;
+    case SDL_RENDERCMD_DRAW_POINTS:
+    {
+        const SDL_Point *points = (const SDL_Point *)verts;
+        if (count <= 0) {
+            return SDL_FALSE;
+        }
+        if (SDL_GetRectEnclosingPoints(points, count, NULL, bounds) == SDL_FALSE) {
+            return SDL_FALSE;
+        }
+        return SDL_TRUE;
+    }
+
+    case SDL_RENDERCMD_FILL_RECTS:
+    {
+        const SDL_Rect *rects = (const SDL_Rect *)verts;
+        if (count <= 0) {
+            return SDL_FALSE;
+        }
+        *bounds = rects[0];
+        for (i = 1; i < count; i++) {
+            SDL_GetRectUnion(bounds, &rects[i], bounds);
+        }
+        return SDL_TRUE;
+    }
+
+    case SDL_RENDERCMD_GEOMETRY:
+    {
+        const Uint8 *ptr = (const Uint8 *)verts;
+        const size_t stride = cmd->data.draw.texture ? sizeof(GeometryCopyData) : sizeof(GeometryFillData);
+        const size_t offset = cmd->data.draw.texture ? offsetof(GeometryCopyData, dst) : offsetof(GeometryFillData, dst);
+        SDL_Point one, min, max;
+
+        if (count <= 0 || (cmd->data.draw.texture && !SW_CanTileTexture(cmd->data.draw.texture))) {
+            return SDL_FALSE;
+        }
+        min = max = *(const SDL_Point *)(ptr + offset);
+        for (i = 1; i < count; i++) {
+            const SDL_Point *p = (const SDL_Point *)(ptr + i * stride + offset);
+            min.x = SDL_min(min.x, p->x);
+            min.y = SDL_min(min.y, p->y);
+            max.x = SDL_max(max.x, p->x);
+            max.y = SDL_max(max.y, p->y);
+        }
+        /* Back from fixed point, with a pixel of slack for the rounding */
+        one.x = one.y = 1;
+        trianglepoint_2_fixedpoint(&one);
+        bounds->x = min.x / one.x - 1;
+        bounds->y = min.y / one.y - 1;
+        bounds->w = max.x / one.x + 2 - bounds->x;
+        bounds->h = max.y / one.y + 2 - bounds->y;
+        return SDL_TRUE;
+    }
+
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static SDL_bool SW_IsWithinOneTile(const SDL_Rect *bounds)
+{
+    return (bounds->x / SW_TILE_SIZE == (bounds->x + bounds->w - 1) / SW_TILE_SIZE &&
+            bounds->y / SW_TILE_SIZE == (bounds->y + bounds->h - 1) / SW_TILE_SIZE) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Makes room for count more items in one of the arrays of the tile batch */
+static SDL_bool SW_ReserveTileItems(void **items, int *max_items, int num_items, int count, size_t size)
+{
+    if (num_items + count > *max_items) {
+        int max = SDL_max(*max_items * 2, num_items + count);
+        void *array = SDL_realloc(*items, max * size);
+        if (array == NULL) {
+            return SDL_FALSE;
+        }
+        *items = array;
+        *max_items = max;
+    }
+    return SDL_TRUE;
+}
+
+static SDL_bool SW_AppendTileJob(SW_TileContext *tiles, const SDL_RenderCommand *cmd,
+                                 const SDL_Rect *clip, const SDL_Rect *bounds, SW_TileJob **result)
+{
+    SW_TileJob *job;
+
+    if (!SW_ReserveTileItems((void **)&tiles->jobs, &tiles->max_jobs, tiles->num_jobs, 1, sizeof(*tiles->jobs))) {
+        return SDL_FALSE;
+    }
+    job = &tiles->jobs[tiles->num_jobs++];
+    job->cmd = cmd;
+    job->clip = *clip;
+    job->tile_x0 = bounds->x / SW_TILE_SIZE;
+    job->tile_y0 = bounds->y / SW_TILE_SIZE;
+    job->tile_x1 = (bounds->x + bounds->w - 1) / SW_TILE_SIZE;
+    job->tile_y1 = (bounds->y + bounds->h - 1) / SW_TILE_SIZE;
+    job->first_copy = 0;
+    job->num_copies = 0;
+    job->texture = NULL;
+    if (result) {
+        *result = job;
+    }
+    return SDL_TRUE;
+}
+
+/* Sets up the texture of a copy command for a color like SW_DrawCopy() and
+   SDL_BlitSurface() do, and keeps the resulting blit for the workers.
+   Returns the index of the blit, or -1 if the copy has to be drawn on its own. */
+static int SW_PrepareTileBlit(SW_TileContext *tiles, const SDL_RenderCommand *cmd, const SDL_Color *color)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)cmd->data.draw.texture->driverdata;
+    SDL_Surface *src = texturedata->surface;
+    const SDL_BlendMode blend = cmd->data.draw.blend;
+    SW_TileBlit *blit;
+
+    /* Copies in a row usually share their state */
+    if (tiles->num_blits > 0) {
+        blit = &tiles->blits[tiles->num_blits - 1];
+        if (blit->source == src && blit->blend == blend &&
+            blit->color.r == color->r && blit->color.g == color->g &&
+            blit->color.b == color->b && blit->color.a == color->a) {
+            return tiles->num_blits - 1;
+        }
+    }
+    if (!SW_ReserveTileItems((void **)&tiles->blits, &tiles->max_blits, tiles->num_blits, 1, sizeof(*tiles->blits))) {
+        return -1;
+    }
+
+    PrepTextureForCopy(cmd, color, src, &texturedata->maps, tiles->surface, SDL_FALSE);
+    if (src->map->info.flags & SDL_COPY_NEAREST) {
+        src->map->info.flags &= ~SDL_COPY_NEAREST;
+        SDL_InvalidateMap(src->map);
+    }
+    if (src->map->dst != tiles->surface && SDL_MapSurface(src, tiles->surface) < 0) {
+        return -1;
+    }
+    if (src->flags & SDL_RLEACCEL) {
+        return -1; /* mapping the surface encoded it */
+    }
+
+    blit = &tiles->blits[tiles->num_blits];
+    blit->source = src;
+    blit->color = *color;
+    blit->blend = blend;
+    blit->func = (SDL_BlitFunc)src->map->data;
+    blit->info = src->map->info;
+    return tiles->num_blits++;
+}
+
+/* Clips a copy to the texture and to the clip rect, like SDL_BlitSurface() */
+static SDL_bool SW_ClipTileCopy(const SDL_Surface *src, const CopyData *copydata, const SDL_Rect *clip, SW_TileCopy *copy)
+{
+    int srcx = copydata->srcrect.x;
+    int srcy = copydata->srcrect.y;
+    int dstx = copydata->dstrect.x;
+    int dsty = copydata->dstrect.y;
+    int w = copydata->srcrect.w;
+    int h = copydata->srcrect.h;
+    int d;
+
+    if (srcx < 0) {
+        w += srcx;
+        dstx -= srcx;
+        srcx = 0;
+    }
+    w = SDL_min(w, src->w - srcx);
+    if (srcy < 0) {
+        h += srcy;
+        dsty -= srcy;
+        srcy = 0;
+    }
+    h = SDL_min(h, src->h - srcy);
+
+    d = clip->x - dstx;
+    if (d > 0) {
+        w -= d;
+        dstx += d;
+        srcx += d;
+    }
+    d = dstx + w - clip->x - clip->w;
+    if (d > 0) {
+        w -= d;
+    }
+    d = clip->y - dsty;
+    if (d > 0) {
+        h -= d;
+        dsty += d;
+        srcy += d;
+    }
+    d = dsty + h - clip->y - clip->h;
+    if (d > 0) {
+        h -= d;
+    }
+    if (w <= 0 || h <= 0) {
+        return SDL_FALSE;
+    }
+
+    copy->srcrect.x = srcx;
+    copy->srcrect.y = srcy;
+    copy->srcrect.w = w;
+    copy->srcrect.h = h;
+    copy->dstrect.x = dstx;
+    copy->dstrect.y = dsty;
+    copy->dstrect.w = w;
+    copy->dstrect.h = h;
+    return SDL_TRUE;
+}
+
+/* Adds a copy command to the tile batch as one job. Each copy is clipped and
+   its blit set up here, so that the tiles only have to clip it to themselves. */
+static SDL_bool SW_AddTileCopyJob(SW_TileContext *tiles, const SDL_RenderCommand *cmd, const SDL_Rect *clip)
+{
+    const CopyData *copydata = (const CopyData *)(((Uint8 *)tiles->vertices) + cmd->data.draw.first);
+    const int count = (int)cmd->data.draw.count;
+    SDL_Surface *src = ((SW_TextureData *)cmd->data.draw.texture->driverdata)->surface;
+    const int first_copy = tiles->num_copies;
+    SW_TileJob *job;
+    SDL_Rect bounds;
+    int i;
+
+    if (!SW_CanTileTexture(cmd->data.draw.texture)) {
+        return SDL_FALSE;
+    }
+
+    /* Scaled copies are only drawn the same when clipped at the edges of the clip rect */
+    for (i = 0; i < count; i++) {
+        if (copydata[i].srcrect.w != copydata[i].dstrect.w || copydata[i].srcrect.h != copydata[i].dstrect.h) {
+            return SDL_FALSE;
+        }
+    }
+    if (!SW_ReserveTileItems((void **)&tiles->copies, &tiles->max_copies, tiles->num_copies, count, sizeof(*tiles->copies))) {
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        SW_TileCopy *copy = &tiles->copies[tiles->num_copies];
+
+        if (!SW_ClipTileCopy(src, &copydata[i], clip, copy)) {
+            continue;
+        }
+        copy->blit = SW_PrepareTileBlit(tiles, cmd, &copydata[i].color);
+        if (copy->blit < 0) {
+            tiles->num_copies = first_copy;
+            return SDL_FALSE;
+        }
+        if (tiles->num_copies == first_copy) {
+            bounds = copy->dstrect;
+        } else {
+            SDL_GetRectUnion(&bounds, &copy->dstrect, &bounds);
+        }
+        ++tiles->num_copies;
+    }
+    if (tiles->num_copies == first_copy) {
+        return SDL_TRUE; /* nothing to draw */
+    }
+
+    if (!SW_AppendTileJob(tiles, cmd, clip, &bounds, &job)) {
+        tiles->num_copies = first_copy;
+        return SDL_FALSE;
+    }
+    job->first_copy = first_copy;
+    job->num_copies = tiles->num_copies - first_copy;
+
+    /* The workers draw on views of the target, which don't track damage */
+    for (i = first_copy; i < tiles->num_copies; i++) {
+        SDL_AddSurfaceDamage(tiles->surface, &tiles->copies[i].dstrect);
+    }
+    return SDL_TRUE;
+}
+
+/* Returns a view of the texture of a geometry command set up for drawing it,
+   which the workers only read */
+static SDL_Surface *SW_PrepareTileTexture(SW_TileContext *tiles, const SDL_RenderCommand *cmd)
+{
+    SDL_Surface *src = ((SW_TextureData *)cmd->data.draw.texture->driverdata)->surface;
+    const SDL_BlendMode blend = cmd->data.draw.blend;
+    SW_TileTexture *entry;
+    SDL_Surface *view;
+    SDL_Color color;
+
+    color.r = cmd->data.draw.r;
+    color.g = cmd->data.draw.g;
+    color.b = cmd->data.draw.b;
+    color.a = cmd->data.draw.a;
+
+    if (tiles->num_textures > 0) {
+        entry = &tiles->textures[tiles->num_textures - 1];
+        if (entry->source == src && entry->blend == blend &&
+            entry->color.r == color.r && entry->color.g == color.g &&
+            entry->color.b == color.b && entry->color.a == color.a) {
+            return entry->view.surface;
+        }
+    }
+    if (tiles->num_textures == tiles->max_textures) {
+        /* The views are kept between batches, the new ones start empty */
+        const int max_textures = tiles->max_textures;
+        if (!SW_ReserveTileItems((void **)&tiles->textures, &tiles->max_textures, tiles->num_textures, 1, sizeof(*tiles->textures))) {
+            return NULL;
+        }
+        SDL_memset(&tiles->textures[max_textures], 0, (tiles->max_textures - max_textures) * sizeof(*tiles->textures));
+    }
 
-            SetDrawState(surface, &drawstate);
+    entry = &tiles->textures[tiles->num_textures];
+    view = SW_GetScratchView(&entry->view, src->pixels, src->w, src->h, src->pitch, src->format->format);
+    if (view == NULL) {
+        return NULL;
+    }
+    SDL_SetSurfaceColorKey(view, (src->map->info.flags & SDL_COPY_COLORKEY) ? SDL_TRUE : SDL_FALSE, src->map->info.colorkey);
+    PrepTextureForCopy(cmd, &color, view, NULL, NULL, SDL_FALSE);
+    entry->source = src;
+    entry->color = color;
+    entry->blend = blend;
+    ++tiles->num_textures;
+    return view;
+}
+
+/* Adds a draw command to the tile batch, or returns SDL_FALSE if it has to be drawn on its own */
+static SDL_bool SW_AddTileJob(SW_TileContext *tiles, const SDL_RenderCommand *cmd, const SW_DrawStateCache *drawstate)
+{
+    SDL_Surface *surface = tiles->surface;
+    SDL_Surface *texture = NULL;
+    SDL_Rect clip, bounds;
+    SDL_bool single_tile = SDL_FALSE;
+    SW_TileJob *job;
+
+    if (cmd->command == SDL_RENDERCMD_CLEAR) {
+        /* By definition the clear ignores the clip rect */
+        clip.x = 0;
+        clip.y = 0;
+        clip.w = surface->w;
+        clip.h = surface->h;
+        bounds = clip;
+    } else if (cmd->command == SDL_RENDERCMD_COPY) {
+        GetDrawClipRect(surface, drawstate, &clip);
+        return SW_AddTileCopyJob(tiles, cmd, &clip);
+    } else {
+        if (!SW_GetCommandBounds(cmd, tiles->vertices, &bounds, &single_tile)) {
+            return SDL_FALSE;
+        }
+        GetDrawClipRect(surface, drawstate, &clip);
+        if (!SDL_GetRectIntersection(&bounds, &clip, &bounds)) {
+            return SDL_TRUE; /* nothing to draw */
+        }
+    }
+
+    if (single_tile && !SW_IsWithinOneTile(&bounds)) {
+        return SDL_FALSE;
+    }
+    if (cmd->command == SDL_RENDERCMD_GEOMETRY && cmd->data.draw.texture) {
+        texture = SW_PrepareTileTexture(tiles, cmd);
+        if (texture == NULL) {
+            return SDL_FALSE;
+        }
+    }
+    if (!SW_AppendTileJob(tiles, cmd, &clip, &bounds, &job)) {
+        return SDL_FALSE;
+    }
+    job->texture = texture;
+
+    /* The workers draw on views of the target, which don't track damage */
+    SDL_AddSurfaceDamage(surface, &bounds);
+    return SDL_TRUE;
+}
+
+/* Runs the blits of a copy job for the part of its copies within a tile, like SDL_SoftBlit() */
+static void SW_DrawTileCopies(const SW_TileContext *tiles, const SW_TileJob *job, const SDL_Rect *tile_rect)
+{
+    const SDL_Surface *surface = tiles->surface;
+    const int dstbpp = surface->format->BytesPerPixel;
+    const SW_TileCopy *copy = &tiles->copies[job->first_copy];
+    int i;
+
+    for (i = 0; i < job->num_copies; i++, copy++) {
+        const SW_TileBlit *blit = &tiles->blits[copy->blit];
+        const SDL_Surface *src = blit->source;
+        SDL_BlitInfo info;
+        SDL_Rect dstrect;
+        int srcx, srcy;
 
-            PrepTextureForCopy(cmd);
+        if (!SDL_GetRectIntersection(&copy->dstrect, tile_rect, &dstrect)) {
+            continue;
+        }
+        srcx = copy->srcrect.x + (dstrect.x - copy->dstrect.x);
+        srcy = copy->srcrect.y + (dstrect.y - copy->dstrect.y);
+
+        /* The blit info is shared by the workers, each one fills in its own copy */
+        info = blit->info;
+        info.src = (Uint8 *)src->pixels + srcy * src->pitch + srcx * info.src_fmt->BytesPerPixel;
+        info.src_w = dstrect.w;
+        info.src_h = dstrect.h;
+        info.src_pitch = src->pitch;
+        info.src_skip = info.src_pitch - info.src_w * info.src_fmt->BytesPerPixel;
+        info.dst = (Uint8 *)surface->pixels + dstrect.y * surface->pitch + dstrect.x * dstbpp;
+        info.dst_w = dstrect.w;
+        info.dst_h = dstrect.h;
+        info.dst_pitch = surface->pitch;
+        info.dst_skip = info.dst_pitch - info.dst_w * dstbpp;
+        blit->func(&info);
+    }
+}
+
+static void SW_DrawTiles(SW_TileContext *tiles, SW_TileWorker *worker)
+{
+    SDL_Surface *surface = tiles->surface;
+    const int num_tiles = tiles->tiles_x * tiles->tiles_y;
+    SDL_Surface *target;
+    int tile;
+
+    target = SW_GetScratchView(&worker->target, surface->pixels, surface->w, surface->h, surface->pitch, surface->format->format);
+    if (target == NULL) {
+        return; /* the other workers take the tiles */
+    }
+
+    while ((tile = SDL_AtomicAdd(&tiles->next_tile, 1)) < num_tiles) {
+        SDL_Rect tile_rect;
+        int i;
+
+        tile_rect.x = (tile % tiles->tiles_x) * SW_TILE_SIZE;
+        tile_rect.y = (tile / tiles->tiles_x) * SW_TILE_SIZE;
+        tile_rect.w = SDL_min(SW_TILE_SIZE, surface->w - tile_rect.x);
+        tile_rect.h = SDL_min(SW_TILE_SIZE, surface->h - tile_rect.y);
 
-            /* Apply viewport */
-            if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                dstrect->x += drawstate.viewport->x;
-                dstrect->y += drawstate.viewport->y;
+        for (i = tiles->bin_start[tile]; i < tiles->bin_start[tile + 1]; ++i) {
+            const SW_TileJob *job = &tiles->jobs[tiles->bins[i]];
+            SDL_Rect clip;
+
+            if (job->num_copies) {
+                SW_DrawTileCopies(tiles, job, &tile_rect);
+                continue;
             }
 
-            if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
-                SDL_BlitSurface(src, srcrect, surface, dstrect);
+            if (job->tile_x0 == job->tile_x1 && job->tile_y0 == job->tile_y1) {
+                /* Draws within one tile are clipped exactly like a serial draw */
+                clip = job->clip;
+            } else if (!SDL_GetRectIntersection(&job->clip, &tile_rect, &clip)) {
+                continue;
+            }
+            SDL_SetSurfaceClipRect(target, &clip);
+            if (job->texture) {
+                SW_DrawGeometry(target, job->cmd, tiles->vertices, job->texture);
             } else {
-                /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                 * to avoid potentially frequent RLE encoding/decoding.
-                 */
-                SDL_SetSurfaceRLE(surface, 0);
-
-                /* Prevent to do scaling + clipping on viewport boundaries as it may lose proportion */
-                if (dstrect->x < 0 || dstrect->y < 0 || dstrect->x + dstrect->w > surface->w || dstrect->y + dstrect->h > surface->h) {
-                    SDL_Surface *tmp = SDL_CreateSurface(dstrect->w, dstrect->h, src->format->format);
-                    /* Scale to an intermediate surface, then blit */
-                    if (tmp) {
-                        SDL_Rect r;
-                        SDL_BlendMode blendmode;
-                        Uint8 alphaMod, rMod, gMod, bMod;
-
-                        SDL_GetSurfaceBlendMode(src, &blendmode);
-                        SDL_GetSurfaceAlphaMod(src, &alphaMod);
-                        SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
-
-                        r.x = 0;
-                        r.y = 0;
-                        r.w = dstrect->w;
-                        r.h = dstrect->h;
-
-                        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
-                        SDL_SetSurfaceColorMod(src, 255, 255, 255);
-                        SDL_SetSurfaceAlphaMod(src, 255);
-
-                        SDL_PrivateBlitSurfaceScaled(src, srcrect, tmp, &r, texture->scaleMode);
-
-                        SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
-                        SDL_SetSurfaceAlphaMod(tmp, alphaMod);
-                        SDL_SetSurfaceBlendMode(tmp, blendmode);
-
-                        SDL_BlitSurface(tmp, NULL, surface, dstrect);
-                        SDL_DestroySurface(tmp);
-                        /* No need to set back r/g/b/a/blendmode to 'src' since it's done in PrepTextureForCopy() */
-                    }
-                } else {
-                    SDL_PrivateBlitSurfaceScaled(src, srcrect, surface, dstrect, texture->scaleMode);
-                }
+                SW_DrawCommand(NULL, target, job->cmd, tiles->vertices);
             }
+        }
+    }
+}
+
+static int SDLCALL SW_TileThread(void *data)
+{
+    SW_TileWorker *worker = (SW_TileWorker *)data;
+    SW_TileContext *tiles = worker->context;
+    Uint32 generation = 0;
+
+    SDL_LockMutex(tiles->lock);
+    for (;;) {
+        while (!tiles->quit && tiles->generation == generation) {
+            SDL_WaitCondition(tiles->work_ready, tiles->lock);
+        }
+        if (tiles->quit) {
             break;
         }
+        generation = tiles->generation;
+        SDL_UnlockMutex(tiles->lock);
 
-        case SDL_RENDERCMD_COPY_EX:
-        {
-            CopyExData *copydata = (CopyExData *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            SetDrawState(surface, &drawstate);
-            PrepTextureForCopy(cmd);
-
-            /* Apply viewport */
-            if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                copydata->dstrect.x += drawstate.viewport->x;
-                copydata->dstrect.y += drawstate.viewport->y;
+        SW_DrawTiles(tiles, worker);
+
+        SDL_LockMutex(tiles->lock);
+        if (--tiles->busy == 0) {
+            SDL_SignalCondition(tiles->work_done);
+        }
+    }
+    SDL_UnlockMutex(tiles->lock);
+    return 0;
+}
+
+/* Bins the collected draw commands and draws all the tiles */
+static void SW_FlushTiles(SW_TileContext *tiles)
+{
+    const int num_tiles = tiles->tiles_x * tiles->tiles_y;
+    int i, x, y, num_bins = 0;
+
+    if (tiles->num_jobs == 0) {
+        return;
+    }
+
+    if (num_tiles + 1 > tiles->max_tiles) {
+        int *bin_start = (int *)SDL_realloc(tiles->bin_start, (num_tiles + 1) * sizeof(int));
+        if (bin_start == NULL) {
+            goto done;
+        }
+        tiles->bin_start = bin_start;
+        tiles->max_tiles = num_tiles + 1;
+    }
+
+    /* Count the jobs of each tile, then place them in the bins in draw order */
+    SDL_memset(tiles->bin_start, 0, (num_tiles + 1) * sizeof(int));
+    for (i = 0; i < tiles->num_jobs; ++i) {
+        const SW_TileJob *job = &tiles->jobs[i];
+        for (y = job->tile_y0; y <= job->tile_y1; ++y) {
+            for (x = job->tile_x0; x <= job->tile_x1; ++x) {
+                ++tiles->bin_start[y * tiles->tiles_x + x + 1];
+            }
+        }
+        num_bins += (job->tile_x1 - job->tile_x0 + 1) * (job->tile_y1 - job->tile_y0 + 1);
+    }
+    if (num_bins > tiles->max_bins) {
+        int *bins = (int *)SDL_realloc(tiles->bins, num_bins * sizeof(int));
+        if (bins == NULL) {
+            goto done;
+        }
+        tiles->bins = bins;
+        tiles->max_bins = num_bins;
+    }
+    for (i = 0; i < num_tiles; ++i) {
+        tiles->bin_start[i + 1] += tiles->bin_start[i];
+    }
+    for (i = 0; i < tiles->num_jobs; ++i) {
+        const SW_TileJob *job = &tiles->jobs[i];
+        for (y = job->tile_y0; y <= job->tile_y1; ++y) {
+            for (x = job->tile_x0; x <= job->tile_x1; ++x) {
+                tiles->bins[tiles->bin_start[y * tiles->tiles_x + x]++] = i;
             }
+        }
+    }
+    /* Filling moved each start to the end of its bin, which is the start of the next one */
+    for (i = num_tiles; i > 0; --i) {
+        tiles->bin_start[i] = tiles->bin_start[i - 1];
+    }
+    tiles->bin_start[0] = 0;
+
+    SDL_AtomicSet(&tiles->next_tile, 0);
+    if (tiles->num_workers > 1) {
+        SDL_LockMutex(tiles->lock);
+        tiles->busy = tiles->num_workers - 1;
+        ++tiles->generation;
+        SDL_BroadcastCondition(tiles->work_ready);
+        SDL_UnlockMutex(tiles->lock);
+    }
 
-            SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
-                            &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip,
-                            copydata->scale_x, copydata->scale_y);
+    SW_DrawTiles(tiles, &tiles->workers[0]);
+
+    if (tiles->num_workers > 1) {
+        SDL_LockMutex(tiles->lock);
+        while (tiles->busy > 0) {
+            SDL_WaitCondition(tiles->work_done, tiles->lock);
+        }
+        SDL_UnlockMutex(tiles->lock);
+    }
+
+done:
+    tiles->num_jobs = 0;
+    tiles->num_copies = 0;
+    tiles->num_blits = 0;
+    tiles->num_textures = 0;
+}
+
+static SDL_bool SW_BeginTiles(SW_TileContext *tiles, SDL_Surface *surface, void *vertices)
+{
+    if (surface->w <= 0 || surface->h <= 0 || surface->pixels == NULL ||
+        SDL_MUSTLOCK(surface) || SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
+        return SDL_FALSE;
+    }
+    tiles->surface = surface;
+    tiles->vertices = vertices;
+    tiles->tiles_x = (surface->w + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    tiles->tiles_y = (surface->h + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    tiles->num_jobs = 0;
+    tiles->num_copies = 0;
+    tiles->num_blits = 0;
+    tiles->num_textures = 0;
+    return SDL_TRUE;
+}
+
+static void SW_DestroyTileContext(SW_TileContext *tiles)
+{
+    int i;
+
+    if (tiles == NULL) {
+        return;
+    }
+
+    if (tiles->lock) {
+        SDL_LockMutex(tiles->lock);
+        tiles->quit = SDL_TRUE;
+        SDL_BroadcastCondition(tiles->work_ready);
+        SDL_UnlockMutex(tiles->lock);
+    }
+    for (i = 0; i < tiles->num_workers; ++i) {
+        SW_TileWorker *worker = &tiles->workers[i];
+        if (worker->thread) {
+            SDL_WaitThread(worker->thread, NULL);
+        }
+        SW_DestroyScratchSurface(&worker->target);
+    }
+    for (i = 0; i < tiles->max_textures; ++i) {
+        SW_DestroyScratchSurface(&tiles->textures[i].view);
+    }
+    SDL_DestroyCondition(tiles->work_done);
+    SDL_DestroyCondition(tiles->work_ready);
+    SDL_DestroyMutex(tiles->lock);
+    SDL_free(tiles->workers);
+    SDL_free(tiles->jobs);
+    SDL_free(tiles->copies);
+    SDL_free(tiles->blits);
+    SDL_free(tiles->textures);
+    SDL_free(tiles->bins);
+    SDL_free(tiles->bin_start);
+    SDL_free(tiles);
+}
+
+static SW_TileContext *SW_CreateTileContext(int num_workers)
+{
+    SW_TileContext *tiles;
+    int i;
+
+    tiles = (SW_TileContext *)SDL_calloc(1, sizeof(*tiles));
+    if (tiles == NULL) {
+        return NULL;
+    }
+    tiles->workers = (SW_TileWorker *)SDL_calloc(num_workers, sizeof(*tiles->workers));
+    tiles->lock = SDL_CreateMutex();
+    tiles->work_ready = SDL_CreateCondition();
+    tiles->work_done = SDL_CreateCondition();
+    if (!tiles->workers || !tiles->lock || !tiles->work_ready || !tiles->work_done) {
+        SW_DestroyTileContext(tiles);
+        return NULL;
+    }
+
+    tiles->workers[0].context = tiles;
+    tiles->num_workers = 1;
+    for (i = 1; i < num_workers; ++i) {
+        SW_TileWorker *worker = &tiles->workers[i];
+        worker->context = tiles;
+        worker->thread = SDL_CreateThreadInternal(SW_TileThread, "SDLSWRender", 0, worker);
+        if (worker->thread == NULL) {
             break;
         }
+        tiles->num_workers = i + 1;
+    }
+    if (tiles->num_workers == 1) {
+        SW_DestroyTileContext(tiles);
+        return NULL;
+    }
+    return tiles;
+}
 
-        case SDL_RENDERCMD_GEOMETRY:
+static int SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    SW_RenderData *data = (SW_RenderData *)renderer->driverdata;
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_TileContext *tiles = NULL;
+    SW_DrawStateCache drawstate;
+
+    if (surface == NULL) {
+        return -1;
+    }
+
+    if (data->tiles && SW_BeginTiles(data->tiles, surface, vertices)) {
+        tiles = data->tiles;
+    }
+
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        switch (cmd->command) {
+        case SDL_RENDERCMD_SETDRAWCOLOR:
         {
-            int i;
-            SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const int count = (int)cmd->data.draw.count;
-            SDL_Texture *texture = cmd->data.draw.texture;
-            const SDL_BlendMode blend = cmd->data.draw.blend;
-
-            SetDrawState(surface, &drawstate);
-
-            if (texture) {
-                SDL_Surface *src = (SDL_Surface *)texture->driverdata;
-
-                GeometryCopyData *ptr = (GeometryCopyData *)verts;
-
-                PrepTextureForCopy(cmd);
-
-                /* Apply viewport */
-                if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                    SDL_Point vp;
-                    vp.x = drawstate.viewport->x;
-                    vp.y = drawstate.viewport->y;
-                    trianglepoint_2_fixedpoint(&vp);
-                    for (i = 0; i < count; i++) {
-                        ptr[i].dst.x += vp.x;
-                        ptr[i].dst.y += vp.y;
-                    }
-                }
+            break; /* Not used in this backend. */
+        }
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_BlitTriangle(
-                        src,
-                        &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
-                        surface,
-                        &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
-                        ptr[0].color, ptr[1].color, ptr[2].color);
-                }
-            } else {
-                GeometryFillData *ptr = (GeometryFillData *)verts;
-
-                /* Apply viewport */
-                if (drawstate.viewport != NULL && (drawstate.viewport->x || drawstate.viewport->y)) {
-                    SDL_Point vp;
-                    vp.x = drawstate.viewport->x;
-                    vp.y = drawstate.viewport->y;
-                    trianglepoint_2_fixedpoint(&vp);
-                    for (i = 0; i < count; i++) {
-                        ptr[i].dst.x += vp.x;
-                        ptr[i].dst.y += vp.y;
-                    }
-                }
+        case SDL_RENDERCMD_SETVIEWPORT:
+        {
+            drawstate.viewport = &cmd->data.viewport.rect;
+            drawstate.surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
-                }
-            }
+        case SDL_RENDERCMD_SETCLIPRECT:
+        {
+            drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
+            drawstate.surface_cliprect_dirty = SDL_TRUE;
             break;
         }
 
         case SDL_RENDERCMD_NO_OP:
             break;
+
+        default:
+        {
+            if (cmd->command != SDL_RENDERCMD_CLEAR) {
+                ApplyViewport(cmd, drawstate.viewport, vertices);
+                ++renderer->stats.draw_calls;
+            }
+
+            /* Draws are collected in tiles until one has to be drawn on its own */
+            if (tiles) {
+                if (SW_AddTileJob(tiles, cmd, &drawstate)) {
+                    break;
+                }
+                SW_FlushTiles(tiles);
+            }
+
+            if (cmd->command == SDL_RENDERCMD_CLEAR) {
+                /* By definition the clear ignores the clip rect */
+                SDL_SetSurfaceClipRect(surface, NULL);
+                drawstate.surface_cliprect_dirty = SDL_TRUE;
+            } else {
+                SetDrawState(surface, &drawstate);
+            }
+            SW_DrawCommand(renderer, surface, cmd, vertices);
+            break;
+        }
         }
 
         cmd = cmd->next;
     }
 
+    if (tiles) {
+        SW_FlushTiles(tiles);
+    }
+
     return 0;
 }
 
@@ -983,15 +2214,28 @@ static int SW_RenderPresent(SDL_Renderer *renderer)
 
 static void SW_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->driverdata;
+    SW_TextureData *texturedata = (SW_TextureData *)texture->driverdata;
 
-    SDL_DestroySurface(surface);
+    if (texturedata) {
+        SW_FlushBlitMaps(&texturedata->maps);
+        SDL_DestroySurface(texturedata->surface);
+        SDL_free(texturedata);
+    }
 }
 
 static void SW_DestroyRenderer(SDL_Renderer *renderer)
 {
     SW_RenderData *data = (SW_RenderData *)renderer->driverdata;
 
+    if (data) {
+        SW_DestroyTileContext(data->tiles);
+        SW_DestroyScratchSurface(&data->source);
+        SW_DestroyScratchSurface(&data->scaled);
+        SW_DestroyScratchSurface(&data->mask);
+        SW_DestroyScratchSurface(&data->rotated);
+        SW_DestroyScratchSurface(&data->mask_rotated);
+        SW_DestroyScratchSurface(&data->rotated_rgb);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -1094,6 +2338,8 @@ SW_CreateRendererForSurface(SDL_Surface *surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    const char *hint;
+    int num_threads;
 
     if (surface == NULL) {
         SDL_InvalidParamError("surface");
@@ -1115,6 +2361,17 @@ SW_CreateRendererForSurface(SDL_Surface *surface)
     data->surface = surface;
     data->window = surface;
 
+    hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+    num_threads = hint ? SDL_atoi(hint) : 1;
+    if (num_threads == 0) {
+        num_threads = SDL_GetCPUCount();
+    }
+    if (num_threads > 1) {
+        data->tiles = SW_CreateTileContext(num_threads);
+    }
+    /* Tiles only pay off with many draws to spread over them */
+    renderer->always_batch = data->tiles ? SDL_TRUE : SDL_FALSE;
+
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
@@ -1130,7 +2387,11 @@ SW_CreateRendererForSurface(SDL_Surface *surface)
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->QueueCopies = SW_QueueCopies;
     renderer->QueueGeometry = SW_QueueGeometry;
+    renderer->CreateStaticGeometry = SW_CreateStaticGeometry;
+    renderer->QueueStaticGeometry = SW_QueueStaticGeometry;
+    renderer->DestroyStaticGeometry = SW_DestroyStaticGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderPresent = SW_RenderPresent;
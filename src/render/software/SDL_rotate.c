@@ -62,18 +62,6 @@ typedef struct tColorY
     Uint8 y;
 } tColorY;
 
-/**
-\brief Number of guard rows added to destination surfaces.
-
-This is a simple but effective workaround for observed issues.
-These rows allocate extra memory and are then hidden from the surface.
-Rows are added to the end of destination surfaces when they are allocated.
-This catches any potential overflows which seem to happen with
-just the right src image dimensions and scale/rotation and can lead
-to a situation where the program can segfault.
-*/
-#define GUARD_ROWS (2)
-
 /**
 \brief Returns colorkey info for a surface
 */
@@ -248,11 +236,235 @@ static void transformSurfaceY90(SDL_Surface *src, SDL_Surface *dst, int angle, i
 
 #undef TRANSFORM_SURFACE_90
 
+/**
+\brief Size of the destination tiles processed by the 32 bit rotozoomer.
+
+The destination is transformed one tile at a time rather than one row at a time,
+so that the source pixels read along a tile row are still in the cache for the
+next ones, whatever the rotation.
+*/
+#define TRANSFORM_TILE_SIZE 32
+
+/**
+\brief Transforms one row of a destination tile.
+
+\param src Source surface.
+\param pc First destination pixel.
+\param n Number of destination pixels.
+\param sdx 16.16 fixed point source X coordinate of the first pixel.
+\param sdy 16.16 fixed point source Y coordinate of the first pixel.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+*/
+typedef void (*transformRowRGBAFunc)(const SDL_Surface *src, tColorRGBA *pc, int n, int sdx, int sdy,
+                                     int isin, int icos, int flipx, int flipy);
+
+/* Nearest neighbor sampling of a row */
+static void transformRowRGBA(const SDL_Surface *src, tColorRGBA *pc, int n, int sdx, int sdy,
+                             int isin, int icos, int flipx, int flipy)
+{
+    const int sw = src->w - 1;
+    const int sh = src->h - 1;
+    int x;
+
+    for (x = 0; x < n; x++) {
+        int dx = (sdx >> 16);
+        int dy = (sdy >> 16);
+        if ((unsigned)dx < (unsigned)src->w && (unsigned)dy < (unsigned)src->h) {
+            if (flipx) {
+                dx = sw - dx;
+            }
+            if (flipy) {
+                dy = sh - dy;
+            }
+            *pc = *((tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx);
+        }
+        sdx += icos;
+        sdy += isin;
+        pc++;
+    }
+}
+
+/* Bilinear interpolation of one pixel, if it's inside the source */
+static SDL_INLINE void interpolatePixelRGBA(const SDL_Surface *src, tColorRGBA *pc, int sdx, int sdy,
+                                            int flipx, int flipy)
+{
+    tColorRGBA c00, c01, c10, c11, cswap;
+    tColorRGBA *sp;
+    int dx = (sdx >> 16);
+    int dy = (sdy >> 16);
+    if (flipx) {
+        dx = (src->w - 1) - dx;
+    }
+    if (flipy) {
+        dy = (src->h - 1) - dy;
+    }
+    if ((dx > -1) && (dy > -1) && (dx < (src->w - 1)) && (dy < (src->h - 1))) {
+        int ex, ey;
+        int t1, t2;
+        sp = (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx;
+        c00 = *sp;
+        sp += 1;
+        c01 = *sp;
+        sp += (src->pitch / 4);
+        c11 = *sp;
+        sp -= 1;
+        c10 = *sp;
+        if (flipx) {
+            cswap = c00;
+            c00 = c01;
+            c01 = cswap;
+            cswap = c10;
+            c10 = c11;
+            c11 = cswap;
+        }
+        if (flipy) {
+            cswap = c00;
+            c00 = c10;
+            c10 = cswap;
+            cswap = c01;
+            c01 = c11;
+            c11 = cswap;
+        }
+        /*
+         * Interpolate colors
+         */
+        ex = (sdx & 0xffff);
+        ey = (sdy & 0xffff);
+        t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+        t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+        pc->r = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+        t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+        t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+        pc->g = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+        t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+        t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+        pc->b = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+        t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+        t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+        pc->a = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+    }
+}
+
+/* Bilinear sampling of a row */
+static void transformRowRGBASmooth(const SDL_Surface *src, tColorRGBA *pc, int n, int sdx, int sdy,
+                                   int isin, int icos, int flipx, int flipy)
+{
+    int x;
+
+    for (x = 0; x < n; x++) {
+        interpolatePixelRGBA(src, pc, sdx, sdy, flipx, flipy);
+        sdx += icos;
+        sdy += isin;
+        pc++;
+    }
+}
+
+/* Returns whether both pixels of a pair can be interpolated, and their top left source pixels */
+static SDL_INLINE SDL_bool getPixelPairRGBA(const SDL_Surface *src, int sdx, int sdy, int isin, int icos,
+                                             int flipx, int flipy, const Uint8 **sp0, const Uint8 **sp1)
+{
+    int dx0 = (sdx >> 16);
+    int dy0 = (sdy >> 16);
+    int dx1 = ((sdx + icos) >> 16);
+    int dy1 = ((sdy + isin) >> 16);
+    if (flipx) {
+        dx0 = (src->w - 1) - dx0;
+        dx1 = (src->w - 1) - dx1;
+    }
+    if (flipy) {
+        dy0 = (src->h - 1) - dy0;
+        dy1 = (src->h - 1) - dy1;
+    }
+    if ((unsigned)dx0 >= (unsigned)(src->w - 1) || (unsigned)dy0 >= (unsigned)(src->h - 1) ||
+        (unsigned)dx1 >= (unsigned)(src->w - 1) || (unsigned)dy1 >= (unsigned)(src->h - 1)) {
+        return SDL_FALSE;
+    }
+    *sp0 = (const Uint8 *)src->pixels + src->pitch * dy0 + dx0 * 4;
+    *sp1 = (const Uint8 *)src->pixels + src->pitch * dy1 + dx1 * 4;
+    return SDL_TRUE;
+}
+
+/*
+ * The SIMD versions interpolate two pixels at a time, with the four components of
+ * each in 16 bit lanes, and give the same results as the scalar code: every
+ * ((a * e) >> 16) with a signed difference and an unsigned 16 bit weight is
+ * computed exactly.
+ */
+#ifdef SDL_SSE2_INTRINSICS
+
+/* ((a * e) >> 16) for signed 16 bit a and unsigned 16 bit e */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") mulhiSignedUnsignedSSE2(__m128i a, __m128i e)
+{
+    return _mm_sub_epi16(_mm_mulhi_epu16(a, e), _mm_and_si128(_mm_srai_epi16(a, 15), e));
+}
+
+static void SDL_TARGETING("sse2") transformRowRGBASmoothSSE2(const SDL_Surface *src, tColorRGBA *pc, int n, int sdx, int sdy,
+                                                             int isin, int icos, int flipx, int flipy)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16(0xff);
+    const int pitch = src->pitch;
+    int x = 0;
+
+    while (x < n) {
+        const Uint8 *sp0, *sp1;
+        if (x + 1 < n && getPixelPairRGBA(src, sdx, sdy, isin, icos, flipx, flipy, &sp0, &sp1)) {
+            /* the top and bottom source pixels of both destination pixels */
+            const __m128i top = _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i *)sp0), _mm_loadl_epi64((const __m128i *)sp1));
+            const __m128i bottom = _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i *)(sp0 + pitch)), _mm_loadl_epi64((const __m128i *)(sp1 + pitch)));
+            __m128i c00 = _mm_unpacklo_epi8(top, zero);
+            __m128i c01 = _mm_unpackhi_epi8(top, zero);
+            __m128i c10 = _mm_unpacklo_epi8(bottom, zero);
+            __m128i c11 = _mm_unpackhi_epi8(bottom, zero);
+            __m128i cswap, ex, ey, t1, t2;
+
+            if (flipx) {
+                cswap = c00;
+                c00 = c01;
+                c01 = cswap;
+                cswap = c10;
+                c10 = c11;
+                c11 = cswap;
+            }
+            if (flipy) {
+                cswap = c00;
+                c00 = c10;
+                c10 = cswap;
+                cswap = c01;
+                c01 = c11;
+                c11 = cswap;
+            }
+            ex = _mm_unpacklo_epi64(_mm_set1_epi16((short)(sdx & 0xffff)), _mm_set1_epi16((short)((sdx + icos) & 0xffff)));
+            ey = _mm_unpacklo_epi64(_mm_set1_epi16((short)(sdy & 0xffff)), _mm_set1_epi16((short)((sdy + isin) & 0xffff)));
+            t1 = _mm_and_si128(_mm_add_epi16(mulhiSignedUnsignedSSE2(_mm_sub_epi16(c01, c00), ex), c00), mask);
+            t2 = _mm_and_si128(_mm_add_epi16(mulhiSignedUnsignedSSE2(_mm_sub_epi16(c11, c10), ex), c10), mask);
+            t1 = _mm_add_epi16(mulhiSignedUnsignedSSE2(_mm_sub_epi16(t2, t1), ey), t1);
+            _mm_storel_epi64((__m128i *)pc, _mm_packus_epi16(t1, t1));
+
+            sdx += 2 * icos;
+            sdy += 2 * isin;
+            pc += 2;
+            x += 2;
+        } else {
+            interpolatePixelRGBA(src, pc, sdx, sdy, flipx, flipy);
+            sdx += icos;
+            sdy += isin;
+            pc++;
+            x++;
+        }
+    }
+}
+
+#endif /* SDL_SSE2_INTRINSICS */
+
 /**
 \brief Internal 32 bit rotozoomer with optional anti-aliasing.
 
 Rotates and zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control
-parameters by scanning the destination surface and applying optionally anti-aliasing
+parameters by scanning the destination surface in tiles and applying optionally anti-aliasing
 by bilinear interpolation.
 Assumes src and dst surfaces are of 32 bit depth.
 Assumes dst surface was allocated with the correct dimensions.
@@ -272,20 +484,14 @@ static void transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int isin, i
                                  const SDL_Rect *rect_dest,
                                  const SDL_FPoint *center)
 {
-    int sw, sh;
     int cx, cy;
-    tColorRGBA c00, c01, c10, c11, cswap;
-    tColorRGBA *pc, *sp;
-    int gap;
+    int tx, ty;
     const int fp_half = (1 << 15);
+    transformRowRGBAFunc transform_row = transformRowRGBA;
 
     /*
      * Variable setup
      */
-    sw = src->w - 1;
-    sh = src->h - 1;
-    pc = (tColorRGBA *)dst->pixels;
-    gap = dst->pitch - dst->w * 4;
     cx = (int)(center->x * 65536.0);
     cy = (int)(center->y * 65536.0);
 
@@ -293,98 +499,27 @@ static void transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int isin, i
      * Switch between interpolating and non-interpolating code
      */
     if (smooth) {
-        int y;
-        for (y = 0; y < dst->h; y++) {
-            int x;
-            double src_x = (rect_dest->x + 0 + 0.5 - center->x);
-            double src_y = (rect_dest->y + y + 0.5 - center->y);
-            int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
-            int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
-            for (x = 0; x < dst->w; x++) {
-                int dx = (sdx >> 16);
-                int dy = (sdy >> 16);
-                if (flipx) {
-                    dx = sw - dx;
-                }
-                if (flipy) {
-                    dy = sh - dy;
-                }
-                if ((dx > -1) && (dy > -1) && (dx < (src->w - 1)) && (dy < (src->h - 1))) {
-                    int ex, ey;
-                    int t1, t2;
-                    sp = (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx;
-                    c00 = *sp;
-                    sp += 1;
-                    c01 = *sp;
-                    sp += (src->pitch / 4);
-                    c11 = *sp;
-                    sp -= 1;
-                    c10 = *sp;
-                    if (flipx) {
-                        cswap = c00;
-                        c00 = c01;
-                        c01 = cswap;
-                        cswap = c10;
-                        c10 = c11;
-                        c11 = cswap;
-                    }
-                    if (flipy) {
-                        cswap = c00;
-                        c00 = c10;
-                        c10 = cswap;
-                        cswap = c01;
-                        c01 = c11;
-                        c11 = cswap;
-                    }
-                    /*
-                     * Interpolate colors
-                     */
-                    ex = (sdx & 0xffff);
-                    ey = (sdy & 0xffff);
-                    t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-                    t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-                    pc->r = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-                    t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-                    pc->g = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-                    t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-                    pc->b = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-                    t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-                    pc->a = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                }
-                sdx += icos;
-                sdy += isin;
-                pc++;
-            }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
+        transform_row = transformRowRGBASmooth;
+#ifdef SDL_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            transform_row = transformRowRGBASmoothSSE2;
         }
-    } else {
-        int y;
-        for (y = 0; y < dst->h; y++) {
-            int x;
-            double src_x = (rect_dest->x + 0 + 0.5 - center->x);
-            double src_y = (rect_dest->y + y + 0.5 - center->y);
-            int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
-            int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
-            for (x = 0; x < dst->w; x++) {
-                int dx = (sdx >> 16);
-                int dy = (sdy >> 16);
-                if ((unsigned)dx < (unsigned)src->w && (unsigned)dy < (unsigned)src->h) {
-                    if (flipx) {
-                        dx = sw - dx;
-                    }
-                    if (flipy) {
-                        dy = sh - dy;
-                    }
-                    *pc = *((tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx);
-                }
-                sdx += icos;
-                sdy += isin;
-                pc++;
+#endif
+    }
+
+    for (ty = 0; ty < dst->h; ty += TRANSFORM_TILE_SIZE) {
+        const int th = SDL_min(TRANSFORM_TILE_SIZE, dst->h - ty);
+        for (tx = 0; tx < dst->w; tx += TRANSFORM_TILE_SIZE) {
+            const int tw = SDL_min(TRANSFORM_TILE_SIZE, dst->w - tx);
+            int y;
+            for (y = ty; y < ty + th; y++) {
+                double src_x = (rect_dest->x + 0 + 0.5 - center->x);
+                double src_y = (rect_dest->y + y + 0.5 - center->y);
+                int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half) + tx * icos;
+                int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half) + tx * isin;
+                tColorRGBA *pc = (tColorRGBA *)((Uint8 *)dst->pixels + dst->pitch * y) + tx;
+                transform_row(src, pc, tw, sdx, sdy, isin, icos, flipx, flipy);
             }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
         }
     }
 }
@@ -482,13 +617,16 @@ When using the NONE and MOD modes, color and alpha modulation must be applied be
 \param cangle The angle cosine
 \param sangle The angle sine
 \param center The true coordinate of the center of rotation
-\return The new rotated surface.
+\param dst A surface to reuse for the result, or NULL to create a new one. It must have the format
+            of 'src', the size of 'rect_dest' and GUARD_ROWS more rows of pixels.
+\return The rotated surface, 'dst' if it was given.
 
 */
 
 SDL_Surface *
 SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, int flipx, int flipy,
-                     const SDL_Rect *rect_dest, double cangle, double sangle, const SDL_FPoint *center)
+                     const SDL_Rect *rect_dest, double cangle, double sangle, const SDL_FPoint *center,
+                     SDL_Surface *dst)
 {
     SDL_Surface *rz_dst;
     int is8bit, angle90;
@@ -519,30 +657,30 @@ SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, int flipx, int
     cangleinv = cangle * 65536.0;
 
     /* Alloc space to completely contain the rotated surface */
-    rz_dst = NULL;
-    if (is8bit) {
-        /* Target surface is 8 bit */
-        rz_dst = SDL_CreateSurface(rect_dest->w, rect_dest->h + GUARD_ROWS, src->format->format);
-        if (rz_dst != NULL) {
-            if (src->format->palette) {
-                for (i = 0; i < src->format->palette->ncolors; i++) {
-                    rz_dst->format->palette->colors[i] = src->format->palette->colors[i];
-                }
-                rz_dst->format->palette->ncolors = src->format->palette->ncolors;
-            }
+    if (dst != NULL) {
+        /* Target surface is provided by the caller */
+        if (dst->format->format != src->format->format || dst->w != rect_dest->w || dst->h != rect_dest->h) {
+            return NULL;
         }
+        rz_dst = dst;
     } else {
-        /* Target surface is 32 bit with source RGBA ordering */
+        /* Target surface is 8 bit or 32 bit with source RGBA ordering */
         rz_dst = SDL_CreateSurface(rect_dest->w, rect_dest->h + GUARD_ROWS, src->format->format);
-    }
 
-    /* Check target */
-    if (rz_dst == NULL) {
-        return NULL;
-    }
+        /* Check target */
+        if (rz_dst == NULL) {
+            return NULL;
+        }
 
-    /* Adjust for guard rows */
-    rz_dst->h = rect_dest->h;
+        /* Adjust for guard rows */
+        rz_dst->h = rect_dest->h;
+    }
+    if (is8bit && src->format->palette) {
+        for (i = 0; i < src->format->palette->ncolors; i++) {
+            rz_dst->format->palette->colors[i] = src->format->palette->colors[i];
+        }
+        rz_dst->format->palette->ncolors = src->format->palette->ncolors;
+    }
 
     SDL_GetSurfaceBlendMode(src, &blendmode);
 
@@ -550,9 +688,16 @@ SDLgfx_rotateSurface(SDL_Surface *src, double angle, int smooth, int flipx, int
         /* If available, the colorkey will be used to discard the pixels that are outside of the rotated area. */
         SDL_SetSurfaceColorKey(rz_dst, SDL_TRUE, colorkey);
         SDL_FillSurfaceRect(rz_dst, NULL, colorkey);
-    } else if (blendmode == SDL_BLENDMODE_NONE) {
-        blendmode = SDL_BLENDMODE_BLEND;
-    } else if (blendmode == SDL_BLENDMODE_MOD || blendmode == SDL_BLENDMODE_MUL) {
+    } else if (blendmode != SDL_BLENDMODE_MOD && blendmode != SDL_BLENDMODE_MUL) {
+        if (blendmode == SDL_BLENDMODE_NONE) {
+            blendmode = SDL_BLENDMODE_BLEND;
+        }
+        if (dst != NULL) {
+            /* A reused surface isn't cleared like a new one, and may still have a colorkey */
+            SDL_SetSurfaceColorKey(rz_dst, SDL_FALSE, 0);
+            SDL_FillSurfaceRect(rz_dst, NULL, 0);
+        }
+    } else {
         /* Without a colorkey, the target texture has to be white for the MOD and MUL blend mode so
          * that the pixels outside the rotated area don't affect the destination surface.
          */
@@ -36,12 +36,22 @@
 
 #define COLOR_EQ(c1, c2) ((c1).r == (c2).r && (c1).g == (c2).g && (c1).b == (c2).b && (c1).a == (c2).a)
 
+/* 32-bit format with 8 bits per channel, handled by SDL_BlitTriangle_8888() */
+#define FORMAT_IS_8888(fmt) ((fmt)->BytesPerPixel == 4 && !(fmt)->palette && \
+                             !(fmt)->Rloss && !(fmt)->Gloss && !(fmt)->Bloss && (!(fmt)->Amask || !(fmt)->Aloss))
+
 static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
                                   SDL_Point s2_x_area, SDL_Rect dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
                                   int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x,
                                   int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y, int w0_row, int w1_row, int w2_row,
                                   SDL_Color c0, SDL_Color c1, SDL_Color c2, int is_uniform);
 
+static void SDL_BlitTriangle_8888(SDL_BlitInfo *info,
+                                  SDL_Point s2_x_area, SDL_Rect dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
+                                  int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x,
+                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y, int w0_row, int w1_row, int w2_row,
+                                  SDL_Color c0, SDL_Color c1, SDL_Color c2, int is_uniform);
+
 #if 0
 int SDL_BlitTriangle(SDL_Surface *src, const SDL_Point srcpoints[3], SDL_Surface *dst, const SDL_Point dstpoints[3])
 {
@@ -145,58 +155,400 @@ static void bounding_rect(const SDL_Point *a, const SDL_Point *b, const SDL_Poin
     r->h = (max_y - min_y);
 }
 
+/* Restrict the span [*x0, *x1] of a row to the pixels inside one edge,
+ * where the edge function 'w + x * step' plus the top-left bias is positive or zero.
+ * An empty span is returned as *x0 > *x1.
+ */
+static void clip_span_to_edge(int w, int step, int bias, int *x0, int *x1)
+{
+    w += bias;
+    if (step > 0) {
+        if (w < 0) {
+            int x = (-w + step - 1) / step;
+            if (*x0 < x) {
+                *x0 = x;
+            }
+        }
+    } else if (step < 0) {
+        if (w < 0) {
+            *x1 = *x0 - 1;
+        } else {
+            int x = w / -step;
+            if (*x1 > x) {
+                *x1 = x;
+            }
+        }
+    } else if (w < 0) {
+        *x1 = *x0 - 1;
+    }
+}
+
+/* A value interpolated along a span, as the quotient and remainder of 'numerator / area'.
+ * Stepping it gives exactly the same result as dividing the numerator at each pixel.
+ */
+typedef struct
+{
+    int value;
+    Uint32 frac; /* in [0, area) */
+    int step;
+    Uint32 step_frac; /* in [0, area) */
+} TriangleInterpolant;
+
+static TriangleInterpolant interpolant_init(Sint64 numerator, Sint64 step, int area)
+{
+    TriangleInterpolant it;
+    Sint64 step_frac = step % area;
+    it.value = (int)(numerator / area);
+    it.frac = (Uint32)(numerator % area);
+    it.step = (int)(step / area);
+    if (step_frac < 0) {
+        step_frac += area;
+        it.step -= 1;
+    }
+    it.step_frac = (Uint32)step_frac;
+    return it;
+}
+
+/* Return the value at the current pixel, and move to the next one.
+ * The remainders are below the area, so their sum can't overflow 32 bits.
+ */
+SDL_FORCE_INLINE int interpolant_next(TriangleInterpolant *it, int area)
+{
+    int value = it->value;
+    Uint32 frac = it->frac + it->step_frac;
+    int carry = (frac >= (Uint32)area);
+    it->frac = carry ? frac - (Uint32)area : frac;
+    it->value += it->step + carry;
+    return value;
+}
+
 /* Triangle rendering, using Barycentric coordinates (w0, w1, w2)
  *
  * The cross product isn't computed from scratch at each iteration,
- * but optimized using constant step increments
+ * but optimized using constant step increments.
  *
+ * Each row only visits the span of pixels inside the triangle, computed
+ * from the edge functions, so there is no inside test per pixel.
+ * Texture coordinates and colors used by the loop body are set up at the
+ * start of the span by TRIANGLE_SETUP_TEXCOORD / TRIANGLE_SETUP_COLOR,
+ * and must then be read once per pixel.
  */
 
-#define TRIANGLE_BEGIN_LOOP                                                        \
-    {                                                                              \
-        int x, y;                                                                  \
-        for (y = 0; y < dstrect.h; y++) {                                          \
-            /* y start */                                                          \
-            int w0 = w0_row;                                                       \
-            int w1 = w1_row;                                                       \
-            int w2 = w2_row;                                                       \
-            for (x = 0; x < dstrect.w; x++) {                                      \
-                /* In triangle */                                                  \
-                if (w0 + bias_w0 >= 0 && w1 + bias_w1 >= 0 && w2 + bias_w2 >= 0) { \
-                    Uint8 *dptr = (Uint8 *)dst_ptr + x * dstbpp;
+#define TRIANGLE_BEGIN_LOOP(setup)                                   \
+    {                                                                \
+        int x, y;                                                    \
+        for (y = 0; y < dstrect.h; y++) {                            \
+            int x0 = 0;                                              \
+            int x1 = dstrect.w - 1;                                  \
+            clip_span_to_edge(w0_row, d2d1_y, bias_w0, &x0, &x1);    \
+            clip_span_to_edge(w1_row, d0d2_y, bias_w1, &x0, &x1);    \
+            clip_span_to_edge(w2_row, d1d0_y, bias_w2, &x0, &x1);    \
+            if (x0 <= x1) {                                          \
+                Uint8 *dptr = (Uint8 *)dst_ptr + x0 * dstbpp;        \
+                setup                                                \
+                for (x = x0; x <= x1; x++, dptr += dstbpp) {
+
+#define TRIANGLE_SETUP_NONE
+
+/* Barycentric coordinates at the start of the span, in 64 bits */
+#define TRIANGLE_W0 ((Sint64)w0_row + (Sint64)x0 * d2d1_y)
+#define TRIANGLE_W1 ((Sint64)w1_row + (Sint64)x0 * d0d2_y)
+#define TRIANGLE_W2 ((Sint64)w2_row + (Sint64)x0 * d1d0_y)
 
 /* Use 64 bits precision to prevent overflow when interpolating color / texture with wide triangles */
-#define TRIANGLE_GET_TEXTCOORD                                                          \
-    int srcx = (int)(((Sint64)w0 * s2s0_x + (Sint64)w1 * s2s1_x + s2_x_area.x) / area); \
-    int srcy = (int)(((Sint64)w0 * s2s0_y + (Sint64)w1 * s2s1_y + s2_x_area.y) / area);
-
-#define TRIANGLE_GET_MAPPED_COLOR                                                      \
-    Uint8 r = (Uint8)(((Sint64)w0 * c0.r + (Sint64)w1 * c1.r + (Sint64)w2 * c2.r) / area); \
-    Uint8 g = (Uint8)(((Sint64)w0 * c0.g + (Sint64)w1 * c1.g + (Sint64)w2 * c2.g) / area); \
-    Uint8 b = (Uint8)(((Sint64)w0 * c0.b + (Sint64)w1 * c1.b + (Sint64)w2 * c2.b) / area); \
-    Uint8 a = (Uint8)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area); \
-    Uint32 color = SDL_MapRGBA(format, r, g, b, a);
-
-#define TRIANGLE_GET_COLOR                                                             \
-    int r = (int)(((Sint64)w0 * c0.r + (Sint64)w1 * c1.r + (Sint64)w2 * c2.r) / area); \
-    int g = (int)(((Sint64)w0 * c0.g + (Sint64)w1 * c1.g + (Sint64)w2 * c2.g) / area); \
-    int b = (int)(((Sint64)w0 * c0.b + (Sint64)w1 * c1.b + (Sint64)w2 * c2.b) / area); \
-    int a = (int)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area);
-
-#define TRIANGLE_END_LOOP \
-    }                     \
-    /* x += 1 */          \
-    w0 += d2d1_y;         \
-    w1 += d0d2_y;         \
-    w2 += d1d0_y;         \
-    }                     \
-    /* y += 1 */          \
-    w0_row += d1d2_x;     \
-    w1_row += d2d0_x;     \
-    w2_row += d0d1_x;     \
-    dst_ptr += dst_pitch; \
-    }                     \
+#define TRIANGLE_SETUP_TEXCOORD                                                                                               \
+    TriangleInterpolant srcx_it = interpolant_init(TRIANGLE_W0 * s2s0_x + TRIANGLE_W1 * s2s1_x + s2_x_area.x,                \
+                                                   (Sint64)d2d1_y * s2s0_x + (Sint64)d0d2_y * s2s1_x, area);                 \
+    TriangleInterpolant srcy_it = interpolant_init(TRIANGLE_W0 * s2s0_y + TRIANGLE_W1 * s2s1_y + s2_x_area.y,                \
+                                                   (Sint64)d2d1_y * s2s0_y + (Sint64)d0d2_y * s2s1_y, area);
+
+#define TRIANGLE_SETUP_COLOR_CHANNEL(c)                                                              \
+    interpolant_init(TRIANGLE_W0 * c0.c + TRIANGLE_W1 * c1.c + TRIANGLE_W2 * c2.c,                   \
+                     (Sint64)d2d1_y * c0.c + (Sint64)d0d2_y * c1.c + (Sint64)d1d0_y * c2.c, area)
+
+#define TRIANGLE_SETUP_COLOR                                        \
+    TriangleInterpolant r_it = TRIANGLE_SETUP_COLOR_CHANNEL(r);     \
+    TriangleInterpolant g_it = TRIANGLE_SETUP_COLOR_CHANNEL(g);     \
+    TriangleInterpolant b_it = TRIANGLE_SETUP_COLOR_CHANNEL(b);     \
+    TriangleInterpolant a_it = TRIANGLE_SETUP_COLOR_CHANNEL(a);
+
+#define TRIANGLE_GET_TEXTCOORD                         \
+    int srcx = interpolant_next(&srcx_it, area);      \
+    int srcy = interpolant_next(&srcy_it, area);
+
+/* Same as SDL_MapRGBA(), inlined for formats without palette */
+#define TRIANGLE_GET_MAPPED_COLOR                                                                                    \
+    Uint8 r = (Uint8)interpolant_next(&r_it, area);                                                                  \
+    Uint8 g = (Uint8)interpolant_next(&g_it, area);                                                                  \
+    Uint8 b = (Uint8)interpolant_next(&b_it, area);                                                                  \
+    Uint8 a = (Uint8)interpolant_next(&a_it, area);                                                                  \
+    Uint32 color = format->palette ? SDL_MapRGBA(format, r, g, b, a) : (r >> format->Rloss) << format->Rshift |     \
+                                                                          (g >> format->Gloss) << format->Gshift |     \
+                                                                          (b >> format->Bloss) << format->Bshift |     \
+                                                                          ((Uint32)(a >> format->Aloss) << format->Ashift & format->Amask);
+
+#define TRIANGLE_GET_COLOR                          \
+    int r = interpolant_next(&r_it, area);          \
+    int g = interpolant_next(&g_it, area);          \
+    int b = interpolant_next(&b_it, area);          \
+    int a = interpolant_next(&a_it, area);
+
+#define TRIANGLE_END_LOOP                                                              \
+    }                                                                                  \
+    }                                                                                  \
+    /* y += 1 */                                                                       \
+    w0_row += d1d2_x;                                                                  \
+    w1_row += d2d0_x;                                                                  \
+    w2_row += d0d1_x;                                                                  \
+    dst_ptr += dst_pitch;                                                              \
+    }                                                                                  \
+    }
+
+#ifdef SDL_SSE2_INTRINSICS
+/* The SSE2 spans draw four pixels at a time, with their interpolated values in
+ * 32 bit lanes and their components in 16 bit lanes. They give the same results
+ * as the scalar loops: the remainders are compared as signed 32 bit values, so
+ * the area is limited, and 'x / 255' is computed exactly for x < 65535.
+ * There is no wider or NEON version: other CPUs use the scalar loops.
+ */
+#define TRIANGLE_SSE2_MAX_AREA   (1 << 29)
+#define TRIANGLE_USE_SSE2(area) ((area) <= TRIANGLE_SSE2_MAX_AREA && SDL_HasSSE2())
+
+/* Draw the start of the span with SSE2, the loop does the remaining pixels */
+#define TRIANGLE_SPAN_SSE2(span)       \
+    if (use_sse2) {                    \
+        const int done = span;         \
+        x0 += done;                    \
+        dptr += done * dstbpp;         \
+    }
+
+/* Four consecutive pixels of a TriangleInterpolant */
+typedef struct
+{
+    __m128i value;
+    __m128i frac;
+    __m128i step;
+    __m128i step_frac;
+} TriangleInterpolant4;
+
+static void SDL_TARGETING("sse2") interpolant4_init(TriangleInterpolant4 *it4, const TriangleInterpolant *it, int area)
+{
+    TriangleInterpolant next = *it;
+    const Uint32 step_frac = 4 * it->step_frac;
+    int values[4];
+    int fracs[4];
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        fracs[i] = (int)next.frac;
+        values[i] = interpolant_next(&next, area);
     }
+    it4->value = _mm_setr_epi32(values[0], values[1], values[2], values[3]);
+    it4->frac = _mm_setr_epi32(fracs[0], fracs[1], fracs[2], fracs[3]);
+    it4->step = _mm_set1_epi32(4 * it->step + (int)(step_frac / (Uint32)area));
+    it4->step_frac = _mm_set1_epi32((int)(step_frac % (Uint32)area));
+}
+
+/* Return the values of the four pixels, and move to the next four */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") interpolant4_next(TriangleInterpolant4 *it4, __m128i area, __m128i area_minus_1)
+{
+    const __m128i value = it4->value;
+    __m128i carry;
+    it4->frac = _mm_add_epi32(it4->frac, it4->step_frac);
+    carry = _mm_cmpgt_epi32(it4->frac, area_minus_1);
+    it4->frac = _mm_sub_epi32(it4->frac, _mm_and_si128(carry, area));
+    it4->value = _mm_sub_epi32(_mm_add_epi32(value, it4->step), carry);
+    return value;
+}
+
+/* Move the scalar interpolant to the first pixel not drawn yet */
+static void SDL_TARGETING("sse2") interpolant4_store(const TriangleInterpolant4 *it4, TriangleInterpolant *it)
+{
+    it->value = _mm_cvtsi128_si32(it4->value);
+    it->frac = (Uint32)_mm_cvtsi128_si32(it4->frac);
+}
+
+static SDL_INLINE __m128i SDL_TARGETING("sse2") gather32SSE2(const Uint8 *src, int src_pitch, __m128i srcx, __m128i srcy)
+{
+    int x[4], y[4];
+    _mm_storeu_si128((__m128i *)x, srcx);
+    _mm_storeu_si128((__m128i *)y, srcy);
+    return _mm_setr_epi32(*(const int *)(src + y[0] * src_pitch + x[0] * 4),
+                          *(const int *)(src + y[1] * src_pitch + x[1] * 4),
+                          *(const int *)(src + y[2] * src_pitch + x[2] * 4),
+                          *(const int *)(src + y[3] * src_pitch + x[3] * 4));
+}
+
+/* x / 255 in each 16 bit lane, for x < 65535 */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") div255SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+/* Texture copy of SDL_SW_BlitTriangle(), for 32-bit formats */
+static int SDL_TARGETING("sse2") CopySpan32SSE2(Uint8 *dptr, int count, const Uint8 *src, int src_pitch,
+                                                 TriangleInterpolant *srcx, TriangleInterpolant *srcy, int area)
+{
+    const __m128i area4 = _mm_set1_epi32(area);
+    const __m128i area_minus_1 = _mm_set1_epi32(area - 1);
+    TriangleInterpolant4 x4, y4;
+    int done;
+
+    if (count < 4) {
+        return 0;
+    }
+    interpolant4_init(&x4, srcx, area);
+    interpolant4_init(&y4, srcy, area);
+    for (done = 0; done + 4 <= count; done += 4, dptr += 16) {
+        const __m128i x = interpolant4_next(&x4, area4, area_minus_1);
+        const __m128i y = interpolant4_next(&y4, area4, area_minus_1);
+        _mm_storeu_si128((__m128i *)dptr, gather32SSE2(src, src_pitch, x, y));
+    }
+    interpolant4_store(&x4, srcx);
+    interpolant4_store(&y4, srcy);
+    return done;
+}
+
+/* Colors of SDL_SW_FillTriangle(), for 8888 formats */
+static int SDL_TARGETING("sse2") FillSpan8888SSE2(Uint8 *dptr, int count, const SDL_PixelFormat *format,
+                                                   TriangleInterpolant *r, TriangleInterpolant *g,
+                                                   TriangleInterpolant *b, TriangleInterpolant *a, int area)
+{
+    const __m128i area4 = _mm_set1_epi32(area);
+    const __m128i area_minus_1 = _mm_set1_epi32(area - 1);
+    const __m128i rshift = _mm_cvtsi32_si128(format->Rshift);
+    const __m128i gshift = _mm_cvtsi32_si128(format->Gshift);
+    const __m128i bshift = _mm_cvtsi32_si128(format->Bshift);
+    const __m128i ashift = _mm_cvtsi32_si128(format->Ashift);
+    const __m128i amask = _mm_set1_epi32((int)format->Amask);
+    TriangleInterpolant4 r4, g4, b4, a4;
+    int done;
+
+    if (count < 4) {
+        return 0;
+    }
+    interpolant4_init(&r4, r, area);
+    interpolant4_init(&g4, g, area);
+    interpolant4_init(&b4, b, area);
+    interpolant4_init(&a4, a, area);
+    for (done = 0; done + 4 <= count; done += 4, dptr += 16) {
+        const __m128i rg = _mm_or_si128(_mm_sll_epi32(interpolant4_next(&r4, area4, area_minus_1), rshift),
+                                        _mm_sll_epi32(interpolant4_next(&g4, area4, area_minus_1), gshift));
+        const __m128i ba = _mm_or_si128(_mm_sll_epi32(interpolant4_next(&b4, area4, area_minus_1), bshift),
+                                        _mm_and_si128(_mm_sll_epi32(interpolant4_next(&a4, area4, area_minus_1), ashift), amask));
+        _mm_storeu_si128((__m128i *)dptr, _mm_or_si128(rg, ba));
+    }
+    interpolant4_store(&r4, r);
+    interpolant4_store(&g4, g);
+    interpolant4_store(&b4, b);
+    interpolant4_store(&a4, a);
+    return done;
+}
+
+/* What BlitSpan8888SSE2() needs from SDL_BlitTriangle_8888(). The source and
+ * destination have their color components in the same bytes, and the alpha
+ * component (or the unused byte) in the first or the last byte of the pixel.
+ */
+typedef struct
+{
+    const Uint8 *src;
+    int src_pitch;
+    int blend;           /* SDL_COPY_BLEND, SDL_COPY_ADD, SDL_COPY_MOD or 0 */
+    int alpha_byte;      /* 0 or 3 */
+    Uint32 src_opaque;   /* alpha bits set for sources without alpha */
+    Uint32 dst_mask;     /* bits written to the destination */
+    int is_uniform;
+    Uint32 modulate;     /* color of uniform triangles */
+    int rshift, gshift, bshift, ashift;
+} TriangleBlit8888;
+
+/* Two pixels of SDL_BlitTriangle_8888(), one component per 16 bit lane */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") blend8888SSE2(const TriangleBlit8888 *blit, __m128i src, __m128i mod, __m128i dst,
+                                                               __m128i color_mask)
+{
+    __m128i alpha;
+
+    src = div255SSE2(_mm_mullo_epi16(src, mod));
+    if (blit->alpha_byte == 3) {
+        alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    } else {
+        alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(0, 0, 0, 0));
+    }
+
+    switch (blit->blend) {
+    case SDL_COPY_BLEND:
+        /* Multiply the colors by alpha, alpha by 255 */
+        src = div255SSE2(_mm_mullo_epi16(src, _mm_or_si128(_mm_and_si128(alpha, color_mask), _mm_andnot_si128(color_mask, _mm_set1_epi16(255)))));
+        return _mm_add_epi16(src, div255SSE2(_mm_mullo_epi16(_mm_sub_epi16(_mm_set1_epi16(255), alpha), dst)));
+    case SDL_COPY_ADD:
+        src = div255SSE2(_mm_mullo_epi16(src, _mm_or_si128(_mm_and_si128(alpha, color_mask), _mm_andnot_si128(color_mask, _mm_set1_epi16(255)))));
+        /* Saturated when packed */
+        return _mm_add_epi16(_mm_and_si128(src, color_mask), dst);
+    case SDL_COPY_MOD:
+        return _mm_or_si128(_mm_and_si128(div255SSE2(_mm_mullo_epi16(src, dst)), color_mask), _mm_andnot_si128(color_mask, dst));
+    default:
+        return src;
+    }
+}
+
+static int SDL_TARGETING("sse2") BlitSpan8888SSE2(const TriangleBlit8888 *blit, Uint8 *dptr, int count,
+                                                   TriangleInterpolant *srcx, TriangleInterpolant *srcy,
+                                                   TriangleInterpolant *r, TriangleInterpolant *g,
+                                                   TriangleInterpolant *b, TriangleInterpolant *a, int area)
+{
+    const __m128i area4 = _mm_set1_epi32(area);
+    const __m128i area_minus_1 = _mm_set1_epi32(area - 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i src_opaque = _mm_set1_epi32((int)blit->src_opaque);
+    const __m128i dst_mask = _mm_set1_epi32((int)blit->dst_mask);
+    const __m128i color_mask = _mm_unpacklo_epi8(_mm_set1_epi32((int)~(0xFFu << (blit->alpha_byte * 8))), zero);
+    const __m128i rshift = _mm_cvtsi32_si128(blit->rshift);
+    const __m128i gshift = _mm_cvtsi32_si128(blit->gshift);
+    const __m128i bshift = _mm_cvtsi32_si128(blit->bshift);
+    const __m128i ashift = _mm_cvtsi32_si128(blit->ashift);
+    __m128i mod = _mm_set1_epi32((int)blit->modulate);
+    TriangleInterpolant4 x4, y4, r4, g4, b4, a4;
+    int done;
+
+    if (count < 4) {
+        return 0;
+    }
+    interpolant4_init(&x4, srcx, area);
+    interpolant4_init(&y4, srcy, area);
+    interpolant4_init(&r4, r, area);
+    interpolant4_init(&g4, g, area);
+    interpolant4_init(&b4, b, area);
+    interpolant4_init(&a4, a, area);
+    for (done = 0; done + 4 <= count; done += 4, dptr += 16) {
+        const __m128i x = interpolant4_next(&x4, area4, area_minus_1);
+        const __m128i y = interpolant4_next(&y4, area4, area_minus_1);
+        const __m128i src = _mm_or_si128(gather32SSE2(blit->src, blit->src_pitch, x, y), src_opaque);
+        const __m128i dst = blit->blend ? _mm_loadu_si128((const __m128i *)dptr) : zero;
+        __m128i lo, hi;
+
+        if (!blit->is_uniform) {
+            mod = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(interpolant4_next(&r4, area4, area_minus_1), rshift),
+                                            _mm_sll_epi32(interpolant4_next(&g4, area4, area_minus_1), gshift)),
+                               _mm_or_si128(_mm_sll_epi32(interpolant4_next(&b4, area4, area_minus_1), bshift),
+                                            _mm_sll_epi32(interpolant4_next(&a4, area4, area_minus_1), ashift)));
+        }
+        lo = blend8888SSE2(blit, _mm_unpacklo_epi8(src, zero), _mm_unpacklo_epi8(mod, zero), _mm_unpacklo_epi8(dst, zero), color_mask);
+        hi = blend8888SSE2(blit, _mm_unpackhi_epi8(src, zero), _mm_unpackhi_epi8(mod, zero), _mm_unpackhi_epi8(dst, zero), color_mask);
+        _mm_storeu_si128((__m128i *)dptr, _mm_and_si128(_mm_packus_epi16(lo, hi), dst_mask));
+    }
+    interpolant4_store(&x4, srcx);
+    interpolant4_store(&y4, srcy);
+    if (!blit->is_uniform) {
+        interpolant4_store(&r4, r);
+        interpolant4_store(&g4, g);
+        interpolant4_store(&b4, b);
+        interpolant4_store(&a4, a);
+    }
+    return done;
+}
+#else
+#define TRIANGLE_SPAN_SSE2(span)
+#endif /* SDL_SSE2_INTRINSICS */
 
 int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Point *d2, SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2)
 {
@@ -219,6 +571,10 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
 
     SDL_Surface *tmp = NULL;
 
+#ifdef SDL_SSE2_INTRINSICS
+    SDL_bool use_sse2;
+#endif
+
     if (dst == NULL) {
         return -1;
     }
@@ -270,7 +626,7 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
         }
 
         /* Use an intermediate surface */
-        tmp = SDL_CreateSurface(dstrect.w, dstrect.h, format);
+        tmp = SDL_CreatePooledSurface(dstrect.w, dstrect.h, format);
         if (tmp == NULL) {
             ret = -1;
             goto end;
@@ -279,6 +635,8 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
         if (blend == SDL_BLENDMODE_MOD) {
             Uint32 c = SDL_MapRGBA(tmp->format, 255, 255, 255, 255);
             SDL_FillSurfaceRect(tmp, NULL, c);
+        } else {
+            SDL_FillSurfaceRect(tmp, NULL, 0);
         }
 
         SDL_SetSurfaceBlendMode(tmp, blend);
@@ -349,13 +707,13 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
         }
 
         if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_NONE)
             {
                 *(Uint32 *)dptr = color;
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 3) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_NONE)
             {
                 Uint8 *s = (Uint8 *)&color;
                 dptr[0] = s[0];
@@ -364,13 +722,13 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 2) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_NONE)
             {
                 *(Uint16 *)dptr = (Uint16)color;
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 1) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_NONE)
             {
                 *dptr = (Uint8)color;
             }
@@ -381,15 +739,19 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
         if (tmp) {
             format = tmp->format;
         }
+#ifdef SDL_SSE2_INTRINSICS
+        use_sse2 = TRIANGLE_USE_SSE2(area) && FORMAT_IS_8888(format);
+#endif
         if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_COLOR
+                                TRIANGLE_SPAN_SSE2(FillSpan8888SSE2(dptr, x1 - x0 + 1, format, &r_it, &g_it, &b_it, &a_it, area)))
             {
                 TRIANGLE_GET_MAPPED_COLOR
                 *(Uint32 *)dptr = color;
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 3) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_COLOR)
             {
                 TRIANGLE_GET_MAPPED_COLOR
                 Uint8 *s = (Uint8 *)&color;
@@ -399,14 +761,14 @@ int SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poin
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 2) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_COLOR)
             {
                 TRIANGLE_GET_MAPPED_COLOR
                 *(Uint16 *)dptr = (Uint16)color;
             }
             TRIANGLE_END_LOOP
         } else if (dstbpp == 1) {
-            TRIANGLE_BEGIN_LOOP
+            TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_COLOR)
             {
                 TRIANGLE_GET_MAPPED_COLOR
                 *dptr = (Uint8)color;
@@ -464,6 +826,10 @@ int SDL_SW_BlitTriangle(
 
     int has_modulation;
 
+#ifdef SDL_SSE2_INTRINSICS
+    SDL_bool use_sse2;
+#endif
+
     if (src == NULL || dst == NULL) {
         return -1;
     }
@@ -661,16 +1027,27 @@ int SDL_SW_BlitTriangle(
         tmp_info.dst = dst_ptr;
         tmp_info.dst_pitch = dst_pitch;
 
-        SDL_BlitTriangle_Slow(&tmp_info, s2_x_area, dstrect, area, bias_w0, bias_w1, bias_w2,
-                              d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x,
-                              s2s0_x, s2s1_x, s2s0_y, s2s1_y, w0_row, w1_row, w2_row,
-                              c0, c1, c2, is_uniform);
+        if (!(tmp_info.flags & SDL_COPY_COLORKEY) && FORMAT_IS_8888(src->format) && FORMAT_IS_8888(dst->format)) {
+            SDL_BlitTriangle_8888(&tmp_info, s2_x_area, dstrect, area, bias_w0, bias_w1, bias_w2,
+                                  d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x,
+                                  s2s0_x, s2s1_x, s2s0_y, s2s1_y, w0_row, w1_row, w2_row,
+                                  c0, c1, c2, is_uniform);
+        } else {
+            SDL_BlitTriangle_Slow(&tmp_info, s2_x_area, dstrect, area, bias_w0, bias_w1, bias_w2,
+                                  d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x,
+                                  s2s0_x, s2s1_x, s2s0_y, s2s1_y, w0_row, w1_row, w2_row,
+                                  c0, c1, c2, is_uniform);
+        }
 
         goto end;
     }
 
+#ifdef SDL_SSE2_INTRINSICS
+    use_sse2 = TRIANGLE_USE_SSE2(area);
+#endif
     if (dstbpp == 4) {
-        TRIANGLE_BEGIN_LOOP
+        TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD
+                            TRIANGLE_SPAN_SSE2(CopySpan32SSE2(dptr, x1 - x0 + 1, (const Uint8 *)src_ptr, src_pitch, &srcx_it, &srcy_it, area)))
         {
             TRIANGLE_GET_TEXTCOORD
             Uint32 *sptr = (Uint32 *)((Uint8 *)src_ptr + srcy * src_pitch);
@@ -678,7 +1055,7 @@ int SDL_SW_BlitTriangle(
         }
         TRIANGLE_END_LOOP
     } else if (dstbpp == 3) {
-        TRIANGLE_BEGIN_LOOP
+        TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD)
         {
             TRIANGLE_GET_TEXTCOORD
             Uint8 *sptr = (Uint8 *)src_ptr + srcy * src_pitch;
@@ -688,7 +1065,7 @@ int SDL_SW_BlitTriangle(
         }
         TRIANGLE_END_LOOP
     } else if (dstbpp == 2) {
-        TRIANGLE_BEGIN_LOOP
+        TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD)
         {
             TRIANGLE_GET_TEXTCOORD
             Uint16 *sptr = (Uint16 *)((Uint8 *)src_ptr + srcy * src_pitch);
@@ -696,7 +1073,7 @@ int SDL_SW_BlitTriangle(
         }
         TRIANGLE_END_LOOP
     } else if (dstbpp == 1) {
-        TRIANGLE_BEGIN_LOOP
+        TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD)
         {
             TRIANGLE_GET_TEXTCOORD
             Uint8 *sptr = (Uint8 *)src_ptr + srcy * src_pitch;
@@ -762,12 +1139,19 @@ static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
     srcfmt_val = detect_format(src_fmt);
     dstfmt_val = detect_format(dst_fmt);
 
-    TRIANGLE_BEGIN_LOOP
+    TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD TRIANGLE_SETUP_COLOR)
     {
         Uint8 *src;
         Uint8 *dst = dptr;
         TRIANGLE_GET_TEXTCOORD
         src = (info->src + (srcy * info->src_pitch) + (srcx * srcbpp));
+        if (!is_uniform) {
+            TRIANGLE_GET_COLOR
+            modulateR = r;
+            modulateG = g;
+            modulateB = b;
+            modulateA = a;
+        }
         if (FORMAT_HAS_ALPHA(srcfmt_val)) {
             DISEMBLE_RGBA(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB, srcA);
         } else if (FORMAT_HAS_NO_ALPHA(srcfmt_val)) {
@@ -799,14 +1183,6 @@ static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
             RGBA_FROM_ARGB2101010(dstpixel, dstR, dstG, dstB, dstA);
         }
 
-        if (!is_uniform) {
-            TRIANGLE_GET_COLOR
-            modulateR = r;
-            modulateG = g;
-            modulateB = b;
-            modulateA = a;
-        }
-
         if (flags & SDL_COPY_MODULATE_COLOR) {
             srcR = (srcR * modulateR) / 255;
             srcG = (srcG * modulateG) / 255;
@@ -884,4 +1260,134 @@ static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
     TRIANGLE_END_LOOP
 }
 
+/* Same as SDL_BlitTriangle_Slow(), specialized for 32-bit formats with 8 bits per channel, without colorkey */
+static void SDL_BlitTriangle_8888(SDL_BlitInfo *info,
+                                  SDL_Point s2_x_area, SDL_Rect dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
+                                  int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x,
+                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y, int w0_row, int w1_row, int w2_row,
+                                  SDL_Color c0, SDL_Color c1, SDL_Color c2, int is_uniform)
+{
+    const int flags = info->flags;
+    Uint32 modulateR = info->r;
+    Uint32 modulateG = info->g;
+    Uint32 modulateB = info->b;
+    Uint32 modulateA = info->a;
+    const SDL_PixelFormat *src_fmt = info->src_fmt;
+    const SDL_PixelFormat *dst_fmt = info->dst_fmt;
+    const int srcRshift = src_fmt->Rshift;
+    const int srcGshift = src_fmt->Gshift;
+    const int srcBshift = src_fmt->Bshift;
+    const int srcAshift = src_fmt->Ashift;
+    const int dstRshift = dst_fmt->Rshift;
+    const int dstGshift = dst_fmt->Gshift;
+    const int dstBshift = dst_fmt->Bshift;
+    const int dstAshift = dst_fmt->Ashift;
+    const Uint32 src_has_alpha = src_fmt->Amask;
+    const Uint32 dst_has_alpha = dst_fmt->Amask;
+
+    const int dstbpp = 4;
+    Uint8 *dst_ptr = info->dst;
+    int dst_pitch = info->dst_pitch;
+
+#ifdef SDL_SSE2_INTRINSICS
+    const int blend = flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL);
+    const int alpha_byte = 6 - (dstRshift + dstGshift + dstBshift) / 8;
+    SDL_bool use_sse2 = TRIANGLE_USE_SSE2(area) && blend != SDL_COPY_MUL &&
+                        srcRshift == dstRshift && srcGshift == dstGshift && srcBshift == dstBshift &&
+                        (alpha_byte == 0 || alpha_byte == 3);
+    TriangleBlit8888 blit;
+
+    blit.src = info->src;
+    blit.src_pitch = info->src_pitch;
+    blit.blend = blend;
+    blit.alpha_byte = alpha_byte;
+    blit.src_opaque = src_has_alpha ? 0 : (0xFFu << (alpha_byte * 8));
+    blit.dst_mask = dst_has_alpha ? 0xFFFFFFFF : ~(0xFFu << (alpha_byte * 8));
+    blit.is_uniform = is_uniform;
+    blit.rshift = dstRshift;
+    blit.gshift = dstGshift;
+    blit.bshift = dstBshift;
+    blit.ashift = alpha_byte * 8;
+    blit.modulate = (modulateR << blit.rshift) | (modulateG << blit.gshift) | (modulateB << blit.bshift) | (modulateA << blit.ashift);
+#endif
+
+    TRIANGLE_BEGIN_LOOP(TRIANGLE_SETUP_TEXCOORD TRIANGLE_SETUP_COLOR
+                        TRIANGLE_SPAN_SSE2(BlitSpan8888SSE2(&blit, dptr, x1 - x0 + 1, &srcx_it, &srcy_it, &r_it, &g_it, &b_it, &a_it, area)))
+    {
+        Uint32 srcpixel, dstpixel;
+        Uint32 srcR, srcG, srcB, srcA;
+        Uint32 dstR, dstG, dstB, dstA;
+        TRIANGLE_GET_TEXTCOORD
+        srcpixel = ((const Uint32 *)(info->src + srcy * info->src_pitch))[srcx];
+        srcR = (Uint8)(srcpixel >> srcRshift);
+        srcG = (Uint8)(srcpixel >> srcGshift);
+        srcB = (Uint8)(srcpixel >> srcBshift);
+        srcA = src_has_alpha ? (Uint8)(srcpixel >> srcAshift) : 0xFF;
+        dstpixel = *(Uint32 *)dptr;
+        dstR = (Uint8)(dstpixel >> dstRshift);
+        dstG = (Uint8)(dstpixel >> dstGshift);
+        dstB = (Uint8)(dstpixel >> dstBshift);
+        dstA = dst_has_alpha ? (Uint8)(dstpixel >> dstAshift) : 0xFF;
+
+        if (!is_uniform) {
+            TRIANGLE_GET_COLOR
+            modulateR = r;
+            modulateG = g;
+            modulateB = b;
+            modulateA = a;
+        }
+
+        if (flags & SDL_COPY_MODULATE_COLOR) {
+            srcR = (srcR * modulateR) / 255;
+            srcG = (srcG * modulateG) / 255;
+            srcB = (srcB * modulateB) / 255;
+        }
+        if (flags & SDL_COPY_MODULATE_ALPHA) {
+            srcA = (srcA * modulateA) / 255;
+        }
+        if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
+            if (srcA < 255) {
+                srcR = (srcR * srcA) / 255;
+                srcG = (srcG * srcA) / 255;
+                srcB = (srcB * srcA) / 255;
+            }
+        }
+        switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+        case 0:
+            dstR = srcR;
+            dstG = srcG;
+            dstB = srcB;
+            dstA = srcA;
+            break;
+        case SDL_COPY_BLEND:
+            dstR = srcR + ((255 - srcA) * dstR) / 255;
+            dstG = srcG + ((255 - srcA) * dstG) / 255;
+            dstB = srcB + ((255 - srcA) * dstB) / 255;
+            dstA = srcA + ((255 - srcA) * dstA) / 255;
+            break;
+        case SDL_COPY_ADD:
+            dstR = SDL_min(srcR + dstR, 255);
+            dstG = SDL_min(srcG + dstG, 255);
+            dstB = SDL_min(srcB + dstB, 255);
+            break;
+        case SDL_COPY_MOD:
+            dstR = (srcR * dstR) / 255;
+            dstG = (srcG * dstG) / 255;
+            dstB = (srcB * dstB) / 255;
+            break;
+        case SDL_COPY_MUL:
+            dstR = SDL_min(((srcR * dstR) + (dstR * (255 - srcA))) / 255, 255);
+            dstG = SDL_min(((srcG * dstG) + (dstG * (255 - srcA))) / 255, 255);
+            dstB = SDL_min(((srcB * dstB) + (dstB * (255 - srcA))) / 255, 255);
+            break;
+        }
+        if (dst_has_alpha) {
+            *(Uint32 *)dptr = (dstR << dstRshift) | (dstG << dstGshift) | (dstB << dstBshift) | (dstA << dstAshift);
+        } else {
+            *(Uint32 *)dptr = (dstR << dstRshift) | (dstG << dstGshift) | (dstB << dstBshift);
+        }
+    }
+    TRIANGLE_END_LOOP
+}
+
 #endif /* SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED */
@@ -558,24 +558,6 @@ done:
  * These use the same techniques as the per-surface blitting macros
  */
 
-/*
- * For 32bpp pixels, we have made sure the alpha is stored in the top
- * 8 bits, so proceed as usual
- */
-#define BLIT_TRANSL_888(src, dst)                        \
-    do {                                                 \
-        Uint32 s = src;                                  \
-        Uint32 d = dst;                                  \
-        unsigned alpha = s >> 24;                        \
-        Uint32 s1 = s & 0xff00ff;                        \
-        Uint32 d1 = d & 0xff00ff;                        \
-        d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff; \
-        s &= 0xff00;                                     \
-        d &= 0xff00;                                     \
-        d = (d + ((s - d) * alpha >> 8)) & 0xff00;       \
-        dst = d1 | d | 0xff000000;                       \
-    } while (0)
-
 /*
  * For 16bpp pixels, we have stored the 5 most significant alpha bits in
  * bits 5-10. As before, we can process all 3 RGB components at the same time.
@@ -624,17 +606,188 @@ typedef struct
     Uint8 Ashift;
 } RLEDestFormat;
 
+/*
+ * Run blitters for 32bpp destinations.
+ *
+ * The encoded pixels have the destination RGB layout with alpha in the top
+ * 8 bits, opaque pixels included, so opaque and translucent runs can share
+ * the same code. Each component is blended as
+ *   d + floor((s - d) * alpha / 256) = (s * alpha + d * (256 - alpha)) >> 8
+ * which fits in 16 bits, with an alpha of 255 treated as 256 so that
+ * opaque pixels are kept exactly.
+ *
+ * With color or alpha modulation, each component of the encoded pixel is
+ * first scaled as (c * m) / 255 like the generic blitter does, using the
+ * factor at the same byte position (alpha being byte 3), and the opaque
+ * runs are blended like the translucent ones.
+ */
+typedef void (*RLERunFunc32)(Uint32 *dst, const Uint32 *src, unsigned n, const Uint16 *mod);
+
+typedef struct
+{
+    RLERunFunc32 opaque;
+    RLERunFunc32 transl;
+    const Uint16 *mod; /* NULL if there is no modulation */
+    Uint16 factors[4];
+} RLEBlitRuns32;
+
+static void RLE_CopyRun32_std(Uint32 *dst, const Uint32 *src, unsigned n, const Uint16 *mod)
+{
+    PIXEL_COPY(dst, src, n, 4);
+}
+
+static void RLE_BlendRun32_std(Uint32 *dst, const Uint32 *src, unsigned n, const Uint16 *mod)
+{
+    unsigned i;
+
+    for (i = 0; i < n; i++) {
+        Uint32 s = src[i];
+        Uint32 d = dst[i];
+        unsigned c0 = s & 0xff;
+        unsigned c1 = (s >> 8) & 0xff;
+        unsigned c2 = (s >> 16) & 0xff;
+        unsigned alpha = s >> 24;
+        if (mod) {
+            c0 = (c0 * mod[0]) / 255;
+            c1 = (c1 * mod[1]) / 255;
+            c2 = (c2 * mod[2]) / 255;
+            alpha = (alpha * mod[3]) / 255;
+        }
+        if (alpha == 255) {
+            alpha = 256;
+        }
+        c0 = (c0 * alpha + (d & 0xff) * (256 - alpha)) >> 8;
+        c1 = (c1 * alpha + ((d >> 8) & 0xff) * (256 - alpha)) >> 8;
+        c2 = (c2 * alpha + ((d >> 16) & 0xff) * (256 - alpha)) >> 8;
+        dst[i] = c0 | (c1 << 8) | (c2 << 16) | 0xff000000;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+
+static void SDL_TARGETING("sse2") RLE_CopyRun32_SSE2(Uint32 *dst, const Uint32 *src, unsigned n, const Uint16 *mod)
+{
+    for (; n >= 4; n -= 4) {
+        _mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+        dst += 4;
+        src += 4;
+    }
+    while (n--) {
+        *dst++ = *src++;
+    }
+}
+
+static void SDL_TARGETING("sse2") RLE_BlendRun32_SSE2(Uint32 *dst, const Uint32 *src, unsigned n, const Uint16 *mod)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i v255 = _mm_set1_epi16(255);
+    const __m128i v256 = _mm_set1_epi16(256);
+    const __m128i amask = _mm_slli_epi32(_mm_cmpeq_epi32(zero, zero), 24);
+    __m128i factors = v255;
+
+    if (mod) {
+        factors = _mm_set_epi16(mod[3], mod[2], mod[1], mod[0], mod[3], mod[2], mod[1], mod[0]);
+    }
+    for (; n >= 4; n -= 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *)src);
+        const __m128i d = _mm_loadu_si128((const __m128i *)dst);
+        __m128i slo = _mm_unpacklo_epi8(s, zero);
+        __m128i shi = _mm_unpackhi_epi8(s, zero);
+        __m128i alo, ahi;
+
+        if (mod) {
+            /* (x / 255) is exactly (x + 1 + (x >> 8)) >> 8 for x <= 255 * 255 */
+            slo = _mm_mullo_epi16(slo, factors);
+            shi = _mm_mullo_epi16(shi, factors);
+            slo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(slo, one), _mm_srli_epi16(slo, 8)), 8);
+            shi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(shi, one), _mm_srli_epi16(shi, 8)), 8);
+        }
+
+        /* broadcast the alpha of each pixel, mapping 255 to 256 */
+        alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alo = _mm_sub_epi16(alo, _mm_cmpeq_epi16(alo, v255));
+        ahi = _mm_sub_epi16(ahi, _mm_cmpeq_epi16(ahi, v255));
+
+        slo = _mm_add_epi16(_mm_mullo_epi16(slo, alo), _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(v256, alo)));
+        shi = _mm_add_epi16(_mm_mullo_epi16(shi, ahi), _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(v256, ahi)));
+        slo = _mm_srli_epi16(slo, 8);
+        shi = _mm_srli_epi16(shi, 8);
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_packus_epi16(slo, shi), amask));
+        dst += 4;
+        src += 4;
+    }
+    if (n) {
+        RLE_BlendRun32_std(dst, src, n, mod);
+    }
+}
+
+#endif /* SDL_SSE2_INTRINSICS */
+
+/* pick the run blitters for a blit to a 32bpp destination */
+static void RLESetupBlitRuns32(SDL_Surface *surf_src, RLEBlitRuns32 *runs)
+{
+    const RLEDestFormat *df = (const RLEDestFormat *)surf_src->map->data;
+    const SDL_BlitInfo *info = &surf_src->map->info;
+    RLERunFunc32 copy_run = RLE_CopyRun32_std;
+    RLERunFunc32 blend_run = RLE_BlendRun32_std;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        copy_run = RLE_CopyRun32_SSE2;
+        blend_run = RLE_BlendRun32_SSE2;
+    }
+#endif
+
+    if (info->flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA)) {
+        if (info->flags & SDL_COPY_MODULATE_COLOR) {
+            runs->factors[df->Rshift / 8] = info->r;
+            runs->factors[df->Gshift / 8] = info->g;
+            runs->factors[df->Bshift / 8] = info->b;
+        } else {
+            runs->factors[0] = runs->factors[1] = runs->factors[2] = 255;
+        }
+        runs->factors[3] = (info->flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+        runs->mod = runs->factors;
+        runs->opaque = blend_run;
+    } else {
+        runs->mod = NULL;
+        runs->opaque = copy_run;
+    }
+    runs->transl = blend_run;
+}
+
+/* the run blitters used by the 16bpp and 32bpp alpha blit macros */
+#define TRANSL_RUN_16(dst, src, n, do_blend)           \
+    do {                                               \
+        Uint16 *tdst = (Uint16 *)(dst);                \
+        const Uint32 *tsrc = (const Uint32 *)(src);    \
+        unsigned tlen = (n);                           \
+        unsigned t;                                    \
+        for (t = 0; t < tlen; t++) {                   \
+            do_blend(tsrc[t], tdst[t]);                \
+        }                                              \
+    } while (0)
+
+#define OPAQUE_RUN_16(dst, src, n) PIXEL_COPY(dst, src, n, 2)
+#define TRANSL_RUN_565(dst, src, n) TRANSL_RUN_16(dst, src, n, BLIT_TRANSL_565)
+#define TRANSL_RUN_555(dst, src, n) TRANSL_RUN_16(dst, src, n, BLIT_TRANSL_555)
+#define OPAQUE_RUN_32(dst, src, n) runs->opaque((Uint32 *)(dst), (const Uint32 *)(src), n, runs->mod)
+#define TRANSL_RUN_32(dst, src, n) runs->transl((Uint32 *)(dst), (const Uint32 *)(src), n, runs->mod)
+
 /* blit a pixel-alpha RLE surface clipped at the right and/or left edges */
 static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
-                             Uint8 *dstbuf, SDL_Rect *srcrect)
+                             Uint8 *dstbuf, SDL_Rect *srcrect,
+                             const RLEBlitRuns32 *runs)
 {
     SDL_PixelFormat *df = surf_dst->format;
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the opaque count type, and do_opaque and do_transl
+     * the macros to blit a run of opaque and translucent pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)                          \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, do_opaque, do_transl)              \
     do {                                                                  \
         int linecount = srcrect->h;                                       \
         int left = srcrect->x;                                            \
@@ -659,9 +812,9 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
                     if (crun > right - cofs)                              \
                         crun = right - cofs;                              \
                     if (crun > 0)                                         \
-                        PIXEL_COPY(dstbuf + cofs * sizeof(Ptype),         \
-                                   srcbuf + (cofs - ofs) * sizeof(Ptype), \
-                                   (unsigned)crun, sizeof(Ptype));        \
+                        do_opaque(dstbuf + cofs * sizeof(Ptype),          \
+                                  srcbuf + (cofs - ofs) * sizeof(Ptype),  \
+                                  (unsigned)crun);                        \
                     srcbuf += run * sizeof(Ptype);                        \
                     ofs += run;                                           \
                 } else if (!ofs)                                          \
@@ -687,13 +840,10 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
                     }                                                     \
                     if (crun > right - cofs)                              \
                         crun = right - cofs;                              \
-                    if (crun > 0) {                                       \
-                        Ptype *dst = (Ptype *)dstbuf + cofs;              \
-                        Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-                        int i;                                            \
-                        for (i = 0; i < crun; i++)                        \
-                            do_blend(src[i], dst[i]);                     \
-                    }                                                     \
+                    if (crun > 0)                                         \
+                        do_transl((Ptype *)dstbuf + cofs,                 \
+                                  (Uint32 *)srcbuf + (cofs - ofs),        \
+                                  (unsigned)crun);                        \
                     srcbuf += run * 4;                                    \
                     ofs += run;                                           \
                 }                                                         \
@@ -705,13 +855,13 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, OPAQUE_RUN_16, TRANSL_RUN_565);
         } else {
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, OPAQUE_RUN_16, TRANSL_RUN_555);
         }
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, OPAQUE_RUN_32, TRANSL_RUN_32);
         break;
     }
 }
@@ -724,6 +874,8 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
     int w = surf_src->w;
     Uint8 *srcbuf, *dstbuf;
     SDL_PixelFormat *df = surf_dst->format;
+    RLEBlitRuns32 runs32;
+    const RLEBlitRuns32 *runs = &runs32;
 
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
@@ -732,6 +884,10 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
         }
     }
 
+    if (df->BytesPerPixel == 4) {
+        RLESetupBlitRuns32(surf_src, &runs32);
+    }
+
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *)surf_dst->pixels + y * surf_dst->pitch + x * df->BytesPerPixel;
@@ -797,15 +953,15 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != surf_src->w) {
-        RLEAlphaClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect);
+        RLEAlphaClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect, runs);
     } else {
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the opaque count type, and do_opaque and do_transl
+         * the macros to blit a run of opaque and translucent pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                         \
+#define RLEALPHABLIT(Ptype, Ctype, do_opaque, do_transl)             \
     do {                                                             \
         int linecount = srcrect->h;                                  \
         do {                                                         \
@@ -817,8 +973,8 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
                 run = ((Ctype *)srcbuf)[1];                          \
                 srcbuf += 2 * sizeof(Ctype);                         \
                 if (run) {                                           \
-                    PIXEL_COPY(dstbuf + ofs * sizeof(Ptype), srcbuf, \
-                               run, sizeof(Ptype));                  \
+                    do_opaque(dstbuf + ofs * sizeof(Ptype), srcbuf,  \
+                              run);                                  \
                     srcbuf += run * sizeof(Ptype);                   \
                     ofs += run;                                      \
                 } else if (!ofs)                                     \
@@ -835,14 +991,8 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
                 run = ((Uint16 *)srcbuf)[1];                         \
                 srcbuf += 4;                                         \
                 if (run) {                                           \
-                    Ptype *dst = (Ptype *)dstbuf + ofs;              \
-                    unsigned i;                                      \
-                    for (i = 0; i < run; i++) {                      \
-                        Uint32 src = *(Uint32 *)srcbuf;              \
-                        do_blend(src, *dst);                         \
-                        srcbuf += 4;                                 \
-                        dst++;                                       \
-                    }                                                \
+                    do_transl((Ptype *)dstbuf + ofs, srcbuf, run);   \
+                    srcbuf += run * 4;                               \
                     ofs += run;                                      \
                 }                                                    \
             } while (ofs < w);                                       \
@@ -853,13 +1003,13 @@ static int SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, SDL_Rect *srcrect,
         switch (df->BytesPerPixel) {
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, OPAQUE_RUN_16, TRANSL_RUN_565);
             } else {
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, OPAQUE_RUN_16, TRANSL_RUN_555);
             }
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, OPAQUE_RUN_32, TRANSL_RUN_32);
             break;
         }
     }
@@ -1057,6 +1207,9 @@ static int RLEAlphaSurface(SDL_Surface *surface)
         default:
             return -1;
         }
+        if (surface->map->info.flags & (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA)) {
+            return -1; /* modulation is only done for 32bpp targets */
+        }
         max_opaque_run = 255; /* runs stored as bytes */
 
         /* worst case is alternating opaque and translucent pixels,
@@ -1406,6 +1559,7 @@ static int RLEColorkeySurface(SDL_Surface *surface)
 int SDL_RLESurface(SDL_Surface *surface)
 {
     int flags;
+    SDL_bool pixel_alpha;
 
     /* Clear any previous RLE conversion */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
@@ -1431,17 +1585,19 @@ int SDL_RLESurface(SDL_Surface *surface)
         /* If we don't have colorkey or blending, nothing to do... */
         return -1;
     }
+    pixel_alpha = ((flags & SDL_COPY_BLEND) && surface->format->Amask) ? SDL_TRUE : SDL_FALSE;
 
-    /* Pass on combinations not supported */
-    if ((flags & SDL_COPY_MODULATE_COLOR) ||
-        ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
+    /* Pass on combinations not supported,
+       color modulation is only done by the pixel alpha blitter */
+    if (((flags & SDL_COPY_MODULATE_COLOR) && !pixel_alpha) ||
+        ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask && !pixel_alpha) ||
         (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) ||
         (flags & SDL_COPY_NEAREST)) {
         return -1;
     }
 
     /* Encode and set up the blit */
-    if (!surface->format->Amask || !(flags & SDL_COPY_BLEND)) {
+    if (!pixel_alpha) {
         if (!surface->map->identity) {
             return -1;
         }
@@ -28,6 +28,13 @@
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 
+#ifdef HAVE_SYSCONF
+#include <unistd.h>
+#endif
+#if defined(__MACOS__) || defined(__IOS__)
+#include <sys/sysctl.h>
+#endif
+
 /* The general purpose software blit routine */
 static int SDLCALL SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
                                 SDL_Surface *dst, SDL_Rect *dstrect)
@@ -97,6 +104,42 @@ static int SDLCALL SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
     return okay ? 0 : -1;
 }
 
+/*
+ * Fills and copies of at least this many bytes use non-temporal stores: they
+ * would evict most of the last level cache, including the data about to be
+ * composited into the destination, for a result that doesn't fit anyway.
+ */
+size_t SDL_GetBlitStreamingThreshold(void)
+{
+    static size_t threshold = 0;
+
+    if (!threshold) {
+        size_t cache_size = 0;
+
+#if defined(HAVE_SYSCONF) && defined(_SC_LEVEL3_CACHE_SIZE)
+        const long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (size > 0) {
+            cache_size = (size_t)size;
+        }
+#elif defined(__MACOS__) || defined(__IOS__)
+        Uint64 size = 0;
+        size_t typeSize = sizeof(size);
+        if (sysctlbyname("hw.l3cachesize", &size, &typeSize, NULL, 0) == 0 && size > 0) {
+            cache_size = (size_t)size;
+        }
+#endif
+        if (!cache_size) {
+            /* Just guess a typical desktop L3 */
+            cache_size = 8 * 1024 * 1024;
+        } else if (cache_size > 32 * 1024 * 1024) {
+            /* Large server caches are reported as a whole, but split between core clusters */
+            cache_size = 32 * 1024 * 1024;
+        }
+        threshold = cache_size / 2;
+    }
+    return threshold;
+}
+
 #if SDL_HAVE_BLIT_AUTO
 
 #ifdef __MACOS__
@@ -23,6 +23,8 @@
 #ifndef SDL_blit_h_
 #define SDL_blit_h_
 
+#include "SDL_rect_c.h"
+
 /* pixman ARM blitters are 32 bit only : */
 #if defined(__aarch64__) || defined(_M_ARM64)
 #undef SDL_ARM_SIMD_BLITTERS
@@ -97,10 +99,30 @@ struct SDL_BlitMap
        an invalid mapping */
     Uint32 dst_palette_version;
     Uint32 src_palette_version;
+
+    /* the area changed since the last window update, for window surfaces
+       with damage tracking */
+    SDL_Region *damage;
 };
 
+/* Record that an area of a surface changed */
+static SDL_INLINE void SDL_AddSurfaceDamage(SDL_Surface *surface, const SDL_Rect *rect)
+{
+    if (surface->map && surface->map->damage) {
+        SDL_AddRectToRegion(surface->map->damage, rect);
+    }
+}
+
+/* Blits from bit fields to a palette look up the nearest palette color in
+   info.table, a 32x32x32 cube indexed by the top 5 bits of each channel.
+   The table is NULL when the palette is the 3-3-2 dither palette. */
+#define SDL_PALETTE_LUT_SIZE (32 * 32 * 32)
+#define SDL_PALETTE_LUT_INDEX(r, g, b) \
+    ((((Uint32)(r) >> 3) << 10) | (((Uint32)(g) >> 3) << 5) | ((Uint32)(b) >> 3))
+
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface *surface);
+extern size_t SDL_GetBlitStreamingThreshold(void);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface *surface);
@@ -108,6 +130,11 @@ extern SDL_BlitFunc SDL_CalculateBlit1(SDL_Surface *surface);
 extern SDL_BlitFunc SDL_CalculateBlitN(SDL_Surface *surface);
 extern SDL_BlitFunc SDL_CalculateBlitA(SDL_Surface *surface);
 
+/* Functions found in SDL_stretch.c */
+extern SDL_bool SDL_IsSoftStretchFilterable(Uint32 format);
+extern SDL_bool SDL_IsSoftStretchConvertible(Uint32 src_format, Uint32 dst_format);
+extern int SDL_PrivateSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
+
 /*
  * Useful macros for blitting routines
  */
@@ -60,7 +60,7 @@ static void BlitNto1SurfaceAlpha(SDL_BlitInfo *info)
         if ( palmap == NULL ) {
             *dst = (Uint8)(((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0)));
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            *dst = palmap[SDL_PALETTE_LUT_INDEX(dR, dG, dB)];
         }
         dst++;
         src += srcbpp;
@@ -105,7 +105,7 @@ static void BlitNto1PixelAlpha(SDL_BlitInfo *info)
         if ( palmap == NULL ) {
             *dst = (Uint8)(((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0)));
         } else {
-            *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+            *dst = palmap[SDL_PALETTE_LUT_INDEX(dR, dG, dB)];
         }
         dst++;
         src += srcbpp;
@@ -153,7 +153,7 @@ static void BlitNto1SurfaceAlphaKey(SDL_BlitInfo *info)
             if ( palmap == NULL ) {
                 *dst = (Uint8)(((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0)));
             } else {
-                *dst = palmap[((dR>>5)<<(3+2))|((dG>>5)<<(2))|((dB>>6)<<(0))];
+                *dst = palmap[SDL_PALETTE_LUT_INDEX(dR, dG, dB)];
             }
         }
         dst++;
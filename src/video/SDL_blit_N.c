@@ -953,6 +953,13 @@ static void Blit_RGB444_RGB888ARMSIMD(SDL_BlitInfo *info)
                       (((src)&0x0000E000) >> 11) | \
                       (((src)&0x000000C0) >> 6));  \
     }
+/* RGB 8-8-8 --> index in the nearest palette color lookup table */
+#define RGB888_LUT_INDEX(dst, src)             \
+    {                                          \
+        dst = ((((src)&0x00F80000) >> 9) |     \
+               (((src)&0x0000F800) >> 6) |     \
+               (((src)&0x000000F8) >> 3));     \
+    }
 static void Blit_RGB888_index8(SDL_BlitInfo *info)
 {
 #ifndef USE_DUFFS_LOOP
@@ -1016,7 +1023,7 @@ static void Blit_RGB888_index8(SDL_BlitInfo *info)
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             , width);
@@ -1024,32 +1031,32 @@ static void Blit_RGB888_index8(SDL_BlitInfo *info)
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
                 SDL_FALLTHROUGH;
             case 2:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
                 SDL_FALLTHROUGH;
             case 1:
-                RGB888_RGB332(Pixel, *src);
+                RGB888_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
@@ -1067,6 +1074,13 @@ static void Blit_RGB888_index8(SDL_BlitInfo *info)
                       (((src)&0x000E0000) >> 15) | \
                       (((src)&0x00000300) >> 8));  \
     }
+/* RGB 10-10-10 --> index in the nearest palette color lookup table */
+#define RGB101010_LUT_INDEX(dst, src)          \
+    {                                          \
+        dst = ((((src)&0x3E000000) >> 15) |    \
+               (((src)&0x000F8000) >> 10) |    \
+               (((src)&0x000003E0) >> 5));     \
+    }
 static void Blit_RGB101010_index8(SDL_BlitInfo *info)
 {
 #ifndef USE_DUFFS_LOOP
@@ -1130,7 +1144,7 @@ static void Blit_RGB101010_index8(SDL_BlitInfo *info)
 #ifdef USE_DUFFS_LOOP
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             , width);
@@ -1138,32 +1152,32 @@ static void Blit_RGB101010_index8(SDL_BlitInfo *info)
 #else
             for (c = width / 4; c; --c) {
                 /* Pack RGB into 8bit pixel */
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
             switch (width & 3) {
             case 3:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
                 SDL_FALLTHROUGH;
             case 2:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
                 SDL_FALLTHROUGH;
             case 1:
-                RGB101010_RGB332(Pixel, *src);
+                RGB101010_LUT_INDEX(Pixel, *src);
                 *dst++ = map[Pixel];
                 ++src;
             }
@@ -2150,9 +2164,7 @@ static void BlitNto1(SDL_BlitInfo *info)
                                 sR, sG, sB);
                 if ( 1 ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR>>5)<<(3+2))|
-                           ((sG>>5)<<(2))  |
-                           ((sB>>6)<<(0))  ];
+                    *dst = map[SDL_PALETTE_LUT_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -2163,8 +2175,7 @@ static void BlitNto1(SDL_BlitInfo *info)
                 DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
                 if (1) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = map[((sR >> 5) << (3 + 2)) |
-                               ((sG >> 5) << (2)) | ((sB >> 6) << (0))];
+                    *dst = map[SDL_PALETTE_LUT_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -2176,6 +2187,56 @@ static void BlitNto1(SDL_BlitInfo *info)
     }
 }
 
+/* 4x4 ordered dither, offsets of about one palette step centered on 0.
+   The pattern is anchored to the destination rectangle of the blit. */
+static const Sint8 dither_offsets[4][4] = {
+    { -15, 1, -11, 5 },
+    { 9, -7, 13, -3 },
+    { -9, 7, -13, 3 },
+    { 15, -1, 11, -5 }
+};
+
+#define DITHER_CHANNEL(c, offset) \
+    (((c) + (offset)) < 0 ? 0 : ((c) + (offset)) > 255 ? 255 : ((c) + (offset)))
+
+static void BlitNto1Dither(SDL_BlitInfo *info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip;
+    const Uint8 *map = info->table;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    int srcbpp = srcfmt->BytesPerPixel;
+    Uint32 Pixel;
+    int sR, sG, sB;
+    int x, y;
+
+    for (y = 0; y < height; ++y) {
+        const Sint8 *offsets = dither_offsets[y & 3];
+        for (x = 0; x < width; ++x) {
+            const int offset = offsets[x & 3];
+
+            DISEMBLE_RGB(src, srcbpp, srcfmt, Pixel, sR, sG, sB);
+            sR = DITHER_CHANNEL(sR, offset);
+            sG = DITHER_CHANNEL(sG, offset);
+            sB = DITHER_CHANNEL(sB, offset);
+            if (map == NULL) {
+                /* Pack RGB into 8bit pixel */
+                *dst = (Uint8)(((sR >> 5) << (3 + 2)) | ((sG >> 5) << (2)) | ((sB >> 6) << (0)));
+            } else {
+                *dst = map[SDL_PALETTE_LUT_INDEX(sR, sG, sB)];
+            }
+            dst++;
+            src += srcbpp;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+}
+
 /* blits 32 bit RGB<->RGBA with both surfaces having the same R,G,B fields */
 static void Blit4to4MaskAlpha(SDL_BlitInfo *info)
 {
@@ -2537,9 +2598,7 @@ static void BlitNto1Key(SDL_BlitInfo *info)
                                 sR, sG, sB);
                 if ( (Pixel & rgbmask) != ckey ) {
                     /* Pack RGB into 8bit pixel */
-                    *dst = (Uint8)palmap[((sR>>5)<<(3+2))|
-                                         ((sG>>5)<<(2))  |
-                                         ((sB>>6)<<(0))  ];
+                    *dst = palmap[SDL_PALETTE_LUT_INDEX(sR, sG, sB)];
                 }
                 dst++;
                 src += srcbpp;
@@ -3020,6 +3079,56 @@ static void BlitNto2101010(SDL_BlitInfo *info)
     }
 }
 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#ifdef SDL_SSE2_INTRINSICS
+static int SDL_TARGETING("sse2") Blit3to4Row_SSE2(const Uint8 *src, Uint8 *dst, int width, SDL_bool inversed, Uint32 alpha, Uint32 keep)
+{
+    const __m128i mask0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+    const __m128i mask1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+    const __m128i mask2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+    const __m128i mask3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+    const __m128i green = _mm_set1_epi32(0x0000FF00);
+    const __m128i low = _mm_set1_epi32(0x000000FF);
+    const __m128i a = _mm_set1_epi32((int)alpha);
+    const __m128i k = _mm_set1_epi32((int)keep);
+    int x;
+
+    /* Each step loads 16 bytes for 4 pixels, so stop 2 pixels early */
+    for (x = 0; x + 6 <= width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + x * 3));
+        __m128i p = _mm_or_si128(_mm_or_si128(_mm_and_si128(v, mask0),
+                                              _mm_and_si128(_mm_slli_si128(v, 1), mask1)),
+                                 _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), mask2),
+                                              _mm_and_si128(_mm_slli_si128(v, 3), mask3)));
+        if (inversed) {
+            p = _mm_or_si128(_mm_or_si128(_mm_and_si128(p, green), _mm_srli_epi32(p, 16)),
+                             _mm_slli_epi32(_mm_and_si128(p, low), 16));
+        }
+        p = _mm_or_si128(p, a);
+        if (keep) {
+            p = _mm_or_si128(p, _mm_and_si128(_mm_loadu_si128((const __m128i *)(dst + x * 4)), k));
+        }
+        _mm_storeu_si128((__m128i *)(dst + x * 4), p);
+    }
+    return x;
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+/* Expands the start of a row of 24-bit pixels to 32-bit ones, setting the
+   top byte to alpha or keeping it from dst if keep is 0xFF000000.
+   Returns the number of pixels done, always fewer than width so that the
+   caller's loop finishes the row. */
+static int Blit3to4Row(const Uint8 *src, Uint8 *dst, int width, SDL_bool inversed, Uint32 alpha, Uint32 keep)
+{
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return Blit3to4Row_SSE2(src, dst, width, inversed, alpha, keep);
+    }
+#endif
+    return 0;
+}
+#endif /* SDL_BYTEORDER == SDL_LIL_ENDIAN */
+
 /* Blit_3or4_to_3or4__same_rgb: 3 or 4 bpp, same RGB triplet */
 static void Blit_3or4_to_3or4__same_rgb(SDL_BlitInfo *info)
 {
@@ -3045,6 +3154,14 @@ static void Blit_3or4_to_3or4__same_rgb(SDL_BlitInfo *info)
         int i2 = srcbpp - 1 - 2;
 #endif
         while (height--) {
+            int done = 0;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (srcbpp == 3) {
+                done = Blit3to4Row(src, dst, width, SDL_FALSE, mask, 0);
+                src += done * 3;
+                dst += done * 4;
+            }
+#endif
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
             {
@@ -3055,7 +3172,7 @@ static void Blit_3or4_to_3or4__same_rgb(SDL_BlitInfo *info)
                 *dst32 = (s0) | (s1 << 8) | (s2 << 16) | mask;
                 dst += 4;
                 src += srcbpp;
-            }, width);
+            }, (width - done));
             /* *INDENT-ON* */ /* clang-format on */
             src += srcskip;
             dst += dstskip;
@@ -3074,6 +3191,14 @@ static void Blit_3or4_to_3or4__same_rgb(SDL_BlitInfo *info)
         int j2 = dstbpp - 1 - 2;
 #endif
         while (height--) {
+            int done = 0;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (srcbpp == 3 && dstbpp == 4) {
+                done = Blit3to4Row(src, dst, width, SDL_FALSE, 0, 0xFF000000);
+                src += done * 3;
+                dst += done * 4;
+            }
+#endif
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
             {
@@ -3085,7 +3210,7 @@ static void Blit_3or4_to_3or4__same_rgb(SDL_BlitInfo *info)
                 dst[j2] = s2;
                 dst += dstbpp;
                 src += srcbpp;
-            }, width);
+            }, (width - done));
             /* *INDENT-ON* */ /* clang-format on */
             src += srcskip;
             dst += dstskip;
@@ -3145,6 +3270,14 @@ static void Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo *info)
             int i2 = srcbpp - 1 - 2;
 #endif
             while (height--) {
+                int done = 0;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                if (srcbpp == 3) {
+                    done = Blit3to4Row(src, dst, width, SDL_TRUE, mask, 0);
+                    src += done * 3;
+                    dst += done * 4;
+                }
+#endif
                 /* *INDENT-OFF* */ /* clang-format off */
                 DUFFS_LOOP(
                 {
@@ -3156,7 +3289,7 @@ static void Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo *info)
                     *dst32 = (s0 << 16) | (s1 << 8) | (s2) | mask;
                     dst += 4;
                     src += srcbpp;
-                }, width);
+                }, (width - done));
                 /* *INDENT-ON* */ /* clang-format on */
                 src += srcskip;
                 dst += dstskip;
@@ -3176,6 +3309,14 @@ static void Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo *info)
         int j2 = dstbpp - 1 - 0;
 #endif
         while (height--) {
+            int done = 0;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+            if (srcbpp == 3 && dstbpp == 4) {
+                done = Blit3to4Row(src, dst, width, SDL_TRUE, 0, 0xFF000000);
+                src += done * 3;
+                dst += done * 4;
+            }
+#endif
             /* *INDENT-OFF* */ /* clang-format off */
             DUFFS_LOOP(
             {
@@ -3188,7 +3329,7 @@ static void Blit_3or4_to_3or4__inversed_rgb(SDL_BlitInfo *info)
                 dst[j2] = s2;
                 dst += dstbpp;
                 src += srcbpp;
-            }, width);
+            }, (width - done));
             /* *INDENT-ON* */ /* clang-format on */
             src += srcskip;
             dst += dstskip;
@@ -3358,7 +3499,9 @@ SDL_CalculateBlitN(SDL_Surface *surface)
     case 0:
         blitfun = NULL;
         if (dstfmt->BitsPerPixel == 8) {
-            if ((srcfmt->BytesPerPixel == 4) &&
+            if (SDL_GetHintBoolean(SDL_HINT_SURFACE_PALETTE_DITHER, SDL_FALSE)) {
+                blitfun = BlitNto1Dither;
+            } else if ((srcfmt->BytesPerPixel == 4) &&
                 (srcfmt->Rmask == 0x00FF0000) &&
                 (srcfmt->Gmask == 0x0000FF00) &&
                 (srcfmt->Bmask == 0x000000FF)) {
@@ -48,8 +48,68 @@ static SDL_INLINE void SDL_TARGETING("sse") SDL_memcpySSE(Uint8 *dst, const Uint
         SDL_memcpy(dst, src, len & 63);
     }
 }
+
+static void SDL_TARGETING("sse") SDL_BlitCopySSE(Uint8 *dst, const Uint8 *src, const int dstskip, const int srcskip, const int w, int h)
+{
+    while (h--) {
+        SDL_memcpySSE(dst, src, w);
+        src += srcskip;
+        dst += dstskip;
+    }
+    /* Non-temporal stores are weakly ordered */
+    _mm_sfence();
+}
 #endif /* SDL_SSE_INTRINSICS */
 
+#ifdef SDL_AVX2_INTRINSICS
+/* Streams into dst, aligned on the way; src may have any alignment */
+static SDL_INLINE void SDL_TARGETING("avx2") SDL_memcpyAVX2(Uint8 *dst, const Uint8 *src, int len)
+{
+    int i;
+    int adjust = (int)(-(intptr_t)dst & 31);
+
+    if (adjust >= len) {
+        SDL_memcpy(dst, src, len);
+        return;
+    }
+    if (adjust) {
+        SDL_memcpy(dst, src, adjust);
+        src += adjust;
+        dst += adjust;
+        len -= adjust;
+    }
+
+    for (i = len / 128; i--;) {
+        __m256i values[4];
+        _mm_prefetch((const char *)src + 128, _MM_HINT_NTA);
+        values[0] = _mm256_loadu_si256((const __m256i *)(src + 0));
+        values[1] = _mm256_loadu_si256((const __m256i *)(src + 32));
+        values[2] = _mm256_loadu_si256((const __m256i *)(src + 64));
+        values[3] = _mm256_loadu_si256((const __m256i *)(src + 96));
+        _mm256_stream_si256((__m256i *)(dst + 0), values[0]);
+        _mm256_stream_si256((__m256i *)(dst + 32), values[1]);
+        _mm256_stream_si256((__m256i *)(dst + 64), values[2]);
+        _mm256_stream_si256((__m256i *)(dst + 96), values[3]);
+        src += 128;
+        dst += 128;
+    }
+
+    if (len & 127) {
+        SDL_memcpy(dst, src, len & 127);
+    }
+}
+
+static void SDL_TARGETING("avx2") SDL_BlitCopyAVX2(Uint8 *dst, const Uint8 *src, const int dstskip, const int srcskip, const int w, int h)
+{
+    while (h--) {
+        SDL_memcpyAVX2(dst, src, w);
+        src += srcskip;
+        dst += dstskip;
+    }
+    _mm_sfence();
+}
+#endif /* SDL_AVX2_INTRINSICS */
+
 #ifdef SDL_MMX_INTRINSICS
 #ifdef _MSC_VER
 #pragma warning(disable : 4799)
@@ -136,21 +196,26 @@ void SDL_BlitCopy(SDL_BlitInfo *info)
         return;
     }
 
+    /* Copies too large for the cache bypass it, the rest is left to SDL_memcpy */
+    if ((size_t)w * h >= SDL_GetBlitStreamingThreshold()) {
+#ifdef SDL_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            SDL_BlitCopyAVX2(dst, src, dstskip, srcskip, w, h);
+            return;
+        }
+#endif
 #ifdef SDL_SSE_INTRINSICS
-    if (SDL_HasSSE() &&
-        !((uintptr_t)src & 15) && !(srcskip & 15) &&
-        !((uintptr_t)dst & 15) && !(dstskip & 15)) {
-        while (h--) {
-            SDL_memcpySSE(dst, src, w);
-            src += srcskip;
-            dst += dstskip;
+        if (SDL_HasSSE() &&
+            !((uintptr_t)src & 15) && !(srcskip & 15) &&
+            !((uintptr_t)dst & 15) && !(dstskip & 15)) {
+            SDL_BlitCopySSE(dst, src, dstskip, srcskip, w, h);
+            return;
         }
-        return;
-    }
 #endif
+    }
 
 #ifdef SDL_MMX_INTRINSICS
-    if (SDL_HasMMX() && !(srcskip & 7) && !(dstskip & 7)) {
+    if (SDL_HasMMX() && !SDL_HasSSE() && !(srcskip & 7) && !(dstskip & 7)) {
         SDL_BlitCopyMMX(dst, src, dstskip, srcskip, w, h);
         return;
     }
@@ -36,6 +36,9 @@
 
 #define SAVE_32BIT_BMP
 
+/* How many bytes of pixel rows to gather for each write when saving */
+#define SAVE_BATCH_SIZE (256 * 1024)
+
 /* Compression encodings for BMP files */
 #ifndef BI_RGB
 #define BI_RGB       0
@@ -50,10 +53,24 @@
 #define LCS_WINDOWS_COLOR_SPACE 0x57696E20
 #endif
 
-static SDL_bool readRlePixels(SDL_Surface *surface, SDL_RWops *src, int isRle8)
+/* Returns the next size bytes of a memory stream without copying them */
+static const Uint8 *MapBMPData(SDL_RWops *src, size_t size)
+{
+    if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+        if ((size_t)(src->hidden.mem.stop - src->hidden.mem.here) >= size) {
+            const Uint8 *data = src->hidden.mem.here;
+            src->hidden.mem.here += size;
+            return data;
+        }
+    }
+    return NULL;
+}
+
+static SDL_bool readRlePixels(SDL_Surface *surface, const Uint8 *src, const Uint8 *srcend, const Uint8 **srcstop, int isRle8)
 {
     /*
     | Sets the surface pixels from src.  A bmp image is upside down.
+    | On success, srcstop is set just past the end of bitmap marker.
     */
     int pitch = surface->pitch;
     int height = surface->h;
@@ -69,20 +86,21 @@ static SDL_bool readRlePixels(SDL_Surface *surface, SDL_RWops *src, int isRle8)
     if (spot >= start && spot < end) \
     *spot = (x)
 
-    /* !!! FIXME: for all these reads, handle error vs eof? handle -2 if non-blocking? */
+#define READ_BYTE(x)     \
+    if (src >= srcend) { \
+        return SDL_TRUE; \
+    }                    \
+    (x) = *src++
+
     for (;;) {
-        if (SDL_RWread(src, &ch, 1) <= 0) {
-            return SDL_TRUE;
-        }
+        READ_BYTE(ch);
         /*
         | encoded mode starts with a run length, and then a byte
         | with two colour indexes to alternate between for the run
         */
         if (ch) {
             Uint8 pixel;
-            if (SDL_RWread(src, &pixel, 1) <= 0) {
-                return SDL_TRUE;
-            }
+            READ_BYTE(pixel);
             if (isRle8) { /* 256-color bitmap, compressed */
                 do {
                     COPY_PIXEL(pixel);
@@ -107,24 +125,19 @@ static SDL_bool readRlePixels(SDL_Surface *surface, SDL_RWops *src, int isRle8)
             | a cursor move, or some absolute data.
             | zero tag may be absolute mode or an escape
             */
-            if (SDL_RWread(src, &ch, 1) <= 0) {
-                return SDL_TRUE;
-            }
+            READ_BYTE(ch);
             switch (ch) {
             case 0: /* end of line */
                 ofs = 0;
                 bits -= pitch; /* go to previous */
                 break;
-            case 1:               /* end of bitmap */
+            case 1: /* end of bitmap */
+                *srcstop = src;
                 return SDL_FALSE; /* success! */
             case 2:               /* delta */
-                if (SDL_RWread(src, &ch, 1) <= 0) {
-                    return SDL_TRUE;
-                }
+                READ_BYTE(ch);
                 ofs += ch;
-                if (SDL_RWread(src, &ch, 1) <= 0) {
-                    return SDL_TRUE;
-                }
+                READ_BYTE(ch);
                 bits -= (ch * pitch);
                 break;
             default: /* no compression */
@@ -132,18 +145,14 @@ static SDL_bool readRlePixels(SDL_Surface *surface, SDL_RWops *src, int isRle8)
                     needsPad = (ch & 1);
                     do {
                         Uint8 pixel;
-                        if (SDL_RWread(src, &pixel, 1) <= 0) {
-                            return SDL_TRUE;
-                        }
+                        READ_BYTE(pixel);
                         COPY_PIXEL(pixel);
                     } while (--ch);
                 } else {
                     needsPad = (((ch + 1) >> 1) & 1); /* (ch+1)>>1: bytes size */
                     for (;;) {
                         Uint8 pixel;
-                        if (SDL_RWread(src, &pixel, 1) <= 0) {
-                            return SDL_TRUE;
-                        }
+                        READ_BYTE(pixel);
                         COPY_PIXEL(pixel >> 4);
                         if (!--ch) {
                             break;
@@ -155,8 +164,8 @@ static SDL_bool readRlePixels(SDL_Surface *surface, SDL_RWops *src, int isRle8)
                     }
                 }
                 /* pad at even boundary */
-                if (needsPad && (SDL_RWread(src, &ch, 1) <= 0)) {
-                    return SDL_TRUE;
+                if (needsPad) {
+                    READ_BYTE(ch);
                 }
                 break;
             }
@@ -193,13 +202,37 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
+static void FlipRows(SDL_Surface *surface)
+{
+    Uint8 tmp[256];
+    const int pitch = surface->pitch;
+    Uint8 *top = (Uint8 *)surface->pixels;
+    Uint8 *bottom = top + (surface->h - 1) * pitch;
+
+    while (top < bottom) {
+        int x, len;
+        for (x = 0; x < pitch; x += len) {
+            len = SDL_min(pitch - x, (int)sizeof(tmp));
+            SDL_memcpy(tmp, top + x, len);
+            SDL_memcpy(top + x, bottom + x, len);
+            SDL_memcpy(bottom + x, tmp, len);
+        }
+        top += pitch;
+        bottom -= pitch;
+    }
+}
+
 SDL_Surface *
 SDL_LoadBMP_RW(SDL_RWops *src, int freesrc)
 {
     SDL_bool was_error;
     Sint64 fp_offset = 0;
     int bmpPitch;
-    int i, pad;
+    int i, y, pad;
+    size_t rowSize, dataSize;
+    const Uint8 *data;
+    const Uint8 *stop = NULL;
+    Uint8 *buffer = NULL;
     SDL_Surface *surface;
     Uint32 Rmask = 0;
     Uint32 Gmask = 0;
@@ -207,7 +240,6 @@ SDL_LoadBMP_RW(SDL_RWops *src, int freesrc)
     Uint32 Amask = 0;
     SDL_Palette *palette;
     Uint8 *bits;
-    Uint8 *top, *end;
     SDL_bool topDown;
     int ExpandBMP;
     SDL_bool haveRGBMasks = SDL_FALSE;
@@ -465,27 +497,27 @@ SDL_LoadBMP_RW(SDL_RWops *src, int freesrc)
             }
         }
 
-        if (biSize == 12) {
-            for (i = 0; i < (int)biClrUsed; ++i) {
-                /* !!! FIXME: this should check for i/o errors! */
-                SDL_RWread(src, &palette->colors[i].b, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1);
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
+        {
+            /* OS/2 BMP palettes are BGR triplets, later ones BGRx quads */
+            Uint8 colors[256 * 4];
+            const int entrySize = (biSize == 12) ? 3 : 4;
+            const Uint8 *entry = colors;
+
+            if (SDL_RWread(src, colors, (Sint64)biClrUsed * entrySize) != (Sint64)biClrUsed * entrySize) {
+                SDL_Error(SDL_EFREAD);
+                was_error = SDL_TRUE;
+                goto done;
             }
-        } else {
             for (i = 0; i < (int)biClrUsed; ++i) {
-                /* !!! FIXME: this should check for i/o errors! */
-                SDL_RWread(src, &palette->colors[i].b, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1);
-                SDL_RWread(src, &palette->colors[i].a, 1);
-
+                palette->colors[i].b = entry[0];
+                palette->colors[i].g = entry[1];
+                palette->colors[i].r = entry[2];
                 /* According to Microsoft documentation, the fourth element
                    is reserved and must be zero, so we shouldn't treat it as
                    alpha.
                 */
                 palette->colors[i].a = SDL_ALPHA_OPAQUE;
+                entry += entrySize;
             }
         }
         palette->ncolors = biClrUsed;
@@ -498,68 +530,109 @@ SDL_LoadBMP_RW(SDL_RWops *src, int freesrc)
         goto done;
     }
     if ((biCompression == BI_RLE4) || (biCompression == BI_RLE8)) {
-        was_error = readRlePixels(surface, src, biCompression == BI_RLE8);
+        /* Decode the rest of the stream from memory rather than byte by byte */
+        if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+            dataSize = (size_t)(src->hidden.mem.stop - src->hidden.mem.here);
+            data = MapBMPData(src, dataSize);
+        } else {
+            buffer = (Uint8 *)SDL_LoadFile_RW(src, &dataSize, SDL_FALSE);
+            data = buffer;
+        }
+        was_error = !data || readRlePixels(surface, data, data + dataSize, &stop, biCompression == BI_RLE8);
         if (was_error) {
             SDL_Error(SDL_EFREAD);
+            goto done;
+        }
+        /* Leave the stream just past the end of the bitmap, for data following it */
+        if (SDL_RWseek(src, fp_offset + bfOffBits + (stop - data), SDL_RW_SEEK_SET) < 0) {
+            SDL_Error(SDL_EFSEEK);
+            was_error = SDL_TRUE;
         }
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels + (surface->h * surface->pitch);
     switch (ExpandBMP) {
     case 1:
         bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     case 2:
         bmpPitch = (biWidth + 3) >> 2;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     case 4:
         bmpPitch = (biWidth + 1) >> 1;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
         break;
     default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
+        bmpPitch = surface->pitch;
         break;
     }
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
+    pad = ((bmpPitch % 4) ? (4 - (bmpPitch % 4)) : 0);
+    rowSize = (size_t)bmpPitch + pad;
+    if (surface->h == 0) {
+        goto done;
     }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 2:
-        case 4:
-        {
-            Uint8 pixel = 0;
-            int shift = (8 - ExpandBMP);
-            for (i = 0; i < surface->w; ++i) {
-                if (i % (8 / ExpandBMP) == 0) {
-                    if (SDL_RWread(src, &pixel, 1) != 1) {
-                        SDL_Error(SDL_EFREAD);
+
+    /* Get the whole pixel array at once, the padding after the last row
+       is allowed to be missing. Memory streams are used in place, other
+       streams are read straight into the surface if the rows match. */
+    dataSize = rowSize * (surface->h - 1) + bmpPitch;
+    data = MapBMPData(src, dataSize);
+    if (data == NULL) {
+        if (ExpandBMP) {
+            buffer = (Uint8 *)SDL_malloc(dataSize);
+            if (buffer == NULL) {
+                SDL_OutOfMemory();
+                was_error = SDL_TRUE;
+                goto done;
+            }
+            bits = buffer;
+        } else {
+            bits = (Uint8 *)surface->pixels;
+        }
+        if (SDL_RWread(src, bits, (Sint64)dataSize) != (Sint64)dataSize) {
+            SDL_Error(SDL_EFREAD);
+            was_error = SDL_TRUE;
+            goto done;
+        }
+        data = bits;
+    }
+    if (pad) {
+        /* Skip the padding of the last row too, if it is there */
+        Uint8 padding[3];
+        SDL_RWread(src, padding, pad);
+    }
+
+    if (data == surface->pixels) {
+        if (!topDown) {
+            FlipRows(surface);
+        }
+    } else {
+        for (y = 0; y < surface->h; ++y) {
+            const Uint8 *row = data + y * rowSize;
+
+            bits = (Uint8 *)surface->pixels + (topDown ? y : (surface->h - 1 - y)) * surface->pitch;
+            if (ExpandBMP) {
+                Uint8 pixel = 0;
+                int shift = (8 - ExpandBMP);
+                for (i = 0; i < surface->w; ++i) {
+                    if (i % (8 / ExpandBMP) == 0) {
+                        pixel = *row++;
+                    }
+                    bits[i] = (pixel >> shift);
+                    if (bits[i] >= biClrUsed) {
+                        SDL_SetError("A BMP image contains a pixel with a color out of the palette");
                         was_error = SDL_TRUE;
                         goto done;
                     }
+                    pixel <<= ExpandBMP;
                 }
-                bits[i] = (pixel >> shift);
-                if (bits[i] >= biClrUsed) {
-                    SDL_SetError("A BMP image contains a pixel with a color out of the palette");
-                    was_error = SDL_TRUE;
-                    goto done;
-                }
-                pixel <<= ExpandBMP;
+            } else {
+                SDL_memcpy(bits, row, surface->pitch);
             }
-        } break;
+        }
+    }
 
-        default:
-            if (SDL_RWread(src, bits, surface->pitch) != surface->pitch) {
-                SDL_Error(SDL_EFREAD);
-                was_error = SDL_TRUE;
-                goto done;
-            }
+    if (!ExpandBMP) {
+        for (y = 0; y < surface->h; ++y) {
+            bits = (Uint8 *)surface->pixels + y * surface->pitch;
             if (biBitCount == 8 && palette && biClrUsed < (1u << biBitCount)) {
                 for (i = 0; i < surface->w; ++i) {
                     if (bits[i] >= biClrUsed) {
@@ -593,25 +666,13 @@ SDL_LoadBMP_RW(SDL_RWops *src, int freesrc)
             }
             }
 #endif
-            break;
-        }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1);
-            }
-        }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
         }
     }
     if (correctAlpha) {
         CorrectAlphaChannel(surface);
     }
 done:
+    SDL_free(buffer);
     if (was_error) {
         if (src) {
             SDL_RWseek(src, fp_offset, SDL_RW_SEEK_SET);
@@ -808,17 +869,19 @@ int SDL_SaveBMP_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst)
 
         /* Write the palette (in BGR color order) */
         if (intermediate_surface->format->palette) {
+            Uint8 entries[256 * 4];
             SDL_Color *colors;
             int ncolors;
 
             colors = intermediate_surface->format->palette->colors;
-            ncolors = intermediate_surface->format->palette->ncolors;
+            ncolors = SDL_min(intermediate_surface->format->palette->ncolors, 256);
             for (i = 0; i < ncolors; ++i) {
-                SDL_RWwrite(dst, &colors[i].b, 1);
-                SDL_RWwrite(dst, &colors[i].g, 1);
-                SDL_RWwrite(dst, &colors[i].r, 1);
-                SDL_RWwrite(dst, &colors[i].a, 1);
+                entries[i * 4 + 0] = colors[i].b;
+                entries[i * 4 + 1] = colors[i].g;
+                entries[i * 4 + 2] = colors[i].r;
+                entries[i * 4 + 3] = colors[i].a;
             }
+            SDL_RWwrite(dst, entries, (Sint64)ncolors * 4);
         }
 
         /* Write the bitmap offset */
@@ -831,20 +894,42 @@ int SDL_SaveBMP_RW(SDL_Surface *surface, SDL_RWops *dst, int freedst)
             SDL_Error(SDL_EFSEEK);
         }
 
-        /* Write the bitmap image upside down */
-        bits = (Uint8 *)intermediate_surface->pixels + (intermediate_surface->h * intermediate_surface->pitch);
+        /* Write the bitmap image upside down. Memory streams take each row
+           directly, other streams get batches of padded rows to cut down on
+           the number of writes. */
         pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *)intermediate_surface->pixels) {
-            bits -= intermediate_surface->pitch;
-            if (SDL_RWwrite(dst, bits, bw) != bw) {
-                SDL_Error(SDL_EFWRITE);
-                break;
+        if (dst->type == SDL_RWOPS_MEMORY) {
+            static const Uint8 padbytes[4] = { 0, 0, 0, 0 };
+            bits = (Uint8 *)intermediate_surface->pixels + (intermediate_surface->h * intermediate_surface->pitch);
+            while (bits > (Uint8 *)intermediate_surface->pixels) {
+                bits -= intermediate_surface->pitch;
+                if (SDL_RWwrite(dst, bits, bw) != bw || (pad && SDL_RWwrite(dst, padbytes, pad) != pad)) {
+                    SDL_Error(SDL_EFWRITE);
+                    break;
+                }
             }
-            if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    SDL_RWwrite(dst, &padbyte, 1);
+        } else if (intermediate_surface->h > 0) {
+            const int rowSize = bw + pad;
+            const int batchRows = SDL_clamp(SAVE_BATCH_SIZE / rowSize, 1, intermediate_surface->h);
+            Uint8 *batch = (Uint8 *)SDL_calloc(batchRows, rowSize);
+
+            if (batch == NULL) {
+                SDL_OutOfMemory();
+            } else {
+                int y = intermediate_surface->h;
+                while (y > 0) {
+                    const int rows = SDL_min(y, batchRows);
+                    for (i = 0; i < rows; ++i) {
+                        bits = (Uint8 *)intermediate_surface->pixels + (y - 1 - i) * intermediate_surface->pitch;
+                        SDL_memcpy(batch + i * rowSize, bits, bw);
+                    }
+                    if (SDL_RWwrite(dst, batch, (Sint64)rows * rowSize) != (Sint64)rows * rowSize) {
+                        SDL_Error(SDL_EFWRITE);
+                        break;
+                    }
+                    y -= rows;
                 }
+                SDL_free(batch);
             }
         }
 
@@ -43,19 +43,21 @@
     c128 = *(__m128 *)cccc;
 #endif
 
-#define SSE_WORK \
+#define SSE_WORK(store) \
     for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
+        store((float *)(p+0), c128); \
+        store((float *)(p+16), c128); \
+        store((float *)(p+32), c128); \
+        store((float *)(p+48), c128); \
         p += 64; \
     }
 
-#define SSE_END
+/* Non-temporal stores are weakly ordered, fence them before returning */
+#define SSE_END_store
+#define SSE_END_stream _mm_sfence();
 
-#define DEFINE_SSE_FILLRECT(bpp, type) \
-static void SDL_TARGETING("sse") SDL_FillSurfaceRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+#define DEFINE_SSE_FILLRECT(bpp, type, suffix, store) \
+static void SDL_TARGETING("sse") SDL_FillSurfaceRect##bpp##SSE##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -76,7 +78,7 @@ static void SDL_TARGETING("sse") SDL_FillSurfaceRect##bpp##SSE(Uint8 *pixels, in
                     p += (bpp); \
                 } \
             } \
-            SSE_WORK; \
+            SSE_WORK(store); \
         } \
         if (n & 63) { \
             int remainder = (n & 63); \
@@ -89,42 +91,110 @@ static void SDL_TARGETING("sse") SDL_FillSurfaceRect##bpp##SSE(Uint8 *pixels, in
         pixels += pitch; \
     } \
  \
-    SSE_END; \
+    SSE_END##suffix \
 }
 
-static void SDL_TARGETING("sse") SDL_FillSurfaceRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
-{
-    int i, n;
+#define DEFINE_SSE_FILLRECT1(suffix, store) \
+static void SDL_TARGETING("sse") SDL_FillSurfaceRect1SSE##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    int i, n; \
+ \
+    SSE_BEGIN; \
+    while (h--) { \
+        Uint8 *p = pixels; \
+        n = w; \
+ \
+        if (n > 63) { \
+            int adjust = 16 - ((uintptr_t)p & 15); \
+            if (adjust) { \
+                n -= adjust; \
+                SDL_memset(p, color, adjust); \
+                p += adjust; \
+            } \
+            SSE_WORK(store); \
+        } \
+        if (n & 63) { \
+            int remainder = (n & 63); \
+            SDL_memset(p, color, remainder); \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    SSE_END##suffix \
+}
 
-    SSE_BEGIN;
-    while (h--) {
-        Uint8 *p = pixels;
-        n = w;
+DEFINE_SSE_FILLRECT1(_store, _mm_store_ps)
+DEFINE_SSE_FILLRECT1(_stream, _mm_stream_ps)
+DEFINE_SSE_FILLRECT(2, Uint16, _store, _mm_store_ps)
+DEFINE_SSE_FILLRECT(2, Uint16, _stream, _mm_stream_ps)
+DEFINE_SSE_FILLRECT(4, Uint32, _store, _mm_store_ps)
+DEFINE_SSE_FILLRECT(4, Uint32, _stream, _mm_stream_ps)
 
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
-            }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
-        }
-        pixels += pitch;
+/* *INDENT-ON* */ /* clang-format on */
+#endif            /* __SSE__ */
+
+#ifdef SDL_AVX2_INTRINSICS
+/* *INDENT-OFF* */ /* clang-format off */
+
+#define AVX2_WORK(store) \
+    for (i = n / 128; i--;) { \
+        store((__m256i *)(p+0), c256); \
+        store((__m256i *)(p+32), c256); \
+        store((__m256i *)(p+64), c256); \
+        store((__m256i *)(p+96), c256); \
+        p += 128; \
     }
 
-    SSE_END;
+#define AVX2_END_store
+#define AVX2_END_stream _mm_sfence();
+
+/* 'color' has already been replicated to 32 bits, so whole bytes can be written once aligned */
+#define DEFINE_AVX2_FILLRECT(bpp, type, suffix, store) \
+static void SDL_TARGETING("avx2") SDL_FillSurfaceRect##bpp##AVX2##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    const __m256i c256 = _mm256_set1_epi32((int)color); \
+    int i, n; \
+    Uint8 *p = NULL; \
+ \
+    while (h--) { \
+        n = (w) * (bpp); \
+        p = pixels; \
+ \
+        if (n > 127) { \
+            int adjust = 32 - ((uintptr_t)p & 31); \
+            if (adjust < 32) { \
+                n -= adjust; \
+                adjust /= (bpp); \
+                while (adjust--) { \
+                    *((type *)p) = (type)color; \
+                    p += (bpp); \
+                } \
+            } \
+            AVX2_WORK(store); \
+        } \
+        if (n & 127) { \
+            int remainder = (n & 127); \
+            remainder /= (bpp); \
+            while (remainder--) { \
+                *((type *)p) = (type)color; \
+                p += (bpp); \
+            } \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    AVX2_END##suffix \
 }
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
-DEFINE_SSE_FILLRECT(2, Uint16)
-DEFINE_SSE_FILLRECT(4, Uint32)
+
+DEFINE_AVX2_FILLRECT(1, Uint8, _store, _mm256_store_si256)
+DEFINE_AVX2_FILLRECT(1, Uint8, _stream, _mm256_stream_si256)
+DEFINE_AVX2_FILLRECT(2, Uint16, _store, _mm256_store_si256)
+DEFINE_AVX2_FILLRECT(2, Uint16, _stream, _mm256_stream_si256)
+DEFINE_AVX2_FILLRECT(4, Uint32, _store, _mm256_store_si256)
+DEFINE_AVX2_FILLRECT(4, Uint32, _stream, _mm256_stream_si256)
 
 /* *INDENT-ON* */ /* clang-format on */
-#endif            /* __SSE__ */
+#endif            /* SDL_AVX2_INTRINSICS */
 
 static void SDL_FillSurfaceRect1(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 {
@@ -302,6 +372,7 @@ int SDL_FillSurfaceRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
     Uint8 *pixels;
     const SDL_Rect *rect;
     void (*fill_function)(Uint8 * pixels, int pitch, Uint32 color, int w, int h) = NULL;
+    void (*stream_function)(Uint8 * pixels, int pitch, Uint32 color, int w, int h) = NULL;
     int i;
 
     if (dst == NULL) {
@@ -376,9 +447,17 @@ int SDL_FillSurfaceRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
         {
             color |= (color << 8);
             color |= (color << 16);
+#ifdef SDL_AVX2_INTRINSICS
+            if (SDL_HasAVX2()) {
+                fill_function = SDL_FillSurfaceRect1AVX2_store;
+                stream_function = SDL_FillSurfaceRect1AVX2_stream;
+                break;
+            }
+#endif
 #ifdef SDL_SSE_INTRINSICS
             if (SDL_HasSSE()) {
-                fill_function = SDL_FillSurfaceRect1SSE;
+                fill_function = SDL_FillSurfaceRect1SSE_store;
+                stream_function = SDL_FillSurfaceRect1SSE_stream;
                 break;
             }
 #endif
@@ -389,9 +468,17 @@ int SDL_FillSurfaceRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
         case 2:
         {
             color |= (color << 16);
+#ifdef SDL_AVX2_INTRINSICS
+            if (SDL_HasAVX2()) {
+                fill_function = SDL_FillSurfaceRect2AVX2_store;
+                stream_function = SDL_FillSurfaceRect2AVX2_stream;
+                break;
+            }
+#endif
 #ifdef SDL_SSE_INTRINSICS
             if (SDL_HasSSE()) {
-                fill_function = SDL_FillSurfaceRect2SSE;
+                fill_function = SDL_FillSurfaceRect2SSE_store;
+                stream_function = SDL_FillSurfaceRect2SSE_stream;
                 break;
             }
 #endif
@@ -408,9 +495,17 @@ int SDL_FillSurfaceRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
 
         case 4:
         {
+#ifdef SDL_AVX2_INTRINSICS
+            if (SDL_HasAVX2()) {
+                fill_function = SDL_FillSurfaceRect4AVX2_store;
+                stream_function = SDL_FillSurfaceRect4AVX2_stream;
+                break;
+            }
+#endif
 #ifdef SDL_SSE_INTRINSICS
             if (SDL_HasSSE()) {
-                fill_function = SDL_FillSurfaceRect4SSE;
+                fill_function = SDL_FillSurfaceRect4SSE_store;
+                stream_function = SDL_FillSurfaceRect4SSE_stream;
                 break;
             }
 #endif
@@ -430,11 +525,17 @@ int SDL_FillSurfaceRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
             continue;
         }
         rect = &clipped;
+        SDL_AddSurfaceDamage(dst, rect);
 
         pixels = (Uint8 *)dst->pixels + rect->y * dst->pitch +
                  rect->x * dst->format->BytesPerPixel;
 
-        fill_function(pixels, dst->pitch, color, rect->w, rect->h);
+        if (stream_function &&
+            (size_t)rect->w * rect->h * dst->format->BytesPerPixel >= SDL_GetBlitStreamingThreshold()) {
+            stream_function(pixels, dst->pitch, color, rect->w, rect->h);
+        } else {
+            fill_function(pixels, dst->pitch, color, rect->w, rect->h);
+        }
     }
 
     /* We're done! */
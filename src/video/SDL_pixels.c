@@ -126,6 +126,8 @@ SDL_GetPixelFormatName(Uint32 format)
         CASE(SDL_PIXELFORMAT_YVYU)
         CASE(SDL_PIXELFORMAT_NV12)
         CASE(SDL_PIXELFORMAT_NV21)
+        CASE(SDL_PIXELFORMAT_P010)
+        CASE(SDL_PIXELFORMAT_P016)
         CASE(SDL_PIXELFORMAT_EXTERNAL_OES)
 
     default:
@@ -508,46 +510,84 @@ SDL_GetPixelFormatEnumForMasks(int bpp, Uint32 Rmask, Uint32 Gmask, Uint32 Bmask
     return SDL_PIXELFORMAT_UNKNOWN;
 }
 
-static SDL_PixelFormat *formats;
-static SDL_SpinLock formats_lock = 0;
+/* The known non-indexed formats are shared and never freed */
+#define FORMAT_CACHE_EMPTY        0
+#define FORMAT_CACHE_INITIALIZING 1
+#define FORMAT_CACHE_READY        2
+
+/* The slot of a format in the cache is its index in this table */
+static const Uint32 cached_formats[] = {
+    SDL_PIXELFORMAT_RGB332, SDL_PIXELFORMAT_XRGB4444, SDL_PIXELFORMAT_XBGR4444,
+    SDL_PIXELFORMAT_XRGB1555, SDL_PIXELFORMAT_XBGR1555, SDL_PIXELFORMAT_ARGB4444,
+    SDL_PIXELFORMAT_RGBA4444, SDL_PIXELFORMAT_ABGR4444, SDL_PIXELFORMAT_BGRA4444,
+    SDL_PIXELFORMAT_ARGB1555, SDL_PIXELFORMAT_RGBA5551, SDL_PIXELFORMAT_ABGR1555,
+    SDL_PIXELFORMAT_BGRA5551, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_BGR565,
+    SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_XRGB8888,
+    SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_XBGR8888, SDL_PIXELFORMAT_BGRX8888,
+    SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_ARGB2101010, SDL_PIXELFORMAT_YV12,
+    SDL_PIXELFORMAT_IYUV, SDL_PIXELFORMAT_YUY2, SDL_PIXELFORMAT_UYVY,
+    SDL_PIXELFORMAT_YVYU, SDL_PIXELFORMAT_NV12, SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_P010, SDL_PIXELFORMAT_P016, SDL_PIXELFORMAT_EXTERNAL_OES
+};
+
+static SDL_PixelFormat formats_cache[SDL_arraysize(cached_formats)];
+static SDL_AtomicInt formats_cache_state[SDL_arraysize(cached_formats)];
+SDL_COMPILE_TIME_ASSERT(formats_cache, SDL_arraysize(formats_cache) == SDL_arraysize(formats_cache_state));
+
+static int SDL_GetFormatCacheIndex(Uint32 pixel_format)
+{
+    int i;
+
+    for (i = 0; i < (int)SDL_arraysize(cached_formats); ++i) {
+        if (cached_formats[i] == pixel_format) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static SDL_bool SDL_IsCachedFormat(const SDL_PixelFormat *format)
+{
+    return (format >= formats_cache && format < formats_cache + SDL_arraysize(formats_cache));
+}
 
 SDL_PixelFormat *
 SDL_CreatePixelFormat(Uint32 pixel_format)
 {
     SDL_PixelFormat *format;
-
-    SDL_AtomicLock(&formats_lock);
-
-    /* Look it up in our list of previously allocated formats */
-    for (format = formats; format; format = format->next) {
-        if (pixel_format == format->format) {
-            ++format->refcount;
-            SDL_AtomicUnlock(&formats_lock);
-            return format;
+    int index = SDL_GetFormatCacheIndex(pixel_format);
+
+    if (index >= 0) {
+        SDL_AtomicInt *state = &formats_cache_state[index];
+
+        /* Only the first use of a format initializes it, without locking */
+        format = &formats_cache[index];
+        while (SDL_AtomicGet(state) != FORMAT_CACHE_READY) {
+            if (SDL_AtomicCAS(state, FORMAT_CACHE_EMPTY, FORMAT_CACHE_INITIALIZING)) {
+                if (SDL_InitFormat(format, pixel_format) < 0) {
+                    SDL_AtomicSet(state, FORMAT_CACHE_EMPTY);
+                    return NULL;
+                }
+                SDL_AtomicSet(state, FORMAT_CACHE_READY);
+            } else {
+                SDL_CPUPauseInstruction();
+            }
         }
+        return format;
     }
 
     /* Allocate an empty pixel format structure, and initialize it */
     format = SDL_malloc(sizeof(*format));
     if (format == NULL) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_OutOfMemory();
         return NULL;
     }
     if (SDL_InitFormat(format, pixel_format) < 0) {
-        SDL_AtomicUnlock(&formats_lock);
         SDL_free(format);
         return NULL;
     }
 
-    if (!SDL_ISPIXELFORMAT_INDEXED(pixel_format)) {
-        /* Cache the RGB formats */
-        format->next = formats;
-        formats = format;
-    }
-
-    SDL_AtomicUnlock(&formats_lock);
-
     return format;
 }
 
@@ -623,34 +663,68 @@ int SDL_InitFormat(SDL_PixelFormat *format, Uint32 pixel_format)
     return 0;
 }
 
-void SDL_DestroyPixelFormat(SDL_PixelFormat *format)
+SDL_bool SDL_Is8888Format(Uint32 format)
 {
-    SDL_PixelFormat *prev;
-
-    if (format == NULL) {
-        return;
+    if (SDL_ISPIXELFORMAT_INDEXED(format) || SDL_ISPIXELFORMAT_FOURCC(format)) {
+        return SDL_FALSE;
     }
+    if (SDL_BYTESPERPIXEL(format) != 4 || format == SDL_PIXELFORMAT_ARGB2101010) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
 
-    SDL_AtomicLock(&formats_lock);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define BYTE_INDEX(shift) ((shift) / 8)
+#else
+#define BYTE_INDEX(shift) (3 - (shift) / 8)
+#endif
 
-    if (--format->refcount > 0) {
-        SDL_AtomicUnlock(&formats_lock);
-        return;
+SDL_bool SDL_GetPixelSwizzle(const SDL_PixelFormat *srcfmt, const SDL_PixelFormat *dstfmt, SDL_PixelSwizzle *swizzle)
+{
+    const Uint32 src_masks[4] = { srcfmt->Rmask, srcfmt->Gmask, srcfmt->Bmask, srcfmt->Amask };
+    const Uint32 dst_masks[4] = { dstfmt->Rmask, dstfmt->Gmask, dstfmt->Bmask, dstfmt->Amask };
+    const int src_shifts[4] = { srcfmt->Rshift, srcfmt->Gshift, srcfmt->Bshift, srcfmt->Ashift };
+    const int dst_shifts[4] = { dstfmt->Rshift, dstfmt->Gshift, dstfmt->Bshift, dstfmt->Ashift };
+    int i;
+
+    if (srcfmt->format == dstfmt->format) {
+        return SDL_FALSE;
     }
 
-    /* Remove this format from our list */
-    if (format == formats) {
-        formats = format->next;
-    } else if (formats) {
-        for (prev = formats; prev->next; prev = prev->next) {
-            if (prev->next == format) {
-                prev->next = format->next;
-                break;
+    SDL_memset(swizzle->shuffle, 0x80, sizeof(swizzle->shuffle));
+    swizzle->fill = 0;
+    for (i = 0; i < 4; i++) {
+        if (dst_masks[i]) {
+            if (src_masks[i]) {
+                swizzle->shuffle[BYTE_INDEX(dst_shifts[i])] = (Uint8)BYTE_INDEX(src_shifts[i]);
+            } else {
+                /* Source has no alpha: opaque */
+                ((Uint8 *)&swizzle->fill)[BYTE_INDEX(dst_shifts[i])] = 0xFF;
             }
         }
     }
+    return SDL_TRUE;
+}
+
+#undef BYTE_INDEX
+
+void SDL_SwizzlePixels(const Uint32 *src, Uint32 *dst, int count, const SDL_PixelSwizzle *swizzle)
+{
+    while (count--) {
+        *dst++ = SDL_SwizzlePixel(*src++, swizzle);
+    }
+}
+
+void SDL_DestroyPixelFormat(SDL_PixelFormat *format)
+{
+    if (format == NULL || SDL_IsCachedFormat(format)) {
+        return;
+    }
 
-    SDL_AtomicUnlock(&formats_lock);
+    if (--format->refcount > 0) {
+        return;
+    }
 
     if (format->palette) {
         SDL_DestroyPalette(format->palette);
@@ -659,9 +733,17 @@ void SDL_DestroyPixelFormat(SDL_PixelFormat *format)
     return;
 }
 
+/* The palettes are allocated with the state SDL keeps about them */
+typedef struct SDL_PaletteData
+{
+    SDL_Palette palette;
+    void *cache; /* SDL_PaletteCache, see GetPaletteCacheCells() */
+} SDL_PaletteData;
+
 SDL_Palette *
 SDL_CreatePalette(int ncolors)
 {
+    SDL_PaletteData *data;
     SDL_Palette *palette;
 
     /* Input validation */
@@ -670,15 +752,17 @@ SDL_CreatePalette(int ncolors)
         return NULL;
     }
 
-    palette = (SDL_Palette *)SDL_malloc(sizeof(*palette));
-    if (palette == NULL) {
+    data = (SDL_PaletteData *)SDL_malloc(sizeof(*data));
+    if (data == NULL) {
         SDL_OutOfMemory();
         return NULL;
     }
+    data->cache = NULL;
+    palette = &data->palette;
     palette->colors =
         (SDL_Color *)SDL_malloc(ncolors * sizeof(*palette->colors));
     if (!palette->colors) {
-        SDL_free(palette);
+        SDL_free(data);
         SDL_OutOfMemory();
         return NULL;
     }
@@ -697,7 +781,7 @@ int SDL_SetPixelFormatPalette(SDL_PixelFormat *format, SDL_Palette *palette)
         return SDL_InvalidParamError("SDL_SetPixelFormatPalette(): format");
     }
 
-    if (palette && palette->ncolors > (1 << format->BitsPerPixel)) {
+    if (palette && (palette->ncolors > (1 << format->BitsPerPixel) || SDL_IsCachedFormat(format))) {
         return SDL_SetError("SDL_SetPixelFormatPalette() passed a palette that doesn't match the format");
     }
 
@@ -741,9 +825,55 @@ int SDL_SetPaletteColors(SDL_Palette *palette, const SDL_Color *colors,
         palette->version = 1;
     }
 
+    /* Nothing uses the palette while its colors change, drop the cache of the old ones */
+    SDL_free(SDL_AtomicSetPtr(&((SDL_PaletteData *)palette)->cache, NULL));
+
     return status;
 }
 
+/*
+ * Cache of SDL_FindColor() results for opaque colors, kept with the palette.
+ *
+ * Each cell of a 32x32x32 RGB cube is 0 when unknown, 1 when several palette
+ * colors are the nearest one for different colors in the cell, and the palette
+ * index + 2 when that palette color is the nearest one for the whole cell.
+ *
+ * A cache only ever holds results for the palette version it was created for.
+ * Threads mapping colors to the same palette share the cells without a lock:
+ * a cell only goes from 0 to the one value all the threads compute for it.
+ * SDL_SetPaletteColors() frees the cache, and the next search creates a new
+ * one for the new colors.
+ */
+typedef struct SDL_PaletteCache
+{
+    Uint32 version; /* the palette version of the cells */
+    Uint16 cells[SDL_PALETTE_LUT_SIZE];
+} SDL_PaletteCache;
+
+static Uint16 *GetPaletteCacheCells(SDL_Palette *pal)
+{
+    void **slot = &((SDL_PaletteData *)pal)->cache;
+    SDL_PaletteCache *cache = (SDL_PaletteCache *)SDL_AtomicGetPtr(slot);
+
+    if (cache == NULL) {
+        cache = (SDL_PaletteCache *)SDL_calloc(1, sizeof(*cache));
+        if (cache == NULL) {
+            return NULL;
+        }
+        cache->version = pal->version;
+        if (!SDL_AtomicCASPtr(slot, NULL, cache)) {
+            /* Another thread set it up first */
+            SDL_free(cache);
+            cache = (SDL_PaletteCache *)SDL_AtomicGetPtr(slot);
+        }
+    }
+    if (cache == NULL || cache->version != pal->version) {
+        /* The colors were changed without SDL_SetPaletteColors() */
+        return NULL;
+    }
+    return cache->cells;
+}
+
 void SDL_DestroyPalette(SDL_Palette *palette)
 {
     if (palette == NULL) {
@@ -752,6 +882,7 @@ void SDL_DestroyPalette(SDL_Palette *palette)
     if (--palette->refcount > 0) {
         return;
     }
+    SDL_free(((SDL_PaletteData *)palette)->cache);
     SDL_free(palette->colors);
     SDL_free(palette);
 }
@@ -784,6 +915,37 @@ void SDL_DitherColors(SDL_Color *colors, int bpp)
     }
 }
 
+/* Tell whether palette color 'pixel' is strictly nearer than all the others, for every opaque color of the cell */
+static SDL_bool IsNearestInCell(const SDL_Palette *pal, int pixel, Uint32 cell)
+{
+    const int lo[3] = { (int)((cell >> 10) & 31) << 3, (int)((cell >> 5) & 31) << 3, (int)(cell & 31) << 3 };
+    const SDL_Color *nearest = &pal->colors[pixel];
+    const int na = nearest->a - SDL_ALPHA_OPAQUE;
+    int i, k;
+
+    for (i = 0; i < pal->ncolors; ++i) {
+        const SDL_Color *other = &pal->colors[i];
+        const int n[3] = { nearest->r, nearest->g, nearest->b };
+        const int o[3] = { other->r, other->g, other->b };
+        const int oa = other->a - SDL_ALPHA_OPAQUE;
+        int difference;
+
+        if (i == pixel) {
+            continue;
+        }
+        /* distance(nearest) - distance(other) is linear over the cell, its maximum is on a corner */
+        difference = na * na - oa * oa;
+        for (k = 0; k < 3; ++k) {
+            const int p = (o[k] > n[k]) ? lo[k] + 7 : lo[k];
+            difference += (o[k] - n[k]) * (2 * p - n[k] - o[k]);
+        }
+        if (difference >= 0) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
 /*
  * Match an RGB value to a particular palette index
  */
@@ -795,6 +957,19 @@ Uint8 SDL_FindColor(SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
     int rd, gd, bd, ad;
     int i;
     Uint8 pixel = 0;
+    const Uint32 cell = SDL_PALETTE_LUT_INDEX(r, g, b);
+    Uint16 *cells = NULL;
+
+    if (a == SDL_ALPHA_OPAQUE) {
+        cells = GetPaletteCacheCells(pal);
+        if (cells && cells[cell] > 1) {
+            return (Uint8)(cells[cell] - 2);
+        }
+        if (cells && cells[cell] == 1) {
+            /* Known to need the full search */
+            cells = NULL;
+        }
+    }
 
     smallest = ~0U;
     for (i = 0; i < pal->ncolors; ++i) {
@@ -811,6 +986,10 @@ Uint8 SDL_FindColor(SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
             smallest = distance;
         }
     }
+
+    if (cells && pal->ncolors > 0) {
+        cells[cell] = IsNearestInCell(pal, pixel, cell) ? (Uint16)(pixel + 2) : 1;
+    }
     return pixel;
 }
 
@@ -988,18 +1167,65 @@ static Uint8 *Map1toN(SDL_PixelFormat *src, Uint8 Rmod, Uint8 Gmod, Uint8 Bmod,
     return map;
 }
 
-/* Map from BitField to Dithered-Palette to Palette */
+/* Map from BitField to Palette, through a nearest color lookup table */
 static Uint8 *MapNto1(SDL_PixelFormat *src, SDL_PixelFormat *dst, int *identical)
 {
-    /* Generate a 256 color dither palette */
-    SDL_Palette dithered;
     SDL_Color colors[256];
     SDL_Palette *pal = dst->palette;
+    Uint8 *lut;
+    Uint32 *best;
+    int i, r, g, b;
 
-    dithered.ncolors = 256;
+    /* The 3-3-2 dither palette needs no table, the blitters pack the bits */
     SDL_DitherColors(colors, 8);
-    dithered.colors = colors;
-    return Map1to1(&dithered, pal, identical);
+    if (pal->ncolors >= 256 && SDL_memcmp(pal->colors, colors, sizeof(colors)) == 0) {
+        *identical = 1;
+        return NULL;
+    }
+    *identical = 0;
+
+    lut = (Uint8 *)SDL_calloc(SDL_PALETTE_LUT_SIZE, sizeof(Uint8));
+    best = (Uint32 *)SDL_malloc(SDL_PALETTE_LUT_SIZE * sizeof(Uint32));
+    if (lut == NULL || best == NULL) {
+        SDL_free(lut);
+        SDL_free(best);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_memset(best, 0xFF, SDL_PALETTE_LUT_SIZE * sizeof(Uint32));
+
+    /* Same distance as SDL_FindColor() for an opaque color at the center of each cell,
+       accumulated one palette color at a time so that the inner loop stays simple */
+    for (i = 0; i < pal->ncolors; ++i) {
+        const SDL_Color *color = &pal->colors[i];
+        const int ad = color->a - SDL_ALPHA_OPAQUE;
+        Uint32 dr[32], dg[32], db[32];
+        Uint32 *cell = best;
+        Uint8 *entry = lut;
+
+        for (r = 0; r < 32; ++r) {
+            const int center = (r << 3) | 4;
+            dr[r] = (Uint32)((center - color->r) * (center - color->r) + ad * ad);
+            dg[r] = (Uint32)((center - color->g) * (center - color->g));
+            db[r] = (Uint32)((center - color->b) * (center - color->b));
+        }
+        for (r = 0; r < 32; ++r) {
+            for (g = 0; g < 32; ++g) {
+                const Uint32 rg = dr[r] + dg[g];
+                for (b = 0; b < 32; ++b) {
+                    const Uint32 distance = rg + db[b];
+                    if (distance < cell[b]) {
+                        cell[b] = distance;
+                        entry[b] = (Uint8)i;
+                    }
+                }
+                cell += 32;
+                entry += 32;
+            }
+        }
+    }
+    SDL_free(best);
+    return lut;
 }
 
 SDL_BlitMap *
@@ -32,6 +32,31 @@
 extern int SDL_InitFormat(SDL_PixelFormat *format, Uint32 pixel_format);
 extern int SDL_CalculateSize(Uint32 format, int width, int height, size_t *size, size_t *pitch, SDL_bool minimalPitch);
 
+/* Conversion between 32 bits formats with 8 bits channels, as a byte shuffle:
+   destination byte i is source byte shuffle[i] (0 when shuffle[i] is 0x80), OR-ed with 'fill'. */
+typedef struct SDL_PixelSwizzle
+{
+    Uint8 shuffle[4];
+    Uint32 fill;
+} SDL_PixelSwizzle;
+
+extern SDL_bool SDL_Is8888Format(Uint32 format);
+extern SDL_bool SDL_GetPixelSwizzle(const SDL_PixelFormat *srcfmt, const SDL_PixelFormat *dstfmt, SDL_PixelSwizzle *swizzle);
+extern void SDL_SwizzlePixels(const Uint32 *src, Uint32 *dst, int count, const SDL_PixelSwizzle *swizzle);
+
+static SDL_INLINE Uint32 SDL_SwizzlePixel(Uint32 pixel, const SDL_PixelSwizzle *swizzle)
+{
+    Uint8 src[4], dst[4];
+    int i;
+
+    SDL_memcpy(src, &pixel, sizeof(src));
+    for (i = 0; i < 4; i++) {
+        dst[i] = (swizzle->shuffle[i] & 0x80) ? 0 : src[swizzle->shuffle[i]];
+    }
+    SDL_memcpy(&pixel, dst, sizeof(dst));
+    return pixel | swizzle->fill;
+}
+
 /* Blit mapping functions */
 extern SDL_BlitMap *SDL_AllocBlitMap(void);
 extern void SDL_InvalidateMap(SDL_BlitMap *map);
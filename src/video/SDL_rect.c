@@ -79,6 +79,63 @@ SDL_GetSpanEnclosingRect(int width, int height,
     return SDL_FALSE;
 }
 
+void SDL_ClearRegion(SDL_Region *region)
+{
+    region->numrects = 0;
+}
+
+static Sint64 SDL_GetRectArea(const SDL_Rect *rect)
+{
+    return (Sint64)rect->w * rect->h;
+}
+
+void SDL_AddRectToRegion(SDL_Region *region, const SDL_Rect *rect)
+{
+    SDL_Rect added, merged;
+    int i, best;
+    Sint64 waste, best_waste;
+
+    if (SDL_RectEmpty(rect)) {
+        return;
+    }
+    added = *rect;
+
+    for (;;) {
+        /* Merge with the rectangles whose union with it is no larger than
+           the two of them, which includes the ones it contains or is
+           contained in, then start over as it grew */
+        i = 0;
+        while (i < region->numrects) {
+            SDL_GetRectUnion(&region->rects[i], &added, &merged);
+            if (SDL_GetRectArea(&merged) <= SDL_GetRectArea(&region->rects[i]) + SDL_GetRectArea(&added)) {
+                added = merged;
+                region->rects[i] = region->rects[--region->numrects];
+                i = 0;
+            } else {
+                ++i;
+            }
+        }
+        if (region->numrects < SDL_REGION_MAX_RECTS) {
+            break;
+        }
+
+        /* Full, merge with the rectangle that wastes the least space */
+        best = 0;
+        best_waste = 0;
+        for (i = 0; i < region->numrects; ++i) {
+            SDL_GetRectUnion(&region->rects[i], &added, &merged);
+            waste = SDL_GetRectArea(&merged) - SDL_GetRectArea(&region->rects[i]) - SDL_GetRectArea(&added);
+            if (i == 0 || waste < best_waste) {
+                best = i;
+                best_waste = waste;
+            }
+        }
+        SDL_GetRectUnion(&region->rects[best], &added, &added);
+        region->rects[best] = region->rects[--region->numrects];
+    }
+    region->rects[region->numrects++] = added;
+}
+
 /* For use with the Cohen-Sutherland algorithm for line clipping, in SDL_rect_impl.h */
 #define CODE_BOTTOM 1
 #define CODE_TOP    2
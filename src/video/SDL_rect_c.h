@@ -26,4 +26,17 @@
 
 extern SDL_bool SDL_GetSpanEnclosingRect(int width, int height, int numrects, const SDL_Rect *rects, SDL_Rect *span);
 
+/* A set of rectangles covering an area, kept short by merging rectangles
+   when they overlap or when their union doesn't waste much space */
+#define SDL_REGION_MAX_RECTS 16
+
+typedef struct SDL_Region
+{
+    int numrects;
+    SDL_Rect rects[SDL_REGION_MAX_RECTS];
+} SDL_Region;
+
+extern void SDL_ClearRegion(SDL_Region *region);
+extern void SDL_AddRectToRegion(SDL_Region *region, const SDL_Rect *rect);
+
 #endif /* SDL_rect_c_h_ */
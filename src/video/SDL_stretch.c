@@ -21,9 +21,11 @@
 #include "SDL_internal.h"
 
 #include "SDL_blit.h"
+#include "SDL_pixels_c.h"
 
 static int SDL_LowerSoftStretchNearest(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
 static int SDL_LowerSoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
+static int SDL_LowerSoftStretchArea(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect);
 static int SDL_UpperSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
 
 int SDL_SoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
@@ -38,6 +40,52 @@ int SDL_SoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect,
     return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, SDL_SCALEMODE_LINEAR);
 }
 
+int SDL_SoftStretchArea(SDL_Surface *src, const SDL_Rect *srcrect,
+                        SDL_Surface *dst, const SDL_Rect *dstrect)
+{
+    return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, SDL_SCALEMODE_BEST);
+}
+
+/* SDL_SCALEMODE_BEST uses area averaging when shrinking and bilinear filtering otherwise */
+int SDL_PrivateSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
+                           SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode)
+{
+    if (scaleMode == SDL_SCALEMODE_BEST) {
+        int src_w = srcrect ? srcrect->w : src->w;
+        int src_h = srcrect ? srcrect->h : src->h;
+        int dst_w = dstrect ? dstrect->w : dst->w;
+        int dst_h = dstrect ? dstrect->h : dst->h;
+        if (dst_w >= src_w && dst_h >= src_h) {
+            scaleMode = SDL_SCALEMODE_LINEAR;
+        }
+    }
+    return SDL_UpperSoftStretch(src, srcrect, dst, dstrect, scaleMode);
+}
+
+SDL_bool SDL_IsSoftStretchFilterable(Uint32 format)
+{
+    if (SDL_ISPIXELFORMAT_INDEXED(format) || SDL_ISPIXELFORMAT_FOURCC(format)) {
+        return SDL_FALSE;
+    }
+    if (SDL_BYTESPERPIXEL(format) < 2 || format == SDL_PIXELFORMAT_ARGB2101010) {
+        /* Filtering works on channels of at most 8 bits */
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Filtered scaling converts on the fly between 32 bits formats with 8 bits channels */
+SDL_bool SDL_IsSoftStretchConvertible(Uint32 src_format, Uint32 dst_format)
+{
+    if (!SDL_IsSoftStretchFilterable(src_format) || !SDL_IsSoftStretchFilterable(dst_format)) {
+        return SDL_FALSE;
+    }
+    if (src_format == dst_format) {
+        return SDL_TRUE;
+    }
+    return (SDL_Is8888Format(src_format) && SDL_Is8888Format(dst_format));
+}
+
 static int SDL_UpperSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
                                 SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode)
 {
@@ -47,14 +95,17 @@ static int SDL_UpperSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
     SDL_Rect full_src;
     SDL_Rect full_dst;
 
-    if (src->format->format != dst->format->format) {
-        return SDL_SetError("Only works with same format surfaces");
-    }
-
-    if (scaleMode != SDL_SCALEMODE_NEAREST) {
-        if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+    if (scaleMode == SDL_SCALEMODE_NEAREST) {
+        if (src->format->format != dst->format->format) {
+            return SDL_SetError("Only works with same format surfaces");
+        }
+    } else {
+        if (!SDL_IsSoftStretchFilterable(src->format->format)) {
             return SDL_SetError("Wrong format");
         }
+        if (!SDL_IsSoftStretchConvertible(src->format->format, dst->format->format)) {
+            return SDL_SetError("Only works with same format surfaces, or 32 bits formats with 8 bits channels");
+        }
     }
 
     /* Verify the blit rectangles */
@@ -94,6 +145,8 @@ static int SDL_UpperSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
         return SDL_SetError("Size too large for scaling");
     }
 
+    SDL_AddSurfaceDamage(dst, dstrect);
+
     /* Lock the destination if it's in hardware */
     dst_locked = 0;
     if (SDL_MUSTLOCK(dst)) {
@@ -116,8 +169,10 @@ static int SDL_UpperSoftStretch(SDL_Surface *src, const SDL_Rect *srcrect,
 
     if (scaleMode == SDL_SCALEMODE_NEAREST) {
         ret = SDL_LowerSoftStretchNearest(src, srcrect, dst, dstrect);
-    } else {
+    } else if (scaleMode == SDL_SCALEMODE_LINEAR) {
         ret = SDL_LowerSoftStretchLinear(src, srcrect, dst, dstrect);
+    } else {
+        ret = SDL_LowerSoftStretchArea(src, srcrect, dst, dstrect);
     }
 
     /* We need to unlock the surfaces if they're locked */
@@ -284,7 +339,7 @@ static SDL_INLINE void INTERPOL_BILINEAR(const Uint32 *s0, const Uint32 *s1, int
 }
 
 static int scale_mat(const Uint32 *src, int src_w, int src_h, int src_pitch,
-                     Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+                     Uint32 *dst, int dst_w, int dst_h, int dst_pitch, const SDL_PixelSwizzle *swizzle)
 {
     BILINEAR___START
 
@@ -327,11 +382,99 @@ static int scale_mat(const Uint32 *src, int src_w, int src_h, int src_pitch,
             INTERPOL_BILINEAR(s_00_01, s_10_11, FRAC_ONE, frac_h0, frac_h1, dst);
             dst += 1;
         }
+        if (swizzle) {
+            SDL_SwizzlePixels(dst - dst_w, dst - dst_w, dst_w, swizzle);
+        }
         dst = (Uint32 *)((Uint8 *)dst + dst_gap);
     }
     return 0;
 }
 
+/* 16 and 24 bits formats: channels are unpacked to one byte each, interpolated, then packed again.
+   16 bits channels keep their native depth, so no precision is lost in the round-trip. */
+static SDL_INLINE void UNPACK_PIXEL(const Uint8 *src, int bpp, const SDL_PixelFormat *fmt, Uint32 *dst)
+{
+    color_t *c = (color_t *)dst;
+    if (bpp == 3) {
+        c->a = src[0];
+        c->b = src[1];
+        c->c = src[2];
+        c->d = 0;
+    } else {
+        Uint32 pixel = *(const Uint16 *)src;
+        c->a = (Uint8)((pixel & fmt->Rmask) >> fmt->Rshift);
+        c->b = (Uint8)((pixel & fmt->Gmask) >> fmt->Gshift);
+        c->c = (Uint8)((pixel & fmt->Bmask) >> fmt->Bshift);
+        c->d = (Uint8)((pixel & fmt->Amask) >> fmt->Ashift);
+    }
+}
+
+static SDL_INLINE void PACK_PIXEL(const Uint32 *src, int bpp, const SDL_PixelFormat *fmt, Uint8 *dst)
+{
+    const color_t *c = (const color_t *)src;
+    if (bpp == 3) {
+        dst[0] = c->a;
+        dst[1] = c->b;
+        dst[2] = c->c;
+    } else {
+        *(Uint16 *)dst = (Uint16)((((Uint32)c->a << fmt->Rshift) & fmt->Rmask) |
+                                  (((Uint32)c->b << fmt->Gshift) & fmt->Gmask) |
+                                  (((Uint32)c->c << fmt->Bshift) & fmt->Bmask) |
+                                  (((Uint32)c->d << fmt->Ashift) & fmt->Amask));
+    }
+}
+
+static SDL_INLINE void INTERPOL_BILINEAR_PACKED(const Uint8 *s0, const Uint8 *s1, int bpp, const SDL_PixelFormat *fmt,
+                                                int frac_w0, int frac_h0, int frac_h1, Uint8 *dst)
+{
+    Uint32 x0[2], x1[2], tmp;
+
+    UNPACK_PIXEL(s0, bpp, fmt, x0);
+    UNPACK_PIXEL(s0 + bpp, bpp, fmt, x0 + 1);
+    UNPACK_PIXEL(s1, bpp, fmt, x1);
+    UNPACK_PIXEL(s1 + bpp, bpp, fmt, x1 + 1);
+    INTERPOL_BILINEAR(x0, x1, frac_w0, frac_h0, frac_h1, &tmp);
+    PACK_PIXEL(&tmp, bpp, fmt, dst);
+}
+
+static int scale_mat_packed(const Uint32 *src, int src_w, int src_h, int src_pitch,
+                            Uint32 *dst_ptr, int dst_w, int dst_h, int dst_pitch,
+                            int bpp, const SDL_PixelFormat *fmt)
+{
+    Uint8 *dst = (Uint8 *)dst_ptr;
+
+    BILINEAR___START
+
+    dst_gap = dst_pitch - bpp * dst_w;
+
+    for (i = 0; i < dst_h; i++) {
+
+        BILINEAR___HEIGHT
+
+        while (left_pad_w--) {
+            INTERPOL_BILINEAR_PACKED((const Uint8 *)src_h0, (const Uint8 *)src_h1, bpp, fmt, FRAC_ZERO, frac_h0, frac_h1, dst);
+            dst += bpp;
+        }
+
+        while (middle--) {
+            int index_w = bpp * SRC_INDEX(fp_sum_w);
+            int frac_w = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+
+            INTERPOL_BILINEAR_PACKED((const Uint8 *)src_h0 + index_w, (const Uint8 *)src_h1 + index_w, bpp, fmt, frac_w, frac_h0, frac_h1, dst);
+            dst += bpp;
+        }
+
+        while (right_pad_w--) {
+            int index_w = bpp * (src_w - 2);
+            INTERPOL_BILINEAR_PACKED((const Uint8 *)src_h0 + index_w, (const Uint8 *)src_h1 + index_w, bpp, fmt, FRAC_ONE, frac_h0, frac_h1, dst);
+            dst += bpp;
+        }
+        dst += dst_gap;
+    }
+    return 0;
+}
+
 #ifdef SDL_NEON_INTRINSICS
 #define CAST_uint8x8_t       (uint8x8_t)
 #define CAST_uint32x2_t      (uint32x2_t)
@@ -404,7 +547,7 @@ static SDL_INLINE void SDL_TARGETING("sse2") INTERPOL_BILINEAR_SSE(const Uint32
     *dst = _mm_cvtsi128_si32(e0);
 }
 
-static int SDL_TARGETING("sse2") scale_mat_SSE(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+static int SDL_TARGETING("sse2") scale_mat_SSE(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch, const SDL_PixelSwizzle *swizzle)
 {
     BILINEAR___START
 
@@ -518,6 +661,157 @@ static int SDL_TARGETING("sse2") scale_mat_SSE(const Uint32 *src, int src_w, int
             INTERPOL_BILINEAR_SSE(s_00_01, s_10_11, FRAC_ONE, v_frac_h0, v_frac_h1, dst, zero);
             dst += 1;
         }
+        if (swizzle) {
+            SDL_SwizzlePixels(dst - dst_w, dst - dst_w, dst_w, swizzle);
+        }
+        dst = (Uint32 *)((Uint8 *)dst + dst_gap);
+    }
+    return 0;
+}
+#endif
+
+#if defined(SDL_AVX2_INTRINSICS) && defined(SDL_SSE2_INTRINSICS)
+
+static SDL_INLINE int hasAVX2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasAVX2();
+    return val;
+}
+
+static SDL_INLINE void SDL_TARGETING("avx2") INTERPOL_BILINEAR_AVX2(const Uint32 *s0, const Uint32 *s1, int frac_w, __m128i v_frac_h0, __m128i v_frac_h1, Uint32 *dst, __m128i zero, const SDL_PixelSwizzle *swizzle)
+{
+    INTERPOL_BILINEAR_SSE(s0, s1, frac_w, v_frac_h0, v_frac_h1, dst, zero);
+    if (swizzle) {
+        *dst = SDL_SwizzlePixel(*dst, swizzle);
+    }
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2") LOAD_PAIRS_AVX2(const Uint32 *s0, const Uint32 *s1, const Uint32 *s2, const Uint32 *s3)
+{
+    /* Lane 0: pairs for pixels 0 and 1, lane 1: pairs for pixels 2 and 3 */
+    __m128i x_01 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)s0), _mm_loadl_epi64((const __m128i *)s1));
+    __m128i x_23 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)s2), _mm_loadl_epi64((const __m128i *)s3));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(x_01), x_23, 1);
+}
+
+static int SDL_TARGETING("avx2") scale_mat_AVX2(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch, const SDL_PixelSwizzle *swizzle)
+{
+    __m128i v_shuffle = _mm_setzero_si128();
+    __m128i v_fill = _mm_setzero_si128();
+
+    BILINEAR___START
+
+    if (swizzle) {
+        Uint32 shuffle;
+        SDL_memcpy(&shuffle, swizzle->shuffle, sizeof(shuffle));
+        /* Same shuffle for the 4 pixels, offset to each pixel. Unused bytes (0x80) stay zeroed. */
+        v_shuffle = _mm_add_epi8(_mm_set1_epi32((int)shuffle), _mm_set_epi32(0x0c0c0c0c, 0x08080808, 0x04040404, 0));
+        v_fill = _mm_set1_epi32((int)swizzle->fill);
+    }
+
+    for (i = 0; i < dst_h; i++) {
+        int nb_block4;
+        __m256i v_frac_h0;
+        __m256i v_frac_h1;
+        __m256i zero;
+
+        BILINEAR___HEIGHT
+
+        nb_block4 = middle / 4;
+
+        v_frac_h0 = _mm256_set1_epi16((short)frac_h0);
+        v_frac_h1 = _mm256_set1_epi16((short)frac_h1);
+        zero = _mm256_setzero_si256();
+
+        while (left_pad_w--) {
+            INTERPOL_BILINEAR_AVX2(src_h0, src_h1, FRAC_ZERO, _mm256_castsi256_si128(v_frac_h0), _mm256_castsi256_si128(v_frac_h1), dst, _mm256_castsi256_si128(zero), swizzle);
+            dst += 1;
+        }
+
+        while (nb_block4--) {
+            int index_w_0, frac_w_0;
+            int index_w_1, frac_w_1;
+            int index_w_2, frac_w_2;
+            int index_w_3, frac_w_3;
+            __m256i x_0, x_1; /* Pairs of pixels in 4*uint8, in rows h0 and h1 */
+            __m256i k_02, k_13, v_frac_w_02, v_frac_w_13;
+            __m128i e0;
+
+            index_w_0 = SRC_INDEX(fp_sum_w);
+            frac_w_0 = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+            index_w_1 = SRC_INDEX(fp_sum_w);
+            frac_w_1 = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+            index_w_2 = SRC_INDEX(fp_sum_w);
+            frac_w_2 = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+            index_w_3 = SRC_INDEX(fp_sum_w);
+            frac_w_3 = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+
+            x_0 = LOAD_PAIRS_AVX2(src_h0 + index_w_0, src_h0 + index_w_1, src_h0 + index_w_2, src_h0 + index_w_3);
+            x_1 = LOAD_PAIRS_AVX2(src_h1 + index_w_0, src_h1 + index_w_1, src_h1 + index_w_2, src_h1 + index_w_3);
+
+            /* Interpolation vertical: { j0, j2 } and { j1, j3 }, with x0 and x1 of each pair in 16 bits */
+            k_02 = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(x_0, zero), v_frac_h1),
+                                    _mm256_mullo_epi16(_mm256_unpacklo_epi8(x_1, zero), v_frac_h0));
+            k_13 = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(x_0, zero), v_frac_h1),
+                                    _mm256_mullo_epi16(_mm256_unpackhi_epi8(x_1, zero), v_frac_h0));
+
+            /* Interpolation horizontal: interleave x0 and x1 channels, then multiply-add with (1 - frac, frac) */
+            v_frac_w_02 = _mm256_set_epi32(
+                (frac_w_2 << 16) | (FRAC_ONE - frac_w_2), (frac_w_2 << 16) | (FRAC_ONE - frac_w_2),
+                (frac_w_2 << 16) | (FRAC_ONE - frac_w_2), (frac_w_2 << 16) | (FRAC_ONE - frac_w_2),
+                (frac_w_0 << 16) | (FRAC_ONE - frac_w_0), (frac_w_0 << 16) | (FRAC_ONE - frac_w_0),
+                (frac_w_0 << 16) | (FRAC_ONE - frac_w_0), (frac_w_0 << 16) | (FRAC_ONE - frac_w_0));
+            v_frac_w_13 = _mm256_set_epi32(
+                (frac_w_3 << 16) | (FRAC_ONE - frac_w_3), (frac_w_3 << 16) | (FRAC_ONE - frac_w_3),
+                (frac_w_3 << 16) | (FRAC_ONE - frac_w_3), (frac_w_3 << 16) | (FRAC_ONE - frac_w_3),
+                (frac_w_1 << 16) | (FRAC_ONE - frac_w_1), (frac_w_1 << 16) | (FRAC_ONE - frac_w_1),
+                (frac_w_1 << 16) | (FRAC_ONE - frac_w_1), (frac_w_1 << 16) | (FRAC_ONE - frac_w_1));
+            k_02 = _mm256_madd_epi16(_mm256_unpacklo_epi16(k_02, _mm256_unpackhi_epi64(k_02, k_02)), v_frac_w_02);
+            k_13 = _mm256_madd_epi16(_mm256_unpacklo_epi16(k_13, _mm256_unpackhi_epi64(k_13, k_13)), v_frac_w_13);
+
+            /* Shift and narrow: { j0, j1 } in lane 0 and { j2, j3 } in lane 1 */
+            k_02 = _mm256_packs_epi32(_mm256_srli_epi32(k_02, PRECISION * 2), _mm256_srli_epi32(k_13, PRECISION * 2));
+            k_02 = _mm256_packus_epi16(k_02, k_02);
+            e0 = _mm256_castsi256_si128(_mm256_permute4x64_epi64(k_02, 0x08));
+
+            if (swizzle) {
+                e0 = _mm_or_si128(_mm_shuffle_epi8(e0, v_shuffle), v_fill);
+            }
+
+            /* Store 4 pixels */
+            _mm_storeu_si128((__m128i *)dst, e0);
+            dst += 4;
+        }
+
+        /* Last points */
+        middle &= 0x3;
+        while (middle--) {
+            const Uint32 *s_00_01;
+            const Uint32 *s_10_11;
+            int index_w = 4 * SRC_INDEX(fp_sum_w);
+            int frac_w = FRAC(fp_sum_w);
+            fp_sum_w += fp_step_w;
+            s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            INTERPOL_BILINEAR_AVX2(s_00_01, s_10_11, frac_w, _mm256_castsi256_si128(v_frac_h0), _mm256_castsi256_si128(v_frac_h1), dst, _mm256_castsi256_si128(zero), swizzle);
+            dst += 1;
+        }
+
+        while (right_pad_w--) {
+            int index_w = 4 * (src_w - 2);
+            const Uint32 *s_00_01 = (const Uint32 *)((const Uint8 *)src_h0 + index_w);
+            const Uint32 *s_10_11 = (const Uint32 *)((const Uint8 *)src_h1 + index_w);
+            INTERPOL_BILINEAR_AVX2(s_00_01, s_10_11, FRAC_ONE, _mm256_castsi256_si128(v_frac_h0), _mm256_castsi256_si128(v_frac_h1), dst, _mm256_castsi256_si128(zero), swizzle);
+            dst += 1;
+        }
         dst = (Uint32 *)((Uint8 *)dst + dst_gap);
     }
     return 0;
@@ -569,7 +863,7 @@ static SDL_INLINE void INTERPOL_BILINEAR_NEON(const Uint32 *s0, const Uint32 *s1
 }
 
 static int
-scale_mat_NEON(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch)
+scale_mat_NEON(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *dst, int dst_w, int dst_h, int dst_pitch, const SDL_PixelSwizzle *swizzle)
 {
     BILINEAR___START
 
@@ -781,6 +1075,9 @@ scale_mat_NEON(const Uint32 *src, int src_w, int src_h, int src_pitch, Uint32 *d
             dst += 1;
         }
 
+        if (swizzle) {
+            SDL_SwizzlePixels(dst - dst_w, dst - dst_w, dst_w, swizzle);
+        }
         dst = (Uint32 *)((Uint8 *)dst + dst_gap);
     }
     return 0;
@@ -797,25 +1094,294 @@ int SDL_LowerSoftStretchLinear(SDL_Surface *s, const SDL_Rect *srcrect,
     int dst_h = dstrect->h;
     int src_pitch = s->pitch;
     int dst_pitch = d->pitch;
-    Uint32 *src = (Uint32 *)((Uint8 *)s->pixels + srcrect->x * 4 + srcrect->y * src_pitch);
-    Uint32 *dst = (Uint32 *)((Uint8 *)d->pixels + dstrect->x * 4 + dstrect->y * dst_pitch);
+    const int bpp = d->format->BytesPerPixel;
+    Uint32 *src = (Uint32 *)((Uint8 *)s->pixels + srcrect->x * bpp + srcrect->y * src_pitch);
+    Uint32 *dst = (Uint32 *)((Uint8 *)d->pixels + dstrect->x * bpp + dstrect->y * dst_pitch);
+
+    SDL_PixelSwizzle swizzle_data;
+    const SDL_PixelSwizzle *swizzle = NULL;
+
+    if (bpp != 4) {
+        return scale_mat_packed(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch, bpp, d->format);
+    }
+
+    if (SDL_GetPixelSwizzle(s->format, d->format, &swizzle_data)) {
+        swizzle = &swizzle_data;
+    }
 
 #ifdef SDL_NEON_INTRINSICS
     if (ret == -1 && hasNEON()) {
-        ret = scale_mat_NEON(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        ret = scale_mat_NEON(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch, swizzle);
+    }
+#endif
+
+#if defined(SDL_AVX2_INTRINSICS) && defined(SDL_SSE2_INTRINSICS)
+    if (ret == -1 && hasAVX2()) {
+        ret = scale_mat_AVX2(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch, swizzle);
     }
 #endif
 
 #ifdef SDL_SSE2_INTRINSICS
     if (ret == -1 && hasSSE2()) {
-        ret = scale_mat_SSE(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        ret = scale_mat_SSE(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch, swizzle);
     }
 #endif
 
     if (ret == -1) {
-        ret = scale_mat(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch);
+        ret = scale_mat(src, src_w, src_h, src_pitch, dst, dst_w, dst_h, dst_pitch, swizzle);
+    }
+
+    return ret;
+}
+
+/* Area averaging (box filter).
+ *
+ * Each destination pixel is the average of the source area it covers, with partially covered
+ * source pixels weighted by their coverage, so any ratio is handled in a single pass.
+ * Weights of a destination pixel always sum to AREA_ONE:
+ * - horizontal pass: 255 * AREA_ONE fits in an unsigned 16 bits lane,
+ * - vertical pass:   255 * AREA_ONE * AREA_ONE fits in an unsigned 32 bits lane.
+ */
+#define AREA_PRECISION 8
+#define AREA_ONE       (1 << AREA_PRECISION)
+#define AREA_ROUND     (1 << (2 * AREA_PRECISION - 1))
+
+static void get_area_weights(int src_nb, int dst_nb, int *first, int *count, Uint16 *weights)
+{
+    /* In units of 1/dst_nb source pixel, destination pixel i covers [i * src_nb, (i + 1) * src_nb)
+       and source pixel j covers [j * dst_nb, (j + 1) * dst_nb) */
+    int i, n = 0;
+    for (i = 0; i < dst_nb; i++) {
+        Sint64 start = (Sint64)i * src_nb;
+        Sint64 end = start + src_nb;
+        int j = (int)(start / dst_nb);
+        int covered = 0;
+        int prev = 0;
+
+        first[i] = j;
+        count[i] = 0;
+        while ((Sint64)j * dst_nb < end) {
+            Sint64 s0 = SDL_max(start, (Sint64)j * dst_nb);
+            Sint64 s1 = SDL_min(end, (Sint64)(j + 1) * dst_nb);
+            int w;
+            covered += (int)(s1 - s0);
+            /* Round the cumulated coverage, so that the weights sum to exactly AREA_ONE */
+            w = (covered * AREA_ONE + src_nb / 2) / src_nb;
+            weights[n++] = (Uint16)(w - prev);
+            prev = w;
+            count[i] += 1;
+            j++;
+        }
+    }
+}
+
+/* Horizontal pass: reduce one source row to 'dst_w' pixels, 4 x 16 bits per pixel */
+static void area_hpass(const Uint32 *src, int dst_w, const int *first, const int *count, const Uint16 *weights, Uint16 *dst)
+{
+    int x, k;
+    for (x = 0; x < dst_w; x++) {
+        const color_t *c = (const color_t *)(src + first[x]);
+        Uint32 a = 0, b = 0, cc = 0, d = 0;
+        for (k = 0; k < count[x]; k++) {
+            Uint32 w = *weights++;
+            a += w * c->a;
+            b += w * c->b;
+            cc += w * c->c;
+            d += w * c->d;
+            c++;
+        }
+        dst[0] = (Uint16)a;
+        dst[1] = (Uint16)b;
+        dst[2] = (Uint16)cc;
+        dst[3] = (Uint16)d;
+        dst += 4;
+    }
+}
+
+/* Vertical pass: accumulate one reduced row, weighted */
+static void area_vpass(const Uint16 *src, int n, Uint32 weight, Uint32 *acc)
+{
+    while (n--) {
+        *acc++ += weight * *src++;
+    }
+}
+
+static void area_store(const Uint32 *acc, int dst_w, Uint32 *dst)
+{
+    Uint8 *d = (Uint8 *)dst;
+    int n = 4 * dst_w;
+    while (n--) {
+        *d++ = (Uint8)((*acc++ + AREA_ROUND) >> (2 * AREA_PRECISION));
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static void SDL_TARGETING("sse2") area_hpass_SSE(const Uint32 *src, int dst_w, const int *first, const int *count, const Uint16 *weights, Uint16 *dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x;
+    for (x = 0; x < dst_w; x++) {
+        const Uint32 *s = src + first[x];
+        int n = count[x];
+        __m128i sum = _mm_setzero_si128();
+
+        /* 2 source pixels per iteration: lanes 0-3 and 4-7 */
+        while (n >= 2) {
+            __m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)s), zero);
+            __m128i w = _mm_unpacklo_epi64(_mm_set1_epi16((short)weights[0]), _mm_set1_epi16((short)weights[1]));
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(p, w));
+            s += 2;
+            weights += 2;
+            n -= 2;
+        }
+        if (n) {
+            __m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*s), zero);
+            sum = _mm_add_epi16(sum, _mm_mullo_epi16(p, _mm_set1_epi16((short)weights[0])));
+            weights += 1;
+        }
+        sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+        _mm_storel_epi64((__m128i *)dst, sum);
+        dst += 4;
+    }
+}
+
+static void SDL_TARGETING("sse2") area_vpass_SSE(const Uint16 *src, int n, Uint32 weight, Uint32 *acc)
+{
+    const __m128i w = _mm_set1_epi16((short)weight);
+
+    /* 8 lanes (2 pixels) per iteration */
+    while (n >= 8) {
+        __m128i h = _mm_loadu_si128((const __m128i *)src);
+        __m128i lo = _mm_mullo_epi16(h, w);
+        __m128i hi = _mm_mulhi_epu16(h, w);
+        __m128i a0 = _mm_loadu_si128((const __m128i *)acc);
+        __m128i a1 = _mm_loadu_si128((const __m128i *)(acc + 4));
+        a0 = _mm_add_epi32(a0, _mm_unpacklo_epi16(lo, hi));
+        a1 = _mm_add_epi32(a1, _mm_unpackhi_epi16(lo, hi));
+        _mm_storeu_si128((__m128i *)acc, a0);
+        _mm_storeu_si128((__m128i *)(acc + 4), a1);
+        src += 8;
+        acc += 8;
+        n -= 8;
+    }
+    area_vpass(src, n, weight, acc);
+}
+
+static void SDL_TARGETING("sse2") area_store_SSE(const Uint32 *acc, int dst_w, Uint32 *dst)
+{
+    const __m128i round = _mm_set1_epi32(AREA_ROUND);
+
+    /* 2 pixels per iteration */
+    while (dst_w >= 2) {
+        __m128i a0 = _mm_loadu_si128((const __m128i *)acc);
+        __m128i a1 = _mm_loadu_si128((const __m128i *)(acc + 4));
+        a0 = _mm_srli_epi32(_mm_add_epi32(a0, round), 2 * AREA_PRECISION);
+        a1 = _mm_srli_epi32(_mm_add_epi32(a1, round), 2 * AREA_PRECISION);
+        a0 = _mm_packs_epi32(a0, a1);
+        a0 = _mm_packus_epi16(a0, a0);
+        _mm_storel_epi64((__m128i *)dst, a0);
+        acc += 8;
+        dst += 2;
+        dst_w -= 2;
+    }
+    area_store(acc, dst_w, dst);
+}
+#endif
+
+static int SDL_LowerSoftStretchArea(SDL_Surface *s, const SDL_Rect *srcrect,
+                                    SDL_Surface *d, const SDL_Rect *dstrect)
+{
+    int ret = 0;
+    int i, k, y;
+    int src_w = srcrect->w;
+    int src_h = srcrect->h;
+    int dst_w = dstrect->w;
+    int dst_h = dstrect->h;
+    int src_pitch = s->pitch;
+    int dst_pitch = d->pitch;
+    const int bpp = d->format->BytesPerPixel;
+    const Uint8 *src = (const Uint8 *)s->pixels + srcrect->x * bpp + srcrect->y * src_pitch;
+    Uint8 *dst = (Uint8 *)d->pixels + dstrect->x * bpp + dstrect->y * dst_pitch;
+    int *first_w, *count_w, *first_h, *count_h;
+    Uint16 *weights_w, *weights_h, *hrow;
+    Uint32 *acc, *line = NULL;
+    void (*hpass)(const Uint32 *, int, const int *, const int *, const Uint16 *, Uint16 *) = area_hpass;
+    void (*vpass)(const Uint16 *, int, Uint32, Uint32 *) = area_vpass;
+    void (*store)(const Uint32 *, int, Uint32 *) = area_store;
+    SDL_PixelSwizzle swizzle_data;
+    const SDL_PixelSwizzle *swizzle = NULL;
+
+    if (SDL_GetPixelSwizzle(s->format, d->format, &swizzle_data)) {
+        swizzle = &swizzle_data;
+    }
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (hasSSE2()) {
+        hpass = area_hpass_SSE;
+        vpass = area_vpass_SSE;
+        store = area_store_SSE;
+    }
+#endif
+
+    first_w = (int *)SDL_malloc(2 * (dst_w + dst_h) * sizeof(int));
+    /* Horizontal weights, reduced row, vertical weights: an axis has at most src + dst weights */
+    weights_w = (Uint16 *)SDL_malloc(((src_w + dst_w) + 4 * dst_w + (src_h + dst_h)) * sizeof(Uint16));
+    acc = (Uint32 *)SDL_malloc(4 * dst_w * sizeof(Uint32));
+    if (bpp != 4) {
+        line = (Uint32 *)SDL_malloc(SDL_max(src_w, dst_w) * sizeof(Uint32));
+    }
+    if (first_w == NULL || weights_w == NULL || acc == NULL || (bpp != 4 && line == NULL)) {
+        ret = SDL_OutOfMemory();
+        goto done;
+    }
+    count_w = first_w + dst_w;
+    first_h = count_w + dst_w;
+    count_h = first_h + dst_h;
+    hrow = weights_w + src_w + dst_w;
+    weights_h = hrow + 4 * dst_w;
+
+    get_area_weights(src_w, dst_w, first_w, count_w, weights_w);
+    get_area_weights(src_h, dst_h, first_h, count_h, weights_h);
+
+    for (y = 0; y < dst_h; y++) {
+        const Uint8 *src_row = src + first_h[y] * src_pitch;
+
+        SDL_memset(acc, 0, 4 * dst_w * sizeof(Uint32));
+        for (k = 0; k < count_h[y]; k++) {
+            const Uint32 weight = *weights_h++;
+            if (weight) {
+                const Uint32 *row = (const Uint32 *)src_row;
+                if (bpp != 4) {
+                    for (i = 0; i < src_w; i++) {
+                        UNPACK_PIXEL(src_row + i * bpp, bpp, d->format, line + i);
+                    }
+                    row = line;
+                }
+                hpass(row, dst_w, first_w, count_w, weights_w, hrow);
+                vpass(hrow, 4 * dst_w, weight, acc);
+            }
+            src_row += src_pitch;
+        }
+
+        if (bpp == 4) {
+            store(acc, dst_w, (Uint32 *)dst);
+            if (swizzle) {
+                SDL_SwizzlePixels((Uint32 *)dst, (Uint32 *)dst, dst_w, swizzle);
+            }
+        } else {
+            store(acc, dst_w, line);
+            for (i = 0; i < dst_w; i++) {
+                PACK_PIXEL(line + i, bpp, d->format, dst + i * bpp);
+            }
+        }
+        dst += dst_pitch;
     }
 
+done:
+    SDL_free(first_w);
+    SDL_free(weights_w);
+    SDL_free(acc);
+    SDL_free(line);
     return ret;
 }
 
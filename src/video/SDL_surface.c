@@ -34,6 +34,20 @@ SDL_COMPILE_TIME_ASSERT(surface_size_assumptions,
 
 SDL_COMPILE_TIME_ASSERT(can_indicate_overflow, SDL_SIZE_MAX > SDL_MAX_SINT32);
 
+/* Surfaces kept for SDL_CreatePooledSurface(), in a few slots for each bucket
+   of sizes and formats. Threads take a surface out of its slot by swapping it
+   with NULL, so only the thread that took a surface ever looks at it. */
+#define SURFACE_POOL_BUCKETS      32
+#define SURFACE_POOL_BUCKET_SLOTS 2
+#define SURFACE_POOL_MAX_BYTES    (64 * 1024 * 1024)
+
+static void *surface_pool[SURFACE_POOL_BUCKETS * SURFACE_POOL_BUCKET_SLOTS];
+static SDL_AtomicInt surface_pool_count;
+static SDL_AtomicInt surface_pool_bytes;
+static SDL_AtomicInt surfaces_allocated;
+static SDL_AtomicInt surfaces_reused;
+static SDL_AtomicInt surfaces_freed;
+
 /* Public routines */
 
 /*
@@ -142,6 +156,8 @@ SDL_CreateSurface(int width, int height, Uint32 format)
         return NULL;
     }
 
+    SDL_AtomicIncRef(&surfaces_allocated);
+
     surface->format = SDL_CreatePixelFormat(format);
     if (!surface->format) {
         SDL_DestroySurface(surface);
@@ -202,6 +218,170 @@ SDL_CreateSurface(int width, int height, Uint32 format)
     return surface;
 }
 
+static size_t SDL_GetPooledSurfaceSize(SDL_Surface *surface)
+{
+    return (size_t)surface->h * surface->pitch;
+}
+
+static void **SDL_GetSurfacePoolBucket(int width, int height, Uint32 format)
+{
+    Uint32 hash = ((Uint32)width * 31 + (Uint32)height) * 31 + format;
+
+    hash ^= (hash >> 16);
+    return &surface_pool[(hash % SURFACE_POOL_BUCKETS) * SURFACE_POOL_BUCKET_SLOTS];
+}
+
+/* Takes the surface out of a slot, the caller owns it */
+static SDL_Surface *SDL_TakePooledSurface(void **slot)
+{
+    SDL_Surface *surface = (SDL_Surface *)SDL_AtomicSetPtr(slot, NULL);
+
+    if (surface) {
+        SDL_AtomicAdd(&surface_pool_count, -1);
+        SDL_AtomicAdd(&surface_pool_bytes, -(int)SDL_GetPooledSurfaceSize(surface));
+    }
+    return surface;
+}
+
+/* Puts a surface in a free slot, the pool owns it on success */
+static SDL_bool SDL_PutPooledSurface(void **slot, SDL_Surface *surface)
+{
+    /* Once in the slot, another thread can take the surface at any time */
+    const int size = (int)SDL_GetPooledSurfaceSize(surface);
+
+    if (!SDL_AtomicCASPtr(slot, NULL, surface)) {
+        return SDL_FALSE;
+    }
+    SDL_AtomicIncRef(&surface_pool_count);
+    SDL_AtomicAdd(&surface_pool_bytes, size);
+    return SDL_TRUE;
+}
+
+static void SDL_FreePooledSurface(SDL_Surface *surface)
+{
+    surface->flags &= ~SDL_POOLED;
+    surface->refcount = 1;
+    SDL_DestroySurface(surface);
+}
+
+/*
+ * Get a surface of the given size and format from the pool, or create it.
+ * The content of the pixels is undefined.
+ */
+SDL_Surface *
+SDL_CreatePooledSurface(int width, int height, Uint32 format)
+{
+    SDL_Surface *surface = NULL;
+    void **bucket;
+    int i;
+
+    if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+        /* The palette would have to be reset too, not worth it */
+        return SDL_CreateSurface(width, height, format);
+    }
+
+    bucket = SDL_GetSurfacePoolBucket(width, height, format);
+    for (i = 0; i < SURFACE_POOL_BUCKET_SLOTS && surface == NULL; ++i) {
+        if (SDL_AtomicGetPtr(&bucket[i]) == NULL) {
+            continue;
+        }
+        surface = SDL_TakePooledSurface(&bucket[i]);
+        if (surface && (surface->w != width || surface->h != height || surface->format->format != format)) {
+            /* Another size or format sharing the bucket, put it back */
+            if (!SDL_PutPooledSurface(&bucket[i], surface)) {
+                SDL_FreePooledSurface(surface);
+            }
+            surface = NULL;
+        }
+    }
+
+    if (surface) {
+        SDL_AtomicIncRef(&surfaces_reused);
+    } else {
+        surface = SDL_CreateSurface(width, height, format);
+        if (surface == NULL) {
+            return NULL;
+        }
+        surface->flags |= SDL_POOLED;
+    }
+    surface->refcount = 1;
+    return surface;
+}
+
+/*
+ * Put a destroyed surface back in the pool, in the state of a new surface.
+ * Returns SDL_FALSE if the surface has to be freed.
+ */
+static SDL_bool SDL_ReturnPooledSurface(SDL_Surface *surface)
+{
+    size_t size = SDL_GetPooledSurfaceSize(surface);
+    SDL_Surface *evicted;
+    void **bucket;
+    int i;
+
+    if (!surface->pixels || !surface->map || size > SURFACE_POOL_MAX_BYTES ||
+        SDL_AtomicGet(&surface_pool_bytes) + (int)size > SURFACE_POOL_MAX_BYTES) {
+        return SDL_FALSE;
+    }
+
+    /* The map was invalidated by SDL_DestroySurface(), reset the blit state */
+    surface->userdata = NULL;
+    surface->map->info.flags = 0;
+    surface->map->info.r = 0xFF;
+    surface->map->info.g = 0xFF;
+    surface->map->info.b = 0xFF;
+    surface->map->info.a = 0xFF;
+    surface->map->info.colorkey = 0;
+    SDL_SetSurfaceClipRect(surface, NULL);
+    if (surface->format->Amask) {
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+    }
+
+    bucket = SDL_GetSurfacePoolBucket(surface->w, surface->h, surface->format->format);
+    for (i = 0; i < SURFACE_POOL_BUCKET_SLOTS; ++i) {
+        if (SDL_PutPooledSurface(&bucket[i], surface)) {
+            return SDL_TRUE;
+        }
+    }
+
+    /* The bucket is full, the surface takes the place of the one in the last slot */
+    SDL_AtomicIncRef(&surface_pool_count);
+    SDL_AtomicAdd(&surface_pool_bytes, (int)size);
+    evicted = (SDL_Surface *)SDL_AtomicSetPtr(&bucket[SURFACE_POOL_BUCKET_SLOTS - 1], surface);
+    if (evicted) {
+        SDL_AtomicAdd(&surface_pool_count, -1);
+        SDL_AtomicAdd(&surface_pool_bytes, -(int)SDL_GetPooledSurfaceSize(evicted));
+        SDL_FreePooledSurface(evicted);
+    }
+    return SDL_TRUE;
+}
+
+void SDL_ClearSurfacePool(void)
+{
+    int i;
+
+    for (i = 0; i < SDL_arraysize(surface_pool); ++i) {
+        SDL_Surface *surface = SDL_TakePooledSurface(&surface_pool[i]);
+        if (surface) {
+            SDL_FreePooledSurface(surface);
+        }
+    }
+}
+
+int SDL_GetSurfacePoolStats(SDL_SurfacePoolStats *stats)
+{
+    if (stats == NULL) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    stats->allocated = (Uint32)SDL_AtomicGet(&surfaces_allocated);
+    stats->reused = (Uint32)SDL_AtomicGet(&surfaces_reused);
+    stats->freed = (Uint32)SDL_AtomicGet(&surfaces_freed);
+    stats->pooled = SDL_AtomicGet(&surface_pool_count);
+    stats->pooled_bytes = (size_t)SDL_AtomicGet(&surface_pool_bytes);
+    return 0;
+}
+
 /*
  * Create an RGB surface from an existing memory buffer using the given given
  * enum SDL_PIXELFORMAT_* format
@@ -660,6 +840,7 @@ int SDL_BlitSurfaceUnchecked(SDL_Surface *src, SDL_Rect *srcrect,
         /*              src, dst->flags, src->map->info.flags, dst, dst->flags, */
         /*              dst->map->info.flags, src->map->blit); */
     }
+    SDL_AddSurfaceDamage(dst, dstrect);
     return src->map->blit(src, srcrect, dst, dstrect);
 }
 
@@ -966,12 +1147,9 @@ int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect,
         }
     } else {
         if (!(src->map->info.flags & complex_copy_flags) &&
-            src->format->format == dst->format->format &&
-            !SDL_ISPIXELFORMAT_INDEXED(src->format->format) &&
-            src->format->BytesPerPixel == 4 &&
-            src->format->format != SDL_PIXELFORMAT_ARGB2101010) {
-            /* fast path */
-            return SDL_SoftStretchLinear(src, srcrect, dst, dstrect);
+            SDL_IsSoftStretchConvertible(src->format->format, dst->format->format)) {
+            /* fast path, converting on the fly between 32 bits formats */
+            return SDL_PrivateSoftStretch(src, srcrect, dst, dstrect, scaleMode);
         } else {
             /* Use intermediate surface(s) */
             SDL_Surface *tmp1 = NULL;
@@ -993,19 +1171,23 @@ int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect,
             srcrect2.h = srcrect->h;
 
             /* Change source format if not appropriate for scaling */
-            if (src->format->BytesPerPixel != 4 || src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+            if (!SDL_IsSoftStretchFilterable(src->format->format)) {
                 SDL_Rect tmprect;
                 int fmt;
                 tmprect.x = 0;
                 tmprect.y = 0;
                 tmprect.w = src->w;
                 tmprect.h = src->h;
-                if (dst->format->BytesPerPixel == 4 && dst->format->format != SDL_PIXELFORMAT_ARGB2101010) {
+                if (SDL_IsSoftStretchFilterable(dst->format->format)) {
                     fmt = dst->format->format;
                 } else {
                     fmt = SDL_PIXELFORMAT_ARGB8888;
                 }
-                tmp1 = SDL_CreateSurface(src->w, src->h, fmt);
+                tmp1 = SDL_CreatePooledSurface(src->w, src->h, fmt);
+                if (tmp1 == NULL) {
+                    return -1;
+                }
+                SDL_FillSurfaceRect(tmp1, NULL, 0);
                 SDL_BlitSurfaceUnchecked(src, srcrect, tmp1, &tmprect);
 
                 srcrect2.x = 0;
@@ -1018,10 +1200,14 @@ int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect,
             }
 
             /* Intermediate scaling */
-            if (is_complex_copy_flags || src->format->format != dst->format->format) {
+            if (is_complex_copy_flags || !SDL_IsSoftStretchConvertible(src->format->format, dst->format->format)) {
                 SDL_Rect tmprect;
-                SDL_Surface *tmp2 = SDL_CreateSurface(dstrect->w, dstrect->h, src->format->format);
-                SDL_SoftStretchLinear(src, &srcrect2, tmp2, NULL);
+                SDL_Surface *tmp2 = SDL_CreatePooledSurface(dstrect->w, dstrect->h, src->format->format);
+                if (tmp2 == NULL) {
+                    SDL_DestroySurface(tmp1);
+                    return -1;
+                }
+                SDL_PrivateSoftStretch(src, &srcrect2, tmp2, NULL, scaleMode);
 
                 SDL_SetSurfaceColorMod(tmp2, r, g, b);
                 SDL_SetSurfaceAlphaMod(tmp2, alpha);
@@ -1034,7 +1220,7 @@ int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect,
                 ret = SDL_BlitSurfaceUnchecked(tmp2, &tmprect, dst, dstrect);
                 SDL_DestroySurface(tmp2);
             } else {
-                ret = SDL_SoftStretchLinear(src, &srcrect2, dst, dstrect);
+                ret = SDL_PrivateSoftStretch(src, &srcrect2, dst, dstrect, scaleMode);
             }
 
             SDL_DestroySurface(tmp1);
@@ -1048,6 +1234,9 @@ int SDL_PrivateBlitSurfaceUncheckedScaled(SDL_Surface *src, SDL_Rect *srcrect,
  */
 int SDL_LockSurface(SDL_Surface *surface)
 {
+    /* The pixels may be changed in any way */
+    SDL_AddSurfaceDamage(surface, &surface->clip_rect);
+
     if (!surface->locked) {
 #if SDL_HAVE_RLE
         /* Perform the lock */
@@ -1292,7 +1481,7 @@ SDL_ConvertSurface(SDL_Surface *surface, const SDL_PixelFormat *format)
             int converted_colorkey = 0;
 
             /* Create a dummy surface to get the colorkey converted */
-            tmp = SDL_CreateSurface(1, 1, surface->format->format);
+            tmp = SDL_CreatePooledSurface(1, 1, surface->format->format);
             if (tmp == NULL) {
                 SDL_DestroySurface(convert);
                 return NULL;
@@ -1480,23 +1669,281 @@ int SDL_ConvertPixels(int width, int height,
 }
 
 /*
- * Premultiply the alpha on a block of pixels
+ * Premultiply and unpremultiply the alpha on rows of 32 bits pixels with 8 bits channels.
  *
- * This is currently only implemented for SDL_PIXELFORMAT_ARGB8888
+ * The kernels work in the source layout, using its alpha shift, and swizzle the
+ * result into the destination layout when 'swizzle' is not NULL.
  *
- * Here are some ideas for optimization:
- * https://github.com/Wizermil/premultiply_alpha/tree/master/premultiply_alpha
- * https://developer.arm.com/documentation/101964/0201/Pre-multiplied-alpha-channel-data
+ * Division by 255 is exact: for x <= 255 * 255, x / 255 == (x + 1 + (x >> 8)) >> 8
  */
-int SDL_PremultiplyAlpha(int width, int height,
-                         Uint32 src_format, const void *src, int src_pitch,
-                         Uint32 dst_format, void *dst, int dst_pitch)
+typedef void (*SDL_PremultiplyRowFunc)(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle);
+
+static void SDL_PremultiplyAlphaRow(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const Uint32 amask = 0xFFu << ashift;
+
+    while (width--) {
+        const Uint32 pixel = *src++;
+        const Uint32 a = (pixel >> ashift) & 0xFF;
+        /* Two channels at a time, alpha excluded */
+        Uint32 rb = (pixel & ~amask & 0x00FF00FF) * a;
+        Uint32 ag = ((pixel >> 8) & ~(amask >> 8) & 0x00FF00FF) * a;
+        Uint32 result;
+
+        rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        ag = ((ag + 0x00010001 + ((ag >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        result = rb | (ag << 8) | (pixel & amask);
+        if (swizzle) {
+            result = SDL_SwizzlePixel(result, swizzle);
+        }
+        *dst++ = result;
+    }
+}
+
+static void SDL_UnpremultiplyAlphaRow(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const Uint32 amask = 0xFFu << ashift;
+
+    while (width--) {
+        const Uint32 pixel = *src++;
+        const Uint32 a = (pixel >> ashift) & 0xFF;
+        Uint32 result = pixel & amask;
+
+        if (a == 0xFF) {
+            result = pixel;
+        } else if (a) {
+            int shift;
+            for (shift = 0; shift < 32; shift += 8) {
+                if (shift != ashift) {
+                    /* Rounded c * 255 / a, clamped for invalid premultiplied data */
+                    Uint32 c = (((pixel >> shift) & 0xFF) * 510 + a) / (2 * a);
+                    if (c > 0xFF) {
+                        c = 0xFF;
+                    }
+                    result |= c << shift;
+                }
+            }
+        }
+        if (swizzle) {
+            result = SDL_SwizzlePixel(result, swizzle);
+        }
+        *dst++ = result;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/* Alpha of each pixel, broadcast to its four bytes */
+#define SPLAT_ALPHA_SSE(p, shift, byte_mask, a)          \
+    a = _mm_and_si128(_mm_srl_epi32(p, shift), byte_mask); \
+    a = _mm_or_si128(a, _mm_slli_epi32(a, 8));             \
+    a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+static SDL_INLINE __m128i SDL_TARGETING("sse2") DIV255_SSE(__m128i x, __m128i one)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, one), _mm_srli_epi16(x, 8)), 8);
+}
+
+static void SDL_TARGETING("sse2") SDL_PremultiplyAlphaRow_SSE2(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i amask = _mm_set1_epi32((int)(0xFFu << ashift));
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    Uint32 *dst_row = dst;
+    int n = width / 4;
+
+    while (n--) {
+        __m128i p = _mm_loadu_si128((const __m128i *)src);
+        __m128i a, lo, hi;
+
+        SPLAT_ALPHA_SSE(p, shift, byte_mask, a);
+        lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi8(a, zero));
+        hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi8(a, zero));
+        lo = _mm_packus_epi16(DIV255_SSE(lo, one), DIV255_SSE(hi, one));
+        /* Keep the original alpha */
+        lo = _mm_or_si128(_mm_andnot_si128(amask, lo), _mm_and_si128(amask, p));
+        _mm_storeu_si128((__m128i *)dst, lo);
+        src += 4;
+        dst += 4;
+    }
+    if (swizzle) {
+        SDL_SwizzlePixels(dst_row, dst_row, (int)(dst - dst_row), swizzle);
+    }
+    SDL_PremultiplyAlphaRow(src, dst, width & 3, ashift, swizzle);
+}
+
+static SDL_INLINE __m128i SDL_TARGETING("sse2") UNPREMULTIPLY_SSE(__m128i c, __m128i a, __m128 v255, __m128 half)
+{
+    /* Division by zero gives an out of range conversion, saturated to 0 when packing */
+    __m128 x = _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(c), v255), _mm_cvtepi32_ps(a));
+    return _mm_cvttps_epi32(_mm_add_ps(x, half));
+}
+
+static void SDL_TARGETING("sse2") SDL_UnpremultiplyAlphaRow_SSE2(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i amask = _mm_set1_epi32((int)(0xFFu << ashift));
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    const __m128 v255 = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    Uint32 *dst_row = dst;
+    int n = width / 4;
+
+    while (n--) {
+        __m128i p = _mm_loadu_si128((const __m128i *)src);
+        __m128i a, c16, a16, x0, x1, x2, x3;
+
+        SPLAT_ALPHA_SSE(p, shift, byte_mask, a);
+        c16 = _mm_unpacklo_epi8(p, zero);
+        a16 = _mm_unpacklo_epi8(a, zero);
+        x0 = UNPREMULTIPLY_SSE(_mm_unpacklo_epi16(c16, zero), _mm_unpacklo_epi16(a16, zero), v255, half);
+        x1 = UNPREMULTIPLY_SSE(_mm_unpackhi_epi16(c16, zero), _mm_unpackhi_epi16(a16, zero), v255, half);
+        c16 = _mm_unpackhi_epi8(p, zero);
+        a16 = _mm_unpackhi_epi8(a, zero);
+        x2 = UNPREMULTIPLY_SSE(_mm_unpacklo_epi16(c16, zero), _mm_unpacklo_epi16(a16, zero), v255, half);
+        x3 = UNPREMULTIPLY_SSE(_mm_unpackhi_epi16(c16, zero), _mm_unpackhi_epi16(a16, zero), v255, half);
+        x0 = _mm_packus_epi16(_mm_packs_epi32(x0, x1), _mm_packs_epi32(x2, x3));
+        x0 = _mm_or_si128(_mm_andnot_si128(amask, x0), _mm_and_si128(amask, p));
+        _mm_storeu_si128((__m128i *)dst, x0);
+        src += 4;
+        dst += 4;
+    }
+    if (swizzle) {
+        SDL_SwizzlePixels(dst_row, dst_row, (int)(dst - dst_row), swizzle);
+    }
+    SDL_UnpremultiplyAlphaRow(src, dst, width & 3, ashift, swizzle);
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_AVX2_INTRINSICS
+static SDL_INLINE void SDL_TARGETING("avx2") GET_SWIZZLE_AVX2(const SDL_PixelSwizzle *swizzle, __m256i *shuffle, __m256i *fill)
+{
+    Uint8 control[32];
+    int i;
+
+    for (i = 0; i < 32; i++) {
+        const Uint8 index = swizzle->shuffle[i % 4];
+        control[i] = (index & 0x80) ? 0x80 : (Uint8)((i % 16) - (i % 4) + index);
+    }
+    *shuffle = _mm256_loadu_si256((const __m256i *)control);
+    *fill = _mm256_set1_epi32((int)swizzle->fill);
+}
+
+#define SPLAT_ALPHA_AVX2(p, shift, byte_mask, a)                \
+    a = _mm256_and_si256(_mm256_srl_epi32(p, shift), byte_mask); \
+    a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));             \
+    a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2") DIV255_AVX2(__m256i x, __m256i one)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, one), _mm256_srli_epi16(x, 8)), 8);
+}
+
+static void SDL_TARGETING("avx2") SDL_PremultiplyAlphaRow_AVX2(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    const __m256i amask = _mm256_set1_epi32((int)(0xFFu << ashift));
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    __m256i shuffle = zero, fill = zero;
+    int n = width / 8;
+
+    if (swizzle) {
+        GET_SWIZZLE_AVX2(swizzle, &shuffle, &fill);
+    }
+    while (n--) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)src);
+        __m256i a, lo, hi;
+
+        SPLAT_ALPHA_AVX2(p, shift, byte_mask, a);
+        lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), _mm256_unpacklo_epi8(a, zero));
+        hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), _mm256_unpackhi_epi8(a, zero));
+        lo = _mm256_packus_epi16(DIV255_AVX2(lo, one), DIV255_AVX2(hi, one));
+        lo = _mm256_or_si256(_mm256_andnot_si256(amask, lo), _mm256_and_si256(amask, p));
+        if (swizzle) {
+            lo = _mm256_or_si256(_mm256_shuffle_epi8(lo, shuffle), fill);
+        }
+        _mm256_storeu_si256((__m256i *)dst, lo);
+        src += 8;
+        dst += 8;
+    }
+    SDL_PremultiplyAlphaRow(src, dst, width & 7, ashift, swizzle);
+}
+
+static SDL_INLINE __m256i SDL_TARGETING("avx2") UNPREMULTIPLY_AVX2(__m256i c, __m256i a, __m256 v255, __m256 half)
 {
-    int c;
-    Uint32 srcpixel;
-    Uint32 srcR, srcG, srcB, srcA;
-    Uint32 dstpixel;
-    Uint32 dstR, dstG, dstB, dstA;
+    __m256 x = _mm256_div_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(c), v255), _mm256_cvtepi32_ps(a));
+    return _mm256_cvttps_epi32(_mm256_add_ps(x, half));
+}
+
+static void SDL_TARGETING("avx2") SDL_UnpremultiplyAlphaRow_AVX2(const Uint32 *src, Uint32 *dst, int width, int ashift, const SDL_PixelSwizzle *swizzle)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    const __m256i amask = _mm256_set1_epi32((int)(0xFFu << ashift));
+    const __m128i shift = _mm_cvtsi32_si128(ashift);
+    const __m256 v255 = _mm256_set1_ps(255.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    __m256i shuffle = zero, fill = zero;
+    int n = width / 8;
+
+    if (swizzle) {
+        GET_SWIZZLE_AVX2(swizzle, &shuffle, &fill);
+    }
+    while (n--) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)src);
+        __m256i a, c16, a16, x0, x1, x2, x3;
+
+        /* Unpacking stays within 128 bits lanes, and so does packing back */
+        SPLAT_ALPHA_AVX2(p, shift, byte_mask, a);
+        c16 = _mm256_unpacklo_epi8(p, zero);
+        a16 = _mm256_unpacklo_epi8(a, zero);
+        x0 = UNPREMULTIPLY_AVX2(_mm256_unpacklo_epi16(c16, zero), _mm256_unpacklo_epi16(a16, zero), v255, half);
+        x1 = UNPREMULTIPLY_AVX2(_mm256_unpackhi_epi16(c16, zero), _mm256_unpackhi_epi16(a16, zero), v255, half);
+        c16 = _mm256_unpackhi_epi8(p, zero);
+        a16 = _mm256_unpackhi_epi8(a, zero);
+        x2 = UNPREMULTIPLY_AVX2(_mm256_unpacklo_epi16(c16, zero), _mm256_unpacklo_epi16(a16, zero), v255, half);
+        x3 = UNPREMULTIPLY_AVX2(_mm256_unpackhi_epi16(c16, zero), _mm256_unpackhi_epi16(a16, zero), v255, half);
+        x0 = _mm256_packus_epi16(_mm256_packs_epi32(x0, x1), _mm256_packs_epi32(x2, x3));
+        x0 = _mm256_or_si256(_mm256_andnot_si256(amask, x0), _mm256_and_si256(amask, p));
+        if (swizzle) {
+            x0 = _mm256_or_si256(_mm256_shuffle_epi8(x0, shuffle), fill);
+        }
+        _mm256_storeu_si256((__m256i *)dst, x0);
+        src += 8;
+        dst += 8;
+    }
+    SDL_UnpremultiplyAlphaRow(src, dst, width & 7, ashift, swizzle);
+}
+#endif /* SDL_AVX2_INTRINSICS */
+
+static SDL_PremultiplyRowFunc SDL_GetPremultiplyRowFunc(SDL_bool premultiply)
+{
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return premultiply ? SDL_PremultiplyAlphaRow_AVX2 : SDL_UnpremultiplyAlphaRow_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return premultiply ? SDL_PremultiplyAlphaRow_SSE2 : SDL_UnpremultiplyAlphaRow_SSE2;
+    }
+#endif
+    return premultiply ? SDL_PremultiplyAlphaRow : SDL_UnpremultiplyAlphaRow;
+}
+
+static int SDL_PrivatePremultiplyAlpha(int width, int height,
+                                       Uint32 src_format, const void *src, int src_pitch,
+                                       Uint32 dst_format, void *dst, int dst_pitch,
+                                       SDL_bool premultiply)
+{
+    SDL_PixelFormat srcfmt, dstfmt;
+    SDL_PixelSwizzle swizzle_data;
+    const SDL_PixelSwizzle *swizzle = NULL;
+    SDL_PremultiplyRowFunc func;
 
     if (src == NULL) {
         return SDL_InvalidParamError("src");
@@ -1510,30 +1957,34 @@ int SDL_PremultiplyAlpha(int width, int height,
     if (!dst_pitch) {
         return SDL_InvalidParamError("dst_pitch");
     }
-    if (src_format != SDL_PIXELFORMAT_ARGB8888) {
+    if (!SDL_Is8888Format(src_format)) {
         return SDL_InvalidParamError("src_format");
     }
-    if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
+    if (!SDL_Is8888Format(dst_format)) {
         return SDL_InvalidParamError("dst_format");
     }
+    if (SDL_InitFormat(&srcfmt, src_format) < 0 || SDL_InitFormat(&dstfmt, dst_format) < 0) {
+        return -1;
+    }
+
+    if (SDL_GetPixelSwizzle(&srcfmt, &dstfmt, &swizzle_data)) {
+        swizzle = &swizzle_data;
+    }
+
+    if (srcfmt.Amask) {
+        func = SDL_GetPremultiplyRowFunc(premultiply);
+    } else {
+        /* Opaque pixels are left unchanged, this is a plain conversion */
+        func = NULL;
+    }
 
     while (height--) {
-        const Uint32 *src_px = (const Uint32 *)src;
-        Uint32 *dst_px = (Uint32 *)dst;
-        for (c = width; c; --c) {
-            /* Component bytes extraction. */
-            srcpixel = *src_px++;
-            RGBA_FROM_ARGB8888(srcpixel, srcR, srcG, srcB, srcA);
-
-            /* Alpha pre-multiplication of each component. */
-            dstA = srcA;
-            dstR = (srcA * srcR) / 255;
-            dstG = (srcA * srcG) / 255;
-            dstB = (srcA * srcB) / 255;
-
-            /* ARGB8888 pixel recomposition. */
-            ARGB8888_FROM_RGBA(dstpixel, dstR, dstG, dstB, dstA);
-            *dst_px++ = dstpixel;
+        if (func) {
+            func((const Uint32 *)src, (Uint32 *)dst, width, srcfmt.Ashift, swizzle);
+        } else if (swizzle) {
+            SDL_SwizzlePixels((const Uint32 *)src, (Uint32 *)dst, width, swizzle);
+        } else if (src != dst) {
+            SDL_memcpy(dst, src, (size_t)width * 4);
         }
         src = (const Uint8 *)src + src_pitch;
         dst = (Uint8 *)dst + dst_pitch;
@@ -1541,6 +1992,26 @@ int SDL_PremultiplyAlpha(int width, int height,
     return 0;
 }
 
+/*
+ * Premultiply the alpha on a block of pixels, converting between 32 bits formats with 8 bits channels
+ */
+int SDL_PremultiplyAlpha(int width, int height,
+                         Uint32 src_format, const void *src, int src_pitch,
+                         Uint32 dst_format, void *dst, int dst_pitch)
+{
+    return SDL_PrivatePremultiplyAlpha(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, SDL_TRUE);
+}
+
+/*
+ * Undo the alpha premultiplication on a block of pixels
+ */
+int SDL_UnpremultiplyAlpha(int width, int height,
+                           Uint32 src_format, const void *src, int src_pitch,
+                           Uint32 dst_format, void *dst, int dst_pitch)
+{
+    return SDL_PrivatePremultiplyAlpha(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch, SDL_FALSE);
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -1562,6 +2033,10 @@ void SDL_DestroySurface(SDL_Surface *surface)
     while (surface->locked > 0) {
         SDL_UnlockSurface(surface);
     }
+    if ((surface->flags & (SDL_POOLED | SDL_RLEACCEL)) == SDL_POOLED &&
+        SDL_ReturnPooledSurface(surface)) {
+        return;
+    }
 #if SDL_HAVE_RLE
     if (surface->flags & SDL_RLEACCEL) {
         SDL_UnRLESurface(surface, 0);
@@ -1585,4 +2060,6 @@ void SDL_DestroySurface(SDL_Surface *surface)
         SDL_FreeBlitMap(surface->map);
     }
     SDL_free(surface);
+
+    SDL_AtomicIncRef(&surfaces_freed);
 }
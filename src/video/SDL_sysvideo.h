@@ -24,6 +24,7 @@
 #define SDL_sysvideo_h_
 
 #include "SDL_vulkan_internal.h"
+#include "SDL_rect_c.h"
 
 /* The SDL video driver */
 
@@ -96,6 +97,7 @@ struct SDL_Window
 
     SDL_Surface *surface;
     SDL_bool surface_valid;
+    SDL_Region surface_damage; /* with SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE */
 
     SDL_bool is_hiding;
     SDL_bool restore_on_show; /* Child was hidden recursively by the parent, restore when shown. */
@@ -2979,6 +2979,13 @@ SDL_Surface *SDL_GetWindowSurface(SDL_Window *window)
         if (window->surface) {
             window->surface_valid = SDL_TRUE;
             window->surface->flags |= SDL_DONTFREE;
+
+            if (SDL_GetHintBoolean(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE, SDL_FALSE)) {
+                /* The whole surface has to be shown once */
+                SDL_ClearRegion(&window->surface_damage);
+                window->surface->map->damage = &window->surface_damage;
+                SDL_AddSurfaceDamage(window->surface, &window->surface->clip_rect);
+            }
         }
     }
     return window->surface;
@@ -2990,6 +2997,17 @@ int SDL_UpdateWindowSurface(SDL_Window *window)
 
     CHECK_WINDOW_MAGIC(window, -1);
 
+    if (window->surface_valid && window->surface->map->damage) {
+        SDL_Region *damage = window->surface->map->damage;
+        int retval = 0;
+
+        if (damage->numrects > 0) {
+            retval = SDL_UpdateWindowSurfaceRects(window, damage->rects, damage->numrects);
+            SDL_ClearRegion(damage);
+        }
+        return retval;
+    }
+
     full_rect.x = 0;
     full_rect.y = 0;
     SDL_GetWindowSizeInPixels(window, &full_rect.w, &full_rect.h);
@@ -3000,12 +3018,21 @@ int SDL_UpdateWindowSurface(SDL_Window *window)
 int SDL_UpdateWindowSurfaceRects(SDL_Window *window, const SDL_Rect *rects,
                                  int numrects)
 {
+    int i;
+
     CHECK_WINDOW_MAGIC(window, -1);
 
     if (!window->surface_valid) {
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
+    if (SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO) <= SDL_LOG_PRIORITY_VERBOSE) {
+        for (i = 0; i < numrects; ++i) {
+            SDL_LogVerbose(SDL_LOG_CATEGORY_VIDEO, "Updating window %" SDL_PRIu32 " surface: %d,%d %dx%d",
+                           window->id, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+        }
+    }
+
     SDL_assert(_this->checked_texture_framebuffer); /* we should have done this before we had a valid surface. */
 
     return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
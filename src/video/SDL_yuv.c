@@ -24,6 +24,7 @@
 #include "SDL_yuv_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
+#include "../thread/SDL_systhread.h"
 
 #define SDL_YUV_SD_THRESHOLD 576
 
@@ -31,6 +32,7 @@ static SDL_YUV_CONVERSION_MODE SDL_YUV_ConversionMode = SDL_YUV_CONVERSION_BT601
 
 #if SDL_HAVE_YUV
 static SDL_bool IsPlanar2x2Format(Uint32 format);
+static SDL_bool IsPlanar2x2_16Format(Uint32 format);
 #endif
 
 void SDL_SetYUVConversionMode(SDL_YUV_CONVERSION_MODE mode)
@@ -67,7 +69,7 @@ int SDL_CalculateYUVSize(Uint32 format, int w, int h, size_t *size, size_t *pitc
 #if SDL_HAVE_YUV
     int sz_plane = 0, sz_plane_chroma = 0, sz_plane_packed = 0;
 
-    if (IsPlanar2x2Format(format) == SDL_TRUE) {
+    if (IsPlanar2x2Format(format) == SDL_TRUE || IsPlanar2x2_16Format(format) == SDL_TRUE) {
         {
             /* sz_plane == w * h; */
             size_t s1;
@@ -173,6 +175,33 @@ int SDL_CalculateYUVSize(Uint32 format, int w, int h, size_t *size, size_t *pitc
         }
         break;
 
+    case SDL_PIXELFORMAT_P010: /**< Planar mode: Y + U/V interleaved, 16-bit samples (2 planes) */
+    case SDL_PIXELFORMAT_P016:
+        if (pitch) {
+            /* pitch == w * 2; */
+            size_t p1;
+            if (SDL_size_mul_overflow(w, 2, &p1) < 0) {
+                return -1;
+            }
+            *pitch = p1;
+        }
+
+        if (size) {
+            /* dst_size == 2 * (sz_plane + sz_plane_chroma + sz_plane_chroma); */
+            size_t s1, s2, s3;
+            if (SDL_size_add_overflow(sz_plane, sz_plane_chroma, &s1) < 0) {
+                return -1;
+            }
+            if (SDL_size_add_overflow(s1, sz_plane_chroma, &s2) < 0) {
+                return -1;
+            }
+            if (SDL_size_mul_overflow(s2, 2, &s3) < 0) {
+                return -1;
+            }
+            *size = s3;
+        }
+        break;
+
     default:
         return -1;
     }
@@ -208,6 +237,12 @@ static SDL_bool IsPlanar2x2Format(Uint32 format)
     return format == SDL_PIXELFORMAT_YV12 || format == SDL_PIXELFORMAT_IYUV || format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21;
 }
 
+/* Like NV12, with little endian 16-bit samples */
+static SDL_bool IsPlanar2x2_16Format(Uint32 format)
+{
+    return format == SDL_PIXELFORMAT_P010 || format == SDL_PIXELFORMAT_P016;
+}
+
 static SDL_bool IsPacked4Format(Uint32 format)
 {
     return format == SDL_PIXELFORMAT_YUY2 || format == SDL_PIXELFORMAT_UYVY || format == SDL_PIXELFORMAT_YVYU;
@@ -242,6 +277,13 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
         planes[0] = (const Uint8 *)yuv;
         planes[1] = planes[0] + pitches[0] * height;
         break;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        pitches[0] = yuv_pitch;
+        pitches[1] = 4 * ((pitches[0] + 3) / 4);
+        planes[0] = (const Uint8 *)yuv;
+        planes[1] = planes[0] + pitches[0] * height;
+        break;
     default:
         return SDL_SetError("GetYUVPlanes(): Unsupported YUV format: %s", SDL_GetPixelFormatName(format));
     }
@@ -296,6 +338,14 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
         *u = *v + 1;
         *uv_stride = pitches[1];
         break;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        *y = planes[0];
+        *y_stride = pitches[0];
+        *u = planes[1];
+        *v = *u + 2;
+        *uv_stride = pitches[1];
+        break;
     default:
         /* Should have caught this above */
         return SDL_SetError("GetYUVPlanes[2]: Unsupported YUV format: %s", SDL_GetPixelFormatName(format));
@@ -303,6 +353,125 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
     return 0;
 }
 
+#ifdef SDL_AVX2_INTRINSICS
+static SDL_bool SDL_TARGETING("avx2") yuv_rgb_avx2(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    if (!SDL_HasAVX2()) {
+        return SDL_FALSE;
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YV12 ||
+        src_format == SDL_PIXELFORMAT_IYUV) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv420_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv420_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv420_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv420_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv420_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv420_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv422_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv422_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv422_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv422_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv422_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv422_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_NV12 ||
+        src_format == SDL_PIXELFORMAT_NV21) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuvnv12_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvnv12_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvnv12_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvnv12_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvnv12_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvnv12_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+    return SDL_FALSE;
+}
+#else
+static SDL_bool yuv_rgb_avx2(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    return SDL_FALSE;
+}
+#endif
+
 #ifdef SDL_SSE2_INTRINSICS
 static SDL_bool SDL_TARGETING("sse2") yuv_rgb_sse(
     Uint32 src_format, Uint32 dst_format,
@@ -577,6 +746,381 @@ static SDL_bool yuv_rgb_std(
     return SDL_FALSE;
 }
 
+static SDL_bool yuv_rgb(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    return yuv_rgb_avx2(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type) ||
+           yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type) ||
+           yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type) ||
+           yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+}
+
+/* Large frames can be split by row pairs and converted on several threads */
+#define YUV_RGB_MAX_THREADS    16
+#define YUV_RGB_MIN_SLICE_ROWS 64
+
+typedef struct YUVToRGBSlice
+{
+    Uint32 src_format, dst_format;
+    Uint32 width, height;
+    const Uint8 *y, *u, *v;
+    Uint32 y_stride, uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    SDL_bool result;
+} YUVToRGBSlice;
+
+static int SDLCALL YUVToRGBSliceThread(void *data)
+{
+    YUVToRGBSlice *slice = (YUVToRGBSlice *)data;
+
+    slice->result = yuv_rgb(slice->src_format, slice->dst_format, slice->width, slice->height,
+                            slice->y, slice->u, slice->v, slice->y_stride, slice->uv_stride,
+                            slice->rgb, slice->rgb_stride, slice->yuv_type);
+    return 0;
+}
+
+static int GetYUVToRGBThreadCount(Uint32 height)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_THREADS);
+    int count;
+
+    if (hint == NULL || !*hint) {
+        return 1;
+    }
+    count = SDL_atoi(hint);
+    if (count <= 0) {
+        count = SDL_GetCPUCount();
+    }
+    count = SDL_min(count, YUV_RGB_MAX_THREADS);
+    count = SDL_min(count, (int)(height / YUV_RGB_MIN_SLICE_ROWS));
+    return SDL_max(count, 1);
+}
+
+static SDL_bool yuv_rgb_threaded(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    YUVToRGBSlice slices[YUV_RGB_MAX_THREADS];
+    SDL_Thread *threads[YUV_RGB_MAX_THREADS];
+    Uint32 rows, start;
+    SDL_bool result = SDL_TRUE;
+    int i, count, num_slices = 0;
+
+    /* Slices start on a row pair, sharing no chroma with each other. Packed
+       formats aren't split, the converters handle the last row of those
+       with different rounding, so the result would depend on the slicing. */
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+        count = 1;
+    } else {
+        count = GetYUVToRGBThreadCount(height);
+    }
+    if (count <= 1) {
+        return yuv_rgb(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+    }
+
+    rows = ((height + count - 1) / count + 1) & ~1;
+    for (start = 0; start < height; start += rows) {
+        YUVToRGBSlice *slice = &slices[num_slices++];
+        const Uint32 uv_row = start / 2;
+
+        slice->src_format = src_format;
+        slice->dst_format = dst_format;
+        slice->width = width;
+        slice->height = SDL_min(rows, height - start);
+        slice->y = y + start * y_stride;
+        slice->u = u + uv_row * uv_stride;
+        slice->v = v + uv_row * uv_stride;
+        slice->y_stride = y_stride;
+        slice->uv_stride = uv_stride;
+        slice->rgb = rgb + start * rgb_stride;
+        slice->rgb_stride = rgb_stride;
+        slice->yuv_type = yuv_type;
+    }
+
+    /* Convert the first slice on this thread, and any slice without a thread */
+    for (i = 1; i < num_slices; ++i) {
+        threads[i] = SDL_CreateThreadInternal(YUVToRGBSliceThread, "SDLYUVConvert", 0, &slices[i]);
+        if (threads[i] == NULL) {
+            YUVToRGBSliceThread(&slices[i]);
+        }
+    }
+    YUVToRGBSliceThread(&slices[0]);
+
+    for (i = 0; i < num_slices; ++i) {
+        if (i > 0 && threads[i]) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+        if (!slices[i].result) {
+            result = SDL_FALSE;
+        }
+    }
+    return result;
+}
+
+/* P010 and P016 are converted with their own factors, derived for 10-bit
+   studio range (Y in 64-940, chroma in 64-960) or full range, in 2.12 fixed
+   point. P016 samples are reduced to 10 bits. The result keeps all 10 bits
+   for ARGB2101010, and is rounded to 8 bits for ARGB8888. */
+#define YUV16_SHIFT 12
+
+typedef struct YUV16ToRGBParams
+{
+    int y_offset;
+    Sint16 y_factor, v_r_factor, u_g_factor, v_g_factor, u_b_factor;
+    int shift; /* YUV16_SHIFT, plus 2 for 8-bit output */
+    int max;
+    SDL_bool ten_bit;
+} YUV16ToRGBParams;
+
+static void SetupYUV16ToRGBParams(YUV16ToRGBParams *params, int width, int height, Uint32 dst_format)
+{
+    static const struct
+    {
+        int y_offset;
+        float y, v_r, u_g, v_g, u_b;
+    } factors[SDL_YUV_CONVERSION_BT709 + 1] = {
+        /* ITU-T T.871 (JPEG) */
+        { 0, 1.0f, 1.402f, -0.3441f, -0.7141f, 1.772f },
+        /* ITU-R BT.601-7 */
+        { 64, 1.1678f, 1.6007f, -0.3929f, -0.8153f, 2.0232f },
+        /* ITU-R BT.709-6 */
+        { 64, 1.1678f, 1.7980f, -0.2139f, -0.5345f, 2.1186f },
+    };
+    const int mode = SDL_GetYUVConversionModeForResolution(width, height);
+    const float scale = (float)(1 << YUV16_SHIFT);
+
+    params->y_offset = factors[mode].y_offset;
+    params->y_factor = (Sint16)SDL_lroundf(factors[mode].y * scale);
+    params->v_r_factor = (Sint16)SDL_lroundf(factors[mode].v_r * scale);
+    params->u_g_factor = (Sint16)SDL_lroundf(factors[mode].u_g * scale);
+    params->v_g_factor = (Sint16)SDL_lroundf(factors[mode].v_g * scale);
+    params->u_b_factor = (Sint16)SDL_lroundf(factors[mode].u_b * scale);
+    params->ten_bit = (dst_format == SDL_PIXELFORMAT_ARGB2101010);
+    params->shift = params->ten_bit ? YUV16_SHIFT : YUV16_SHIFT + 2;
+    params->max = params->ten_bit ? 1023 : 255;
+}
+
+/* Converts a pair of rows and returns the number of pixels handled, which is even */
+typedef int (*YUV16ToRGBFunc)(const YUV16ToRGBParams *params, const Uint16 *y0, const Uint16 *y1, const Uint16 *uv, int width, Uint32 *dst0, Uint32 *dst1);
+
+static SDL_INLINE Uint32 YUV16ToRGB_Pixel(const YUV16ToRGBParams *params, int y, int r_uv, int g_uv, int b_uv)
+{
+    const int y_tmp = ((y >> 6) - params->y_offset) * params->y_factor + (1 << (params->shift - 1));
+    const int r = SDL_clamp((y_tmp + r_uv) >> params->shift, 0, params->max);
+    const int g = SDL_clamp((y_tmp + g_uv) >> params->shift, 0, params->max);
+    const int b = SDL_clamp((y_tmp + b_uv) >> params->shift, 0, params->max);
+
+    if (params->ten_bit) {
+        return 0xC0000000 | ((Uint32)r << 20) | ((Uint32)g << 10) | (Uint32)b;
+    }
+    return 0xFF000000 | ((Uint32)r << 16) | ((Uint32)g << 8) | (Uint32)b;
+}
+
+static void YUV16ToRGB_Rows_std(const YUV16ToRGBParams *params, const Uint16 *y0, const Uint16 *y1, const Uint16 *uv, int x, int width, Uint32 *dst0, Uint32 *dst1)
+{
+    for (; x < width; x += 2) {
+        const int u = (uv[x] >> 6) - 512;
+        const int v = (uv[x + 1] >> 6) - 512;
+        const int r_uv = v * params->v_r_factor;
+        const int g_uv = u * params->u_g_factor + v * params->v_g_factor;
+        const int b_uv = u * params->u_b_factor;
+
+        dst0[x] = YUV16ToRGB_Pixel(params, y0[x], r_uv, g_uv, b_uv);
+        dst1[x] = YUV16ToRGB_Pixel(params, y1[x], r_uv, g_uv, b_uv);
+        if (x + 1 < width) {
+            dst0[x + 1] = YUV16ToRGB_Pixel(params, y0[x + 1], r_uv, g_uv, b_uv);
+            dst1[x + 1] = YUV16ToRGB_Pixel(params, y1[x + 1], r_uv, g_uv, b_uv);
+        }
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/* Converts eight Y samples with the chroma terms of four U/V pairs, each repeated for two pixels */
+static void SDL_TARGETING("sse2") YUV16ToRGB_Store_SSE2(const YUV16ToRGBParams *params, const Uint16 *src, Uint32 *dst,
+                                                        const __m128i *r_uv, const __m128i *g_uv, const __m128i *b_uv)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shift = _mm_cvtsi32_si128(params->shift);
+    const __m128i max = _mm_set1_epi16((short)params->max);
+    const __m128i y = _mm_sub_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)src), 6), _mm_set1_epi16((short)params->y_offset));
+    const __m128i y_factor = _mm_set1_epi32(params->y_factor);
+    const __m128i y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(y, zero), y_factor);
+    const __m128i y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(y, zero), y_factor);
+    __m128i r, g, b, lo, hi;
+
+    r = _mm_packs_epi32(_mm_sra_epi32(_mm_add_epi32(y_lo, r_uv[0]), shift), _mm_sra_epi32(_mm_add_epi32(y_hi, r_uv[1]), shift));
+    g = _mm_packs_epi32(_mm_sra_epi32(_mm_add_epi32(y_lo, g_uv[0]), shift), _mm_sra_epi32(_mm_add_epi32(y_hi, g_uv[1]), shift));
+    b = _mm_packs_epi32(_mm_sra_epi32(_mm_add_epi32(y_lo, b_uv[0]), shift), _mm_sra_epi32(_mm_add_epi32(y_hi, b_uv[1]), shift));
+    r = _mm_min_epi16(_mm_max_epi16(r, zero), max);
+    g = _mm_min_epi16(_mm_max_epi16(g, zero), max);
+    b = _mm_min_epi16(_mm_max_epi16(b, zero), max);
+
+    /* The low and high 16 bits of each pixel */
+    if (params->ten_bit) {
+        lo = _mm_or_si128(b, _mm_slli_epi16(g, 10));
+        hi = _mm_or_si128(_mm_or_si128(_mm_srli_epi16(g, 6), _mm_slli_epi16(r, 4)), _mm_set1_epi16((short)0xC000));
+    } else {
+        lo = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+        hi = _mm_or_si128(r, _mm_set1_epi16((short)0xFF00));
+    }
+    _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(lo, hi));
+    _mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(lo, hi));
+}
+
+static int SDL_TARGETING("sse2") YUV16ToRGB_Rows_SSE2(const YUV16ToRGBParams *params, const Uint16 *y0, const Uint16 *y1, const Uint16 *uv, int width, Uint32 *dst0, Uint32 *dst1)
+{
+    const __m128i offset = _mm_set1_epi16(512);
+    const __m128i round = _mm_set1_epi32(1 << (params->shift - 1));
+    const __m128i r_factors = _mm_set1_epi32((int)((Uint32)(Uint16)params->v_r_factor << 16));
+    const __m128i g_factors = _mm_set1_epi32((int)(((Uint32)(Uint16)params->v_g_factor << 16) | (Uint16)params->u_g_factor));
+    const __m128i b_factors = _mm_set1_epi32((Uint16)params->u_b_factor);
+    int x;
+
+    for (x = 0; x + 8 <= width; x += 8) {
+        /* Four U/V pairs */
+        const __m128i uvs = _mm_sub_epi16(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(uv + x)), 6), offset);
+        const __m128i r = _mm_add_epi32(_mm_madd_epi16(uvs, r_factors), round);
+        const __m128i g = _mm_add_epi32(_mm_madd_epi16(uvs, g_factors), round);
+        const __m128i b = _mm_add_epi32(_mm_madd_epi16(uvs, b_factors), round);
+        __m128i r_uv[2], g_uv[2], b_uv[2];
+
+        r_uv[0] = _mm_unpacklo_epi32(r, r);
+        r_uv[1] = _mm_unpackhi_epi32(r, r);
+        g_uv[0] = _mm_unpacklo_epi32(g, g);
+        g_uv[1] = _mm_unpackhi_epi32(g, g);
+        b_uv[0] = _mm_unpacklo_epi32(b, b);
+        b_uv[1] = _mm_unpackhi_epi32(b, b);
+
+        YUV16ToRGB_Store_SSE2(params, y0 + x, dst0 + x, r_uv, g_uv, b_uv);
+        YUV16ToRGB_Store_SSE2(params, y1 + x, dst1 + x, r_uv, g_uv, b_uv);
+    }
+    return x;
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_AVX2_INTRINSICS
+/* As the SSE2 version, with sixteen pixels. Unpack works within 128-bit lanes,
+   so the chroma of pairs 0-3 and 4-7 lines up with Y samples 0-7 and 8-15 */
+static void SDL_TARGETING("avx2") YUV16ToRGB_Store_AVX2(const YUV16ToRGBParams *params, const Uint16 *src, Uint32 *dst,
+                                                        const __m256i *r_uv, const __m256i *g_uv, const __m256i *b_uv)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m128i shift = _mm_cvtsi32_si128(params->shift);
+    const __m256i max = _mm256_set1_epi16((short)params->max);
+    const __m256i y = _mm256_sub_epi16(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)src), 6), _mm256_set1_epi16((short)params->y_offset));
+    const __m256i y_factor = _mm256_set1_epi32(params->y_factor);
+    const __m256i y_lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(y, zero), y_factor);
+    const __m256i y_hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(y, zero), y_factor);
+    __m256i r, g, b, lo, hi, px_lo, px_hi;
+
+    r = _mm256_packs_epi32(_mm256_sra_epi32(_mm256_add_epi32(y_lo, r_uv[0]), shift), _mm256_sra_epi32(_mm256_add_epi32(y_hi, r_uv[1]), shift));
+    g = _mm256_packs_epi32(_mm256_sra_epi32(_mm256_add_epi32(y_lo, g_uv[0]), shift), _mm256_sra_epi32(_mm256_add_epi32(y_hi, g_uv[1]), shift));
+    b = _mm256_packs_epi32(_mm256_sra_epi32(_mm256_add_epi32(y_lo, b_uv[0]), shift), _mm256_sra_epi32(_mm256_add_epi32(y_hi, b_uv[1]), shift));
+    r = _mm256_min_epi16(_mm256_max_epi16(r, zero), max);
+    g = _mm256_min_epi16(_mm256_max_epi16(g, zero), max);
+    b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max);
+
+    if (params->ten_bit) {
+        lo = _mm256_or_si256(b, _mm256_slli_epi16(g, 10));
+        hi = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi16(g, 6), _mm256_slli_epi16(r, 4)), _mm256_set1_epi16((short)0xC000));
+    } else {
+        lo = _mm256_or_si256(b, _mm256_slli_epi16(g, 8));
+        hi = _mm256_or_si256(r, _mm256_set1_epi16((short)0xFF00));
+    }
+
+    /* Pixels 0-3 and 8-11, then 4-7 and 12-15 */
+    px_lo = _mm256_unpacklo_epi16(lo, hi);
+    px_hi = _mm256_unpackhi_epi16(lo, hi);
+    _mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(px_lo, px_hi, 0x20));
+    _mm256_storeu_si256((__m256i *)(dst + 8), _mm256_permute2x128_si256(px_lo, px_hi, 0x31));
+}
+
+static int SDL_TARGETING("avx2") YUV16ToRGB_Rows_AVX2(const YUV16ToRGBParams *params, const Uint16 *y0, const Uint16 *y1, const Uint16 *uv, int width, Uint32 *dst0, Uint32 *dst1)
+{
+    const __m256i offset = _mm256_set1_epi16(512);
+    const __m256i round = _mm256_set1_epi32(1 << (params->shift - 1));
+    const __m256i r_factors = _mm256_set1_epi32((int)((Uint32)(Uint16)params->v_r_factor << 16));
+    const __m256i g_factors = _mm256_set1_epi32((int)(((Uint32)(Uint16)params->v_g_factor << 16) | (Uint16)params->u_g_factor));
+    const __m256i b_factors = _mm256_set1_epi32((Uint16)params->u_b_factor);
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        /* Eight U/V pairs */
+        const __m256i uvs = _mm256_sub_epi16(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(uv + x)), 6), offset);
+        const __m256i r = _mm256_add_epi32(_mm256_madd_epi16(uvs, r_factors), round);
+        const __m256i g = _mm256_add_epi32(_mm256_madd_epi16(uvs, g_factors), round);
+        const __m256i b = _mm256_add_epi32(_mm256_madd_epi16(uvs, b_factors), round);
+        __m256i r_uv[2], g_uv[2], b_uv[2];
+
+        r_uv[0] = _mm256_unpacklo_epi32(r, r);
+        r_uv[1] = _mm256_unpackhi_epi32(r, r);
+        g_uv[0] = _mm256_unpacklo_epi32(g, g);
+        g_uv[1] = _mm256_unpackhi_epi32(g, g);
+        b_uv[0] = _mm256_unpacklo_epi32(b, b);
+        b_uv[1] = _mm256_unpackhi_epi32(b, b);
+
+        YUV16ToRGB_Store_AVX2(params, y0 + x, dst0 + x, r_uv, g_uv, b_uv);
+        YUV16ToRGB_Store_AVX2(params, y1 + x, dst1 + x, r_uv, g_uv, b_uv);
+    }
+    return x;
+}
+#endif /* SDL_AVX2_INTRINSICS */
+
+static int SDL_ConvertPixels_YUV16_to_RGB(int width, int height, Uint32 src_format, const void *src, int src_pitch,
+                                          Uint32 dst_format, void *dst, int dst_pitch)
+{
+    YUV16ToRGBParams params;
+    YUV16ToRGBFunc rows = NULL;
+    const Uint8 *plane_y;
+    const Uint8 *plane_u;
+    const Uint8 *plane_v;
+    Uint32 y_stride, uv_stride;
+    int j;
+
+    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &plane_y, &plane_u, &plane_v, &y_stride, &uv_stride) < 0) {
+        return -1;
+    }
+    SetupYUV16ToRGBParams(&params, width, height, dst_format);
+
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        rows = YUV16ToRGB_Rows_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if (rows == NULL && SDL_HasSSE2()) {
+        rows = YUV16ToRGB_Rows_SSE2;
+    }
+#endif
+
+    /* The last row is repeated for odd heights */
+    for (j = 0; j < height; j += 2) {
+        const Uint16 *y0 = (const Uint16 *)(plane_y + j * y_stride);
+        const Uint16 *y1 = (j + 1 < height) ? (const Uint16 *)(plane_y + (j + 1) * y_stride) : y0;
+        const Uint16 *uv = (const Uint16 *)(plane_u + (j / 2) * uv_stride);
+        Uint32 *dst0 = (Uint32 *)((Uint8 *)dst + j * dst_pitch);
+        Uint32 *dst1 = (j + 1 < height) ? (Uint32 *)((Uint8 *)dst0 + dst_pitch) : dst0;
+        int x = 0;
+
+        if (rows) {
+            x = rows(&params, y0, y1, uv, width, dst0, dst1);
+        }
+        YUV16ToRGB_Rows_std(&params, y0, y1, uv, x, width, dst0, dst1);
+    }
+    return 0;
+}
+
 int SDL_ConvertPixels_YUV_to_RGB(int width, int height,
                                  Uint32 src_format, const void *src, int src_pitch,
                                  Uint32 dst_format, void *dst, int dst_pitch)
@@ -588,6 +1132,13 @@ int SDL_ConvertPixels_YUV_to_RGB(int width, int height,
     Uint32 uv_stride = 0;
     YCbCrType yuv_type = YCBCR_601;
 
+    if (IsPlanar2x2_16Format(src_format)) {
+        if (dst_format == SDL_PIXELFORMAT_ARGB8888 || dst_format == SDL_PIXELFORMAT_ARGB2101010) {
+            return SDL_ConvertPixels_YUV16_to_RGB(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+        }
+        goto convert_via_argb8888;
+    }
+
     if (GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
         return -1;
     }
@@ -596,18 +1147,11 @@ int SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         return -1;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
-        return 0;
-    }
-
-    if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
-        return 0;
-    }
-
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
+    if (yuv_rgb_threaded(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
         return 0;
     }
 
+convert_via_argb8888:
     /* No fast path for the RGB format, instead convert using an intermediate buffer */
     if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
         int ret;
@@ -643,87 +1187,444 @@ struct RGB2YUVFactors
     float v[3]; /* Rfactor, Gfactor, Bfactor */
 };
 
-static int SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+static const struct RGB2YUVFactors RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] = {
+    /* ITU-T T.871 (JPEG) */
+    {
+        0,
+        { 0.2990f, 0.5870f, 0.1140f },
+        { -0.1687f, -0.3313f, 0.5000f },
+        { 0.5000f, -0.4187f, -0.0813f },
+    },
+    /* ITU-R BT.601-7 */
+    {
+        16,
+        { 0.2568f, 0.5041f, 0.0979f },
+        { -0.1482f, -0.2910f, 0.4392f },
+        { 0.4392f, -0.3678f, -0.0714f },
+    },
+    /* ITU-R BT.709-6 */
+    {
+        16,
+        { 0.1826f, 0.6142f, 0.0620f },
+        { -0.1006f, -0.3386f, 0.4392f },
+        { 0.4392f, -0.3989f, -0.0403f },
+    },
+};
+
+/* The factors are applied in fixed point with 14 fractional bits. Results
+   are rounded the way the float conversion did it, (int)(x + 0.5f), which
+   truncates toward zero for negative chroma, and then offset and clamped. */
+#define RGB2YUV_SHIFT 14
+#define RGB2YUV_HALF  (1 << (RGB2YUV_SHIFT - 1))
+
+typedef struct RGB2YUVParams
 {
-    const int src_pitch_x_2 = src_pitch * 2;
-    const int height_half = height / 2;
-    const int height_remainder = (height & 0x1);
-    const int width_half = width / 2;
-    const int width_remainder = (width & 0x1);
-    int i, j;
+    Uint32 format; /* destination format */
+    int rshift, gshift, bshift;
+    Sint16 y[3], u[3], v[3];
+    int y_offset;
+} RGB2YUVParams;
 
-    static struct RGB2YUVFactors RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] = {
-        /* ITU-T T.871 (JPEG) */
-        {
-            0,
-            { 0.2990f, 0.5870f, 0.1140f },
-            { -0.1687f, -0.3313f, 0.5000f },
-            { 0.5000f, -0.4187f, -0.0813f },
-        },
-        /* ITU-R BT.601-7 */
-        {
-            16,
-            { 0.2568f, 0.5041f, 0.0979f },
-            { -0.1482f, -0.2910f, 0.4392f },
-            { 0.4392f, -0.3678f, -0.0714f },
-        },
-        /* ITU-R BT.709-6 */
-        {
-            16,
-            { 0.1826f, 0.6142f, 0.0620f },
-            { -0.1006f, -0.3386f, 0.4392f },
-            { 0.4392f, -0.3989f, -0.0403f },
-        },
-    };
+static SDL_INLINE int RGB2YUV_Round(int x)
+{
+    x += RGB2YUV_HALF;
+    return (x >= 0) ? (x >> RGB2YUV_SHIFT) : -(-x >> RGB2YUV_SHIFT);
+}
+
+#define RGB2YUV_CHANNEL(pixel, shift) (int)(((pixel) >> (shift)) & 0xFF)
+#define RGB2YUV_CLAMP(x)              (Uint8)SDL_clamp(x, 0, 255)
+#define RGB2YUV_Y(p, r, g, b)         RGB2YUV_CLAMP(RGB2YUV_Round((p)->y[0] * (r) + (p)->y[1] * (g) + (p)->y[2] * (b)) + (p)->y_offset)
+#define RGB2YUV_U(p, r, g, b)         RGB2YUV_CLAMP(RGB2YUV_Round((p)->u[0] * (r) + (p)->u[1] * (g) + (p)->u[2] * (b)) + 128)
+#define RGB2YUV_V(p, r, g, b)         RGB2YUV_CLAMP(RGB2YUV_Round((p)->v[0] * (r) + (p)->v[1] * (g) + (p)->v[2] * (b)) + 128)
+
+static void SetupRGB2YUVParams(RGB2YUVParams *params, int width, int height, Uint32 src_format, Uint32 dst_format)
+{
     const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[SDL_GetYUVConversionModeForResolution(width, height)];
+    const float scale = (float)(1 << RGB2YUV_SHIFT);
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int bpp, i;
+
+    SDL_GetMasksForPixelFormatEnum(src_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
+    params->format = dst_format;
+    params->rshift = SDL_MostSignificantBitIndex32(Rmask) - 7;
+    params->gshift = SDL_MostSignificantBitIndex32(Gmask) - 7;
+    params->bshift = SDL_MostSignificantBitIndex32(Bmask) - 7;
+    for (i = 0; i < 3; ++i) {
+        params->y[i] = (Sint16)SDL_lroundf(cvt->y[i] * scale);
+        params->u[i] = (Sint16)SDL_lroundf(cvt->u[i] * scale);
+        params->v[i] = (Sint16)SDL_lroundf(cvt->v[i] * scale);
+    }
+    params->y_offset = cvt->y_offset;
+}
 
-#define MAKE_Y(r, g, b) (Uint8)((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset)
-#define MAKE_U(r, g, b) (Uint8)((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 128)
-#define MAKE_V(r, g, b) (Uint8)((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 128)
-
-#define READ_2x2_PIXELS                                                                                     \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-    const Uint32 p3 = ((const Uint32 *)next_row)[2 * i];                                                    \
-    const Uint32 p4 = ((const Uint32 *)next_row)[2 * i + 1];                                                \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000) + (p3 & 0x00ff0000) + (p4 & 0x00ff0000)) >> 18; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00) + (p3 & 0x0000ff00) + (p4 & 0x0000ff00)) >> 10; \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff) + (p3 & 0x000000ff) + (p4 & 0x000000ff)) >> 2;
-
-#define READ_2x1_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)next_row)[2 * i];            \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;  \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;
-
-#define READ_1x2_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];        \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;  \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;
-
-#define READ_1x1_PIXEL                                  \
-    const Uint32 p = ((const Uint32 *)curr_row)[2 * i]; \
-    const Uint32 r = (p & 0x00ff0000) >> 16;            \
-    const Uint32 g = (p & 0x0000ff00) >> 8;             \
-    const Uint32 b = (p & 0x000000ff);
-
-#define READ_TWO_RGB_PIXELS                                  \
-    const Uint32 p = ((const Uint32 *)curr_row)[2 * i];      \
-    const Uint32 r = (p & 0x00ff0000) >> 16;                 \
-    const Uint32 g = (p & 0x0000ff00) >> 8;                  \
-    const Uint32 b = (p & 0x000000ff);                       \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i + 1]; \
-    const Uint32 r1 = (p1 & 0x00ff0000) >> 16;               \
-    const Uint32 g1 = (p1 & 0x0000ff00) >> 8;                \
-    const Uint32 b1 = (p1 & 0x000000ff);                     \
-    const Uint32 R = (r + r1) / 2;                           \
-    const Uint32 G = (g + g1) / 2;                           \
-    const Uint32 B = (b + b1) / 2;
-
-#define READ_ONE_RGB_PIXEL READ_1x1_PIXEL
+/* Each function converts a pair of source rows to 4:2:0, or one source row
+   to packed 4:2:2, and returns the number of pixels it handled, which is
+   even. The portable version finishes the rest of the row. Chroma is taken
+   from the truncated average of each 2x2 (or 2x1) block. */
+typedef int (*RGBToYUV420Func)(const RGB2YUVParams *params, const Uint8 *row0, const Uint8 *row1, int width,
+                               Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v, int uv_step);
+typedef int (*RGBToYUV422Func)(const RGB2YUVParams *params, const Uint8 *row, int width, Uint8 *dst);
+
+/* The last column is repeated for odd widths */
+static void RGBToYUV420_Rows_std(const RGB2YUVParams *params, const Uint8 *row0, const Uint8 *row1, int x, int width,
+                                 Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v, int uv_step)
+{
+    const Uint32 *src0 = (const Uint32 *)row0;
+    const Uint32 *src1 = (const Uint32 *)row1;
+
+    for (; x < width; x += 2) {
+        const int x1 = (x + 1 < width) ? x + 1 : x;
+        const Uint32 p1 = src0[x];
+        const Uint32 p2 = src0[x1];
+        const Uint32 p3 = src1[x];
+        const Uint32 p4 = src1[x1];
+        const int r1 = RGB2YUV_CHANNEL(p1, params->rshift), g1 = RGB2YUV_CHANNEL(p1, params->gshift), b1 = RGB2YUV_CHANNEL(p1, params->bshift);
+        const int r2 = RGB2YUV_CHANNEL(p2, params->rshift), g2 = RGB2YUV_CHANNEL(p2, params->gshift), b2 = RGB2YUV_CHANNEL(p2, params->bshift);
+        const int r3 = RGB2YUV_CHANNEL(p3, params->rshift), g3 = RGB2YUV_CHANNEL(p3, params->gshift), b3 = RGB2YUV_CHANNEL(p3, params->bshift);
+        const int r4 = RGB2YUV_CHANNEL(p4, params->rshift), g4 = RGB2YUV_CHANNEL(p4, params->gshift), b4 = RGB2YUV_CHANNEL(p4, params->bshift);
+        const int r = (r1 + r2 + r3 + r4) >> 2;
+        const int g = (g1 + g2 + g3 + g4) >> 2;
+        const int b = (b1 + b2 + b3 + b4) >> 2;
+
+        y0[x] = RGB2YUV_Y(params, r1, g1, b1);
+        y1[x] = RGB2YUV_Y(params, r3, g3, b3);
+        if (x1 != x) {
+            y0[x1] = RGB2YUV_Y(params, r2, g2, b2);
+            y1[x1] = RGB2YUV_Y(params, r4, g4, b4);
+        }
+        u[(x / 2) * uv_step] = RGB2YUV_U(params, r, g, b);
+        v[(x / 2) * uv_step] = RGB2YUV_V(params, r, g, b);
+    }
+}
+
+static void RGBToYUV422_Row_std(const RGB2YUVParams *params, const Uint8 *row, int x, int width, Uint8 *dst)
+{
+    const Uint32 *src = (const Uint32 *)row;
+    int y0_pos, y1_pos, u_pos, v_pos;
+
+    switch (params->format) {
+    case SDL_PIXELFORMAT_UYVY:
+        u_pos = 0, y0_pos = 1, v_pos = 2, y1_pos = 3;
+        break;
+    case SDL_PIXELFORMAT_YVYU:
+        y0_pos = 0, v_pos = 1, y1_pos = 2, u_pos = 3;
+        break;
+    default: /* SDL_PIXELFORMAT_YUY2 */
+        y0_pos = 0, u_pos = 1, y1_pos = 2, v_pos = 3;
+        break;
+    }
+
+    for (; x < width; x += 2) {
+        const Uint32 p1 = src[x];
+        const Uint32 p2 = src[(x + 1 < width) ? x + 1 : x];
+        const int r1 = RGB2YUV_CHANNEL(p1, params->rshift), g1 = RGB2YUV_CHANNEL(p1, params->gshift), b1 = RGB2YUV_CHANNEL(p1, params->bshift);
+        const int r2 = RGB2YUV_CHANNEL(p2, params->rshift), g2 = RGB2YUV_CHANNEL(p2, params->gshift), b2 = RGB2YUV_CHANNEL(p2, params->bshift);
+        const int r = (r1 + r2) >> 1;
+        const int g = (g1 + g2) >> 1;
+        const int b = (b1 + b2) >> 1;
+        Uint8 *out = dst + x * 2;
+
+        out[y0_pos] = RGB2YUV_Y(params, r1, g1, b1);
+        out[y1_pos] = RGB2YUV_Y(params, r2, g2, b2);
+        out[u_pos] = RGB2YUV_U(params, r, g, b);
+        out[v_pos] = RGB2YUV_V(params, r, g, b);
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+#define RGB2YUV_PAIR_SSE2(lo, hi) _mm_set1_epi32((int)(((Uint32)(Uint16)(hi) << 16) | (Uint16)(lo)))
+
+/* Reads eight pixels as three vectors of 16-bit channels */
+static void SDL_TARGETING("sse2") RGB2YUV_Load_SSE2(const Uint8 *src, const __m128i *shifts, __m128i *R, __m128i *G, __m128i *B)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i p0 = _mm_loadu_si128((const __m128i *)src);
+    const __m128i p1 = _mm_loadu_si128((const __m128i *)(src + 16));
+
+    *R = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(p0, shifts[0]), mask), _mm_and_si128(_mm_srl_epi32(p1, shifts[0]), mask));
+    *G = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(p0, shifts[1]), mask), _mm_and_si128(_mm_srl_epi32(p1, shifts[1]), mask));
+    *B = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(p0, shifts[2]), mask), _mm_and_si128(_mm_srl_epi32(p1, shifts[2]), mask));
+}
+
+/* RGB2YUV_Round(cR * R + cG * G + cB * B) + offset, with rg = (cR, cG) and
+   bk = (cB, RGB2YUV_HALF / 128), so the rounding term comes from B * 128 */
+static __m128i SDL_TARGETING("sse2") RGB2YUV_Apply_SSE2(__m128i R, __m128i G, __m128i B, __m128i rg, __m128i bk, __m128i offset)
+{
+    const __m128i k = _mm_set1_epi16(128);
+    const __m128i fraction = _mm_set1_epi32((1 << RGB2YUV_SHIFT) - 1);
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(R, G), rg), _mm_madd_epi16(_mm_unpacklo_epi16(B, k), bk));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(R, G), rg), _mm_madd_epi16(_mm_unpackhi_epi16(B, k), bk));
+
+    /* Truncate toward zero */
+    lo = _mm_add_epi32(lo, _mm_and_si128(_mm_srai_epi32(lo, 31), fraction));
+    hi = _mm_add_epi32(hi, _mm_and_si128(_mm_srai_epi32(hi, 31), fraction));
+    return _mm_add_epi16(_mm_packs_epi32(_mm_srai_epi32(lo, RGB2YUV_SHIFT), _mm_srai_epi32(hi, RGB2YUV_SHIFT)), offset);
+}
+
+/* Sums adjacent pairs of 16-bit lanes from two vectors into one vector and divides by 2^shift */
+static __m128i SDL_TARGETING("sse2") RGB2YUV_PairSum_SSE2(__m128i a, __m128i b, int shift)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    return _mm_srli_epi16(_mm_packs_epi32(_mm_madd_epi16(a, ones), _mm_madd_epi16(b, ones)), shift);
+}
+
+static int SDL_TARGETING("sse2") RGBToYUV420_Rows_SSE2(const RGB2YUVParams *params, const Uint8 *row0, const Uint8 *row1, int width,
+                                                      Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v, int uv_step)
+{
+    const __m128i shifts[3] = { _mm_cvtsi32_si128(params->rshift), _mm_cvtsi32_si128(params->gshift), _mm_cvtsi32_si128(params->bshift) };
+    const __m128i y_rg = RGB2YUV_PAIR_SSE2(params->y[0], params->y[1]);
+    const __m128i y_bk = RGB2YUV_PAIR_SSE2(params->y[2], RGB2YUV_HALF / 128);
+    const __m128i u_rg = RGB2YUV_PAIR_SSE2(params->u[0], params->u[1]);
+    const __m128i u_bk = RGB2YUV_PAIR_SSE2(params->u[2], RGB2YUV_HALF / 128);
+    const __m128i v_rg = RGB2YUV_PAIR_SSE2(params->v[0], params->v[1]);
+    const __m128i v_bk = RGB2YUV_PAIR_SSE2(params->v[2], RGB2YUV_HALF / 128);
+    const __m128i y_offset = _mm_set1_epi16((short)params->y_offset);
+    const __m128i uv_offset = _mm_set1_epi16(128);
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m128i R0a, G0a, B0a, R0b, G0b, B0b, R1a, G1a, B1a, R1b, G1b, B1b;
+        __m128i R, G, B, uv;
+
+        RGB2YUV_Load_SSE2(row0 + x * 4, shifts, &R0a, &G0a, &B0a);
+        RGB2YUV_Load_SSE2(row0 + x * 4 + 32, shifts, &R0b, &G0b, &B0b);
+        RGB2YUV_Load_SSE2(row1 + x * 4, shifts, &R1a, &G1a, &B1a);
+        RGB2YUV_Load_SSE2(row1 + x * 4 + 32, shifts, &R1b, &G1b, &B1b);
+
+        _mm_storeu_si128((__m128i *)(y0 + x), _mm_packus_epi16(RGB2YUV_Apply_SSE2(R0a, G0a, B0a, y_rg, y_bk, y_offset), RGB2YUV_Apply_SSE2(R0b, G0b, B0b, y_rg, y_bk, y_offset)));
+        _mm_storeu_si128((__m128i *)(y1 + x), _mm_packus_epi16(RGB2YUV_Apply_SSE2(R1a, G1a, B1a, y_rg, y_bk, y_offset), RGB2YUV_Apply_SSE2(R1b, G1b, B1b, y_rg, y_bk, y_offset)));
+
+        R = RGB2YUV_PairSum_SSE2(_mm_add_epi16(R0a, R1a), _mm_add_epi16(R0b, R1b), 2);
+        G = RGB2YUV_PairSum_SSE2(_mm_add_epi16(G0a, G1a), _mm_add_epi16(G0b, G1b), 2);
+        B = RGB2YUV_PairSum_SSE2(_mm_add_epi16(B0a, B1a), _mm_add_epi16(B0b, B1b), 2);
+
+        /* Eight U in the low half, eight V in the high half */
+        uv = _mm_packus_epi16(RGB2YUV_Apply_SSE2(R, G, B, u_rg, u_bk, uv_offset), RGB2YUV_Apply_SSE2(R, G, B, v_rg, v_bk, uv_offset));
+        if (uv_step == 1) {
+            _mm_storel_epi64((__m128i *)(u + x / 2), uv);
+            _mm_storel_epi64((__m128i *)(v + x / 2), _mm_srli_si128(uv, 8));
+        } else if (u < v) {
+            _mm_storeu_si128((__m128i *)(u + x), _mm_unpacklo_epi8(uv, _mm_srli_si128(uv, 8)));
+        } else {
+            _mm_storeu_si128((__m128i *)(v + x), _mm_unpacklo_epi8(_mm_srli_si128(uv, 8), uv));
+        }
+    }
+    return x;
+}
+
+static int SDL_TARGETING("sse2") RGBToYUV422_Row_SSE2(const RGB2YUVParams *params, const Uint8 *row, int width, Uint8 *dst)
+{
+    const __m128i shifts[3] = { _mm_cvtsi32_si128(params->rshift), _mm_cvtsi32_si128(params->gshift), _mm_cvtsi32_si128(params->bshift) };
+    const __m128i y_rg = RGB2YUV_PAIR_SSE2(params->y[0], params->y[1]);
+    const __m128i y_bk = RGB2YUV_PAIR_SSE2(params->y[2], RGB2YUV_HALF / 128);
+    const __m128i u_rg = RGB2YUV_PAIR_SSE2(params->u[0], params->u[1]);
+    const __m128i u_bk = RGB2YUV_PAIR_SSE2(params->u[2], RGB2YUV_HALF / 128);
+    const __m128i v_rg = RGB2YUV_PAIR_SSE2(params->v[0], params->v[1]);
+    const __m128i v_bk = RGB2YUV_PAIR_SSE2(params->v[2], RGB2YUV_HALF / 128);
+    const __m128i y_offset = _mm_set1_epi16((short)params->y_offset);
+    const __m128i uv_offset = _mm_set1_epi16(128);
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m128i Ra, Ga, Ba, Rb, Gb, Bb;
+        __m128i R, G, B, Y, U, V, c;
+
+        RGB2YUV_Load_SSE2(row + x * 4, shifts, &Ra, &Ga, &Ba);
+        RGB2YUV_Load_SSE2(row + x * 4 + 32, shifts, &Rb, &Gb, &Bb);
+
+        Y = _mm_packus_epi16(RGB2YUV_Apply_SSE2(Ra, Ga, Ba, y_rg, y_bk, y_offset), RGB2YUV_Apply_SSE2(Rb, Gb, Bb, y_rg, y_bk, y_offset));
+
+        R = RGB2YUV_PairSum_SSE2(Ra, Rb, 1);
+        G = RGB2YUV_PairSum_SSE2(Ga, Gb, 1);
+        B = RGB2YUV_PairSum_SSE2(Ba, Bb, 1);
+        U = RGB2YUV_Apply_SSE2(R, G, B, u_rg, u_bk, uv_offset);
+        V = RGB2YUV_Apply_SSE2(R, G, B, v_rg, v_bk, uv_offset);
+        U = _mm_packus_epi16(U, U);
+        V = _mm_packus_epi16(V, V);
+
+        switch (params->format) {
+        case SDL_PIXELFORMAT_UYVY:
+            c = _mm_unpacklo_epi8(U, V);
+            _mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(c, Y));
+            _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(c, Y));
+            break;
+        case SDL_PIXELFORMAT_YVYU:
+            c = _mm_unpacklo_epi8(V, U);
+            _mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(Y, c));
+            _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(Y, c));
+            break;
+        default: /* SDL_PIXELFORMAT_YUY2 */
+            c = _mm_unpacklo_epi8(U, V);
+            _mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(Y, c));
+            _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(Y, c));
+            break;
+        }
+    }
+    return x;
+}
+#endif /* SDL_SSE2_INTRINSICS */
+
+#ifdef SDL_AVX2_INTRINSICS
+#define RGB2YUV_PAIR_AVX2(lo, hi) _mm256_set1_epi32((int)(((Uint32)(Uint16)(hi) << 16) | (Uint16)(lo)))
+
+/* Undoes the lane interleaving of the 256-bit pack instructions */
+#define RGB2YUV_FIXUP_AVX2(x) _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0))
+
+/* Reads sixteen pixels as three vectors of 16-bit channels */
+static void SDL_TARGETING("avx2") RGB2YUV_Load_AVX2(const Uint8 *src, const __m128i *shifts, __m256i *R, __m256i *G, __m256i *B)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i p0 = _mm256_loadu_si256((const __m256i *)src);
+    const __m256i p1 = _mm256_loadu_si256((const __m256i *)(src + 32));
+
+    *R = RGB2YUV_FIXUP_AVX2(_mm256_packs_epi32(_mm256_and_si256(_mm256_srl_epi32(p0, shifts[0]), mask), _mm256_and_si256(_mm256_srl_epi32(p1, shifts[0]), mask)));
+    *G = RGB2YUV_FIXUP_AVX2(_mm256_packs_epi32(_mm256_and_si256(_mm256_srl_epi32(p0, shifts[1]), mask), _mm256_and_si256(_mm256_srl_epi32(p1, shifts[1]), mask)));
+    *B = RGB2YUV_FIXUP_AVX2(_mm256_packs_epi32(_mm256_and_si256(_mm256_srl_epi32(p0, shifts[2]), mask), _mm256_and_si256(_mm256_srl_epi32(p1, shifts[2]), mask)));
+}
+
+static __m256i SDL_TARGETING("avx2") RGB2YUV_Apply_AVX2(__m256i R, __m256i G, __m256i B, __m256i rg, __m256i bk, __m256i offset)
+{
+    const __m256i k = _mm256_set1_epi16(128);
+    const __m256i fraction = _mm256_set1_epi32((1 << RGB2YUV_SHIFT) - 1);
+    __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(R, G), rg), _mm256_madd_epi16(_mm256_unpacklo_epi16(B, k), bk));
+    __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(R, G), rg), _mm256_madd_epi16(_mm256_unpackhi_epi16(B, k), bk));
+
+    lo = _mm256_add_epi32(lo, _mm256_and_si256(_mm256_srai_epi32(lo, 31), fraction));
+    hi = _mm256_add_epi32(hi, _mm256_and_si256(_mm256_srai_epi32(hi, 31), fraction));
+
+    /* Unpack and pack both work within 128-bit lanes, so the order is kept */
+    return _mm256_add_epi16(_mm256_packs_epi32(_mm256_srai_epi32(lo, RGB2YUV_SHIFT), _mm256_srai_epi32(hi, RGB2YUV_SHIFT)), offset);
+}
+
+static __m256i SDL_TARGETING("avx2") RGB2YUV_PairSum_AVX2(__m256i a, __m256i b, int shift)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    return _mm256_srli_epi16(RGB2YUV_FIXUP_AVX2(_mm256_packs_epi32(_mm256_madd_epi16(a, ones), _mm256_madd_epi16(b, ones))), shift);
+}
+
+static int SDL_TARGETING("avx2") RGBToYUV420_Rows_AVX2(const RGB2YUVParams *params, const Uint8 *row0, const Uint8 *row1, int width,
+                                                      Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v, int uv_step)
+{
+    const __m128i shifts[3] = { _mm_cvtsi32_si128(params->rshift), _mm_cvtsi32_si128(params->gshift), _mm_cvtsi32_si128(params->bshift) };
+    const __m256i y_rg = RGB2YUV_PAIR_AVX2(params->y[0], params->y[1]);
+    const __m256i y_bk = RGB2YUV_PAIR_AVX2(params->y[2], RGB2YUV_HALF / 128);
+    const __m256i u_rg = RGB2YUV_PAIR_AVX2(params->u[0], params->u[1]);
+    const __m256i u_bk = RGB2YUV_PAIR_AVX2(params->u[2], RGB2YUV_HALF / 128);
+    const __m256i v_rg = RGB2YUV_PAIR_AVX2(params->v[0], params->v[1]);
+    const __m256i v_bk = RGB2YUV_PAIR_AVX2(params->v[2], RGB2YUV_HALF / 128);
+    const __m256i y_offset = _mm256_set1_epi16((short)params->y_offset);
+    const __m256i uv_offset = _mm256_set1_epi16(128);
+    int x;
+
+    for (x = 0; x + 32 <= width; x += 32) {
+        __m256i R0a, G0a, B0a, R0b, G0b, B0b, R1a, G1a, B1a, R1b, G1b, B1b;
+        __m256i R, G, B, uv;
+        __m128i U, V;
+
+        RGB2YUV_Load_AVX2(row0 + x * 4, shifts, &R0a, &G0a, &B0a);
+        RGB2YUV_Load_AVX2(row0 + x * 4 + 64, shifts, &R0b, &G0b, &B0b);
+        RGB2YUV_Load_AVX2(row1 + x * 4, shifts, &R1a, &G1a, &B1a);
+        RGB2YUV_Load_AVX2(row1 + x * 4 + 64, shifts, &R1b, &G1b, &B1b);
+
+        _mm256_storeu_si256((__m256i *)(y0 + x), RGB2YUV_FIXUP_AVX2(_mm256_packus_epi16(RGB2YUV_Apply_AVX2(R0a, G0a, B0a, y_rg, y_bk, y_offset), RGB2YUV_Apply_AVX2(R0b, G0b, B0b, y_rg, y_bk, y_offset))));
+        _mm256_storeu_si256((__m256i *)(y1 + x), RGB2YUV_FIXUP_AVX2(_mm256_packus_epi16(RGB2YUV_Apply_AVX2(R1a, G1a, B1a, y_rg, y_bk, y_offset), RGB2YUV_Apply_AVX2(R1b, G1b, B1b, y_rg, y_bk, y_offset))));
+
+        R = RGB2YUV_PairSum_AVX2(_mm256_add_epi16(R0a, R1a), _mm256_add_epi16(R0b, R1b), 2);
+        G = RGB2YUV_PairSum_AVX2(_mm256_add_epi16(G0a, G1a), _mm256_add_epi16(G0b, G1b), 2);
+        B = RGB2YUV_PairSum_AVX2(_mm256_add_epi16(B0a, B1a), _mm256_add_epi16(B0b, B1b), 2);
+
+        /* Sixteen U in the low lane, sixteen V in the high lane */
+        uv = RGB2YUV_FIXUP_AVX2(_mm256_packus_epi16(RGB2YUV_Apply_AVX2(R, G, B, u_rg, u_bk, uv_offset), RGB2YUV_Apply_AVX2(R, G, B, v_rg, v_bk, uv_offset)));
+        U = _mm256_castsi256_si128(uv);
+        V = _mm256_extracti128_si256(uv, 1);
+        if (uv_step == 1) {
+            _mm_storeu_si128((__m128i *)(u + x / 2), U);
+            _mm_storeu_si128((__m128i *)(v + x / 2), V);
+        } else if (u < v) {
+            _mm_storeu_si128((__m128i *)(u + x), _mm_unpacklo_epi8(U, V));
+            _mm_storeu_si128((__m128i *)(u + x + 16), _mm_unpackhi_epi8(U, V));
+        } else {
+            _mm_storeu_si128((__m128i *)(v + x), _mm_unpacklo_epi8(V, U));
+            _mm_storeu_si128((__m128i *)(v + x + 16), _mm_unpackhi_epi8(V, U));
+        }
+    }
+    return x;
+}
+
+static int SDL_TARGETING("avx2") RGBToYUV422_Row_AVX2(const RGB2YUVParams *params, const Uint8 *row, int width, Uint8 *dst)
+{
+    const __m128i shifts[3] = { _mm_cvtsi32_si128(params->rshift), _mm_cvtsi32_si128(params->gshift), _mm_cvtsi32_si128(params->bshift) };
+    const __m256i y_rg = RGB2YUV_PAIR_AVX2(params->y[0], params->y[1]);
+    const __m256i y_bk = RGB2YUV_PAIR_AVX2(params->y[2], RGB2YUV_HALF / 128);
+    const __m256i u_rg = RGB2YUV_PAIR_AVX2(params->u[0], params->u[1]);
+    const __m256i u_bk = RGB2YUV_PAIR_AVX2(params->u[2], RGB2YUV_HALF / 128);
+    const __m256i v_rg = RGB2YUV_PAIR_AVX2(params->v[0], params->v[1]);
+    const __m256i v_bk = RGB2YUV_PAIR_AVX2(params->v[2], RGB2YUV_HALF / 128);
+    const __m256i y_offset = _mm256_set1_epi16((short)params->y_offset);
+    const __m256i uv_offset = _mm256_set1_epi16(128);
+    int x;
+
+    for (x = 0; x + 32 <= width; x += 32) {
+        __m256i Ra, Ga, Ba, Rb, Gb, Bb;
+        __m256i R, G, B, Y, uv;
+        __m128i Ylo, Yhi, U, V, clo, chi, first_lo, first_hi, second_lo, second_hi;
+
+        RGB2YUV_Load_AVX2(row + x * 4, shifts, &Ra, &Ga, &Ba);
+        RGB2YUV_Load_AVX2(row + x * 4 + 64, shifts, &Rb, &Gb, &Bb);
+
+        Y = RGB2YUV_FIXUP_AVX2(_mm256_packus_epi16(RGB2YUV_Apply_AVX2(Ra, Ga, Ba, y_rg, y_bk, y_offset), RGB2YUV_Apply_AVX2(Rb, Gb, Bb, y_rg, y_bk, y_offset)));
+        Ylo = _mm256_castsi256_si128(Y);
+        Yhi = _mm256_extracti128_si256(Y, 1);
+
+        R = RGB2YUV_PairSum_AVX2(Ra, Rb, 1);
+        G = RGB2YUV_PairSum_AVX2(Ga, Gb, 1);
+        B = RGB2YUV_PairSum_AVX2(Ba, Bb, 1);
+        uv = RGB2YUV_FIXUP_AVX2(_mm256_packus_epi16(RGB2YUV_Apply_AVX2(R, G, B, u_rg, u_bk, uv_offset), RGB2YUV_Apply_AVX2(R, G, B, v_rg, v_bk, uv_offset)));
+        U = _mm256_castsi256_si128(uv);
+        V = _mm256_extracti128_si256(uv, 1);
+
+        if (params->format == SDL_PIXELFORMAT_YVYU) {
+            clo = _mm_unpacklo_epi8(V, U);
+            chi = _mm_unpackhi_epi8(V, U);
+        } else {
+            clo = _mm_unpacklo_epi8(U, V);
+            chi = _mm_unpackhi_epi8(U, V);
+        }
+        if (params->format == SDL_PIXELFORMAT_UYVY) {
+            first_lo = clo, first_hi = chi, second_lo = Ylo, second_hi = Yhi;
+        } else {
+            first_lo = Ylo, first_hi = Yhi, second_lo = clo, second_hi = chi;
+        }
+        _mm_storeu_si128((__m128i *)(dst + x * 2), _mm_unpacklo_epi8(first_lo, second_lo));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 16), _mm_unpackhi_epi8(first_lo, second_lo));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 32), _mm_unpacklo_epi8(first_hi, second_hi));
+        _mm_storeu_si128((__m128i *)(dst + x * 2 + 48), _mm_unpackhi_epi8(first_hi, second_hi));
+    }
+    return x;
+}
+#endif /* SDL_AVX2_INTRINSICS */
+
+static int SDL_ConvertPixels_8888_to_YUV(int width, int height, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+{
+    RGB2YUVParams params;
+    RGBToYUV420Func rows420 = NULL;
+    RGBToYUV422Func row422 = NULL;
+    int j;
+
+    SetupRGB2YUVParams(&params, width, height, src_format, dst_format);
+
+#ifdef SDL_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        rows420 = RGBToYUV420_Rows_AVX2;
+        row422 = RGBToYUV422_Row_AVX2;
+    }
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+    if (rows420 == NULL && SDL_HasSSE2()) {
+        rows420 = RGBToYUV420_Rows_SSE2;
+        row422 = RGBToYUV422_Row_SSE2;
+    }
+#endif
 
     switch (dst_format) {
     case SDL_PIXELFORMAT_YV12:
@@ -731,13 +1632,11 @@ static int SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
     {
-        const Uint8 *curr_row, *next_row;
-
+        const int uv_step = (dst_format == SDL_PIXELFORMAT_NV12 || dst_format == SDL_PIXELFORMAT_NV21) ? 2 : 1;
         Uint8 *plane_y;
         Uint8 *plane_u;
         Uint8 *plane_v;
-        Uint8 *plane_interleaved_uv;
-        Uint32 y_stride, uv_stride, y_skip, uv_skip;
+        Uint32 y_stride, uv_stride;
 
         if (GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
                          (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
@@ -745,119 +1644,20 @@ static int SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *
             return -1;
         }
 
-        plane_interleaved_uv = (plane_y + height * y_stride);
-        y_skip = (y_stride - width);
-
-        curr_row = (const Uint8 *)src;
+        /* The last row is repeated for odd heights */
+        for (j = 0; j < height; j += 2) {
+            const Uint8 *row0 = (const Uint8 *)src + j * src_pitch;
+            const Uint8 *row1 = (j + 1 < height) ? row0 + src_pitch : row0;
+            Uint8 *y0 = plane_y + j * y_stride;
+            Uint8 *y1 = (j + 1 < height) ? y0 + y_stride : y0;
+            Uint8 *u = plane_u + (j / 2) * uv_stride;
+            Uint8 *v = plane_v + (j / 2) * uv_stride;
+            int x = 0;
 
-        /* Write Y plane */
-        for (j = 0; j < height; j++) {
-            for (i = 0; i < width; i++) {
-                const Uint32 p1 = ((const Uint32 *)curr_row)[i];
-                const Uint32 r = (p1 & 0x00ff0000) >> 16;
-                const Uint32 g = (p1 & 0x0000ff00) >> 8;
-                const Uint32 b = (p1 & 0x000000ff);
-                *plane_y++ = MAKE_Y(r, g, b);
-            }
-            plane_y += y_skip;
-            curr_row += src_pitch;
-        }
-
-        curr_row = (const Uint8 *)src;
-        next_row = (const Uint8 *)src;
-        next_row += src_pitch;
-
-        if (dst_format == SDL_PIXELFORMAT_YV12 || dst_format == SDL_PIXELFORMAT_IYUV) {
-            /* Write UV planes, not interleaved */
-            uv_skip = (uv_stride - (width + 1) / 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
-                }
-                plane_u += uv_skip;
-                plane_v += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
-            }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
-                }
-                plane_u += uv_skip;
-                plane_v += uv_skip;
-            }
-        } else if (dst_format == SDL_PIXELFORMAT_NV12) {
-            uv_skip = (uv_stride - ((width + 1) / 2) * 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-                plane_interleaved_uv += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
-            }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-            }
-        } else /* dst_format == SDL_PIXELFORMAT_NV21 */ {
-            uv_skip = (uv_stride - ((width + 1) / 2) * 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
-                plane_interleaved_uv += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
-            }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
+            if (rows420) {
+                x = rows420(&params, row0, row1, width, y0, y1, u, v, uv_step);
             }
+            RGBToYUV420_Rows_std(&params, row0, row1, x, width, y0, y1, u, v, uv_step);
         }
     } break;
 
@@ -865,95 +1665,28 @@ static int SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
     {
-        const Uint8 *curr_row = (const Uint8 *)src;
-        Uint8 *plane = (Uint8 *)dst;
         const int row_size = (4 * ((width + 1) / 2));
-        int plane_skip;
 
         if (dst_pitch < row_size) {
             return SDL_SetError("Destination pitch is too small, expected at least %d\n", row_size);
         }
-        plane_skip = (dst_pitch - row_size);
 
         /* Write YUV plane, packed */
-        if (dst_format == SDL_PIXELFORMAT_YUY2) {
-            for (j = 0; j < height; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_TWO_RGB_PIXELS;
-                    /* Y U Y1 V */
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_U(R, G, B);
-                    *plane++ = MAKE_Y(r1, g1, b1);
-                    *plane++ = MAKE_V(R, G, B);
-                }
-                if (width_remainder) {
-                    READ_ONE_RGB_PIXEL;
-                    /* Y U Y V */
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_U(r, g, b);
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_V(r, g, b);
-                }
-                plane += plane_skip;
-                curr_row += src_pitch;
-            }
-        } else if (dst_format == SDL_PIXELFORMAT_UYVY) {
-            for (j = 0; j < height; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_TWO_RGB_PIXELS;
-                    /* U Y V Y1 */
-                    *plane++ = MAKE_U(R, G, B);
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_V(R, G, B);
-                    *plane++ = MAKE_Y(r1, g1, b1);
-                }
-                if (width_remainder) {
-                    READ_ONE_RGB_PIXEL;
-                    /* U Y V Y */
-                    *plane++ = MAKE_U(r, g, b);
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_V(r, g, b);
-                    *plane++ = MAKE_Y(r, g, b);
-                }
-                plane += plane_skip;
-                curr_row += src_pitch;
-            }
-        } else if (dst_format == SDL_PIXELFORMAT_YVYU) {
-            for (j = 0; j < height; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_TWO_RGB_PIXELS;
-                    /* Y V Y1 U */
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_V(R, G, B);
-                    *plane++ = MAKE_Y(r1, g1, b1);
-                    *plane++ = MAKE_U(R, G, B);
-                }
-                if (width_remainder) {
-                    READ_ONE_RGB_PIXEL;
-                    /* Y V Y U */
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_V(r, g, b);
-                    *plane++ = MAKE_Y(r, g, b);
-                    *plane++ = MAKE_U(r, g, b);
-                }
-                plane += plane_skip;
-                curr_row += src_pitch;
+        for (j = 0; j < height; j++) {
+            const Uint8 *row = (const Uint8 *)src + j * src_pitch;
+            Uint8 *plane = (Uint8 *)dst + j * dst_pitch;
+            int x = 0;
+
+            if (row422) {
+                x = row422(&params, row, width, plane);
             }
+            RGBToYUV422_Row_std(&params, row, x, width, plane);
         }
     } break;
 
     default:
         return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
     }
-#undef MAKE_Y
-#undef MAKE_U
-#undef MAKE_V
-#undef READ_2x2_PIXELS
-#undef READ_2x1_PIXELS
-#undef READ_1x2_PIXELS
-#undef READ_1x1_PIXEL
-#undef READ_TWO_RGB_PIXELS
-#undef READ_ONE_RGB_PIXEL
     return 0;
 }
 
@@ -984,12 +1717,12 @@ int SDL_ConvertPixels_RGB_to_YUV(int width, int height,
     }
 #endif
 
-    /* ARGB8888 to FOURCC */
-    if (src_format == SDL_PIXELFORMAT_ARGB8888) {
-        return SDL_ConvertPixels_ARGB8888_to_YUV(width, height, src, src_pitch, dst_format, dst, dst_pitch);
+    /* 8888 to FOURCC, reading the channels in place */
+    if (SDL_Is8888Format(src_format)) {
+        return SDL_ConvertPixels_8888_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
     }
 
-    /* not ARGB8888 to FOURCC : need an intermediate conversion */
+    /* not 8888 to FOURCC : need an intermediate conversion */
     {
         int ret;
         void *tmp;
@@ -1008,7 +1741,7 @@ int SDL_ConvertPixels_RGB_to_YUV(int width, int height,
         }
 
         /* convert tmp/ARGB8888 to dst/FOURCC */
-        ret = SDL_ConvertPixels_ARGB8888_to_YUV(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch);
+        ret = SDL_ConvertPixels_8888_to_YUV(width, height, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch, dst_format, dst, dst_pitch);
         SDL_free(tmp);
         return ret;
     }
@@ -1053,6 +1786,27 @@ static int SDL_ConvertPixels_YUV_to_YUV_Copy(int width, int height, Uint32 forma
         return 0;
     }
 
+    if (IsPlanar2x2_16Format(format)) {
+        /* Y plane */
+        for (i = height; i--;) {
+            SDL_memcpy(dst, src, (size_t)width * 2);
+            src = (const Uint8 *)src + src_pitch;
+            dst = (Uint8 *)dst + dst_pitch;
+        }
+
+        /* U/V plane is half the height of the Y plane, rounded up */
+        height = (height + 1) / 2;
+        width = ((width + 1) / 2) * 4;
+        src_pitch = ((src_pitch + 3) / 4) * 4;
+        dst_pitch = ((dst_pitch + 3) / 4) * 4;
+        for (i = height; i--;) {
+            SDL_memcpy(dst, src, width);
+            src = (const Uint8 *)src + src_pitch;
+            dst = (Uint8 *)dst + dst_pitch;
+        }
+        return 0;
+    }
+
     if (IsPacked4Format(format)) {
         /* Packed planes */
         width = 4 * ((width + 1) / 2);
@@ -0,0 +1,325 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#ifdef SDL_VIDEO_DRIVER_OFFSCREEN
+
+/* Frame capture for the offscreen driver, configured by environment variables:
+
+   SDL_VIDEO_OFFSCREEN_SAVE_FRAMES: save each frame to a numbered file,
+     SDL_window<id>-<frame>.bmp, or .ppm if the variable is set to "ppm".
+   SDL_VIDEO_OFFSCREEN_CAPTURE_FILE: write the frames as raw pixels to this
+     file, which may be a pipe such as /dev/stdout. The pixels are in the
+     framebuffer format, XRGB8888, without padding between rows.
+   SDL_VIDEO_OFFSCREEN_CAPTURE_BUFFERS: the number of frames that can be
+     waiting to be written, 3 by default.
+
+   The frames are copied to a ring of buffers and written by a separate
+   thread, so that rendering never waits for the disk or the pipe. When all
+   the buffers are in use, the frame is dropped, and the number of dropped
+   frames is logged when the window is destroyed.
+*/
+
+#include "../SDL_sysvideo.h"
+#include "../../thread/SDL_systhread.h"
+#include "SDL_offscreencapture_c.h"
+
+#define DEFAULT_CAPTURE_BUFFERS 3
+#define MAX_CAPTURE_BUFFERS     64
+
+typedef enum
+{
+    CAPTURE_OUTPUT_BMP,
+    CAPTURE_OUTPUT_PPM,
+    CAPTURE_OUTPUT_RAW
+} SDL_OffscreenCaptureOutput;
+
+typedef struct
+{
+    Uint8 *pixels;
+    size_t size;
+    int w, h;
+    int frame_number;
+} SDL_OffscreenCaptureFrame;
+
+struct SDL_OffscreenCapture
+{
+    SDL_WindowID window_id;
+    SDL_OffscreenCaptureOutput output;
+    SDL_RWops *stream;
+
+    SDL_Thread *thread;
+    SDL_Mutex *lock;
+    SDL_Condition *cond;
+    SDL_bool quit;
+
+    /* The frames waiting to be written start at head, the writer thread
+       owns them and the rendering thread owns the others */
+    SDL_OffscreenCaptureFrame *frames;
+    int num_frames;
+    int head;
+    int count;
+
+    int written;
+    int dropped;
+};
+
+/* Numbered like the windows' frames used to be, across all windows */
+static SDL_AtomicInt frame_number;
+
+static int WriteFramePPM(SDL_OffscreenCaptureFrame *frame, const char *file)
+{
+    SDL_RWops *dst;
+    Uint8 *row;
+    char header[64];
+    int x, y;
+    int retval = 0;
+
+    row = (Uint8 *)SDL_malloc((size_t)frame->w * 3);
+    if (row == NULL) {
+        return SDL_OutOfMemory();
+    }
+    dst = SDL_RWFromFile(file, "wb");
+    if (dst == NULL) {
+        SDL_free(row);
+        return -1;
+    }
+
+    (void)SDL_snprintf(header, sizeof(header), "P6\n%d %d\n255\n", frame->w, frame->h);
+    if (SDL_RWwrite(dst, header, SDL_strlen(header)) < 0) {
+        retval = -1;
+    }
+    for (y = 0; y < frame->h && retval == 0; ++y) {
+        const Uint32 *src = (const Uint32 *)(frame->pixels + (size_t)y * frame->w * 4);
+        for (x = 0; x < frame->w; ++x) {
+            row[x * 3 + 0] = (Uint8)(src[x] >> 16);
+            row[x * 3 + 1] = (Uint8)(src[x] >> 8);
+            row[x * 3 + 2] = (Uint8)src[x];
+        }
+        if (SDL_RWwrite(dst, row, (Sint64)frame->w * 3) < 0) {
+            retval = -1;
+        }
+    }
+
+    if (SDL_RWclose(dst) < 0) {
+        retval = -1;
+    }
+    SDL_free(row);
+    return retval;
+}
+
+static int WriteFrame(SDL_OffscreenCapture *capture, SDL_OffscreenCaptureFrame *frame)
+{
+    char file[128];
+    SDL_Surface *surface;
+    int retval;
+
+    switch (capture->output) {
+    case CAPTURE_OUTPUT_RAW:
+        if (SDL_RWwrite(capture->stream, frame->pixels, (Sint64)frame->w * frame->h * 4) < 0) {
+            return -1;
+        }
+        return 0;
+
+    case CAPTURE_OUTPUT_PPM:
+        (void)SDL_snprintf(file, sizeof(file), "SDL_window%" SDL_PRIu32 "-%8.8d.ppm",
+                           capture->window_id, frame->frame_number);
+        return WriteFramePPM(frame, file);
+
+    default:
+        (void)SDL_snprintf(file, sizeof(file), "SDL_window%" SDL_PRIu32 "-%8.8d.bmp",
+                           capture->window_id, frame->frame_number);
+        surface = SDL_CreateSurfaceFrom(frame->pixels, frame->w, frame->h, frame->w * 4, SDL_PIXELFORMAT_XRGB8888);
+        if (surface == NULL) {
+            return -1;
+        }
+        retval = SDL_SaveBMP(surface, file);
+        SDL_DestroySurface(surface);
+        return retval;
+    }
+}
+
+static int SDLCALL CaptureThread(void *data)
+{
+    SDL_OffscreenCapture *capture = (SDL_OffscreenCapture *)data;
+    SDL_OffscreenCaptureFrame *frame;
+
+    for (;;) {
+        SDL_LockMutex(capture->lock);
+        while (capture->count == 0 && !capture->quit) {
+            SDL_WaitCondition(capture->cond, capture->lock);
+        }
+        if (capture->count == 0) {
+            SDL_UnlockMutex(capture->lock);
+            break;
+        }
+        frame = &capture->frames[capture->head];
+        SDL_UnlockMutex(capture->lock);
+
+        if (WriteFrame(capture, frame) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't write offscreen frame %d: %s", frame->frame_number, SDL_GetError());
+        }
+
+        SDL_LockMutex(capture->lock);
+        capture->head = (capture->head + 1) % capture->num_frames;
+        --capture->count;
+        ++capture->written;
+        SDL_UnlockMutex(capture->lock);
+    }
+    return 0;
+}
+
+SDL_OffscreenCapture *SDL_OFFSCREEN_CreateCapture(SDL_Window *window)
+{
+    SDL_OffscreenCapture *capture;
+    const char *save_frames = SDL_getenv("SDL_VIDEO_OFFSCREEN_SAVE_FRAMES");
+    const char *file = SDL_getenv("SDL_VIDEO_OFFSCREEN_CAPTURE_FILE");
+    const char *buffers = SDL_getenv("SDL_VIDEO_OFFSCREEN_CAPTURE_BUFFERS");
+
+    if (!save_frames && !file) {
+        return NULL;
+    }
+
+    capture = (SDL_OffscreenCapture *)SDL_calloc(1, sizeof(*capture));
+    if (capture == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    capture->window_id = SDL_GetWindowID(window);
+    if (file) {
+        capture->output = CAPTURE_OUTPUT_RAW;
+    } else if (SDL_strcasecmp(save_frames, "ppm") == 0) {
+        capture->output = CAPTURE_OUTPUT_PPM;
+    } else {
+        capture->output = CAPTURE_OUTPUT_BMP;
+    }
+
+    capture->num_frames = buffers ? SDL_atoi(buffers) : DEFAULT_CAPTURE_BUFFERS;
+    capture->num_frames = SDL_clamp(capture->num_frames, 1, MAX_CAPTURE_BUFFERS);
+    capture->frames = (SDL_OffscreenCaptureFrame *)SDL_calloc(capture->num_frames, sizeof(*capture->frames));
+    if (capture->frames == NULL) {
+        SDL_OutOfMemory();
+        goto error;
+    }
+
+    if (file) {
+        capture->stream = SDL_RWFromFile(file, "wb");
+        if (capture->stream == NULL) {
+            goto error;
+        }
+    }
+
+    capture->lock = SDL_CreateMutex();
+    capture->cond = SDL_CreateCondition();
+    if (capture->lock == NULL || capture->cond == NULL) {
+        goto error;
+    }
+    capture->thread = SDL_CreateThreadInternal(CaptureThread, "SDLOffscreenCapture", 0, capture);
+    if (capture->thread == NULL) {
+        goto error;
+    }
+    return capture;
+
+error:
+    SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't start offscreen frame capture: %s", SDL_GetError());
+    SDL_OFFSCREEN_DestroyCapture(capture);
+    return NULL;
+}
+
+void SDL_OFFSCREEN_CaptureFrame(SDL_OffscreenCapture *capture, SDL_Surface *surface)
+{
+    SDL_OffscreenCaptureFrame *frame;
+    const int number = SDL_AtomicAdd(&frame_number, 1) + 1;
+    const size_t row_size = (size_t)surface->w * 4;
+    size_t size = row_size * surface->h;
+    int y;
+
+    SDL_LockMutex(capture->lock);
+    if (capture->count == capture->num_frames) {
+        if (capture->dropped++ == 0) {
+            SDL_Log("Offscreen capture can't keep up, dropping frame %d", number);
+        }
+        SDL_UnlockMutex(capture->lock);
+        return;
+    }
+    frame = &capture->frames[(capture->head + capture->count) % capture->num_frames];
+    SDL_UnlockMutex(capture->lock);
+
+    /* The frame isn't queued yet, the writer thread doesn't use it */
+    if (size > frame->size) {
+        Uint8 *pixels = (Uint8 *)SDL_realloc(frame->pixels, size);
+        if (pixels == NULL) {
+            SDL_OutOfMemory();
+            return;
+        }
+        frame->pixels = pixels;
+        frame->size = size;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        SDL_memcpy(frame->pixels + y * row_size, (const Uint8 *)surface->pixels + y * surface->pitch, row_size);
+    }
+    frame->w = surface->w;
+    frame->h = surface->h;
+    frame->frame_number = number;
+
+    SDL_LockMutex(capture->lock);
+    ++capture->count;
+    SDL_SignalCondition(capture->cond);
+    SDL_UnlockMutex(capture->lock);
+}
+
+void SDL_OFFSCREEN_DestroyCapture(SDL_OffscreenCapture *capture)
+{
+    int i;
+
+    if (capture == NULL) {
+        return;
+    }
+
+    /* Write the frames still in the buffers */
+    if (capture->thread) {
+        SDL_LockMutex(capture->lock);
+        capture->quit = SDL_TRUE;
+        SDL_SignalCondition(capture->cond);
+        SDL_UnlockMutex(capture->lock);
+        SDL_WaitThread(capture->thread, NULL);
+
+        if (capture->dropped) {
+            SDL_Log("Offscreen capture wrote %d frames, dropped %d frames",
+                    capture->written, capture->dropped);
+        }
+    }
+
+    if (capture->stream) {
+        SDL_RWclose(capture->stream);
+    }
+    SDL_DestroyCondition(capture->cond);
+    SDL_DestroyMutex(capture->lock);
+    if (capture->frames) {
+        for (i = 0; i < capture->num_frames; ++i) {
+            SDL_free(capture->frames[i].pixels);
+        }
+        SDL_free(capture->frames);
+    }
+    SDL_free(capture);
+}
+
+#endif /* SDL_VIDEO_DRIVER_OFFSCREEN */
@@ -23,7 +23,9 @@
 #ifdef SDL_VIDEO_DRIVER_OFFSCREEN
 
 #include "../SDL_sysvideo.h"
+#include "../SDL_egl_c.h"
 #include "SDL_offscreenframebuffer_c.h"
+#include "SDL_offscreenwindow.h"
 
 #define OFFSCREEN_SURFACE "_SDL_DummySurface"
 
@@ -54,7 +56,7 @@ int SDL_OFFSCREEN_CreateWindowFramebuffer(SDL_VideoDevice *_this, SDL_Window *wi
 
 int SDL_OFFSCREEN_UpdateWindowFramebuffer(SDL_VideoDevice *_this, SDL_Window *window, const SDL_Rect *rects, int numrects)
 {
-    static int frame_number;
+    SDL_WindowData *data = window->driverdata;
     SDL_Surface *surface;
 
     surface = (SDL_Surface *)SDL_GetWindowData(window, OFFSCREEN_SURFACE);
@@ -63,11 +65,8 @@ int SDL_OFFSCREEN_UpdateWindowFramebuffer(SDL_VideoDevice *_this, SDL_Window *wi
     }
 
     /* Send the data to the display */
-    if (SDL_getenv("SDL_VIDEO_OFFSCREEN_SAVE_FRAMES")) {
-        char file[128];
-        (void)SDL_snprintf(file, sizeof(file), "SDL_window%" SDL_PRIu32 "-%8.8d.bmp",
-                           SDL_GetWindowID(window), ++frame_number);
-        SDL_SaveBMP(surface, file);
+    if (data->capture) {
+        SDL_OFFSCREEN_CaptureFrame(data->capture, surface);
     }
     return 0;
 }
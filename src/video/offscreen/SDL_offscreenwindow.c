@@ -46,6 +46,7 @@ int OFFSCREEN_CreateWindow(SDL_VideoDevice *_this, SDL_Window *window)
     }
 
     offscreen_window->sdl_window = window;
+    offscreen_window->capture = SDL_OFFSCREEN_CreateCapture(window);
 
 #ifdef SDL_VIDEO_OPENGL_EGL
     if (window->flags & SDL_WINDOW_OPENGL) {
@@ -73,6 +74,7 @@ void OFFSCREEN_DestroyWindow(SDL_VideoDevice *_this, SDL_Window *window)
     SDL_WindowData *offscreen_window = window->driverdata;
 
     if (offscreen_window) {
+        SDL_OFFSCREEN_DestroyCapture(offscreen_window->capture);
 #ifdef SDL_VIDEO_OPENGL_EGL
         SDL_EGL_DestroySurface(_this, offscreen_window->egl_surface);
 #endif
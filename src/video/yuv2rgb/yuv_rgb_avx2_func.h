@@ -0,0 +1,364 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* You need to define the following macros before including this file:
+	AVX2_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+/* This follows the SSE version, with the same fixed point math, so the results
+   are identical. Samples are widened to 16 bits as they are read, and each
+   register holds 16 pixels, so the chroma of 32 pixels is computed once for both
+   lines. Unpacking works within 128-bit lanes, so pixels are put back in order
+   with cross lane permutes before they are stored. */
+
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+
+/* Chroma terms for 16 U/V samples, each repeated for two pixels.
+   R1/G1/B1 are for pixels 0-15, R2/G2/B2 for pixels 16-31 */
+#define UV2RGB_32(U,V,R1,G1,B1,R2,G2,B2) \
+{ \
+	__m256i r_tmp, g_tmp, b_tmp, lo, hi; \
+	r_tmp = _mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_r_factor)); \
+	g_tmp = _mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_g_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_g_factor))); \
+	b_tmp = _mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_b_factor)); \
+	lo = _mm256_unpacklo_epi16(r_tmp, r_tmp); \
+	hi = _mm256_unpackhi_epi16(r_tmp, r_tmp); \
+	R1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	R2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+	lo = _mm256_unpacklo_epi16(g_tmp, g_tmp); \
+	hi = _mm256_unpackhi_epi16(g_tmp, g_tmp); \
+	G1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	G2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+	lo = _mm256_unpacklo_epi16(b_tmp, b_tmp); \
+	hi = _mm256_unpackhi_epi16(b_tmp, b_tmp); \
+	B1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	B2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+}
+
+#define ADD_Y2RGB_32(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mullo_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	Y2 = _mm256_mullo_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	\
+	R1 = _mm256_srai_epi16(_mm256_add_epi16(R1, Y1), PRECISION); \
+	G1 = _mm256_srai_epi16(_mm256_add_epi16(G1, Y1), PRECISION); \
+	B1 = _mm256_srai_epi16(_mm256_add_epi16(B1, Y1), PRECISION); \
+	R2 = _mm256_srai_epi16(_mm256_add_epi16(R2, Y2), PRECISION); \
+	G2 = _mm256_srai_epi16(_mm256_add_epi16(G2, Y2), PRECISION); \
+	B2 = _mm256_srai_epi16(_mm256_add_epi16(B2, Y2), PRECISION); \
+
+/* Packs 32 pixels with the bytes C0, C1, C2, C3 in memory order into RGB1-RGB4.
+   packus leaves pixels 0-7 and 16-23 in the first lane, 8-15 and 24-31 in the second */
+#define PACK_RGBA_32(C0_1, C0_2, C1_1, C1_2, C2_1, C2_2, C3_1, C3_2, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m256i c0, c1, c2, c3, c01, c23, lo, hi; \
+	c0 = _mm256_packus_epi16(C0_1, C0_2); \
+	c1 = _mm256_packus_epi16(C1_1, C1_2); \
+	c2 = _mm256_packus_epi16(C2_1, C2_2); \
+	c3 = _mm256_packus_epi16(C3_1, C3_2); \
+	\
+	c01 = _mm256_unpacklo_epi8(c0, c1); \
+	c23 = _mm256_unpacklo_epi8(c2, c3); \
+	lo = _mm256_unpacklo_epi16(c01, c23); \
+	hi = _mm256_unpackhi_epi16(c01, c23); \
+	RGB1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+	\
+	c01 = _mm256_unpackhi_epi8(c0, c1); \
+	c23 = _mm256_unpackhi_epi8(c2, c3); \
+	lo = _mm256_unpacklo_epi16(c01, c23); \
+	hi = _mm256_unpackhi_epi16(c01, c23); \
+	RGB3 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	RGB4 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+}
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define SAVE_LINE(rgb_ptr) \
+{ \
+	const __m256i zero = _mm256_setzero_si256(); \
+	const __m256i max = _mm256_set1_epi16(0xFF); \
+	__m256i rgb_1, rgb_2; \
+	r_16_1 = _mm256_min_epi16(_mm256_max_epi16(r_16_1, zero), max); \
+	g_16_1 = _mm256_min_epi16(_mm256_max_epi16(g_16_1, zero), max); \
+	b_16_1 = _mm256_min_epi16(_mm256_max_epi16(b_16_1, zero), max); \
+	r_16_2 = _mm256_min_epi16(_mm256_max_epi16(r_16_2, zero), max); \
+	g_16_2 = _mm256_min_epi16(_mm256_max_epi16(g_16_2, zero), max); \
+	b_16_2 = _mm256_min_epi16(_mm256_max_epi16(b_16_2, zero), max); \
+	rgb_1 = _mm256_or_si256(_mm256_or_si256( \
+		_mm256_and_si256(_mm256_slli_epi16(r_16_1, 8), _mm256_set1_epi16((short)0xF800)), \
+		_mm256_slli_epi16(_mm256_srli_epi16(g_16_1, 2), 5)), \
+		_mm256_srli_epi16(b_16_1, 3)); \
+	rgb_2 = _mm256_or_si256(_mm256_or_si256( \
+		_mm256_and_si256(_mm256_slli_epi16(r_16_2, 8), _mm256_set1_epi16((short)0xF800)), \
+		_mm256_slli_epi16(_mm256_srli_epi16(g_16_2, 2), 5)), \
+		_mm256_srli_epi16(b_16_2, 3)); \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+/* Packed as R, G, B, 0, then each group of 8 pixels is squeezed into 24 bytes */
+#define SAVE_RGB24_8(rgb_ptr, RGB) \
+{ \
+	__m256i packed = _mm256_shuffle_epi8(RGB, shuffle); \
+	packed = _mm256_permutevar8x32_epi32(packed, permute); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr), _mm256_castsi256_si128(packed)); \
+	_mm_storel_epi64((__m128i*)(rgb_ptr+16), _mm256_extracti128_si256(packed, 1)); \
+}
+
+#define SAVE_LINE(rgb_ptr) \
+{ \
+	const __m256i zero = _mm256_setzero_si256(); \
+	const __m256i shuffle = _mm256_setr_epi8( \
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, \
+		0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1); \
+	const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7); \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4; \
+	PACK_RGBA_32(r_16_1, r_16_2, g_16_1, g_16_2, b_16_1, b_16_2, zero, zero, rgb_1, rgb_2, rgb_3, rgb_4) \
+	SAVE_RGB24_8(rgb_ptr, rgb_1) \
+	SAVE_RGB24_8(rgb_ptr+24, rgb_2) \
+	SAVE_RGB24_8(rgb_ptr+48, rgb_3) \
+	SAVE_RGB24_8(rgb_ptr+72, rgb_4) \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+/* Memory order of the bytes, as 32-bit pixels are little endian */
+#if RGB_FORMAT == RGB_FORMAT_RGBA
+#define PACK_PIXEL(RGB1, RGB2, RGB3, RGB4) \
+	PACK_RGBA_32(a, a, b_16_1, b_16_2, g_16_1, g_16_2, r_16_1, r_16_2, RGB1, RGB2, RGB3, RGB4)
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+#define PACK_PIXEL(RGB1, RGB2, RGB3, RGB4) \
+	PACK_RGBA_32(a, a, r_16_1, r_16_2, g_16_1, g_16_2, b_16_1, b_16_2, RGB1, RGB2, RGB3, RGB4)
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+#define PACK_PIXEL(RGB1, RGB2, RGB3, RGB4) \
+	PACK_RGBA_32(b_16_1, b_16_2, g_16_1, g_16_2, r_16_1, r_16_2, a, a, RGB1, RGB2, RGB3, RGB4)
+#else
+#define PACK_PIXEL(RGB1, RGB2, RGB3, RGB4) \
+	PACK_RGBA_32(r_16_1, r_16_2, g_16_1, g_16_2, b_16_1, b_16_2, a, a, RGB1, RGB2, RGB3, RGB4)
+#endif
+
+#define SAVE_LINE(rgb_ptr) \
+{ \
+	const __m256i a = _mm256_set1_epi16(0xFF); \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4; \
+	PACK_PIXEL(rgb_1, rgb_2, rgb_3, rgb_4) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+96), rgb_4); \
+}
+
+#else
+#error SAVE_LINE unimplemented
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+{ \
+	const __m256i y = LOAD_SI256((const __m256i*)(y_ptr)); \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(y)); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(y, 1)); \
+}
+
+#define READ_UV \
+	u_16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(u_ptr))); \
+	v_16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(v_ptr))); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+	y_16_1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr)), _mm256_set1_epi16(0xFF)); \
+	y_16_2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr+32)), _mm256_set1_epi16(0xFF)); \
+
+#define READ_UV \
+{ \
+	const __m256i mask = _mm256_set1_epi32(0xFF); \
+	__m256i u1, u2, v1, v2; \
+	u1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), mask); \
+	u2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr+32)), mask); \
+	u_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(u1, u2), 0xD8); \
+	v1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), mask); \
+	v2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr+32)), mask); \
+	v_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(v1, v2), 0xD8); \
+}
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+{ \
+	const __m256i y = LOAD_SI256((const __m256i*)(y_ptr)); \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(y)); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(y, 1)); \
+}
+
+#define READ_UV \
+	u_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi16(0xFF)); \
+	v_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi16(0xFF)); \
+
+#else
+#error READ_UV unimplemented
+#endif
+
+#define YUV2RGB_32_LINE(y_ptr, rgb_ptr) \
+{ \
+	__m256i r_16_1 = r_uv_16_1, g_16_1 = g_uv_16_1, b_16_1 = b_uv_16_1; \
+	__m256i r_16_2 = r_uv_16_2, g_16_2 = g_uv_16_2, b_16_2 = b_uv_16_2; \
+	__m256i y_16_1, y_16_2; \
+	\
+	READ_Y(y_ptr) \
+	ADD_Y2RGB_32(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	SAVE_LINE(rgb_ptr) \
+}
+
+
+void SDL_TARGETING("avx2") AVX2_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+#else
+#error Unknown RGB pixel size
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_NV12
+	/* The U/V reads go one byte past the last pair, as in the SSE version */
+	const int fix_read_nv12 = ((width & 31) == 0);
+#else
+	const int fix_read_nv12 = 0;
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_422
+	/* Avoid invalid read on last line */
+	const int fix_read_422 = 1;
+#else
+	const int fix_read_422 = 0;
+#endif
+
+
+	if (width >= 32) {
+		uint32_t xpos, ypos;
+		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)) - fix_read_422; ypos+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+ypos*Y_stride,
+				*y_ptr2=Y+(ypos+1)*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
+				*rgb_ptr2=RGB+(ypos+1)*RGB_stride;
+
+			for(xpos=0; xpos<(width-31) - fix_read_nv12; xpos+=32)
+			{
+				__m256i u_16, v_16;
+				__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2;
+
+				READ_UV
+				u_16 = _mm256_add_epi16(u_16, _mm256_set1_epi16(-128));
+				v_16 = _mm256_add_epi16(v_16, _mm256_set1_epi16(-128));
+				UV2RGB_32(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2)
+
+				YUV2RGB_32_LINE(y_ptr1, rgb_ptr1)
+				if (uv_y_sample_interval > 1)
+				{
+					YUV2RGB_32_LINE(y_ptr2, rgb_ptr2)
+				}
+
+				y_ptr1+=32*y_pixel_stride;
+				y_ptr2+=32*y_pixel_stride;
+				u_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=32*rgb_pixel_stride;
+				rgb_ptr2+=32*rgb_pixel_stride;
+			}
+		}
+
+		if (fix_read_422) {
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+			ypos += uv_y_sample_interval;
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && ypos == (height-1))
+		{
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	{
+		uint32_t converted = (width & ~31);
+		if (fix_read_nv12) {
+			converted -= 32;
+		}
+		if (converted != width)
+		{
+			const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+				*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+				*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+			uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+			STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+}
+
+#undef AVX2_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef LOAD_SI256
+#undef SAVE_SI256
+#undef UV2RGB_32
+#undef ADD_Y2RGB_32
+#undef PACK_RGBA_32
+#undef PACK_PIXEL
+#undef SAVE_RGB24_8
+#undef SAVE_LINE
+#undef READ_Y
+#undef READ_UV
+#undef YUV2RGB_32_LINE
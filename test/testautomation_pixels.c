@@ -119,6 +119,7 @@ static int pixels_allocFreeFormat(void *arg)
     Uint32 format;
     Uint32 masks;
     SDL_PixelFormat *result;
+    SDL_PixelFormat *shared;
 
     /* Blank/unknown format */
     format = 0;
@@ -161,6 +162,13 @@ static int pixels_allocFreeFormat(void *arg)
             /* Deallocate again */
             SDL_DestroyPixelFormat(result);
             SDLTest_AssertPass("Call to SDL_DestroyPixelFormat()");
+
+            /* RGB formats are shared, indexed formats have their own palette */
+            if (!SDL_ISPIXELFORMAT_INDEXED(format)) {
+                shared = SDL_CreatePixelFormat(format);
+                SDLTest_AssertCheck(shared == result, "Verify format is shared after SDL_DestroyPixelFormat()");
+                SDL_DestroyPixelFormat(shared);
+            }
         }
     }
 
@@ -347,6 +355,101 @@ static int pixels_allocFreePalette(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Brute force search for the nearest opaque palette entry, ties go to the lowest index */
+static Uint8 FindNearestColor(const SDL_Palette *palette, int r, int g, int b)
+{
+    Uint32 best = ~0u;
+    Uint8 pixel = 0;
+    int i;
+
+    for (i = 0; i < palette->ncolors; ++i) {
+        const int dr = palette->colors[i].r - r;
+        const int dg = palette->colors[i].g - g;
+        const int db = palette->colors[i].b - b;
+        const int da = palette->colors[i].a - 255;
+        const Uint32 distance = (Uint32)(dr * dr + dg * dg + db * db + da * da);
+        if (distance < best) {
+            best = distance;
+            pixel = (Uint8)i;
+        }
+    }
+    return pixel;
+}
+
+/**
+ * Call to SDL_MapRGB and blits from XRGB8888 to INDEX8 with a random palette
+ */
+static int pixels_mapNearestColor(void *arg)
+{
+    SDL_Surface *src = NULL;
+    SDL_Surface *dst = NULL;
+    SDL_Palette *palette = NULL;
+    SDL_Color colors[256];
+    int i, pass;
+    int mismatches;
+
+    src = SDL_CreateSurface(32 * 32, 32, SDL_PIXELFORMAT_XRGB8888);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    dst = SDL_CreateSurface(32 * 32, 32, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertCheck(dst != NULL, "Verify destination surface is not NULL");
+    if (src == NULL || dst == NULL) {
+        goto out;
+    }
+    palette = dst->format->palette;
+
+    for (pass = 0; pass < 2; ++pass) {
+        /* A random palette, changed on the second pass to check that cached lookups are refreshed */
+        for (i = 0; i < 256; ++i) {
+            colors[i].r = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            colors[i].g = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            colors[i].b = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            colors[i].a = SDL_ALPHA_OPAQUE;
+        }
+        SDL_SetPaletteColors(palette, colors, 0, 256);
+        SDLTest_AssertPass("Call to SDL_SetPaletteColors(), pass %d", pass);
+
+        /* SDL_MapRGB() is an exact nearest color search */
+        mismatches = 0;
+        for (i = 0; i < 2000; ++i) {
+            const int r = SDLTest_RandomIntegerInRange(0, 255);
+            const int g = SDLTest_RandomIntegerInRange(0, 255);
+            const int b = SDLTest_RandomIntegerInRange(0, 255);
+            const Uint32 pixel = SDL_MapRGB(dst->format, (Uint8)r, (Uint8)g, (Uint8)b);
+            /* Look the same color up twice, the second time is served from the cache */
+            if (pixel != FindNearestColor(palette, r, g, b) ||
+                SDL_MapRGB(dst->format, (Uint8)r, (Uint8)g, (Uint8)b) != pixel) {
+                ++mismatches;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify SDL_MapRGB() finds the nearest color, expected: 0 mismatches, got %d", mismatches);
+
+        /* Blits find the nearest color at the center of each 5-bit cell */
+        for (i = 0; i < 32 * 32 * 32; ++i) {
+            const Uint32 r = (Uint32)((i >> 10) << 3) | 4;
+            const Uint32 g = (Uint32)(((i >> 5) & 31) << 3) | 4;
+            const Uint32 b = (Uint32)((i & 31) << 3) | 4;
+            ((Uint32 *)src->pixels)[i] = (r << 16) | (g << 8) | b;
+        }
+        SDL_BlitSurface(src, NULL, dst, NULL);
+        SDLTest_AssertPass("Call to SDL_BlitSurface(), pass %d", pass);
+
+        mismatches = 0;
+        for (i = 0; i < 32 * 32 * 32; ++i) {
+            const Uint32 color = ((Uint32 *)src->pixels)[i];
+            const Uint8 expected = FindNearestColor(palette, (int)(color >> 16), (int)((color >> 8) & 0xFF), (int)(color & 0xFF));
+            if (((Uint8 *)dst->pixels)[(i / dst->w) * dst->pitch + (i % dst->w)] != expected) {
+                ++mismatches;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify blit finds the nearest colors, expected: 0 mismatches, got %d", mismatches);
+    }
+
+out:
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(dst);
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -362,9 +465,13 @@ static const SDLTest_TestCaseReference pixelsTest3 = {
     (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference pixelsTest4 = {
+    (SDLTest_TestCaseFp)pixels_mapNearestColor, "pixels_mapNearestColor", "Call to SDL_MapRGB and blits to paletted surfaces", TEST_ENABLED
+};
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] = {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
 };
 
 /* Pixels test suite (global) */
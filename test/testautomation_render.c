@@ -468,6 +468,697 @@ static int render_testBlitColor(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * \brief Blits doing color tests, alternating with blits in another state.
+ *
+ * \sa SDL_SetTextureColorMod
+ * \sa SDL_SetTextureBlendMode
+ * \sa SDL_RenderTexture
+ */
+static int render_testBlitColorAlternating(void *arg)
+{
+    int ret;
+    SDL_FRect rect, other;
+    SDL_Texture *tface;
+    SDL_Surface *referenceSurface = NULL;
+    SDL_BlendMode blendMode;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int i, j, ni, nj;
+    int checkFailCount1;
+    int checkFailCount2;
+
+    /* Clear surface. */
+    clearScreen();
+
+    /* Create face surface. */
+    tface = loadTestFace();
+    SDLTest_AssertCheck(tface != NULL, "Verify loadTestFace() result");
+    if (tface == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Constant values. */
+    CHECK_FUNC(SDL_QueryTexture, (tface, &tformat, &taccess, &tw, &th))
+    CHECK_FUNC(SDL_GetTextureBlendMode, (tface, &blendMode))
+    rect.w = (float)tw;
+    rect.h = (float)th;
+    ni = TESTRENDER_SCREEN_W - tw;
+    nj = TESTRENDER_SCREEN_H - th;
+
+    /* Other blits, scaled and added below the compared area. */
+    other.x = 0.0f;
+    other.y = (float)(TESTRENDER_SCREEN_H + 1);
+    other.w = (float)(tw * 2);
+    other.h = (float)(th * 2);
+
+    /* Same blits as render_testBlitColor(), each one after another blit of the same texture. */
+    checkFailCount1 = 0;
+    checkFailCount2 = 0;
+    for (j = 0; j <= nj; j += 4) {
+        for (i = 0; i <= ni; i += 4) {
+            ret = SDL_SetTextureColorMod(tface, 255, 255, 255);
+            ret |= SDL_SetTextureBlendMode(tface, (i / 4) % 2 ? SDL_BLENDMODE_ADD : SDL_BLENDMODE_MOD);
+            if (ret != 0) {
+                checkFailCount1++;
+            }
+            ret = SDL_RenderTexture(renderer, tface, NULL, &other);
+            if (ret != 0) {
+                checkFailCount2++;
+            }
+
+            ret = SDL_SetTextureColorMod(tface, (255 / nj) * j, (255 / ni) * i, (255 / nj) * j);
+            ret |= SDL_SetTextureBlendMode(tface, blendMode);
+            if (ret != 0) {
+                checkFailCount1++;
+            }
+            rect.x = (float)i;
+            rect.y = (float)j;
+            ret = SDL_RenderTexture(renderer, tface, NULL, &rect);
+            if (ret != 0) {
+                checkFailCount2++;
+            }
+        }
+    }
+    SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_SetTextureColorMod and SDL_SetTextureBlendMode, expected: 0, got: %i", checkFailCount1);
+    SDLTest_AssertCheck(checkFailCount2 == 0, "Validate results from calls to SDL_RenderTexture, expected: 0, got: %i", checkFailCount2);
+
+    /* See if it's the same. */
+    referenceSurface = SDLTest_ImageBlitColor();
+    compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+
+    /* Make current */
+    SDL_RenderPresent(renderer);
+
+    /* Clean up. */
+    SDL_DestroyTexture(tface);
+    SDL_DestroySurface(referenceSurface);
+    referenceSurface = NULL;
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Blits doing color tests in a single batch.
+ *
+ * \sa SDL_RenderTextures
+ * \sa SDL_DestroyTexture
+ */
+static int render_testBlitBatch(void *arg)
+{
+    int ret;
+    SDL_Texture *tface;
+    SDL_Surface *referenceSurface = NULL;
+    SDL_TextureBatchItem *items;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int i, j, ni, nj;
+    int count;
+
+    /* Clear surface. */
+    clearScreen();
+
+    /* Create face surface. */
+    tface = loadTestFace();
+    SDLTest_AssertCheck(tface != NULL, "Verify loadTestFace() result");
+    if (tface == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Constant values. */
+    CHECK_FUNC(SDL_QueryTexture, (tface, &tformat, &taccess, &tw, &th))
+    ni = TESTRENDER_SCREEN_W - tw;
+    nj = TESTRENDER_SCREEN_H - th;
+
+    items = (SDL_TextureBatchItem *)SDL_calloc(((ni / 4) + 1) * ((nj / 4) + 1), sizeof(*items));
+    SDLTest_AssertCheck(items != NULL, "Verify item allocation");
+    if (items == NULL) {
+        SDL_DestroyTexture(tface);
+        return TEST_ABORTED;
+    }
+
+    /* Same blits as render_testBlitColor(), with the color mod of each item. */
+    count = 0;
+    for (j = 0; j <= nj; j += 4) {
+        for (i = 0; i <= ni; i += 4) {
+            SDL_TextureBatchItem *item = &items[count++];
+            item->srcrect.w = (float)tw;
+            item->srcrect.h = (float)th;
+            item->dstrect.x = (float)i;
+            item->dstrect.y = (float)j;
+            item->dstrect.w = (float)tw;
+            item->dstrect.h = (float)th;
+            item->color.r = (Uint8)((255 / nj) * j);
+            item->color.g = (Uint8)((255 / ni) * i);
+            item->color.b = (Uint8)((255 / nj) * j);
+            item->color.a = 255;
+        }
+    }
+    ret = SDL_RenderTextures(renderer, tface, items, count);
+    SDLTest_AssertCheck(ret == 0, "Validate result from call to SDL_RenderTextures, expected: 0, got: %i", ret);
+
+    /* See if it's the same. */
+    referenceSurface = SDLTest_ImageBlitColor();
+    compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+
+    /* Make current */
+    SDL_RenderPresent(renderer);
+
+    /* Clean up. */
+    SDL_free(items);
+    SDL_DestroyTexture(tface);
+    SDL_DestroySurface(referenceSurface);
+    referenceSurface = NULL;
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Blits in a single batch with source rects outside of the texture.
+ *
+ * \sa SDL_RenderTextures
+ * \sa SDL_RenderTextureRotated
+ */
+static int render_testBlitBatchClipped(void *arg)
+{
+    int ret;
+    SDL_Texture *tface;
+    SDL_Surface *referenceSurface;
+    SDL_TextureBatchItem items[4];
+    SDL_Rect rect;
+    Uint8 *pixels;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int i;
+
+    tface = loadTestFace();
+    SDLTest_AssertCheck(tface != NULL, "Verify loadTestFace() result");
+    if (tface == NULL) {
+        return TEST_ABORTED;
+    }
+    CHECK_FUNC(SDL_QueryTexture, (tface, &tformat, &taccess, &tw, &th))
+
+    /* Partly outside, flipped, fully outside and rotated around the texture */
+    SDL_zeroa(items);
+    for (i = 0; i < SDL_arraysize(items); ++i) {
+        items[i].srcrect.w = (float)tw;
+        items[i].srcrect.h = (float)th;
+        items[i].dstrect.x = (float)((i % 2) * 40);
+        items[i].dstrect.y = (float)((i / 2) * 30);
+        items[i].dstrect.w = 40.0f;
+        items[i].dstrect.h = 30.0f;
+        items[i].color.r = items[i].color.g = items[i].color.b = items[i].color.a = 255;
+    }
+    items[0].srcrect.x = -(float)tw / 2;
+    items[1].srcrect.x = (float)tw / 2;
+    items[1].srcrect.y = (float)th / 2;
+    items[1].flip = SDL_FLIP_HORIZONTAL;
+    items[2].srcrect.y = (float)-th;
+    items[3].srcrect.x = -10.0f;
+    items[3].srcrect.y = -10.0f;
+    items[3].srcrect.w = (float)tw + 20.0f;
+    items[3].srcrect.h = (float)th + 20.0f;
+    items[3].angle = 30.0;
+
+    /* Draw the reference one item at a time */
+    clearScreen();
+    for (i = 0; i < SDL_arraysize(items); ++i) {
+        CHECK_FUNC(SDL_RenderTextureRotated, (renderer, tface, &items[i].srcrect, &items[i].dstrect, items[i].angle, NULL, items[i].flip))
+    }
+    pixels = (Uint8 *)SDL_malloc(4 * TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H);
+    SDLTest_AssertCheck(pixels != NULL, "Validate allocated temp pixel buffer");
+    if (pixels == NULL) {
+        SDL_DestroyTexture(tface);
+        return TEST_ABORTED;
+    }
+    rect.x = 0;
+    rect.y = 0;
+    rect.w = TESTRENDER_SCREEN_W;
+    rect.h = TESTRENDER_SCREEN_H;
+    CHECK_FUNC(SDL_RenderReadPixels, (renderer, &rect, RENDER_COMPARE_FORMAT, pixels, TESTRENDER_SCREEN_W * 4))
+    referenceSurface = SDL_CreateSurfaceFrom(pixels, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, TESTRENDER_SCREEN_W * 4, RENDER_COMPARE_FORMAT);
+    SDLTest_AssertCheck(referenceSurface != NULL, "Verify result from SDL_CreateSurfaceFrom is not NULL");
+
+    /* The batch clips the source rects the same way */
+    clearScreen();
+    ret = SDL_RenderTextures(renderer, tface, items, SDL_arraysize(items));
+    SDLTest_AssertCheck(ret == 0, "Validate result from call to SDL_RenderTextures, expected: 0, got: %i", ret);
+    if (referenceSurface != NULL) {
+        compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+    }
+
+    /* Make current */
+    SDL_RenderPresent(renderer);
+
+    /* Clean up. */
+    SDL_DestroySurface(referenceSurface);
+    SDL_free(pixels);
+    SDL_DestroyTexture(tface);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Blits alternating between two textures with draw reordering enabled.
+ *
+ * \sa SDL_HINT_RENDER_REORDERING
+ * \sa SDL_RenderTexture
+ * \sa SDL_GetRenderStats
+ */
+static int render_testBlitReordered(void *arg)
+{
+    int ret;
+    SDL_FRect rect;
+    SDL_Texture *tface[2];
+    SDL_Surface *referenceSurface = NULL;
+    SDL_RenderStats stats;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int i, j, ni, nj;
+    int checkFailCount1;
+
+    /* Recreate the renderer with reordering, which needs batching. */
+    SDL_DestroyRenderer(renderer);
+    SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+    SDL_SetHint(SDL_HINT_RENDER_REORDERING, "1");
+    renderer = SDL_CreateRenderer(window, NULL, SDL_RENDERER_ACCELERATED);
+    SDL_ResetHint(SDL_HINT_RENDER_BATCHING);
+    SDL_ResetHint(SDL_HINT_RENDER_REORDERING);
+    SDLTest_AssertCheck(renderer != NULL, "Check SDL_CreateRenderer result");
+    if (renderer == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Clear surface. */
+    clearScreen();
+
+    /* Create two face textures. */
+    tface[0] = loadTestFace();
+    tface[1] = loadTestFace();
+    SDLTest_AssertCheck(tface[0] != NULL && tface[1] != NULL, "Verify loadTestFace() results");
+    if (tface[0] == NULL || tface[1] == NULL) {
+        SDL_DestroyTexture(tface[0]);
+        SDL_DestroyTexture(tface[1]);
+        return TEST_ABORTED;
+    }
+
+    /* Constant values. */
+    CHECK_FUNC(SDL_QueryTexture, (tface[0], &tformat, &taccess, &tw, &th))
+    rect.w = (float)tw;
+    rect.h = (float)th;
+    ni = TESTRENDER_SCREEN_W - tw;
+    nj = TESTRENDER_SCREEN_H - th;
+
+    /* Same overlapping blits as render_testBlit(), which must keep their order. */
+    checkFailCount1 = 0;
+    for (j = 0; j <= nj; j += 4) {
+        for (i = 0; i <= ni; i += 4) {
+            rect.x = (float)i;
+            rect.y = (float)j;
+            ret = SDL_RenderTexture(renderer, tface[(i + j) / 4 % 2], NULL, &rect);
+            if (ret != 0) {
+                checkFailCount1++;
+            }
+        }
+    }
+    SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_RenderTexture, expected: 0, got: %i", checkFailCount1);
+
+    /* See if it's the same */
+    referenceSurface = SDLTest_ImageBlit();
+    compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+
+    /* Start from a fresh frame. */
+    SDL_RenderPresent(renderer);
+
+    /* Blits that don't overlap, below the compared area, can be grouped by texture. */
+    rect.y = (float)(TESTRENDER_SCREEN_H + 1);
+    for (i = 0; i < 4; i++) {
+        rect.x = (float)(i * (tw + 2));
+        CHECK_FUNC(SDL_RenderTexture, (renderer, tface[i % 2], NULL, &rect))
+    }
+    SDL_RenderPresent(renderer);
+
+    CHECK_FUNC(SDL_GetRenderStats, (renderer, &stats))
+    SDLTest_AssertCheck(stats.reordered_commands >= 1, "Validate reordered commands, expected: >= 1, got: %i", stats.reordered_commands);
+    SDLTest_AssertCheck(stats.saved_state_changes >= 1, "Validate saved state changes, expected: >= 1, got: %i", stats.saved_state_changes);
+
+    /* Clean up. */
+    SDL_DestroyTexture(tface[0]);
+    SDL_DestroyTexture(tface[1]);
+    SDL_DestroySurface(referenceSurface);
+    referenceSurface = NULL;
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Tests the rendering statistics of a presented frame.
+ *
+ * \sa SDL_GetRenderStats
+ * \sa SDL_RenderPresent
+ */
+static int render_testRenderStats(void *arg)
+{
+    SDL_Texture *tface;
+    SDL_RenderStats stats;
+    SDL_FRect rect;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int pitch;
+    void *pixels;
+    int draws;
+
+    /* Create face texture. */
+    tface = loadTestFace();
+    SDLTest_AssertCheck(tface != NULL, "Verify loadTestFace() result");
+    if (tface == NULL) {
+        return TEST_ABORTED;
+    }
+    CHECK_FUNC(SDL_QueryTexture, (tface, &tformat, &taccess, &tw, &th))
+    pitch = tw * SDL_BYTESPERPIXEL(tformat);
+    pixels = SDL_calloc(th, pitch);
+    SDLTest_AssertCheck(pixels != NULL, "Verify pixel allocation");
+    if (pixels == NULL) {
+        SDL_DestroyTexture(tface);
+        return TEST_ABORTED;
+    }
+
+    /* Start from a fresh frame. */
+    SDL_RenderPresent(renderer);
+
+    /* Draw, update the texture while it is in use, and draw again. */
+    clearScreen();
+    rect.x = 0.0f;
+    rect.y = 0.0f;
+    rect.w = (float)tw;
+    rect.h = (float)th;
+    CHECK_FUNC(SDL_RenderFillRect, (renderer, &rect))
+    CHECK_FUNC(SDL_RenderTexture, (renderer, tface, NULL, &rect))
+    CHECK_FUNC(SDL_UpdateTexture, (tface, NULL, pixels, pitch))
+    rect.x = (float)tw;
+    CHECK_FUNC(SDL_RenderTexture, (renderer, tface, NULL, &rect))
+    SDL_RenderPresent(renderer);
+
+    CHECK_FUNC(SDL_GetRenderStats, (renderer, &stats))
+    draws = stats.rect_commands + stats.copy_commands + stats.geometry_commands;
+    SDLTest_AssertCheck(stats.clear_commands >= 1, "Validate clear commands, expected: >= 1, got: %i", stats.clear_commands);
+    SDLTest_AssertCheck(draws >= 3, "Validate drawing commands, expected: >= 3, got: %i", draws);
+    SDLTest_AssertCheck(stats.submitted_commands >= draws, "Validate submitted commands, expected: >= %i, got: %i", draws, stats.submitted_commands);
+    /* Without batching the texture isn't in a pending command when it is updated */
+    SDLTest_AssertCheck(stats.texture_flushes <= 1, "Validate texture flushes, expected: <= 1, got: %i", stats.texture_flushes);
+    SDLTest_AssertCheck(stats.flushes >= 2, "Validate flushes, expected: >= 2, got: %i", stats.flushes);
+    SDLTest_AssertCheck(stats.texture_bytes == (Uint64)th * pitch, "Validate texture bytes, expected: %i, got: %" SDL_PRIu64, th * pitch, stats.texture_bytes);
+
+    /* An empty frame has nothing to report. */
+    SDL_RenderPresent(renderer);
+    CHECK_FUNC(SDL_GetRenderStats, (renderer, &stats))
+    SDLTest_AssertCheck(stats.submitted_commands == 0, "Validate submitted commands, expected: 0, got: %i", stats.submitted_commands);
+    SDLTest_AssertCheck(stats.flushes == 0, "Validate flushes, expected: 0, got: %i", stats.flushes);
+
+    /* Clean up. */
+    SDL_free(pixels);
+    SDL_DestroyTexture(tface);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Tests blitting a streaming texture and reading the result back asynchronously.
+ *
+ * \sa SDL_LockTexture
+ * \sa SDL_RenderReadPixelsAsync
+ * \sa SDL_GetRenderReadbackPixels
+ */
+static int render_testReadPixelsAsync(void *arg)
+{
+    int ret;
+    SDL_FRect rect;
+    SDL_Rect lockrect, readrect;
+    SDL_Surface *face;
+    SDL_Texture *tface;
+    SDL_Surface *referenceSurface = NULL;
+    SDL_Surface *testSurface;
+    SDL_RenderReadback *readback, *clipped;
+    Uint32 *pixels;
+    void *locked;
+    int pitch;
+    int i, j, ni, nj, y;
+    int checkFailCount1;
+
+    /* Clear surface. */
+    clearScreen();
+
+    /* Need drawcolor or just skip test. */
+    SDLTest_AssertCheck(hasDrawColor(), "_hasDrawColor)");
+
+    /* Create a streaming face texture, filled in two locks. */
+    face = SDLTest_ImageFace();
+    SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+    if (face == NULL) {
+        return TEST_ABORTED;
+    }
+    tface = SDL_CreateTexture(renderer, face->format->format, SDL_TEXTUREACCESS_STREAMING, face->w, face->h);
+    SDLTest_AssertCheck(tface != NULL, "Verify SDL_CreateTexture() result");
+    if (tface == NULL) {
+        SDL_DestroySurface(face);
+        return TEST_ABORTED;
+    }
+    CHECK_FUNC(SDL_SetTextureBlendMode, (tface, SDL_BLENDMODE_BLEND))
+    CHECK_FUNC(SDL_LockTexture, (tface, NULL, &locked, &pitch))
+    for (y = 0; y < face->h; ++y) {
+        SDL_memset((Uint8 *)locked + y * pitch, 0x80, (size_t)face->w * face->format->BytesPerPixel);
+    }
+    SDL_UnlockTexture(tface);
+    lockrect.x = 0;
+    lockrect.y = 0;
+    lockrect.w = face->w;
+    lockrect.h = face->h / 2;
+    CHECK_FUNC(SDL_LockTexture, (tface, &lockrect, &locked, &pitch))
+    for (y = 0; y < lockrect.h; ++y) {
+        SDL_memcpy((Uint8 *)locked + y * pitch, (Uint8 *)face->pixels + y * face->pitch, (size_t)face->w * face->format->BytesPerPixel);
+    }
+    SDL_UnlockTexture(tface);
+    lockrect.y = face->h / 2;
+    lockrect.h = face->h - lockrect.y;
+    CHECK_FUNC(SDL_LockTexture, (tface, &lockrect, &locked, &pitch))
+    for (y = 0; y < lockrect.h; ++y) {
+        SDL_memcpy((Uint8 *)locked + y * pitch, (Uint8 *)face->pixels + (lockrect.y + y) * face->pitch, (size_t)face->w * face->format->BytesPerPixel);
+    }
+    SDL_UnlockTexture(tface);
+
+    /* Constant values. */
+    rect.w = (float)face->w;
+    rect.h = (float)face->h;
+    ni = TESTRENDER_SCREEN_W - face->w;
+    nj = TESTRENDER_SCREEN_H - face->h;
+    SDL_DestroySurface(face);
+
+    /* Loop blit. */
+    checkFailCount1 = 0;
+    for (j = 0; j <= nj; j += 4) {
+        for (i = 0; i <= ni; i += 4) {
+            /* Blitting. */
+            rect.x = (float)i;
+            rect.y = (float)j;
+            ret = SDL_RenderTexture(renderer, tface, NULL, &rect);
+            if (ret != 0) {
+                checkFailCount1++;
+            }
+        }
+    }
+    SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_RenderTexture, expected: 0, got: %i", checkFailCount1);
+
+    /* Start the reads, then draw over what was read */
+    readrect.x = 0;
+    readrect.y = 0;
+    readrect.w = TESTRENDER_SCREEN_W;
+    readrect.h = TESTRENDER_SCREEN_H;
+    readback = SDL_RenderReadPixelsAsync(renderer, &readrect, RENDER_COMPARE_FORMAT);
+    SDLTest_AssertCheck(readback != NULL, "Verify SDL_RenderReadPixelsAsync() result");
+    readrect.x = -10;
+    readrect.y = -10;
+    clipped = SDL_RenderReadPixelsAsync(renderer, &readrect, RENDER_COMPARE_FORMAT);
+    SDLTest_AssertCheck(clipped != NULL, "Verify SDL_RenderReadPixelsAsync() result with a clipped rect");
+    CHECK_FUNC(SDL_RenderClear, (renderer))
+    if (readback == NULL || clipped == NULL) {
+        SDL_DestroyTexture(tface);
+        return TEST_ABORTED;
+    }
+    SDL_IsRenderReadbackReady(readback);
+    SDLTest_AssertPass("Call to SDL_IsRenderReadbackReady()");
+
+    /* See if it's the same as the plain blit */
+    referenceSurface = SDLTest_ImageBlit();
+    pixels = (Uint32 *)SDL_calloc(2 * TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H, sizeof(*pixels));
+    SDLTest_AssertCheck(pixels != NULL, "Validate allocated temp pixel buffer");
+    if (pixels != NULL) {
+        Uint32 *clipped_pixels = pixels + TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H;
+
+        testSurface = SDL_CreateSurfaceFrom(pixels, TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H, TESTRENDER_SCREEN_W * 4, RENDER_COMPARE_FORMAT);
+        CHECK_FUNC(SDL_GetRenderReadbackPixels, (readback, pixels, TESTRENDER_SCREEN_W * 4))
+        ret = SDLTest_CompareSurfaces(testSurface, referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+        SDL_DestroySurface(testSurface);
+
+        /* The clipped read leaves the pixels outside the viewport alone */
+        CHECK_FUNC(SDL_GetRenderReadbackPixels, (clipped, clipped_pixels, TESTRENDER_SCREEN_W * 4))
+        checkFailCount1 = 0;
+        for (j = 0; j < TESTRENDER_SCREEN_H; ++j) {
+            for (i = 0; i < TESTRENDER_SCREEN_W; ++i) {
+                Uint32 expected = 0;
+                if (i >= 10 && j >= 10) {
+                    expected = pixels[(j - 10) * TESTRENDER_SCREEN_W + (i - 10)];
+                }
+                if (clipped_pixels[j * TESTRENDER_SCREEN_W + i] != expected) {
+                    checkFailCount1++;
+                }
+            }
+        }
+        SDLTest_AssertCheck(checkFailCount1 == 0, "Validate pixels of the clipped read, expected: 0 wrong, got: %i", checkFailCount1);
+        SDL_free(pixels);
+    }
+
+    /* Clean up. */
+    SDL_DestroyRenderReadback(readback);
+    SDL_DestroyRenderReadback(clipped);
+    SDL_DestroyTexture(tface);
+    SDL_DestroySurface(referenceSurface);
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Blits with static geometry, moved and rotated by its transform.
+ *
+ * \sa SDL_CreateStaticGeometry
+ * \sa SDL_RenderStaticGeometry
+ * \sa SDL_DestroyStaticGeometry
+ */
+static int render_testStaticGeometry(void *arg)
+{
+    int ret;
+    SDL_Texture *tface;
+    SDL_StaticGeometry *geometry;
+    SDL_Surface *referenceSurface = NULL;
+    SDL_Vertex vertices[4], rotated[4];
+    const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+    float transform[6];
+    SDL_Rect readrect;
+    Uint32 *pixels;
+    Uint32 tformat;
+    int taccess, tw, th;
+    int i, j, ni, nj;
+    int checkFailCount1;
+
+    /* Clear surface. */
+    clearScreen();
+
+    /* Need drawcolor or just skip test. */
+    SDLTest_AssertCheck(hasDrawColor(), "_hasDrawColor)");
+
+    /* Create face surface. */
+    tface = loadTestFace();
+    SDLTest_AssertCheck(tface != NULL, "Verify loadTestFace() result");
+    if (tface == NULL) {
+        return TEST_ABORTED;
+    }
+
+    /* Constant values. */
+    CHECK_FUNC(SDL_QueryTexture, (tface, &tformat, &taccess, &tw, &th))
+    ni = TESTRENDER_SCREEN_W - tw;
+    nj = TESTRENDER_SCREEN_H - th;
+
+    /* The face at the origin, as a quad of two triangles. */
+    SDL_zeroa(vertices);
+    for (i = 0; i < 4; ++i) {
+        vertices[i].position.x = (i == 1 || i == 2) ? (float)tw : 0.0f;
+        vertices[i].position.y = (i >= 2) ? (float)th : 0.0f;
+        vertices[i].color.r = vertices[i].color.g = vertices[i].color.b = vertices[i].color.a = 255;
+        vertices[i].tex_coord.x = (i == 1 || i == 2) ? 1.0f : 0.0f;
+        vertices[i].tex_coord.y = (i >= 2) ? 1.0f : 0.0f;
+    }
+    geometry = SDL_CreateStaticGeometry(renderer, tface, vertices, 4, indices, 6);
+    SDLTest_AssertCheck(geometry != NULL, "Verify SDL_CreateStaticGeometry() result");
+    if (geometry == NULL) {
+        SDL_DestroyTexture(tface);
+        return TEST_ABORTED;
+    }
+
+    /* Same blits as render_testBlit(), moving the geometry. */
+    transform[0] = 1.0f;
+    transform[1] = 0.0f;
+    transform[2] = 0.0f;
+    transform[3] = 1.0f;
+    checkFailCount1 = 0;
+    for (j = 0; j <= nj; j += 4) {
+        for (i = 0; i <= ni; i += 4) {
+            transform[4] = (float)i;
+            transform[5] = (float)j;
+            ret = SDL_RenderStaticGeometry(renderer, geometry, transform);
+            if (ret != 0) {
+                checkFailCount1++;
+            }
+        }
+    }
+    SDLTest_AssertCheck(checkFailCount1 == 0, "Validate results from calls to SDL_RenderStaticGeometry, expected: 0, got: %i", checkFailCount1);
+
+    /* See if it's the same */
+    referenceSurface = SDLTest_ImageBlit();
+    compare(referenceSurface, ALLOWABLE_ERROR_OPAQUE);
+    SDL_DestroySurface(referenceSurface);
+
+    /* Rotated by 90 degrees and scaled, the same as the moved vertices drawn as regular geometry. */
+    transform[0] = 0.0f;
+    transform[1] = 1.5f;
+    transform[2] = -1.5f;
+    transform[3] = 0.0f;
+    transform[4] = 70.0f;
+    transform[5] = 5.0f;
+    for (i = 0; i < 4; ++i) {
+        rotated[i] = vertices[i];
+        rotated[i].position.x = transform[0] * vertices[i].position.x + transform[2] * vertices[i].position.y + transform[4];
+        rotated[i].position.y = transform[1] * vertices[i].position.x + transform[3] * vertices[i].position.y + transform[5];
+    }
+    pixels = (Uint32 *)SDL_calloc(2 * TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H, sizeof(*pixels));
+    SDLTest_AssertCheck(pixels != NULL, "Validate allocated temp pixel buffer");
+    if (pixels != NULL) {
+        Uint32 *static_pixels = pixels + TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H;
+
+        readrect.x = 0;
+        readrect.y = 0;
+        readrect.w = TESTRENDER_SCREEN_W;
+        readrect.h = TESTRENDER_SCREEN_H;
+        clearScreen();
+        CHECK_FUNC(SDL_RenderGeometry, (renderer, tface, rotated, 4, indices, 6))
+        CHECK_FUNC(SDL_RenderReadPixels, (renderer, &readrect, RENDER_COMPARE_FORMAT, pixels, TESTRENDER_SCREEN_W * 4))
+        clearScreen();
+        CHECK_FUNC(SDL_RenderStaticGeometry, (renderer, geometry, transform))
+        CHECK_FUNC(SDL_RenderReadPixels, (renderer, &readrect, RENDER_COMPARE_FORMAT, static_pixels, TESTRENDER_SCREEN_W * 4))
+
+        checkFailCount1 = 0;
+        for (i = 0; i < TESTRENDER_SCREEN_W * TESTRENDER_SCREEN_H; ++i) {
+            if (pixels[i] != static_pixels[i]) {
+                checkFailCount1++;
+            }
+        }
+        SDLTest_AssertCheck(checkFailCount1 == 0, "Validate pixels of the rotated geometry, expected: 0 wrong, got: %i", checkFailCount1);
+        SDL_free(pixels);
+    }
+
+    /* The geometry can't be drawn without its texture. */
+    SDL_DestroyTexture(tface);
+    ret = SDL_RenderStaticGeometry(renderer, geometry, NULL);
+    SDLTest_AssertCheck(ret < 0, "Validate result from SDL_RenderStaticGeometry after destroying the texture, expected: <0, got: %i", ret);
+
+    /* Make current */
+    SDL_RenderPresent(renderer);
+
+    /* Clean up. */
+    SDL_DestroyStaticGeometry(geometry);
+
+    return TEST_COMPLETED;
+}
+
 /**
  * \brief Tests blitting with alpha.
  *
@@ -1273,11 +1964,40 @@ static const SDLTest_TestCaseReference renderTest9 = {
     (SDLTest_TestCaseFp)render_testLogicalSize, "render_testLogicalSize", "Tests logical size", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference renderTest10 = {
+    (SDLTest_TestCaseFp)render_testBlitBatch, "render_testBlitBatch", "Tests blitting in a single batch", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest11 = {
+    (SDLTest_TestCaseFp)render_testRenderStats, "render_testRenderStats", "Tests the rendering statistics of a frame", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest12 = {
+    (SDLTest_TestCaseFp)render_testBlitReordered, "render_testBlitReordered", "Tests blitting with draw reordering", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest13 = {
+    (SDLTest_TestCaseFp)render_testReadPixelsAsync, "render_testReadPixelsAsync", "Tests blitting a streaming texture and reading pixels asynchronously", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest14 = {
+    (SDLTest_TestCaseFp)render_testStaticGeometry, "render_testStaticGeometry", "Tests blitting with static geometry", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest15 = {
+    (SDLTest_TestCaseFp)render_testBlitColorAlternating, "render_testBlitColorAlternating", "Tests blitting with color, alternating with other blits", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTest16 = {
+    (SDLTest_TestCaseFp)render_testBlitBatchClipped, "render_testBlitBatchClipped", "Tests blitting in a single batch with source rects outside of the texture", TEST_ENABLED
+};
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] = {
     &renderTest1, &renderTest2, &renderTest3, &renderTest4,
     &renderTest5, &renderTest6, &renderTest7, &renderTest8,
-    &renderTest9, NULL
+    &renderTest9, &renderTest10, &renderTest11, &renderTest12,
+    &renderTest13, &renderTest14, &renderTest15, &renderTest16, NULL
 };
 
 /* Render test suite (global) */
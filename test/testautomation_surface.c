@@ -396,6 +396,73 @@ static int surface_testLoadFailure(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * \brief Tests loading BMP images followed by other data in a stream.
+ */
+static int surface_testLoadEmbedded(void *arg)
+{
+    /* 2x2 RLE8 image, then 3x2 uncompressed 4-bit image with padded rows */
+    static const Uint8 rle_pixels[] = { 1, 1, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1 };
+    static const Uint8 rgb_pixels[] = { 0x10, 0x10, 0, 0, 0x01, 0x00, 0, 0 };
+    static const char tail[] = "tail";
+    const Uint8 *pixels[] = { rle_pixels, rgb_pixels };
+    const size_t sizes[] = { sizeof(rle_pixels), sizeof(rgb_pixels) };
+    const int widths[] = { 2, 3 };
+    int i;
+
+    for (i = 0; i < 2; ++i) {
+        Uint8 data[128];
+        Uint8 *p = data;
+        const Uint32 offset = 14 + 40 + 2 * 4;
+        const Uint32 size = offset + (Uint32)sizes[i];
+        char buf[sizeof(tail)];
+        SDL_RWops *rw;
+        SDL_Surface *face;
+        Sint64 pos;
+
+        SDL_zeroa(data);
+        *p++ = 'B';
+        *p++ = 'M';
+        SDL_memcpy(p, &size, 4); /* bfSize */
+        p += 4 + 4;
+        SDL_memcpy(p, &offset, 4); /* bfOffBits */
+        p += 4;
+        p[0] = 40;              /* biSize */
+        p[4] = (Uint8)widths[i]; /* biWidth */
+        p[8] = 2;               /* biHeight */
+        p[12] = 1;              /* biPlanes */
+        p[14] = (i == 0) ? 8 : 4; /* biBitCount */
+        p[16] = (i == 0) ? 1 : 0; /* biCompression, BI_RLE8 or BI_RGB */
+        p[32] = 2;              /* biClrUsed */
+        p += 40;
+        p[4] = p[5] = p[6] = 0xFF; /* palette, black and white */
+        p += 8;
+        SDL_memcpy(p, pixels[i], sizes[i]);
+        p += sizes[i];
+        SDL_memcpy(p, tail, sizeof(tail));
+        p += sizeof(tail);
+
+        rw = SDL_RWFromConstMem(data, (size_t)(p - data));
+        face = SDL_LoadBMP_RW(rw, SDL_FALSE);
+        SDLTest_AssertPass("Call to SDL_LoadBMP_RW(), image %d", i);
+        SDLTest_AssertCheck(face != NULL, "Verify result from SDL_LoadBMP_RW is not NULL");
+        if (face != NULL) {
+            const Uint8 *row0 = (const Uint8 *)face->pixels;
+            const Uint8 *row1 = row0 + face->pitch;
+            SDLTest_AssertCheck(face->w == widths[i] && face->h == 2, "Verify size, expected: %dx2, got: %dx%d", widths[i], face->w, face->h);
+            SDLTest_AssertCheck(row0[0] == 0 && row0[1] == 1 && row1[0] == 1 && row1[1] == 0, "Verify pixels are decoded");
+        }
+        pos = SDL_RWtell(rw);
+        SDLTest_AssertCheck(pos == size, "Verify stream is positioned after the image, expected: %" SDL_PRIu32 ", got: %" SDL_PRIs64, size, pos);
+        SDLTest_AssertCheck(SDL_RWread(rw, buf, sizeof(buf)) == sizeof(buf) && SDL_memcmp(buf, tail, sizeof(tail)) == 0, "Verify data following the image can be read");
+
+        SDL_DestroySurface(face);
+        SDL_RWclose(rw);
+    }
+
+    return TEST_COMPLETED;
+}
+
 /**
  * \brief Tests some blitting routines.
  */
@@ -573,6 +640,328 @@ static int surface_testBlitBlendLoop(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * \brief Tests area averaging and filtered scaling of 16, 24 and 32 bits surfaces
+ */
+static int surface_testStretchArea(void *arg)
+{
+    const Uint32 formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB565 };
+    int i, x, y, ret;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Surface *src = SDL_CreateSurface(64, 48, formats[i]);
+        SDL_Surface *dst = SDL_CreateSurface(5, 7, formats[i]);
+        Uint32 white, black, pixel;
+        int bpp;
+        SDL_bool uniform = SDL_TRUE;
+
+        SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify surfaces are not NULL");
+        if (src == NULL || dst == NULL) {
+            SDL_DestroySurface(src);
+            SDL_DestroySurface(dst);
+            continue;
+        }
+        bpp = src->format->BytesPerPixel;
+
+        /* A one pixel checkerboard averages to mid gray */
+        white = SDL_MapRGB(src->format, 255, 255, 255);
+        black = SDL_MapRGB(src->format, 0, 0, 0);
+        for (y = 0; y < src->h; ++y) {
+            for (x = 0; x < src->w; ++x) {
+                pixel = ((x ^ y) & 1) ? white : black;
+                SDL_memcpy((Uint8 *)src->pixels + y * src->pitch + x * bpp, &pixel, bpp);
+            }
+        }
+        ret = SDL_SoftStretchArea(src, NULL, dst, NULL);
+        SDLTest_AssertPass("Call to SDL_SoftStretchArea(), format %s", SDL_GetPixelFormatName(formats[i]));
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchArea, expected: 0, got: %i", ret);
+
+        for (y = 0; y < dst->h; ++y) {
+            for (x = 0; x < dst->w; ++x) {
+                Uint8 r, g, b;
+                pixel = 0;
+                SDL_memcpy(&pixel, (Uint8 *)dst->pixels + y * dst->pitch + x * bpp, bpp);
+                SDL_GetRGB(pixel, dst->format, &r, &g, &b);
+                if (r < 112 || r > 143 || g < 112 || g > 143 || b < 112 || b > 143) {
+                    uniform = SDL_FALSE;
+                }
+            }
+        }
+        SDLTest_AssertCheck(uniform, "Verify checkerboard is averaged to gray");
+
+        ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear, expected: 0, got: %i", ret);
+
+        SDL_DestroySurface(src);
+        SDL_DestroySurface(dst);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \brief Tests that scaling between 32 bits formats matches scaling then converting
+ */
+static int surface_testStretchConvert(void *arg)
+{
+    SDL_Surface *src, *dst, *ref, *converted;
+    int x, y, ret;
+
+    src = SDL_CreateSurface(37, 23, SDL_PIXELFORMAT_ABGR8888);
+    dst = SDL_CreateSurface(101, 67, SDL_PIXELFORMAT_XRGB8888);
+    ref = SDL_CreateSurface(101, 67, SDL_PIXELFORMAT_ABGR8888);
+    SDLTest_AssertCheck(src != NULL && dst != NULL && ref != NULL, "Verify surfaces are not NULL");
+    if (src == NULL || dst == NULL || ref == NULL) {
+        goto done;
+    }
+
+    for (y = 0; y < src->h; ++y) {
+        for (x = 0; x < src->w; ++x) {
+            ((Uint32 *)((Uint8 *)src->pixels + y * src->pitch))[x] = SDL_MapRGBA(src->format, (Uint8)(x * 7), (Uint8)(y * 11), (Uint8)(x * y), (Uint8)(x + y));
+        }
+    }
+
+    ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear, expected: 0, got: %i", ret);
+    ret = SDL_SoftStretchLinear(src, NULL, ref, NULL);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear, expected: 0, got: %i", ret);
+
+    converted = SDL_ConvertSurfaceFormat(ref, SDL_PIXELFORMAT_XRGB8888);
+    SDLTest_AssertCheck(converted != NULL, "Verify converted surface is not NULL");
+    if (converted != NULL) {
+        ret = SDLTest_CompareSurfaces(dst, converted, 0);
+        SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+        SDL_DestroySurface(converted);
+    }
+
+done:
+    SDL_DestroySurface(src);
+    SDL_DestroySurface(dst);
+    SDL_DestroySurface(ref);
+
+    return TEST_COMPLETED;
+}
+
+static int surface_testPremultiplyAlpha(void *arg)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888,
+        SDL_PIXELFORMAT_XRGB8888
+    };
+    Uint32 src[256 + 3], dst[256 + 3];
+    int i, j, k, ret, errors;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            SDL_PixelFormat *srcfmt = SDL_CreatePixelFormat(formats[i]);
+            SDL_PixelFormat *dstfmt = SDL_CreatePixelFormat(formats[j]);
+
+            /* Every alpha value, with an odd count to go through the SIMD tails */
+            for (k = 0; k < SDL_arraysize(src); ++k) {
+                src[k] = SDL_MapRGBA(srcfmt, (Uint8)(k * 7), (Uint8)(255 - k), 255, (Uint8)k);
+            }
+
+            ret = SDL_PremultiplyAlpha(SDL_arraysize(src), 1, formats[i], src, sizeof(src), formats[j], dst, sizeof(dst));
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha, expected: 0, got: %i", ret);
+            errors = 0;
+            for (k = 0; k < SDL_arraysize(src); ++k) {
+                Uint8 r, g, b, a;
+                const Uint32 alpha = srcfmt->Amask ? (Uint8)k : 255;
+
+                SDL_GetRGBA(dst[k], dstfmt, &r, &g, &b, &a);
+                if (r != (Uint8)(k * 7) * alpha / 255 || g != (Uint8)(255 - k) * alpha / 255 || b != alpha ||
+                    a != (dstfmt->Amask ? alpha : 255)) {
+                    ++errors;
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify premultiplied %s -> %s, expected: 0 errors, got: %i",
+                                SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(formats[j]), errors);
+
+            if (srcfmt->Amask && !dstfmt->Amask) {
+                /* The alpha is gone, there is no way back */
+                SDL_DestroyPixelFormat(srcfmt);
+                SDL_DestroyPixelFormat(dstfmt);
+                continue;
+            }
+
+            /* Round trip, in place */
+            ret = SDL_UnpremultiplyAlpha(SDL_arraysize(dst), 1, formats[j], dst, sizeof(dst), formats[j], dst, sizeof(dst));
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_UnpremultiplyAlpha, expected: 0, got: %i", ret);
+            errors = 0;
+            for (k = 0; k < SDL_arraysize(src); ++k) {
+                Uint8 r, g, b, a;
+                const int alpha = srcfmt->Amask ? (Uint8)k : 255;
+
+                SDL_GetRGBA(dst[k], dstfmt, &r, &g, &b, &a);
+                /* Premultiplication loses up to 255 / alpha of precision */
+                if (alpha && (SDL_abs(r - (Uint8)(k * 7)) > 255 / alpha + 1 || SDL_abs(g - (Uint8)(255 - k)) > 255 / alpha + 1 || b != 255)) {
+                    ++errors;
+                } else if (!alpha && (r || g || b)) {
+                    ++errors;
+                }
+            }
+            SDLTest_AssertCheck(errors == 0, "Verify unpremultiplied %s, expected: 0 errors, got: %i",
+                                SDL_GetPixelFormatName(formats[j]), errors);
+
+            SDL_DestroyPixelFormat(srcfmt);
+            SDL_DestroyPixelFormat(dstfmt);
+        }
+    }
+
+    ret = SDL_PremultiplyAlpha(1, 1, SDL_PIXELFORMAT_RGB565, src, 4, SDL_PIXELFORMAT_ARGB8888, dst, 4);
+    SDLTest_AssertCheck(ret < 0, "Verify SDL_PremultiplyAlpha rejects 16 bits formats, got: %i", ret);
+
+    return TEST_COMPLETED;
+}
+
+static int surface_testBlitRLEModulate(void *arg)
+{
+    const int w = 67, h = 13;
+    SDL_Surface *sprite, *plain, *rle;
+    Uint32 *pixels;
+    int x, y, i, ret, errors;
+
+    sprite = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_ARGB8888);
+    plain = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_XRGB8888);
+    rle = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_XRGB8888);
+    SDLTest_AssertCheck(sprite && plain && rle, "Verify surfaces are not NULL");
+    if (!sprite || !plain || !rle) {
+        goto out;
+    }
+
+    /* Transparent, opaque and translucent runs of different lengths */
+    for (y = 0; y < h; ++y) {
+        pixels = (Uint32 *)((Uint8 *)sprite->pixels + y * sprite->pitch);
+        for (x = 0; x < w; ++x) {
+            const int phase = (x + y) % 11;
+            const Uint32 alpha = phase < 5 ? 0 : phase < 8 ? 255 : (Uint32)(x * 37 + y * 11) & 0xff;
+            pixels[x] = (alpha << 24) | ((Uint32)(x * 7 + y) << 16 & 0xff0000) | ((Uint32)(y * 19) << 8 & 0xff00) | (Uint32)(255 - x);
+        }
+    }
+
+    for (i = 0; i < 3; ++i) {
+        ret = SDL_SetSurfaceColorMod(sprite, i == 1 ? 255 : 200, i == 1 ? 255 : 100, 50);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceColorMod, expected: 0, got: %i", ret);
+        ret = SDL_SetSurfaceAlphaMod(sprite, i == 0 ? 255 : 128);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SetSurfaceAlphaMod, expected: 0, got: %i", ret);
+
+        SDL_FillSurfaceRect(plain, NULL, SDL_MapRGB(plain->format, 10, 128, 240));
+        SDL_FillSurfaceRect(rle, NULL, SDL_MapRGB(rle->format, 10, 128, 240));
+
+        SDL_SetSurfaceRLE(sprite, SDL_FALSE);
+        ret = SDL_BlitSurface(sprite, NULL, plain, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+        SDL_SetSurfaceRLE(sprite, SDL_TRUE);
+        ret = SDL_BlitSurface(sprite, NULL, rle, NULL);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface with RLE, expected: 0, got: %i", ret);
+
+        errors = 0;
+        for (y = 0; y < h; ++y) {
+            const Uint32 *p = (const Uint32 *)((const Uint8 *)plain->pixels + y * plain->pitch);
+            const Uint32 *r = (const Uint32 *)((const Uint8 *)rle->pixels + y * rle->pitch);
+            for (x = 0; x < w; ++x) {
+                int c;
+                for (c = 0; c < 24; c += 8) {
+                    if (SDL_abs((int)((p[x] >> c) & 0xff) - (int)((r[x] >> c) & 0xff)) > 2) {
+                        ++errors;
+                    }
+                }
+            }
+        }
+        SDLTest_AssertCheck(errors == 0, "Verify RLE blit with modulation %d matches, expected: 0 errors, got: %i", i, errors);
+    }
+
+out:
+    SDL_DestroySurface(sprite);
+    SDL_DestroySurface(plain);
+    SDL_DestroySurface(rle);
+    return TEST_COMPLETED;
+}
+
+static int surface_testPool(void *arg)
+{
+    SDL_SurfacePoolStats before, after;
+    SDL_Surface *surface, *target = NULL;
+    SDL_Renderer *renderer = NULL;
+    SDL_Texture *texture = NULL;
+    SDL_FRect dstrect;
+    SDL_BlendMode blendMode;
+    Uint8 r, g, b;
+    int i, ret;
+
+    SDL_ClearSurfacePool();
+    ret = SDL_GetSurfacePoolStats(&before);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_GetSurfacePoolStats, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck(before.pooled == 0 && before.pooled_bytes == 0,
+                        "Verify pool is empty, got: %i surfaces, %u bytes", before.pooled, (unsigned int)before.pooled_bytes);
+
+    surface = SDL_CreatePooledSurface(37, 21, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(surface != NULL && (surface->flags & SDL_POOLED), "Verify pooled surface is not NULL and flagged");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    SDL_SetSurfaceColorMod(surface, 1, 2, 3);
+    SDL_SetSurfaceColorKey(surface, SDL_TRUE, 0);
+    SDL_DestroySurface(surface);
+
+    ret = SDL_GetSurfacePoolStats(&after);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_GetSurfacePoolStats, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck(after.allocated == before.allocated + 1, "Verify one surface was allocated");
+    SDLTest_AssertCheck(after.freed == before.freed, "Verify no surface was freed");
+    SDLTest_AssertCheck(after.pooled == 1, "Verify surface went back to the pool, got: %i", after.pooled);
+
+    /* Same size and format: reused, in the state of a new surface */
+    surface = SDL_CreatePooledSurface(37, 21, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(surface != NULL, "Verify pooled surface is not NULL");
+    if (surface == NULL) {
+        return TEST_ABORTED;
+    }
+    SDL_GetSurfaceBlendMode(surface, &blendMode);
+    SDL_GetSurfaceColorMod(surface, &r, &g, &b);
+    SDLTest_AssertCheck(blendMode == SDL_BLENDMODE_BLEND, "Verify blend mode was reset, got: %i", blendMode);
+    SDLTest_AssertCheck(r == 255 && g == 255 && b == 255, "Verify color mod was reset, got: %u,%u,%u", r, g, b);
+    SDLTest_AssertCheck(!SDL_SurfaceHasColorKey(surface), "Verify color key was reset");
+    SDL_GetSurfacePoolStats(&after);
+    SDLTest_AssertCheck(after.allocated == before.allocated + 1 && after.reused == before.reused + 1,
+                        "Verify surface was reused instead of allocated");
+    SDL_DestroySurface(surface);
+
+    SDL_ClearSurfacePool();
+    SDL_GetSurfacePoolStats(&after);
+    SDLTest_AssertCheck(after.pooled == 0 && after.freed == before.freed + 1, "Verify pool was cleared");
+
+    /* A steady state frame with scaled copies doesn't allocate surfaces */
+    target = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_ARGB8888);
+    renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    texture = renderer ? SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16) : NULL;
+    SDLTest_AssertCheck(texture != NULL, "Verify software renderer and texture are not NULL");
+    if (texture == NULL) {
+        goto out;
+    }
+    dstrect.x = -10.0f;
+    dstrect.y = 20.0f;
+    dstrect.w = 50.0f;
+    dstrect.h = 30.0f;
+    for (i = 0; i < 3; ++i) {
+        SDL_GetSurfacePoolStats(&before);
+        SDL_RenderClear(renderer);
+        SDL_RenderTexture(renderer, texture, NULL, &dstrect);
+        SDL_RenderFlush(renderer);
+        SDL_GetSurfacePoolStats(&after);
+    }
+    SDLTest_AssertCheck(after.allocated == before.allocated,
+                        "Verify steady state frame allocated no surface, got: %u", (unsigned int)(after.allocated - before.allocated));
+    SDLTest_AssertCheck(after.reused > before.reused, "Verify pooled surfaces were reused");
+
+out:
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    return TEST_COMPLETED;
+}
+
 static int surface_testOverflow(void *arg)
 {
     char buf[1024];
@@ -804,6 +1193,30 @@ static const SDLTest_TestCaseReference surfaceTest12 = {
     (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference surfaceTestStretchArea = {
+    (SDLTest_TestCaseFp)surface_testStretchArea, "surface_testStretchArea", "Tests area averaging and filtered scaling.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestStretchConvert = {
+    (SDLTest_TestCaseFp)surface_testStretchConvert, "surface_testStretchConvert", "Tests scaling with format conversion.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestPremultiplyAlpha = {
+    (SDLTest_TestCaseFp)surface_testPremultiplyAlpha, "surface_testPremultiplyAlpha", "Tests alpha premultiplication and its inverse.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestBlitRLEModulate = {
+    (SDLTest_TestCaseFp)surface_testBlitRLEModulate, "surface_testBlitRLEModulate", "Tests RLE accelerated blits with color and alpha modulation.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestPool = {
+    (SDLTest_TestCaseFp)surface_testPool, "surface_testPool", "Tests the surface pool and allocation counters.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestLoadEmbedded = {
+    (SDLTest_TestCaseFp)surface_testLoadEmbedded, "surface_testLoadEmbedded", "Tests loading BMP images followed by other data.", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference surfaceTestOverflow = {
     surface_testOverflow, "surface_testOverflow", "Test overflow detection.", TEST_ENABLED
 };
@@ -812,7 +1225,9 @@ static const SDLTest_TestCaseReference surfaceTestOverflow = {
 static const SDLTest_TestCaseReference *surfaceTests[] = {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, &surfaceTestOverflow, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTestStretchArea, &surfaceTestStretchConvert,
+    &surfaceTestPremultiplyAlpha, &surfaceTestBlitRLEModulate, &surfaceTestPool, &surfaceTestLoadEmbedded,
+    &surfaceTestOverflow, NULL
 };
 
 /* Surface test suite (global) */
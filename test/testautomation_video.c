@@ -1748,6 +1748,155 @@ static int video_setWindowCenteredOnDisplay(void *arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * \brief Tests updating the window surface with damage tracking
+ *
+ * \sa SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE
+ * \sa SDL_UpdateWindowSurface
+ */
+static int video_updateWindowSurfaceDamage(void *arg)
+{
+    const char *title = "video_updateWindowSurfaceDamage Test Window";
+    SDL_Window *window;
+    SDL_Surface *surface;
+    SDL_Rect rect;
+    int i, result;
+
+    SDL_SetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE, "1");
+    window = createVideoSuiteTestWindow(title);
+    if (window == NULL) {
+        SDL_ResetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE);
+        return TEST_ABORTED;
+    }
+
+    surface = SDL_GetWindowSurface(window);
+    SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+    if (surface == NULL) {
+        SDLTest_Log("Skipping test, no window surface: %s", SDL_GetError());
+    } else {
+        /* Whole surface, then nothing */
+        for (i = 0; i < 2; ++i) {
+            result = SDL_UpdateWindowSurface(window);
+            SDLTest_AssertCheck(result == 0, "Verify result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+        }
+
+        /* More rectangles than the damage tracking keeps */
+        for (i = 0; i < 40; ++i) {
+            rect.x = (i * 37) % surface->w;
+            rect.y = (i * 23) % surface->h;
+            rect.w = 3;
+            rect.h = 3;
+            SDL_FillSurfaceRect(surface, &rect, 0);
+            if (i % 4 == 0) {
+                SDL_Surface *sprite = SDL_CreateSurface(3, 3, surface->format->format);
+                SDL_BlitSurface(sprite, NULL, surface, &rect);
+                SDL_DestroySurface(sprite);
+            }
+        }
+        result = SDL_UpdateWindowSurface(window);
+        SDLTest_AssertCheck(result == 0, "Verify result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+
+        SDL_LockSurface(surface);
+        SDL_UnlockSurface(surface);
+        result = SDL_UpdateWindowSurface(window);
+        SDLTest_AssertCheck(result == 0, "Verify result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+    }
+
+    destroyVideoSuiteTestWindow(window);
+    SDL_ResetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE);
+    return TEST_COMPLETED;
+}
+
+/* The rects logged by SDL_UpdateWindowSurfaceRects() */
+typedef struct
+{
+    int numrects;
+    SDL_Rect rects[16];
+} UpdatedRects;
+
+static void SDLCALL logUpdatedRects(void *userdata, int category, SDL_LogPriority priority, const char *message)
+{
+    UpdatedRects *updated = (UpdatedRects *)userdata;
+    SDL_WindowID id;
+    SDL_Rect rect;
+
+    if (category == SDL_LOG_CATEGORY_VIDEO &&
+        SDL_sscanf(message, "Updating window %" SDL_PRIu32 " surface: %d,%d %dx%d", &id, &rect.x, &rect.y, &rect.w, &rect.h) == 5 &&
+        updated->numrects < (int)SDL_arraysize(updated->rects)) {
+        updated->rects[updated->numrects++] = rect;
+    }
+}
+
+/**
+ * \brief Tests the areas updated after a blended fill on the window surface with damage tracking
+ *
+ * \sa SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE
+ * \sa SDL_CreateSoftwareRenderer
+ * \sa SDL_UpdateWindowSurface
+ */
+static int video_updateWindowSurfaceDamageBlended(void *arg)
+{
+    const char *title = "video_updateWindowSurfaceDamageBlended Test Window";
+    const SDL_Rect expected = { 10, 20, 30, 15 };
+    SDL_LogOutputFunction log_function;
+    void *log_userdata;
+    SDL_LogPriority log_priority;
+    UpdatedRects updated;
+    SDL_Window *window;
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    SDL_FRect rect;
+    int result;
+
+    SDL_SetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE, "1");
+    window = createVideoSuiteTestWindow(title);
+    surface = window ? SDL_GetWindowSurface(window) : NULL;
+    renderer = surface ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    SDLTest_AssertCheck(renderer != NULL, "Validate software renderer on the window surface, got: %s", renderer ? "yes" : SDL_GetError());
+    if (renderer == NULL) {
+        destroyVideoSuiteTestWindow(window);
+        SDL_ResetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE);
+        return TEST_ABORTED;
+    }
+
+    /* Send the whole surface first */
+    result = SDL_UpdateWindowSurface(window);
+    SDLTest_AssertCheck(result == 0, "Verify result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+
+    rect.x = (float)expected.x;
+    rect.y = (float)expected.y;
+    rect.w = (float)expected.w;
+    rect.h = (float)expected.h;
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 128);
+    SDL_RenderFillRect(renderer, &rect);
+    result = SDL_RenderFlush(renderer);
+    SDLTest_AssertCheck(result == 0, "Verify result from SDL_RenderFlush(), expected: 0, got: %i", result);
+
+    SDL_zero(updated);
+    SDL_LogGetOutputFunction(&log_function, &log_userdata);
+    log_priority = SDL_LogGetPriority(SDL_LOG_CATEGORY_VIDEO);
+    SDL_LogSetOutputFunction(logUpdatedRects, &updated);
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, SDL_LOG_PRIORITY_VERBOSE);
+    result = SDL_UpdateWindowSurface(window);
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_VIDEO, log_priority);
+    SDL_LogSetOutputFunction(log_function, log_userdata);
+    SDLTest_AssertCheck(result == 0, "Verify result from SDL_UpdateWindowSurface(), expected: 0, got: %i", result);
+
+    SDLTest_AssertCheck(updated.numrects == 1, "Verify number of updated rects, expected: 1, got: %i", updated.numrects);
+    if (updated.numrects == 1) {
+        SDLTest_AssertCheck(SDL_RectsEqual(&updated.rects[0], &expected),
+                            "Verify updated rect, expected: %d,%d %dx%d, got: %d,%d %dx%d",
+                            expected.x, expected.y, expected.w, expected.h,
+                            updated.rects[0].x, updated.rects[0].y, updated.rects[0].w, updated.rects[0].h);
+    }
+
+    SDL_DestroyRenderer(renderer);
+    destroyVideoSuiteTestWindow(window);
+    SDL_ResetHint(SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE);
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -1823,12 +1972,20 @@ static const SDLTest_TestCaseReference videoTest18 = {
     (SDLTest_TestCaseFp)video_setWindowCenteredOnDisplay, "video_setWindowCenteredOnDisplay", "Checks using SDL_WINDOWPOS_CENTERED_DISPLAY centers the window on a display", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference videoTest19 = {
+    (SDLTest_TestCaseFp)video_updateWindowSurfaceDamage, "video_updateWindowSurfaceDamage", "Checks SDL_UpdateWindowSurface with SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE", TEST_ENABLED
+};
+
 /* Sequence of Video test cases */
+static const SDLTest_TestCaseReference videoTest20 = {
+    (SDLTest_TestCaseFp)video_updateWindowSurfaceDamageBlended, "video_updateWindowSurfaceDamageBlended", "Checks the areas updated after a blended fill with SDL_HINT_VIDEO_WINDOW_SURFACE_DAMAGE", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference *videoTests[] = {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
-    &videoTest18, NULL
+    &videoTest18, &videoTest19, &videoTest20, NULL
 };
 
 /* Video test suite (global) */
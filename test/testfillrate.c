@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark of surface fills and same format copies, from sizes that stay in
+   the cache up to 8K frames that don't fit in it.
+*/
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+static const struct
+{
+    const char *name;
+    int w, h;
+} sizes[] = {
+    { "256x256", 256, 256 },
+    { "1080p", 1920, 1080 },
+    { "4K", 3840, 2160 },
+    { "8K", 7680, 4320 },
+};
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_INDEX8,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_XRGB8888,
+};
+
+static void LogRate(const char *what, const char *size, Uint32 format, const SDL_Surface *surface, int iterations, Uint64 elapsed)
+{
+    const double seconds = (double)elapsed / SDL_GetPerformanceFrequency();
+    const double bytes = (double)surface->w * surface->h * surface->format->BytesPerPixel * iterations;
+
+    SDL_Log("%-5s %-8s %-24s %8.3f ms each, %7.2f GB/s\n", what, size, SDL_GetPixelFormatName(format),
+            seconds * 1000.0 / iterations, bytes / seconds / (1024.0 * 1024.0 * 1024.0));
+}
+
+int main(int argc, char *argv[])
+{
+    int i, j, k;
+    int iterations = 20;
+    SDLTest_CommonState *state;
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (state == NULL) {
+        return 1;
+    }
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Parse commandline */
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (!consumed) {
+            if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_atoi(argv[i + 1]);
+                if (iterations > 0) {
+                    consumed = 2;
+                }
+            }
+        }
+        if (consumed <= 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+
+        i += consumed;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    for (i = 0; i < SDL_arraysize(sizes); ++i) {
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            SDL_Surface *src = SDL_CreateSurface(sizes[i].w, sizes[i].h, formats[j]);
+            SDL_Surface *dst = SDL_CreateSurface(sizes[i].w, sizes[i].h, formats[j]);
+            Uint64 start;
+
+            if (src == NULL || dst == NULL) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create %s surface: %s\n", sizes[i].name, SDL_GetError());
+                SDL_DestroySurface(src);
+                SDL_DestroySurface(dst);
+                continue;
+            }
+            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+
+            /* Warm up, so that the pages are mapped before timing */
+            SDL_FillSurfaceRect(src, NULL, 0x12345678);
+            SDL_FillSurfaceRect(dst, NULL, 0);
+
+            start = SDL_GetPerformanceCounter();
+            for (k = 0; k < iterations; ++k) {
+                SDL_FillSurfaceRect(dst, NULL, (Uint32)k);
+            }
+            LogRate("fill", sizes[i].name, formats[j], dst, iterations, SDL_GetPerformanceCounter() - start);
+
+            start = SDL_GetPerformanceCounter();
+            for (k = 0; k < iterations; ++k) {
+                SDL_BlitSurface(src, NULL, dst, NULL);
+            }
+            LogRate("copy", sizes[i].name, formats[j], dst, iterations, SDL_GetPerformanceCounter() - start);
+
+            SDL_DestroySurface(src);
+            SDL_DestroySurface(dst);
+        }
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
@@ -29,6 +29,12 @@ static SDL_Texture **sprites;
 static SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
 static float angle = 0.0f;
 static int sprite_w, sprite_h;
+static int benchmark_frames = 0;
+
+#define BENCHMARK_CELL_SIZE 24
+#define BENCHMARK_MAX_CELLS 4096
+static SDL_Vertex benchmark_verts[BENCHMARK_MAX_CELLS * 4];
+static int benchmark_indices[BENCHMARK_MAX_CELLS * 6];
 
 static int done;
 
@@ -65,6 +71,52 @@ static int LoadSprite(const char *file)
     return 0;
 }
 
+/* Fill the viewport with a rotated grid of colored quads, two triangles each */
+static void DrawBenchmarkMesh(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *viewport)
+{
+    const float a = (angle * 3.1415f) / 180.0f;
+    const float cos_a = SDL_cosf(a);
+    const float sin_a = SDL_sinf(a);
+    const float cx = viewport->x + viewport->w / 2.0f;
+    const float cy = viewport->y + viewport->h / 2.0f;
+    /* Large enough to cover the viewport at any angle */
+    const int cells = (int)((viewport->w + viewport->h) / BENCHMARK_CELL_SIZE) + 1;
+    int num_cells = 0;
+    int x, y, i;
+
+    for (y = 0; y < cells; ++y) {
+        for (x = 0; x < cells && num_cells < BENCHMARK_MAX_CELLS; ++x) {
+            SDL_Vertex *v = &benchmark_verts[num_cells * 4];
+            int *index = &benchmark_indices[num_cells * 6];
+
+            for (i = 0; i < 4; ++i) {
+                const int corner_x = x + (i == 1 || i == 2);
+                const int corner_y = y + (i >= 2);
+                const float px = (corner_x - cells / 2.0f) * BENCHMARK_CELL_SIZE;
+                const float py = (corner_y - cells / 2.0f) * BENCHMARK_CELL_SIZE;
+
+                v[i].position.x = cx + px * cos_a - py * sin_a;
+                v[i].position.y = cy + px * sin_a + py * cos_a;
+                v[i].color.r = (Uint8)(corner_x * 255 / cells);
+                v[i].color.g = (Uint8)(corner_y * 255 / cells);
+                v[i].color.b = (Uint8)(255 - corner_x * 255 / cells);
+                v[i].color.a = 0xC0;
+                v[i].tex_coord.x = (float)(i == 1 || i == 2);
+                v[i].tex_coord.y = (float)(i >= 2);
+            }
+            index[0] = num_cells * 4;
+            index[1] = num_cells * 4 + 1;
+            index[2] = num_cells * 4 + 2;
+            index[3] = num_cells * 4;
+            index[4] = num_cells * 4 + 2;
+            index[5] = num_cells * 4 + 3;
+            ++num_cells;
+        }
+    }
+
+    SDL_RenderGeometry(renderer, texture, benchmark_verts, num_cells * 4, benchmark_indices, num_cells * 6);
+}
+
 static void loop(void)
 {
     int i;
@@ -105,7 +157,12 @@ static void loop(void)
         SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
         SDL_RenderClear(renderer);
 
-        {
+        if (benchmark_frames) {
+            SDL_Rect viewport;
+
+            SDL_GetRenderViewport(renderer, &viewport);
+            DrawBenchmarkMesh(renderer, sprites[i], &viewport);
+        } else {
             SDL_Rect viewport;
             SDL_Vertex verts[3];
             float a;
@@ -157,6 +214,10 @@ static void loop(void)
 
         SDL_RenderPresent(renderer);
     }
+
+    if (benchmark_frames) {
+        angle += 1.0f;
+    }
 #ifdef __EMSCRIPTEN__
     if (done) {
         emscripten_cancel_main_loop();
@@ -208,10 +269,17 @@ int main(int argc, char *argv[])
             } else if (SDL_strcasecmp(argv[i], "--use-texture") == 0) {
                 use_texture = SDL_TRUE;
                 consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--benchmark") == 0) {
+                if (argv[i + 1]) {
+                    benchmark_frames = SDL_atoi(argv[i + 1]);
+                    if (benchmark_frames > 0) {
+                        consumed = 2;
+                    }
+                }
             }
         }
         if (consumed < 0) {
-            static const char *options[] = { "[--blend none|blend|add|mod|mul]", "[--use-texture]", NULL };
+            static const char *options[] = { "[--blend none|blend|add|mod|mul]", "[--use-texture]", "[--benchmark N]", NULL };
             SDLTest_CommonLogUsage(state, argv[0], options);
             return 1;
         }
@@ -255,6 +323,9 @@ int main(int argc, char *argv[])
     while (!done) {
         ++frames;
         loop();
+        if (benchmark_frames && frames >= (Uint32)benchmark_frames) {
+            done = 1;
+        }
     }
 #endif
 
@@ -263,6 +334,9 @@ int main(int argc, char *argv[])
     if (now > then) {
         double fps = ((double)frames * 1000) / (now - then);
         SDL_Log("%2.2f frames per second\n", fps);
+        if (benchmark_frames) {
+            SDL_Log("%.3f ms per frame\n", (double)(now - then) / frames);
+        }
     }
 
     quit(0);
@@ -0,0 +1,149 @@
+/*
+  Copyright (C) 1997-2023 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Benchmark of alpha blended sprite blits with and without RLE acceleration,
+   for sprites with more or less transparent pixels, plain and tinted.
+*/
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define SPRITE_SIZE 128
+
+/* Percentage of transparent pixels, the rest being half opaque and half
+   translucent */
+static const int sparsities[] = { 0, 50, 80, 95 };
+
+static void FillSprite(SDL_Surface *sprite, int sparsity)
+{
+    int x, y;
+    Uint32 seed = 1;
+
+    for (y = 0; y < sprite->h; ++y) {
+        Uint32 *pixels = (Uint32 *)((Uint8 *)sprite->pixels + y * sprite->pitch);
+        for (x = 0; x < sprite->w; ++x) {
+            Uint32 alpha;
+
+            /* transparent spans of a few pixels, like antialiased shapes */
+            if ((x / 8 * 37 + y * 11) % 100 < sparsity) {
+                alpha = 0;
+            } else {
+                seed = seed * 1103515245 + 12345;
+                alpha = (seed >> 16) & 1 ? 255 : (seed >> 8) & 0xff;
+            }
+            pixels[x] = (alpha << 24) | (((Uint32)x * 2) << 16) | (((Uint32)y * 2) << 8) | 0x80;
+        }
+    }
+}
+
+static double BlitSprites(SDL_Surface *sprite, SDL_Surface *screen, int iterations)
+{
+    int i;
+    Uint64 start;
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        SDL_Rect position;
+
+        position.x = (i * 97) % (screen->w - SPRITE_SIZE);
+        position.y = (i * 61) % (screen->h - SPRITE_SIZE);
+        position.w = SPRITE_SIZE;
+        position.h = SPRITE_SIZE;
+        SDL_BlitSurface(sprite, NULL, screen, &position);
+    }
+    return (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+int main(int argc, char *argv[])
+{
+    int i, j;
+    int iterations = 2000;
+    SDLTest_CommonState *state;
+    SDL_Surface *screen;
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (state == NULL) {
+        return 1;
+    }
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Parse commandline */
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (!consumed) {
+            if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_atoi(argv[i + 1]);
+                if (iterations > 0) {
+                    consumed = 2;
+                }
+            }
+        }
+        if (consumed <= 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+
+        i += consumed;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    screen = SDL_CreateSurface(1280, 720, SDL_PIXELFORMAT_XRGB8888);
+    if (screen == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create screen surface: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    SDL_FillSurfaceRect(screen, NULL, 0);
+
+    for (i = 0; i < SDL_arraysize(sparsities); ++i) {
+        for (j = 0; j < 2; ++j) {
+            SDL_Surface *sprite = SDL_CreateSurface(SPRITE_SIZE, SPRITE_SIZE, SDL_PIXELFORMAT_ARGB8888);
+            const char *tint = j ? "tinted" : "plain";
+            double plain, rle;
+
+            if (sprite == NULL) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create sprite: %s\n", SDL_GetError());
+                continue;
+            }
+            FillSprite(sprite, sparsities[i]);
+            SDL_SetSurfaceBlendMode(sprite, SDL_BLENDMODE_BLEND);
+            if (j) {
+                SDL_SetSurfaceColorMod(sprite, 255, 160, 64);
+                SDL_SetSurfaceAlphaMod(sprite, 200);
+            }
+
+            plain = BlitSprites(sprite, screen, iterations);
+            SDL_SetSurfaceRLE(sprite, SDL_TRUE);
+            rle = BlitSprites(sprite, screen, iterations);
+
+            SDL_Log("%2d%% transparent %-6s: %8.2f us without RLE, %8.2f us with RLE, %5.2fx\n",
+                    sparsities[i], tint, plain * 1000000.0 / iterations, rle * 1000000.0 / iterations, plain / rle);
+
+            SDL_DestroySurface(sprite);
+        }
+    }
+
+    SDL_DestroySurface(screen);
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
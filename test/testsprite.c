@@ -42,6 +42,8 @@ static Uint64 next_fps_check;
 static Uint32 frames;
 static const int fps_check_delay = 5000;
 static int use_rendergeometry = 0;
+static SDL_bool use_rendertextures = SDL_FALSE;
+static SDL_bool show_stats = SDL_FALSE;
 
 /* Number of iterations to move sprites - used for visual tests. */
 /* -1: infinite random moves (default); >=0: enables N deterministic moves */
@@ -86,6 +88,41 @@ static int LoadSprite(const char *file)
     return 0;
 }
 
+static void DrawStats(SDL_Renderer *renderer)
+{
+    SDL_RenderStats stats;
+    char text[128];
+    const float x = sprite_w + 4.0f;
+    float y = 4.0f;
+
+    if (SDL_GetRenderStats(renderer, &stats) < 0) {
+        return;
+    }
+
+    /* The overlay is drawn with the renderer too, so it is part of the next frame's numbers */
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_snprintf(text, sizeof(text), "commands: %d submitted, %d dropped", stats.submitted_commands, stats.dropped_commands);
+    SDLTest_DrawString(renderer, x, y, text);
+    y += FONT_LINE_HEIGHT;
+    SDL_snprintf(text, sizeof(text), "  state %d, clear %d, points %d, lines %d, rects %d, copies %d, geometry %d",
+                 stats.state_commands, stats.clear_commands, stats.point_commands, stats.line_commands,
+                 stats.rect_commands, stats.copy_commands, stats.geometry_commands);
+    SDLTest_DrawString(renderer, x, y, text);
+    y += FONT_LINE_HEIGHT;
+    SDL_snprintf(text, sizeof(text), "draw calls: %d, flushes: %d (%d for textures)", stats.draw_calls, stats.flushes, stats.texture_flushes);
+    SDLTest_DrawString(renderer, x, y, text);
+    y += FONT_LINE_HEIGHT;
+    SDL_snprintf(text, sizeof(text), "changes: texture %d, blend %d, shader %d, viewport %d",
+                 stats.texture_changes, stats.blend_changes, stats.shader_changes, stats.viewport_changes);
+    SDLTest_DrawString(renderer, x, y, text);
+    y += FONT_LINE_HEIGHT;
+    SDL_snprintf(text, sizeof(text), "uploads: %" SDL_PRIu64 " vertex bytes, %" SDL_PRIu64 " texture bytes", stats.vertex_bytes, stats.texture_bytes);
+    SDLTest_DrawString(renderer, x, y, text);
+    y += FONT_LINE_HEIGHT;
+    SDL_snprintf(text, sizeof(text), "queue time: %.3f ms", stats.command_time_ns / 1000000.0);
+    SDLTest_DrawString(renderer, x, y, text);
+}
+
 static void MoveSprites(SDL_Renderer *renderer, SDL_Texture *sprite)
 {
     int i;
@@ -234,7 +271,23 @@ static void MoveSprites(SDL_Renderer *renderer, SDL_Texture *sprite)
     }
 
     /* Draw sprites */
-    if (use_rendergeometry == 0) {
+    if (use_rendertextures) {
+        /* Draw all the sprites in a single batch */
+        SDL_TextureBatchItem *items = (SDL_TextureBatchItem *)SDL_calloc(num_sprites, sizeof(*items));
+        if (items) {
+            for (i = 0; i < num_sprites; ++i) {
+                items[i].srcrect.w = sprite_w;
+                items[i].srcrect.h = sprite_h;
+                items[i].dstrect = positions[i];
+                items[i].color.r = 0xFF;
+                items[i].color.g = 0xFF;
+                items[i].color.b = 0xFF;
+                items[i].color.a = 0xFF;
+            }
+            SDL_RenderTextures(renderer, sprite, items, num_sprites);
+            SDL_free(items);
+        }
+    } else if (use_rendergeometry == 0) {
         for (i = 0; i < num_sprites; ++i) {
             position = &positions[i];
 
@@ -390,6 +443,10 @@ static void MoveSprites(SDL_Renderer *renderer, SDL_Texture *sprite)
         SDL_free(indices2);
     }
 
+    if (show_stats) {
+        DrawStats(renderer);
+    }
+
     /* Update the screen! */
     SDL_RenderPresent(renderer);
 }
@@ -422,7 +479,7 @@ static void loop(void)
         /* Print out some timing information */
         const Uint64 then = next_fps_check - fps_check_delay;
         const double fps = ((double)frames * 1000) / (now - then);
-        SDL_Log("%2.2f frames per second\n", fps);
+        SDL_Log("%2.2f frames per second, %2.0f sprites per second\n", fps, fps * num_sprites);
         next_fps_check = now + fps_check_delay;
         frames = 0;
     }
@@ -499,6 +556,12 @@ int main(int argc, char *argv[])
                     }
                 }
                 consumed = 2;
+            } else if (SDL_strcasecmp(argv[i], "--use-rendertextures") == 0) {
+                use_rendertextures = SDL_TRUE;
+                consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--stats") == 0) {
+                show_stats = SDL_TRUE;
+                consumed = 1;
             } else if (SDL_isdigit(*argv[i])) {
                 num_sprites = SDL_atoi(argv[i]);
                 consumed = 1;
@@ -514,6 +577,8 @@ int main(int argc, char *argv[])
                 "[--cyclealpha]",
                 "[--iterations N]",
                 "[--use-rendergeometry mode1|mode2]",
+                "[--use-rendertextures]",
+                "[--stats]",
                 "[num_sprites]",
                 "[icon.bmp]",
                 NULL
@@ -16,7 +16,7 @@
 #include "testutils.h"
 
 /* 422 (YUY2, etc) formats are the largest */
-#define MAX_YUV_SURFACE_SIZE(W, H, P) (H * 4 * (W + P + 1) / 2)
+#define MAX_YUV_SURFACE_SIZE(W, H, P) ((H) * 4 * ((W) + (P) + 1))
 
 /* Return true if the YUV format is packed pixels */
 static SDL_bool is_packed_yuv_format(Uint32 format)
@@ -116,15 +116,27 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
         SDL_PIXELFORMAT_UYVY,
         SDL_PIXELFORMAT_YVYU
     };
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_XBGR8888,
+        SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_BGRX8888
+    };
+    const Uint32 formats_16[] = {
+        SDL_PIXELFORMAT_P010,
+        SDL_PIXELFORMAT_P016
+    };
     int i, j;
     SDL_Surface *pattern = generate_test_pattern(pattern_size);
     const int yuv_len = MAX_YUV_SURFACE_SIZE(pattern->w, pattern->h, extra_pitch);
+    const int rgb_pitch = pattern->w * 4;
     Uint8 *yuv1 = (Uint8 *)SDL_malloc(yuv_len);
     Uint8 *yuv2 = (Uint8 *)SDL_malloc(yuv_len);
+    Uint8 *rgb = (Uint8 *)SDL_malloc((size_t)rgb_pitch * pattern->h);
     int yuv1_pitch, yuv2_pitch;
     int result = -1;
 
-    if (pattern == NULL || yuv1 == NULL || yuv2 == NULL) {
+    if (pattern == NULL || yuv1 == NULL || yuv2 == NULL || rgb == NULL) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't allocate test surfaces");
         goto done;
     }
@@ -142,6 +154,52 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
         }
     }
 
+    /* Verify conversion from 16-bit YUV formats, which keeps 10 bits of precision for ARGB2101010 */
+    for (i = 0; i < SDL_arraysize(formats_16); ++i) {
+        int x, y;
+
+        if (!ConvertRGBtoYUV(formats_16[i], pattern->pixels, pattern->pitch, yuv1, pattern->w, pattern->h, SDL_GetYUVConversionModeForResolution(pattern->w, pattern->h), 0, 100)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "ConvertRGBtoYUV() doesn't support converting to %s\n", SDL_GetPixelFormatName(formats_16[i]));
+            goto done;
+        }
+
+        /* Repack with some extra pitch, keeping the samples aligned.
+           The UV rows have 4 bytes for each pair of pixels. */
+        yuv1_pitch = CalculateYUVPitch(formats_16[i], pattern->w);
+        yuv2_pitch = yuv1_pitch + 2 * extra_pitch;
+        for (y = 0; y < pattern->h; ++y) {
+            SDL_memcpy(yuv2 + y * yuv2_pitch, yuv1 + y * yuv1_pitch, yuv1_pitch);
+        }
+        for (y = 0; y < (pattern->h + 1) / 2; ++y) {
+            const int uv_len = 4 * ((pattern->w + 1) / 2);
+            SDL_memcpy(yuv2 + pattern->h * yuv2_pitch + y * 4 * ((yuv2_pitch + 3) / 4), yuv1 + pattern->h * yuv1_pitch + y * uv_len, uv_len);
+        }
+        if (!verify_yuv_data(formats_16[i], yuv2, yuv2_pitch, pattern)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed conversion from %s to RGB\n", SDL_GetPixelFormatName(formats_16[i]));
+            goto done;
+        }
+
+        if (SDL_ConvertPixels(pattern->w, pattern->h, formats_16[i], yuv2, yuv2_pitch, SDL_PIXELFORMAT_ARGB2101010, rgb, rgb_pitch) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(formats_16[i]), SDL_GetPixelFormatName(SDL_PIXELFORMAT_ARGB2101010), SDL_GetError());
+            goto done;
+        }
+        for (y = 0; y < pattern->h; ++y) {
+            const Uint32 *actual = (const Uint32 *)(rgb + y * rgb_pitch);
+            const Uint8 *expected = (const Uint8 *)pattern->pixels + y * pattern->pitch;
+            for (x = 0; x < pattern->w; ++x) {
+                const int deltaR = (int)((actual[x] >> 20) & 0x3FF) - 4 * expected[0];
+                const int deltaG = (int)((actual[x] >> 10) & 0x3FF) - 4 * expected[1];
+                const int deltaB = (int)(actual[x] & 0x3FF) - 4 * expected[2];
+                if (deltaR * deltaR + deltaG * deltaG + deltaB * deltaB > 16 * 20) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pixel at %d,%d was 0x%.8" SDL_PRIx32 ", expected 0x%.2x,0x%.2x,0x%.2x\n", x, y, actual[x], expected[0], expected[1], expected[2]);
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed conversion from %s to %s\n", SDL_GetPixelFormatName(formats_16[i]), SDL_GetPixelFormatName(SDL_PIXELFORMAT_ARGB2101010));
+                    goto done;
+                }
+                expected += 3;
+            }
+        }
+    }
+
     /* Verify conversion to YUV formats */
     for (i = 0; i < SDL_arraysize(formats); ++i) {
         yuv1_pitch = CalculateYUVPitch(formats[i], pattern->w) + extra_pitch;
@@ -155,6 +213,25 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
         }
     }
 
+    /* Verify conversion to YUV formats from 32-bit RGB formats, which are read directly */
+    for (i = 0; i < SDL_arraysize(rgb_formats); ++i) {
+        if (SDL_ConvertPixels(pattern->w, pattern->h, pattern->format->format, pattern->pixels, pattern->pitch, rgb_formats[i], rgb, rgb_pitch) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(pattern->format->format), SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetError());
+            goto done;
+        }
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            yuv1_pitch = CalculateYUVPitch(formats[j], pattern->w) + extra_pitch;
+            if (SDL_ConvertPixels(pattern->w, pattern->h, rgb_formats[i], rgb, rgb_pitch, formats[j], yuv1, yuv1_pitch) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetPixelFormatName(formats[j]), SDL_GetError());
+                goto done;
+            }
+            if (!verify_yuv_data(formats[j], yuv1, yuv1_pitch, pattern)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed conversion from %s to %s\n", SDL_GetPixelFormatName(rgb_formats[i]), SDL_GetPixelFormatName(formats[j]));
+                goto done;
+            }
+        }
+    }
+
     /* Verify conversion between YUV formats */
     for (i = 0; i < SDL_arraysize(formats); ++i) {
         for (j = 0; j < SDL_arraysize(formats); ++j) {
@@ -205,10 +282,68 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
 done:
     SDL_free(yuv1);
     SDL_free(yuv2);
+    SDL_free(rgb);
     SDL_DestroySurface(pattern);
     return result;
 }
 
+/* Report the time to convert a frame of common video sizes */
+static int run_benchmark(Uint32 yuv_format, Uint32 rgb_format, int iterations)
+{
+    static const struct
+    {
+        const char *name;
+        int w, h;
+    } sizes[] = {
+        { "720p", 1280, 720 },
+        { "1080p", 1920, 1080 },
+        { "4K", 3840, 2160 },
+    };
+    int i, j;
+
+    for (i = 0; i < SDL_arraysize(sizes); ++i) {
+        const int w = sizes[i].w;
+        const int h = sizes[i].h;
+        const int yuv_pitch = CalculateYUVPitch(yuv_format, w);
+        const int rgb_pitch = w * 4;
+        const size_t yuv_len = MAX_YUV_SURFACE_SIZE((size_t)w, (size_t)h, 0);
+        Uint8 *yuv = (Uint8 *)SDL_malloc(yuv_len);
+        Uint8 *rgb = (Uint8 *)SDL_malloc((size_t)rgb_pitch * h);
+        Uint64 start, elapsed;
+
+        if (yuv == NULL || rgb == NULL) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+            SDL_free(yuv);
+            SDL_free(rgb);
+            return -1;
+        }
+        for (j = 0; j < (int)yuv_len; ++j) {
+            yuv[j] = (Uint8)(j * 7);
+        }
+
+        /* Warm up, so that the pages are mapped before timing */
+        if (SDL_ConvertPixels(w, h, yuv_format, yuv, yuv_pitch, rgb_format, rgb, rgb_pitch) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(yuv_format), SDL_GetPixelFormatName(rgb_format), SDL_GetError());
+            SDL_free(yuv);
+            SDL_free(rgb);
+            return -1;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        for (j = 0; j < iterations; ++j) {
+            SDL_ConvertPixels(w, h, yuv_format, yuv, yuv_pitch, rgb_format, rgb, rgb_pitch);
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%-6s %s to %s: %.2f ms/frame\n", sizes[i].name,
+                    SDL_GetPixelFormatName(yuv_format), SDL_GetPixelFormatName(rgb_format),
+                    (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations);
+
+        SDL_free(yuv);
+        SDL_free(rgb);
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     struct
@@ -258,6 +393,7 @@ int main(int argc, char **argv)
     Uint64 then, now;
     int i, iterations = 100;
     SDL_bool should_run_automated_tests = SDL_FALSE;
+    SDL_bool should_run_benchmark = SDL_FALSE;
     SDLTest_CommonState *state;
 
     /* Initialize test framework */
@@ -308,6 +444,9 @@ int main(int argc, char **argv)
             } else if (SDL_strcmp(argv[i], "--nv21") == 0) {
                 yuv_format = SDL_PIXELFORMAT_NV21;
                 consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--p010") == 0) {
+                yuv_format = SDL_PIXELFORMAT_P010;
+                consumed = 1;
             } else if (SDL_strcmp(argv[i], "--rgb555") == 0) {
                 rgb_format = SDL_PIXELFORMAT_RGB555;
                 consumed = 1;
@@ -332,6 +471,9 @@ int main(int argc, char **argv)
             } else if (SDL_strcmp(argv[i], "--automated") == 0) {
                 should_run_automated_tests = SDL_TRUE;
                 consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--benchmark") == 0) {
+                should_run_benchmark = SDL_TRUE;
+                consumed = 1;
             } else if (!filename) {
                 filename = argv[i];
                 consumed = 1;
@@ -340,9 +482,9 @@ int main(int argc, char **argv)
         if (consumed <= 0) {
             static const char *options[] = {
                 "[--jpeg|--bt601|-bt709|--auto]",
-                "[--yv12|--iyuv|--yuy2|--uyvy|--yvyu|--nv12|--nv21]",
+                "[--yv12|--iyuv|--yuy2|--uyvy|--yvyu|--nv12|--nv21|--p010]",
                 "[--rgb555|--rgb565|--rgb24|--argb|--abgr|--rgba|--bgra]",
-                "[--automated]",
+                "[--automated|--benchmark]",
                 "[sample.bmp]",
                 NULL,
             };
@@ -367,6 +509,11 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    /* Run the benchmark */
+    if (should_run_benchmark) {
+        return (run_benchmark(yuv_format, rgb_format, iterations) < 0) ? 2 : 0;
+    }
+
     filename = GetResourceFilename(filename, "testyuv.bmp");
     original = SDL_ConvertSurfaceFormat(SDL_LoadBMP(filename), SDL_PIXELFORMAT_RGB24);
     if (original == NULL) {
@@ -259,9 +259,28 @@ static void ConvertRGBtoPacked4(Uint32 format, Uint8 *src, int pitch, Uint8 *out
     }
 }
 
+/* Converts to NV12 and widens the samples into the high bits, which is exact for P010 and P016 */
+static void ConvertRGBtoPlanar2x2_16(Uint8 *src, int pitch, Uint8 *out, int w, int h, SDL_YUV_CONVERSION_MODE mode, int monochrome, int luminance)
+{
+    const int size = w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+    Uint16 *out16 = (Uint16 *)out;
+    int i;
+
+    ConvertRGBtoPlanar2x2(SDL_PIXELFORMAT_NV12, src, pitch, out, w, h, mode, monochrome, luminance);
+
+    /* Go backwards so we don't overwrite samples we haven't read yet */
+    for (i = size - 1; i >= 0; --i) {
+        out16[i] = (Uint16)(out[i] << 8);
+    }
+}
+
 SDL_bool ConvertRGBtoYUV(Uint32 format, Uint8 *src, int pitch, Uint8 *out, int w, int h, SDL_YUV_CONVERSION_MODE mode, int monochrome, int luminance)
 {
     switch (format) {
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        ConvertRGBtoPlanar2x2_16(src, pitch, out, w, h, mode, monochrome, luminance);
+        return SDL_TRUE;
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_IYUV:
     case SDL_PIXELFORMAT_NV12:
@@ -286,6 +305,9 @@ int CalculateYUVPitch(Uint32 format, int width)
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
         return width;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        return 2 * width;
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU: